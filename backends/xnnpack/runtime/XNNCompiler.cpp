@@ -1770,7 +1770,7 @@ ET_NODISCARD Error XNNCompiler::compileModel(
     size_t num_bytes,
     XNNExecutor* executor,
     XNNWeightsCache* weights_cache,
-    xnn_workspace_t workspace,
+    XNNWorkspace* workspace,
     const NamedDataMap* named_data_map) {
   Result<XNNHeader> header = XNNHeader::Parse(buffer_pointer, num_bytes);
   const uint8_t* flatbuffer_data = nullptr;
@@ -1891,24 +1891,25 @@ ET_NODISCARD Error XNNCompiler::compileModel(
   xnn_weights_cache_t weights_cache_ptr = nullptr;
 #endif
 
-#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
+  // Every delegate gets a workspace from the XNNWorkspaceManager, even when
+  // it doesn't share it with any other delegate.
   ET_CHECK_OR_RETURN_ERROR(
       workspace != nullptr, Internal, "Failed to initialize XNNPACK workspace");
+  std::shared_ptr<pthreadpool> threadpool =
+      ::executorch::extension::threadpool::get_shared_pthreadpool();
+#ifndef ENABLE_XNNPACK_WEIGHTS_CACHE
+  // Creating a runtime registers it with its workspace, which is not thread
+  // safe. Delegates that share a workspace can still define their subgraphs
+  // in parallel; only this step, which also packs the weights, is serialized.
+  auto workspace_lock = workspace->acquire();
+#endif
   status = xnn_create_runtime_v4(
       subgraph.get(),
       weights_cache_ptr,
-      workspace,
-      ::executorch::extension::threadpool::get_pthreadpool(),
+      workspace->unsafe_get_workspace(),
+      threadpool.get(),
       runtime_flags,
       &runtime_ptr);
-#else
-  status = xnn_create_runtime_v3(
-      subgraph.get(),
-      weights_cache_ptr,
-      ::executorch::extension::threadpool::get_pthreadpool(),
-      runtime_flags,
-      &runtime_ptr);
-#endif
 
   ET_CHECK_OR_RETURN_ERROR(
       xnn_status_success == status,
@@ -1935,6 +1936,7 @@ ET_NODISCARD Error XNNCompiler::compileModel(
       std::move(input_ids),
       std::move(output_ids),
       std::move(packed_weights_names.get()));
+  executor->threadpool_ = std::move(threadpool);
 
   return err;
 };
@@ -10,6 +10,7 @@
 
 #include <executorch/backends/xnnpack/runtime/XNNExecutor.h>
 #include <executorch/backends/xnnpack/runtime/XNNWeightsCache.h>
+#include <executorch/backends/xnnpack/runtime/XNNWorkspace.h>
 #include <executorch/runtime/platform/compiler.h>
 #include <xnnpack.h>
 
@@ -23,12 +24,14 @@ class XNNCompiler {
   // Takes Flatbuffer Serialized XNNPACK Model and rebuilds the xnn-subgraph
   // returns an executor object that holds the xnn runtime object which we
   // can then use to set inputs and run inference using the xnn graph.
+  // Without the weights cache, `workspace` is only locked while the runtime
+  // is created; with it, the caller must already hold the workspace lock.
   ET_NODISCARD static executorch::runtime::Error compileModel(
       const void* buffer_pointer,
       size_t num_bytes,
       XNNExecutor* executor,
       XNNWeightsCache* weights_cache,
-      xnn_workspace_t workspace,
+      XNNWorkspace* workspace,
       const NamedDataMap* named_data_map);
 };
 
@@ -8,6 +8,8 @@
 
 #include <executorch/backends/xnnpack/runtime/XNNExecutor.h>
 
+#include <algorithm>
+
 namespace executorch {
 namespace backends {
 namespace xnnpack {
@@ -54,6 +56,9 @@ ET_NODISCARD Error XNNExecutor::initialize(
   externals_.resize(input_ids_.size() + output_ids_.size());
   packed_data_names_ = std::move(packed_data_names);
 
+  input_shapes_.resize(input_ids_.size());
+  needs_reshape_ = true;
+
   return Error::Ok;
 }
 
@@ -61,9 +66,10 @@ ET_NODISCARD Error XNNExecutor::initialize(
  * Prepares the args for XNNPACK Runtime.
  *
  * Creates an array of xnn_externals_values from the EValues passed in.
- * Reshapes all the external input tensors, in case any input shapes have
- * changed. The reshapes the entire runtime, propagating shape information
- * through the runtime.
+ * Reshapes the external input tensors whose shapes have changed since the
+ * last call, then reshapes the entire runtime, propagating shape information
+ * through the runtime. When no input shape has changed, the runtime keeps the
+ * shapes and memory plan from the previous call and the reshape is skipped.
  *
  * Note: the external ids given to the external tensors in the XNNPACK
  * runtime correspond to their index in the list of arg passed into
@@ -117,23 +123,38 @@ ET_NODISCARD Error XNNExecutor::prepare_args(EValue** args) {
       for (int j = 0; j < num_dims; ++j) {
         dims[j] = tensor->size(static_cast<int>(dim_order[j]));
       }
-      status =
-          xnn_reshape_external_value(runtime_.get(), ext_id, num_dims, dims);
-      ET_CHECK_OR_RETURN_ERROR(
-          status == xnn_status_success,
-          Internal,
-          "Internal Error: Reshape Input Tensor Failed with code: %s",
-          xnn_status_to_string(status));
+
+      InputShape& last_shape = input_shapes_[i];
+      if (needs_reshape_ || num_dims != last_shape.num_dims ||
+          !std::equal(dims, dims + num_dims, last_shape.dims)) {
+        // Stays set until the runtime has been reshaped successfully, so a
+        // failure below forces a full reshape on the next call.
+        needs_reshape_ = true;
+        status =
+            xnn_reshape_external_value(runtime_.get(), ext_id, num_dims, dims);
+        ET_CHECK_OR_RETURN_ERROR(
+            status == xnn_status_success,
+            Internal,
+            "Internal Error: Reshape Input Tensor Failed with code: %s",
+            xnn_status_to_string(status));
+        last_shape.num_dims = num_dims;
+        std::copy(dims, dims + num_dims, last_shape.dims);
+      }
     }
   }
-  // // Propagate Input Shape and Memory Plan for increased allocation
-  status = xnn_reshape_runtime(runtime_.get());
 
-  ET_CHECK_OR_RETURN_ERROR(
-      status == xnn_status_success,
-      Internal,
-      "Internal Error: Propagating input shapes failed with code: %s",
-      xnn_status_to_string(status));
+  if (needs_reshape_) {
+    // Propagate Input Shape and Memory Plan for increased allocation
+    status = xnn_reshape_runtime(runtime_.get());
+
+    ET_CHECK_OR_RETURN_ERROR(
+        status == xnn_status_success,
+        Internal,
+        "Internal Error: Propagating input shapes failed with code: %s",
+        xnn_status_to_string(status));
+    needs_reshape_ = false;
+    num_runtime_reshapes_++;
+  }
 
   return Error::Ok;
 }
@@ -9,7 +9,9 @@
 #pragma once
 
 #include <executorch/backends/xnnpack/runtime/XNNStatus.h>
+#include <executorch/backends/xnnpack/runtime/XNNWorkspace.h>
 #include <executorch/backends/xnnpack/runtime/profiling/XNNProfiler.h>
+#include <executorch/extension/threadpool/threadpool.h>
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
@@ -26,6 +28,13 @@ namespace delegate {
 
 class XNNExecutor {
  private:
+  // Declared before runtime_ so that the runtime is deleted before the
+  // workspace it was created on is released.
+  std::shared_ptr<XNNWorkspace> workspace_;
+  // The pthreadpool that the runtime was created with, if any. The ThreadPool
+  // it came from, e.g. one selected by a UseThreadPoolGuard, may be destroyed
+  // before the runtime, so keep it alive here.
+  std::shared_ptr<pthreadpool> threadpool_;
   std::unique_ptr<xnn_runtime, decltype(&xnn_delete_runtime)> runtime_{
       nullptr,
       &xnn_delete_runtime};
@@ -36,9 +45,27 @@ class XNNExecutor {
   std::vector<xnn_external_value> externals_;
   std::vector<std::string> packed_data_names_;
 
+  // Shape of an input, in dim order, as last given to the runtime.
+  struct InputShape {
+    size_t num_dims = 0;
+    size_t dims[XNN_MAX_TENSOR_DIMS];
+  };
+  std::vector<InputShape> input_shapes_;
+  // Whether the runtime must be reshaped before the next setup, even if the
+  // input shapes match input_shapes_.
+  bool needs_reshape_ = true;
+  // Number of times prepare_args() reshaped the runtime.
+  size_t num_runtime_reshapes_ = 0;
+  // The serialized graph that the runtime was compiled from, if it is kept
+  // so that clones can compile it again.
+  const executorch::runtime::FreeableBuffer* graph_ = nullptr;
+
  public:
   XNNExecutor() = default;
 
+  explicit XNNExecutor(std::shared_ptr<XNNWorkspace> workspace)
+      : workspace_(std::move(workspace)) {}
+
   inline size_t getNumInputs() {
     return input_ids_.size();
   }
@@ -51,6 +78,38 @@ class XNNExecutor {
     return packed_data_names_;
   }
 
+  /**
+   * Returns the workspace the runtime is created on, or nullptr if the
+   * executor was not given one.
+   */
+  inline std::shared_ptr<XNNWorkspace> get_workspace() {
+    return workspace_;
+  }
+
+  /**
+   * Remembers `graph`, the serialized graph that the runtime was compiled
+   * from, for clones of this executor. It must outlive the executor.
+   */
+  inline void set_graph(const executorch::runtime::FreeableBuffer* graph) {
+    graph_ = graph;
+  }
+
+  /**
+   * Returns the graph that the runtime was compiled from, or nullptr if it
+   * was not kept.
+   */
+  inline const executorch::runtime::FreeableBuffer* get_graph() const {
+    return graph_;
+  }
+
+  /**
+   * Returns the number of times prepare_args() has reshaped the runtime, which
+   * only happens when the input shapes change.
+   */
+  inline size_t get_num_runtime_reshapes() const {
+    return num_runtime_reshapes_;
+  }
+
   /**
    * Initialize the XNNExecutor with a given runtime and input/output ids.
    * The input/output ids are expected to be sorted in order of their
@@ -66,13 +125,15 @@ class XNNExecutor {
    * Prepares the arguments for runtime graph execution.
    * args is an array of EValues that will be passed into the runtime.
    * input shapes will be propagated through the runtime, and perform
-   * any additional memory planning as needed
+   * any additional memory planning as needed. Shape propagation is skipped
+   * when the input shapes are the same as in the previous call.
    */
   ET_NODISCARD executorch::runtime::Error prepare_args(
       executorch::runtime::EValue** args);
 
   /**
-   * Executes the graph using the args prepared at prepare_args().
+   * Executes the graph using the args prepared at prepare_args(), on the
+   * threadpool that was current when the runtime was created.
    */
   ET_NODISCARD executorch::runtime::Error forward(
       executorch::ET_RUNTIME_NAMESPACE::BackendExecutionContext& context);
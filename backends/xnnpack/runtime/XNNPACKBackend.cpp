@@ -7,32 +7,44 @@
  */
 
 #include <executorch/backends/xnnpack/runtime/XNNCompiler.h>
+#include <executorch/backends/xnnpack/runtime/XNNHeader.h>
+#include <executorch/backends/xnnpack/runtime/XNNPACKBackend.h>
 #include <executorch/backends/xnnpack/runtime/XNNWeightsCache.h>
+#include <executorch/backends/xnnpack/runtime/XNNWorkspaceManager.h>
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/executor/pte_data_map.h>
 
+#include <cstring>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 
 #pragma clang diagnostic ignored "-Wglobal-constructors"
 
 namespace executorch {
 namespace backends {
 
+using executorch::backends::xnnpack::WorkspaceSharingMode;
+using executorch::backends::xnnpack::delegate::XNNHeader;
 using executorch::backends::xnnpack::delegate::XNNWeightsCache;
+using executorch::backends::xnnpack::delegate::XNNWorkspace;
+using executorch::backends::xnnpack::delegate::XNNWorkspaceManager;
 using executorch::ET_RUNTIME_NAMESPACE::Backend;
 using executorch::ET_RUNTIME_NAMESPACE::BackendExecutionContext;
 using executorch::ET_RUNTIME_NAMESPACE::BackendInitContext;
+using executorch::ET_RUNTIME_NAMESPACE::BackendOptionContext;
 using executorch::ET_RUNTIME_NAMESPACE::CompileSpec;
 using executorch::ET_RUNTIME_NAMESPACE::DelegateHandle;
 using executorch::ET_RUNTIME_NAMESPACE::NamedDataMap;
 using executorch::runtime::ArrayRef;
+using executorch::runtime::BackendOption;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
 using executorch::runtime::FreeableBuffer;
 using executorch::runtime::Result;
+using executorch::runtime::Span;
 
 class XnnpackBackend final
     : public ::executorch::ET_RUNTIME_NAMESPACE::BackendInterface {
@@ -49,24 +61,6 @@ class XnnpackBackend final
           (unsigned int)status);
       return;
     }
-
-#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
-    // Create a workspace for the XNNExecutor to use. This workspace will be
-    // shared across all delegate instances.
-    ET_LOG(Debug, "Creating XNN workspace");
-    xnn_workspace_t workspace = nullptr;
-    status = xnn_create_workspace(&workspace);
-    if (status != xnn_status_success) {
-      ET_LOG(
-          Error,
-          "Failed to create XNN workspace, XNNPACK status: 0x%x",
-          (unsigned int)status);
-      workspace = nullptr;
-      return;
-    }
-    workspace_.reset(workspace);
-    ET_LOG(Debug, "Created XNN workspace: %p", workspace_.get());
-#endif // ENABLE_XNNPACK_SHARED_WORKSPACE
   }
 
   bool is_available() const override {
@@ -77,50 +71,49 @@ class XnnpackBackend final
       BackendInitContext& context,
       FreeableBuffer* processed,
       ArrayRef<CompileSpec> compile_specs) const override {
-    auto executor = context.get_runtime_allocator()
-                        ->allocateInstance<xnnpack::delegate::XNNExecutor>();
-    if (executor == nullptr) {
-      return Error::MemoryAllocationFailed;
+    Result<xnnpack::delegate::XNNExecutor*> executor =
+        create_executor(context, processed->data(), processed->size());
+    if (!executor.ok()) {
+      processed->Free();
+      return executor.error();
     }
-
-    const NamedDataMap* named_data_map = context.get_named_data_map();
-    // thread safe. This can heppen when multiple threads call init() on
-    // the same backend instance.
-#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
-    const std::lock_guard<std::mutex> lock(workspace_mutex_);
-#endif
-
 #ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
-    const std::lock_guard<std::mutex> lock_weight_cache(weights_cache_mutex_);
-    weights_cache_->initialize_for_runtime(
-        context.get_runtime_allocator(), named_data_map);
+    // The runtime keeps `processed` until the delegate is destroyed. Graphs
+    // whose weights all come from the named data map are small, so keep them
+    // for clone(): compiling them again finds the weights already packed in
+    // the cache.
+    Result<XNNHeader> header =
+        XNNHeader::Parse(processed->data(), processed->size());
+    if (header.ok() && header->constant_data_size == 0) {
+      executor.get()->set_graph(processed);
+      return executor.get();
+    }
 #endif
-
-    // Executor has been allocated but not constructed, ensure that runtime_ is
-    // nullptr by constructing it in place here. NOTE: Since we use placement
-    // new and since this type is not trivially destructible, we must call the
-    // destructor manually in destroy().
-    new (executor) xnnpack::delegate::XNNExecutor;
-    Error err = xnnpack::delegate::XNNCompiler::compileModel(
-        processed->data(),
-        processed->size(),
-        executor,
-        weights_cache_.get(),
-        workspace_.get(),
-        named_data_map);
     // This backend does not need its processed data after compiling the model.
     processed->Free();
+    return executor.get();
+  }
 
-    if (err != Error::Ok) {
-      // destroy() won't be called on this handle, so we need to clean it up
-      // now.
-      executor->~XNNExecutor();
-
-      ET_LOG(
-          Error, "XNNCompiler::compileModel failed: 0x%x", (unsigned int)err);
-      return err;
+  Result<DelegateHandle*> clone(
+      BackendInitContext& context,
+      DelegateHandle* handle) const override {
+    auto source = static_cast<xnnpack::delegate::XNNExecutor*>(handle);
+    const FreeableBuffer* graph = source->get_graph();
+    if (graph == nullptr) {
+      // Without the weights cache, a new runtime packs its weights again
+      // anyway, so the clone may as well init() from scratch.
+      return Error::NotSupported;
     }
-    return executor;
+    // The clone may execute at the same time as its source, so it needs a
+    // runtime of its own. Compiling the graph again reuses the packed weights.
+    Result<xnnpack::delegate::XNNExecutor*> executor =
+        create_executor(context, graph->data(), graph->size());
+    if (!executor.ok()) {
+      return executor.error();
+    }
+    // The graph belongs to the source delegate, which outlives the clone.
+    executor.get()->set_graph(graph);
+    return executor.get();
   }
 
   Error execute(
@@ -129,12 +122,15 @@ class XnnpackBackend final
       EValue** args) const override {
     auto executor = static_cast<xnnpack::delegate::XNNExecutor*>(handle);
 
-#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
-    const std::lock_guard<std::mutex> lock(workspace_mutex_);
-#endif
+    // Only delegates that share this workspace are serialized; delegates on
+    // other workspaces can execute concurrently.
+    auto workspace_lock = executor->get_workspace()->acquire();
 
 #ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
-    const std::lock_guard<std::mutex> lock_weights_cache(weights_cache_mutex_);
+    // Executing only reads packed weights, so any number of delegates may do
+    // so at once. init() and destroy() take the lock exclusively.
+    const std::shared_lock<std::shared_mutex> lock_weights_cache(
+        weights_cache_mutex_);
 #endif
 
     // Prepare Inputs/Outputs and Propagate Input Shapes
@@ -157,21 +153,21 @@ class XnnpackBackend final
 
   void destroy(DelegateHandle* handle) const override {
     if (handle != nullptr) {
+      auto executor = static_cast<xnnpack::delegate::XNNExecutor*>(handle);
+
       // This is needed to serialize access to xnn_delete_runtime which is not
       // thread safe. This can heppen when multiple threads call destroy() on
-      // the same backend instance.
-#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
-      const std::lock_guard<std::mutex> lock(workspace_mutex_);
-#endif
-
-      auto executor = static_cast<xnnpack::delegate::XNNExecutor*>(handle);
+      // the same backend instance. Keep a reference to the workspace so that
+      // it outlives the lock even if this is its last delegate.
+      std::shared_ptr<XNNWorkspace> workspace = executor->get_workspace();
+      auto workspace_lock = workspace->acquire();
 
 #ifdef ENABLE_XNNPACK_PROFILING
       executor->print_avg_op_timings();
 #endif
 
 #ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
-      const std::lock_guard<std::mutex> lock_weights_cache(
+      const std::unique_lock<std::shared_mutex> lock_weights_cache(
           weights_cache_mutex_);
       weights_cache_->delete_packed_data(executor->get_packed_data_names());
 #endif
@@ -181,26 +177,129 @@ class XnnpackBackend final
     }
   }
 
+  Error set_option(
+      ET_UNUSED BackendOptionContext& context,
+      const Span<BackendOption>& backend_options) override {
+    for (const auto& option : backend_options) {
+      if (strcmp(option.key, xnnpack::workspace_sharing_mode_option_key) ==
+          0) {
+        auto* value = std::get_if<int>(&option.value);
+        ET_CHECK_OR_RETURN_ERROR(
+            value != nullptr,
+            InvalidArgument,
+            "XNNPACK option %s must be an int",
+            option.key);
+        Error err = workspace_manager_.set_sharing_mode(
+            static_cast<WorkspaceSharingMode>(*value));
+        if (err != Error::Ok) {
+          return err;
+        }
+      } else {
+        ET_LOG(Error, "Unsupported XNNPACK option: %s", option.key);
+        return Error::InvalidArgument;
+      }
+    }
+    return Error::Ok;
+  }
+
+  Error get_option(
+      ET_UNUSED BackendOptionContext& context,
+      Span<BackendOption>& backend_options) override {
+    for (auto& option : backend_options) {
+      if (strcmp(option.key, xnnpack::workspace_sharing_mode_option_key) ==
+          0) {
+        option.value = static_cast<int>(workspace_manager_.get_sharing_mode());
+      } else {
+        ET_LOG(Error, "Unsupported XNNPACK option: %s", option.key);
+        return Error::InvalidArgument;
+      }
+    }
+    return Error::Ok;
+  }
+
  private:
-  // This is a global workspace for all delegate instances.
-  mutable std::mutex workspace_mutex_;
-  std::unique_ptr<xnn_workspace, decltype(&xnn_release_workspace)> workspace_{
-      nullptr,
-      &xnn_release_workspace};
-
-  // Weights cache is global to all delegate instances.
-  mutable std::mutex weights_cache_mutex_;
+  // Compiles the serialized graph in `data` into a new executor, allocated
+  // from the runtime allocator of `context`.
+  Result<xnnpack::delegate::XNNExecutor*> create_executor(
+      BackendInitContext& context,
+      const void* data,
+      size_t size) const {
+    auto executor = context.get_runtime_allocator()
+                        ->allocateInstance<xnnpack::delegate::XNNExecutor>();
+    if (executor == nullptr) {
+      return Error::MemoryAllocationFailed;
+    }
+
+    const NamedDataMap* named_data_map = context.get_named_data_map();
+
+    // All delegates of a Method share its id, so it identifies the model for
+    // WorkspaceSharingMode::PerModel. The runtime allocator would not, since
+    // it differs between delegates that are initialized in parallel.
+    auto workspace = workspace_manager_.get_or_create_workspace(
+        reinterpret_cast<uintptr_t>(context.get_method_id()));
+    if (!workspace.ok()) {
+      return workspace.error();
+    }
+
+#ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
+    // Packing weights into the shared cache is not thread safe, so the whole
+    // compile holds both locks, in the order of the lock hierarchy below.
+    // Without the cache, compileModel() only locks the workspace while it
+    // creates the runtime.
+    auto workspace_lock = workspace.get()->acquire();
+    const std::unique_lock<std::shared_mutex> lock_weight_cache(
+        weights_cache_mutex_);
+    weights_cache_->initialize_for_runtime(
+        context.get_runtime_allocator(), named_data_map);
+#endif
+
+    // Executor has been allocated but not constructed, ensure that runtime_ is
+    // nullptr by constructing it in place here. NOTE: Since we use placement
+    // new and since this type is not trivially destructible, we must call the
+    // destructor manually in destroy().
+    new (executor) xnnpack::delegate::XNNExecutor(workspace.get());
+    Error err = xnnpack::delegate::XNNCompiler::compileModel(
+        data,
+        size,
+        executor,
+        weights_cache_.get(),
+        workspace.get().get(),
+        named_data_map);
+    if (err != Error::Ok) {
+      // destroy() won't be called on this handle, so we need to clean it up
+      // now.
+      executor->~XNNExecutor();
+
+      ET_LOG(
+          Error, "XNNCompiler::compileModel failed: 0x%x", (unsigned int)err);
+      return err;
+    }
+    return executor;
+  }
+
+  // Hands out the workspaces that delegate instances are created on.
+  mutable XNNWorkspaceManager workspace_manager_{
+#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
+      WorkspaceSharingMode::Global
+#else
+      WorkspaceSharingMode::Disabled
+#endif
+  };
+
+  // Weights cache is global to all delegate instances. Packed weights are
+  // only written in init() and destroy(), so execute() takes a shared lock.
+  mutable std::shared_mutex weights_cache_mutex_;
   std::unique_ptr<XNNWeightsCache> weights_cache_ =
       std::make_unique<XNNWeightsCache>();
 
   // Lock Hiearchy for Mutexes:
-  // workspace_mutex_
+  // XNNWorkspace mutex
   // weights_cache_mutex_
 };
 
 namespace {
 auto cls = XnnpackBackend();
-Backend backend{"XnnpackBackend", &cls};
+Backend backend{xnnpack::xnnpack_backend_key, &cls};
 static auto success_with_compiler = register_backend(backend);
 } // namespace
 
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+namespace executorch {
+namespace backends {
+namespace xnnpack {
+
+/// The name the XNNPACK backend is registered under. Pass it to
+/// executorch::runtime::set_option() to configure the backend.
+const char xnnpack_backend_key[] = "XnnpackBackend";
+
+/// Backend option that selects the WorkspaceSharingMode, as an int. Only
+/// affects delegates initialized after the option is set.
+const char workspace_sharing_mode_option_key[] = "workspace_sharing_mode";
+
+/**
+ * Controls which delegate instances share an XNNPACK workspace (the scratch
+ * memory used for intermediate tensors). Delegates that share a workspace
+ * cannot execute at the same time, so sharing trades memory for concurrency.
+ */
+enum class WorkspaceSharingMode {
+  /// Every delegate instance has its own workspace. Any delegates may execute
+  /// concurrently.
+  Disabled = 0,
+
+  /// The delegates of one loaded Method share a workspace. Separate Methods,
+  /// including clones of the same Method, can execute concurrently.
+  PerModel = 1,
+
+  /// All delegate instances in the process share a single workspace, and
+  /// their executions are serialized.
+  Global = 2,
+
+  /// The number of sharing modes. Not a valid mode.
+  Count,
+};
+
+} // namespace xnnpack
+} // namespace backends
+} // namespace executorch
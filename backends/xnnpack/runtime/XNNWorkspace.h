@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/log.h>
+
+#include <xnnpack.h>
+#include <memory>
+#include <mutex>
+
+namespace executorch {
+namespace backends {
+namespace xnnpack {
+namespace delegate {
+
+using WorkspacePtr =
+    std::unique_ptr<xnn_workspace, decltype(&xnn_release_workspace)>;
+
+/**
+ * An XNNPACK workspace and the mutex that guards it. Runtimes created on the
+ * same workspace use the same scratch memory, so only one of them may be
+ * reshaped, set up, invoked, created or deleted at a time.
+ */
+class XNNWorkspace {
+ public:
+  explicit XNNWorkspace(WorkspacePtr workspace)
+      : workspace_(std::move(workspace)) {}
+
+  XNNWorkspace(const XNNWorkspace&) = delete;
+  XNNWorkspace& operator=(const XNNWorkspace&) = delete;
+  XNNWorkspace(XNNWorkspace&&) = delete;
+  XNNWorkspace& operator=(XNNWorkspace&&) = delete;
+
+  /**
+   * Locks the workspace. The returned lock must be held while using any
+   * runtime created on this workspace.
+   */
+  std::unique_lock<std::mutex> acquire() {
+    return std::unique_lock<std::mutex>(mutex_);
+  }
+
+  /**
+   * Returns the underlying XNNPACK workspace. Callers must hold the lock
+   * returned by acquire() while XNNPACK uses it.
+   */
+  xnn_workspace_t unsafe_get_workspace() const {
+    return workspace_.get();
+  }
+
+  /**
+   * Creates a new XNNPACK workspace.
+   */
+  static runtime::Result<std::shared_ptr<XNNWorkspace>> create() {
+    xnn_workspace_t workspace = nullptr;
+    xnn_status status = xnn_create_workspace(&workspace);
+    if (status != xnn_status_success) {
+      ET_LOG(
+          Error,
+          "Failed to create XNN workspace, XNNPACK status: 0x%x",
+          (unsigned int)status);
+      return runtime::Error::Internal;
+    }
+    return std::make_shared<XNNWorkspace>(
+        WorkspacePtr(workspace, &xnn_release_workspace));
+  }
+
+ private:
+  std::mutex mutex_;
+  WorkspacePtr workspace_;
+};
+
+} // namespace delegate
+} // namespace xnnpack
+} // namespace backends
+} // namespace executorch
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/xnnpack/runtime/XNNWorkspaceManager.h>
+
+namespace executorch {
+namespace backends {
+namespace xnnpack {
+namespace delegate {
+
+using executorch::runtime::Error;
+using executorch::runtime::Result;
+
+XNNWorkspaceManager::XNNWorkspaceManager(WorkspaceSharingMode sharing_mode)
+    : sharing_mode_(sharing_mode) {}
+
+Error XNNWorkspaceManager::set_sharing_mode(WorkspaceSharingMode sharing_mode) {
+  ET_CHECK_OR_RETURN_ERROR(
+      static_cast<int>(sharing_mode) >= 0 &&
+          sharing_mode < WorkspaceSharingMode::Count,
+      InvalidArgument,
+      "Invalid XNNPACK workspace sharing mode %d",
+      static_cast<int>(sharing_mode));
+  sharing_mode_.store(sharing_mode);
+  return Error::Ok;
+}
+
+Result<std::shared_ptr<XNNWorkspace>>
+XNNWorkspaceManager::get_or_create_workspace(uintptr_t model_id) {
+  WorkspaceSharingMode sharing_mode = sharing_mode_.load();
+  if (sharing_mode == WorkspaceSharingMode::Disabled) {
+    return XNNWorkspace::create();
+  }
+
+  const std::lock_guard<std::mutex> lock(mutex_);
+  std::weak_ptr<XNNWorkspace>* slot = &global_workspace_;
+  if (sharing_mode == WorkspaceSharingMode::PerModel) {
+    // Drop entries whose delegates have all been destroyed; their ids may be
+    // reused by unrelated models.
+    for (auto it = model_workspaces_.begin(); it != model_workspaces_.end();) {
+      if (it->second.expired()) {
+        it = model_workspaces_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    slot = &model_workspaces_[model_id];
+  }
+
+  std::shared_ptr<XNNWorkspace> workspace = slot->lock();
+  if (workspace == nullptr) {
+    auto created = XNNWorkspace::create();
+    if (!created.ok()) {
+      return created.error();
+    }
+    workspace = std::move(created.get());
+    *slot = workspace;
+  }
+  return workspace;
+}
+
+} // namespace delegate
+} // namespace xnnpack
+} // namespace backends
+} // namespace executorch
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/backends/xnnpack/runtime/XNNPACKBackend.h>
+#include <executorch/backends/xnnpack/runtime/XNNWorkspace.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace executorch {
+namespace backends {
+namespace xnnpack {
+namespace delegate {
+
+/**
+ * Hands out XNNPACK workspaces to delegate instances according to the current
+ * WorkspaceSharingMode. Workspaces are reference counted by the delegates
+ * that use them, and are released once the last of those delegates is
+ * destroyed.
+ *
+ * This class is thread safe.
+ */
+class XNNWorkspaceManager {
+ public:
+  explicit XNNWorkspaceManager(WorkspaceSharingMode sharing_mode);
+
+  /**
+   * Sets the sharing mode used for workspaces handed out from now on.
+   * Delegates that already have a workspace keep it.
+   */
+  runtime::Error set_sharing_mode(WorkspaceSharingMode sharing_mode);
+
+  WorkspaceSharingMode get_sharing_mode() const {
+    return sharing_mode_.load();
+  }
+
+  /**
+   * Returns the workspace to use for a new delegate instance.
+   *
+   * @param[in] model_id Identifies the loaded Method the delegate belongs
+   *     to. Only used in WorkspaceSharingMode::PerModel, where delegates with
+   *     the same id share a workspace.
+   */
+  runtime::Result<std::shared_ptr<XNNWorkspace>> get_or_create_workspace(
+      uintptr_t model_id);
+
+ private:
+  std::atomic<WorkspaceSharingMode> sharing_mode_;
+
+  // Guards the members below.
+  std::mutex mutex_;
+  std::weak_ptr<XNNWorkspace> global_workspace_;
+  std::unordered_map<uintptr_t, std::weak_ptr<XNNWorkspace>> model_workspaces_;
+};
+
+} // namespace delegate
+} // namespace xnnpack
+} // namespace backends
+} // namespace executorch
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/xnnpack/runtime/XNNWorkspaceManager.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <gtest/gtest.h>
+#include <xnnpack.h>
+
+using executorch::backends::xnnpack::WorkspaceSharingMode;
+using executorch::backends::xnnpack::delegate::XNNWorkspace;
+using executorch::backends::xnnpack::delegate::XNNWorkspaceManager;
+using executorch::runtime::Error;
+
+class XNNWorkspaceManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+    ASSERT_EQ(xnn_initialize(nullptr), xnn_status_success);
+  }
+};
+
+TEST_F(XNNWorkspaceManagerTest, DisabledModeCreatesDistinctWorkspaces) {
+  XNNWorkspaceManager manager(WorkspaceSharingMode::Disabled);
+  auto a = manager.get_or_create_workspace(1);
+  auto b = manager.get_or_create_workspace(1);
+  ASSERT_TRUE(a.ok());
+  ASSERT_TRUE(b.ok());
+  EXPECT_NE(a.get(), b.get());
+  EXPECT_NE(a.get()->unsafe_get_workspace(), b.get()->unsafe_get_workspace());
+}
+
+TEST_F(XNNWorkspaceManagerTest, PerModelModeSharesWithinModel) {
+  XNNWorkspaceManager manager(WorkspaceSharingMode::PerModel);
+  auto a1 = manager.get_or_create_workspace(1);
+  auto a2 = manager.get_or_create_workspace(1);
+  auto b = manager.get_or_create_workspace(2);
+  ASSERT_TRUE(a1.ok());
+  ASSERT_TRUE(a2.ok());
+  ASSERT_TRUE(b.ok());
+  EXPECT_EQ(a1.get(), a2.get());
+  EXPECT_NE(a1.get(), b.get());
+}
+
+TEST_F(XNNWorkspaceManagerTest, GlobalModeSharesAcrossModels) {
+  XNNWorkspaceManager manager(WorkspaceSharingMode::Global);
+  auto a = manager.get_or_create_workspace(1);
+  auto b = manager.get_or_create_workspace(2);
+  ASSERT_TRUE(a.ok());
+  ASSERT_TRUE(b.ok());
+  EXPECT_EQ(a.get(), b.get());
+}
+
+TEST_F(XNNWorkspaceManagerTest, WorkspaceReleasedWithLastUser) {
+  XNNWorkspaceManager manager(WorkspaceSharingMode::PerModel);
+  std::weak_ptr<XNNWorkspace> released;
+  {
+    auto workspace = manager.get_or_create_workspace(1);
+    ASSERT_TRUE(workspace.ok());
+    released = workspace.get();
+  }
+  EXPECT_TRUE(released.expired());
+
+  // The id can be reused by a new model once the old workspace is gone.
+  auto workspace = manager.get_or_create_workspace(1);
+  ASSERT_TRUE(workspace.ok());
+  EXPECT_NE(workspace.get(), nullptr);
+}
+
+TEST_F(XNNWorkspaceManagerTest, SetSharingMode) {
+  XNNWorkspaceManager manager(WorkspaceSharingMode::Disabled);
+  EXPECT_EQ(manager.set_sharing_mode(WorkspaceSharingMode::Global), Error::Ok);
+  EXPECT_EQ(manager.get_sharing_mode(), WorkspaceSharingMode::Global);
+  EXPECT_EQ(
+      manager.set_sharing_mode(WorkspaceSharingMode::Count),
+      Error::InvalidArgument);
+  EXPECT_EQ(manager.get_sharing_mode(), WorkspaceSharingMode::Global);
+}
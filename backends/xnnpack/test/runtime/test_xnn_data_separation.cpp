@@ -8,6 +8,7 @@
 
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/extension/flat_tensor/flat_tensor_data_map.h>
+#include <executorch/extension/runner_util/inputs.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/executor/method.h>
@@ -19,6 +20,7 @@
 
 using namespace ::testing;
 using executorch::extension::FlatTensorDataMap;
+using executorch::extension::prepare_input_tensors;
 using executorch::runtime::DataLoader;
 using executorch::runtime::Error;
 using executorch::runtime::FreeableBuffer;
@@ -112,3 +114,33 @@ TEST_F(DataSeparationTest, TestE2E) {
   Error err = method->execute();
   ASSERT_EQ(err, Error::Ok);
 }
+
+TEST_F(DataSeparationTest, TestClone) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = linear_program_->load_method(
+      "forward", &mmm.get(), nullptr, linear_data_map_.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // With the weights cache, the clone's delegate compiles the graph that
+  // the method's delegate kept, and finds the weights already packed.
+  ManagedMemoryManager clone_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> clone =
+      method->clone(&clone_mmm.get(), nullptr, linear_data_map_.get());
+  ASSERT_EQ(clone.error(), Error::Ok);
+
+  auto inputs = prepare_input_tensors(*method);
+  ASSERT_EQ(inputs.error(), Error::Ok);
+  auto clone_inputs = prepare_input_tensors(*clone);
+  ASSERT_EQ(clone_inputs.error(), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  ASSERT_EQ(clone->execute(), Error::Ok);
+
+  const auto& expected = method->get_output(0).toTensor();
+  const auto& actual = clone->get_output(0).toTensor();
+  ASSERT_EQ(actual.numel(), expected.numel());
+  for (ssize_t i = 0; i < actual.numel(); ++i) {
+    EXPECT_FLOAT_EQ(
+        actual.const_data_ptr<float>()[i], expected.const_data_ptr<float>()[i]);
+  }
+}
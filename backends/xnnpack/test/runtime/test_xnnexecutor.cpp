@@ -11,9 +11,15 @@
 #include <gtest/gtest.h>
 #include <xnnpack.h>
 
+#include <atomic>
+#include <thread>
+
 using executorch::backends::xnnpack::delegate::XNNExecutor;
+using executorch::backends::xnnpack::delegate::XNNWorkspace;
+using executorch::runtime::BackendExecutionContext;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
+using executorch::runtime::TensorShapeDynamism;
 using executorch::runtime::testing::TensorFactory;
 
 TEST(XNNExecutorTest, ArgumentWithTooManyDimensions) {
@@ -93,3 +99,205 @@ TEST(XNNExecutorTest, ArgumentWithTooManyDimensions) {
   // Check for invalid number of dimensions should fail without stack overflow.
   EXPECT_EQ(executor.prepare_args(args.data()), Error::InvalidArgument);
 }
+
+TEST(XNNExecutorTest, ReshapesOnlyWhenInputShapeChanges) {
+  XNNExecutor executor;
+  xnn_subgraph_t subgraph = nullptr;
+  xnn_runtime_t rt = nullptr;
+  et_pal_init();
+  ASSERT_EQ(xnn_initialize(nullptr), xnn_status_success);
+  ASSERT_EQ(xnn_create_subgraph(2, 0, &subgraph), xnn_status_success);
+  std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)> auto_subgraph(
+      subgraph, xnn_delete_subgraph);
+
+  std::vector<size_t> dims = {
+      2,
+  };
+  auto input_id = XNN_INVALID_VALUE_ID;
+  ASSERT_EQ(
+      xnn_status_success,
+      xnn_define_tensor_value(
+          subgraph,
+          xnn_datatype_fp32,
+          dims.size(),
+          dims.data(),
+          nullptr,
+          /*external_id=*/0,
+          /*flags=*/XNN_VALUE_FLAG_EXTERNAL_INPUT,
+          &input_id));
+  ASSERT_NE(input_id, XNN_INVALID_VALUE_ID);
+
+  auto output_id = XNN_INVALID_VALUE_ID;
+  ASSERT_EQ(
+      xnn_status_success,
+      xnn_define_tensor_value(
+          subgraph,
+          xnn_datatype_fp32,
+          dims.size(),
+          dims.data(),
+          nullptr,
+          /*external_id=*/1,
+          /*flags=*/XNN_VALUE_FLAG_EXTERNAL_OUTPUT,
+          &output_id));
+  ASSERT_NE(output_id, XNN_INVALID_VALUE_ID);
+
+  ASSERT_EQ(
+      xnn_status_success,
+      xnn_define_clamp(subgraph, 0.0f, 1.0f, input_id, output_id, 0));
+
+  ASSERT_EQ(xnn_create_runtime(subgraph, &rt), xnn_status_success);
+  EXPECT_EQ(
+      executor.initialize(
+          rt,
+          {
+              0,
+          },
+          {
+              1,
+          },
+          {}),
+      Error::Ok);
+
+  TensorFactory<executorch::aten::ScalarType::Float> tf;
+  auto output_tensor = tf.zeros({4}, TensorShapeDynamism::DYNAMIC_BOUND);
+  EValue output_ev(output_tensor);
+  BackendExecutionContext context;
+
+  // Run twice with the same input shape; the second call reuses the shapes
+  // propagated by the first one.
+  auto small_input = tf.make({2}, {-1.0f, 0.5f});
+  EValue small_input_ev(small_input);
+  std::array<EValue*, 2> small_args = {&small_input_ev, &output_ev};
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_EQ(executor.prepare_args(small_args.data()), Error::Ok);
+    EXPECT_EQ(executor.get_num_runtime_reshapes(), 1);
+    ASSERT_EQ(executor.forward(context), Error::Ok);
+    ASSERT_EQ(executor.resize_outputs(small_args.data()), Error::Ok);
+    EXPECT_EQ(output_ev.toTensor().size(0), 2);
+    EXPECT_EQ(output_ev.toTensor().const_data_ptr<float>()[0], 0.0f);
+    EXPECT_EQ(output_ev.toTensor().const_data_ptr<float>()[1], 0.5f);
+  }
+
+  // A new input shape must be propagated to the outputs.
+  auto large_input = tf.make({4}, {2.0f, 0.25f, -3.0f, 0.75f});
+  EValue large_input_ev(large_input);
+  std::array<EValue*, 2> large_args = {&large_input_ev, &output_ev};
+  ASSERT_EQ(executor.prepare_args(large_args.data()), Error::Ok);
+  EXPECT_EQ(executor.get_num_runtime_reshapes(), 2);
+  ASSERT_EQ(executor.forward(context), Error::Ok);
+  ASSERT_EQ(executor.resize_outputs(large_args.data()), Error::Ok);
+  EXPECT_EQ(output_ev.toTensor().size(0), 4);
+  EXPECT_EQ(output_ev.toTensor().const_data_ptr<float>()[0], 1.0f);
+  EXPECT_EQ(output_ev.toTensor().const_data_ptr<float>()[3], 0.75f);
+
+  // A different input with the same shape as the last one doesn't reshape.
+  auto other_large_input = tf.make({4}, {0.5f, 0.5f, 0.5f, 0.5f});
+  EValue other_large_input_ev(other_large_input);
+  std::array<EValue*, 2> other_large_args = {
+      &other_large_input_ev, &output_ev};
+  ASSERT_EQ(executor.prepare_args(other_large_args.data()), Error::Ok);
+  EXPECT_EQ(executor.get_num_runtime_reshapes(), 2);
+}
+
+namespace {
+
+// Creates a runtime on `workspace` that clamps a 2-element fp32 input to
+// [0, 1].
+xnn_runtime_t create_clamp_runtime(xnn_workspace_t workspace) {
+  xnn_subgraph_t subgraph = nullptr;
+  if (xnn_create_subgraph(2, 0, &subgraph) != xnn_status_success) {
+    return nullptr;
+  }
+  std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)> auto_subgraph(
+      subgraph, xnn_delete_subgraph);
+
+  const size_t dims[] = {2};
+  uint32_t input_id = XNN_INVALID_VALUE_ID;
+  uint32_t output_id = XNN_INVALID_VALUE_ID;
+  xnn_runtime_t rt = nullptr;
+  if (xnn_define_tensor_value(
+          subgraph,
+          xnn_datatype_fp32,
+          1,
+          dims,
+          nullptr,
+          /*external_id=*/0,
+          /*flags=*/XNN_VALUE_FLAG_EXTERNAL_INPUT,
+          &input_id) != xnn_status_success ||
+      xnn_define_tensor_value(
+          subgraph,
+          xnn_datatype_fp32,
+          1,
+          dims,
+          nullptr,
+          /*external_id=*/1,
+          /*flags=*/XNN_VALUE_FLAG_EXTERNAL_OUTPUT,
+          &output_id) != xnn_status_success ||
+      xnn_define_clamp(subgraph, 0.0f, 1.0f, input_id, output_id, 0) !=
+          xnn_status_success ||
+      xnn_create_runtime_v4(subgraph, nullptr, workspace, nullptr, 0, &rt) !=
+          xnn_status_success) {
+    return nullptr;
+  }
+  return rt;
+}
+
+} // namespace
+
+TEST(XNNExecutorTest, ExecutesConcurrently) {
+  et_pal_init();
+  ASSERT_EQ(xnn_initialize(nullptr), xnn_status_success);
+  constexpr size_t kNumExecutors = 4;
+  constexpr int kNumIterations = 200;
+
+  // The first two executors share a workspace, like delegates of one Method in
+  // WorkspaceSharingMode::PerModel, and the others have one each.
+  auto shared_workspace = XNNWorkspace::create();
+  ASSERT_TRUE(shared_workspace.ok());
+  std::vector<std::unique_ptr<XNNExecutor>> executors;
+  for (size_t i = 0; i < kNumExecutors; ++i) {
+    std::shared_ptr<XNNWorkspace> workspace = shared_workspace.get();
+    if (i >= 2) {
+      auto created = XNNWorkspace::create();
+      ASSERT_TRUE(created.ok());
+      workspace = created.get();
+    }
+    xnn_runtime_t rt = create_clamp_runtime(workspace->unsafe_get_workspace());
+    ASSERT_NE(rt, nullptr);
+    executors.push_back(std::make_unique<XNNExecutor>(workspace));
+    ASSERT_EQ(executors.back()->initialize(rt, {0}, {1}, {}), Error::Ok);
+  }
+
+  // Each thread runs one executor the way XnnpackBackend::execute() does, and
+  // checks every result.
+  std::atomic<int> num_failures{0};
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kNumExecutors; ++i) {
+    threads.emplace_back([&, i] {
+      XNNExecutor& executor = *executors[i];
+      TensorFactory<executorch::aten::ScalarType::Float> tf;
+      auto output = tf.zeros({2});
+      EValue output_ev(output);
+      BackendExecutionContext context;
+      for (int iteration = 0; iteration < kNumIterations; ++iteration) {
+        const float value = ((i * kNumIterations + iteration) % 97) / 100.0f;
+        auto input = tf.make({2}, {-1.0f, value});
+        EValue input_ev(input);
+        std::array<EValue*, 2> args = {&input_ev, &output_ev};
+
+        auto lock = executor.get_workspace()->acquire();
+        if (executor.prepare_args(args.data()) != Error::Ok ||
+            executor.forward(context) != Error::Ok ||
+            executor.resize_outputs(args.data()) != Error::Ok ||
+            output.const_data_ptr<float>()[0] != 0.0f ||
+            output.const_data_ptr<float>()[1] != value) {
+          num_failures++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_failures.load(), 0);
+}
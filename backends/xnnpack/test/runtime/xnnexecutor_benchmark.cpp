@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * Measures the per-call overhead of XNNExecutor on a chain of cheap ops, once
+ * with the same input shape on every call, where prepare_args() skips the
+ * runtime reshape, and once with the shape changing on every call, where it
+ * can't.
+ *
+ * Then measures the throughput of executors that run on several threads at
+ * once, the way XnnpackBackend::execute() runs them: once with all executors
+ * on one workspace, as in WorkspaceSharingMode::Global, and once with a
+ * workspace each, as in WorkspaceSharingMode::Disabled.
+ *
+ * Not a test: run it by hand and compare the times before and after changes
+ * to the executor.
+ */
+
+#include <executorch/backends/xnnpack/runtime/XNNExecutor.h>
+#include <executorch/backends/xnnpack/runtime/XNNWorkspace.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/platform/platform.h>
+
+#include <xnnpack.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using executorch::backends::xnnpack::delegate::XNNExecutor;
+using executorch::backends::xnnpack::delegate::XNNWorkspace;
+using executorch::runtime::BackendExecutionContext;
+using executorch::runtime::Error;
+using executorch::runtime::EValue;
+using executorch::runtime::TensorShapeDynamism;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+constexpr size_t kNumOps = 32;
+constexpr size_t kMaxSize = 64;
+constexpr int kCallsPerRun = 1000;
+constexpr int kTimedRuns = 10;
+constexpr size_t kNumThreads = 4;
+
+/**
+ * Returns an executor for a chain of kNumOps clamps of a 1-D fp32 tensor, on
+ * `workspace`, or nullptr on failure.
+ */
+std::unique_ptr<XNNExecutor> make_clamp_chain(
+    std::shared_ptr<XNNWorkspace> workspace) {
+  xnn_subgraph_t subgraph = nullptr;
+  if (xnn_create_subgraph(2, 0, &subgraph) != xnn_status_success) {
+    return nullptr;
+  }
+  std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)> auto_subgraph(
+      subgraph, xnn_delete_subgraph);
+
+  const size_t dims[] = {kMaxSize};
+  uint32_t input_id = XNN_INVALID_VALUE_ID;
+  if (xnn_define_tensor_value(
+          subgraph,
+          xnn_datatype_fp32,
+          1,
+          dims,
+          nullptr,
+          /*external_id=*/0,
+          /*flags=*/XNN_VALUE_FLAG_EXTERNAL_INPUT,
+          &input_id) != xnn_status_success) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < kNumOps; ++i) {
+    const bool is_last = i == kNumOps - 1;
+    uint32_t output_id = XNN_INVALID_VALUE_ID;
+    if (xnn_define_tensor_value(
+            subgraph,
+            xnn_datatype_fp32,
+            1,
+            dims,
+            nullptr,
+            /*external_id=*/is_last ? 1 : XNN_INVALID_VALUE_ID,
+            /*flags=*/is_last ? XNN_VALUE_FLAG_EXTERNAL_OUTPUT : 0,
+            &output_id) != xnn_status_success ||
+        xnn_define_clamp(subgraph, -1.0f, 1.0f, input_id, output_id, 0) !=
+            xnn_status_success) {
+      return nullptr;
+    }
+    input_id = output_id;
+  }
+
+  xnn_runtime_t runtime = nullptr;
+  if (xnn_create_runtime_v4(
+          subgraph,
+          nullptr,
+          workspace->unsafe_get_workspace(),
+          nullptr,
+          0,
+          &runtime) != xnn_status_success) {
+    return nullptr;
+  }
+  auto executor = std::make_unique<XNNExecutor>(std::move(workspace));
+  if (executor->initialize(runtime, {0}, {1}, {}) != Error::Ok) {
+    return nullptr;
+  }
+  return executor;
+}
+
+/**
+ * Returns the fastest of kTimedRuns runs of kCallsPerRun executions, in
+ * nanoseconds per execution. Execution `i` uses `inputs[i % inputs.size()]`.
+ */
+double time_executions(XNNExecutor& executor, std::vector<EValue>& inputs) {
+  TensorFactory<executorch::aten::ScalarType::Float> tf;
+  auto output = tf.zeros({kMaxSize}, TensorShapeDynamism::DYNAMIC_BOUND);
+  EValue output_ev(output);
+  BackendExecutionContext context;
+
+  auto best = std::chrono::steady_clock::duration::max();
+  for (int run = 0; run < kTimedRuns; ++run) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kCallsPerRun; ++i) {
+      std::array<EValue*, 2> args = {&inputs[i % inputs.size()], &output_ev};
+      auto lock = executor.get_workspace()->acquire();
+      if (executor.prepare_args(args.data()) != Error::Ok ||
+          executor.forward(context) != Error::Ok ||
+          executor.resize_outputs(args.data()) != Error::Ok) {
+        std::fprintf(stderr, "Execution failed\n");
+        std::exit(1);
+      }
+    }
+    best = std::min(best, std::chrono::steady_clock::now() - start);
+  }
+  return std::chrono::duration<double, std::nano>(best).count() /
+      kCallsPerRun;
+}
+
+/**
+ * Returns the number of executions per second when each of kNumThreads
+ * threads runs time_executions() on an executor of its own, with all
+ * executors on one workspace if `share_workspace` is true.
+ */
+double concurrent_throughput(bool share_workspace) {
+  std::vector<std::unique_ptr<XNNExecutor>> executors;
+  std::shared_ptr<XNNWorkspace> workspace;
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    if (workspace == nullptr || !share_workspace) {
+      auto created = XNNWorkspace::create();
+      if (!created.ok()) {
+        std::fprintf(stderr, "Failed to create a workspace\n");
+        std::exit(1);
+      }
+      workspace = created.get();
+    }
+    executors.push_back(make_clamp_chain(workspace));
+    if (executors.back() == nullptr) {
+      std::fprintf(stderr, "Failed to create the XNNPACK runtime\n");
+      std::exit(1);
+    }
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&executors, i] {
+      TensorFactory<executorch::aten::ScalarType::Float> tf;
+      std::vector<EValue> inputs = {EValue(tf.ones({kMaxSize}))};
+      time_executions(*executors[i], inputs);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  return kNumThreads * kTimedRuns * kCallsPerRun / seconds;
+}
+
+} // namespace
+
+int main() {
+  et_pal_init();
+  if (xnn_initialize(nullptr) != xnn_status_success) {
+    std::fprintf(stderr, "xnn_initialize() failed\n");
+    return 1;
+  }
+  auto workspace = XNNWorkspace::create();
+  if (!workspace.ok()) {
+    std::fprintf(stderr, "Failed to create a workspace\n");
+    return 1;
+  }
+  auto executor = make_clamp_chain(workspace.get());
+  if (executor == nullptr) {
+    std::fprintf(stderr, "Failed to create the XNNPACK runtime\n");
+    return 1;
+  }
+
+  TensorFactory<executorch::aten::ScalarType::Float> tf;
+  auto large = tf.ones({kMaxSize});
+  auto small = tf.ones({kMaxSize / 2});
+  std::vector<EValue> same_shape = {EValue(large)};
+  std::vector<EValue> changing_shape = {EValue(large), EValue(small)};
+
+  const double same_shape_ns = time_executions(*executor, same_shape);
+  const size_t reshapes_before = executor->get_num_runtime_reshapes();
+  const double changing_shape_ns = time_executions(*executor, changing_shape);
+  const size_t num_changing_reshapes =
+      executor->get_num_runtime_reshapes() - reshapes_before;
+
+  std::printf(
+      "%zu clamps, best of %d runs of %d executions:\n"
+      "  same input shape:     %.1f ns per execution\n"
+      "  changing input shape: %.1f ns per execution (%zu reshapes)\n",
+      kNumOps,
+      kTimedRuns,
+      kCallsPerRun,
+      same_shape_ns,
+      changing_shape_ns,
+      num_changing_reshapes);
+
+  const double shared_throughput = concurrent_throughput(true);
+  const double separate_throughput = concurrent_throughput(false);
+  std::printf(
+      "%zu threads:\n"
+      "  one shared workspace:     %.0f executions per second\n"
+      "  one workspace per thread: %.0f executions per second\n",
+      kNumThreads,
+      shared_throughput,
+      separate_throughput);
+  return 0;
+}
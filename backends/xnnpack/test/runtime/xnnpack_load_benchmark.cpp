@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * Measures how long it takes to load a method with several XNNPACK delegates,
+ * once initializing the delegates one after the other and once initializing
+ * them in parallel with MethodLoadOptions::delegate_init_runner. Both are
+ * timed with WorkspaceSharingMode::Disabled, where every delegate compiles
+ * independently, and with WorkspaceSharingMode::PerModel, where the delegates
+ * of the method create their XNNPACK runtimes one at a time.
+ *
+ * Takes the path to a program whose "forward" method has several XNNPACK
+ * partitions, e.g. one exported with
+ *
+ *   python -m executorch.test.models.export_delegated_program \
+ *       --modules ModuleLinearPartitioned --backend_id XnnpackBackend \
+ *       --outdir /tmp
+ *
+ * Not a test: run it by hand and compare the times before and after changes
+ * to delegate init.
+ */
+
+#include <executorch/backends/xnnpack/runtime/XNNPACKBackend.h>
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/extension/threadpool/threadpool.h>
+#include <executorch/extension/threadpool/threadpool_task_runner.h>
+#include <executorch/runtime/backend/interface.h>
+#include <executorch/runtime/backend/options.h>
+#include <executorch/runtime/executor/method_load_options.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using executorch::backends::xnnpack::workspace_sharing_mode_option_key;
+using executorch::backends::xnnpack::WorkspaceSharingMode;
+using executorch::extension::FileDataLoader;
+using executorch::extension::threadpool::ThreadPool;
+using executorch::extension::threadpool::ThreadPoolTaskRunner;
+using executorch::runtime::BackendOptions;
+using executorch::runtime::Error;
+using executorch::runtime::HierarchicalAllocator;
+using executorch::runtime::MemoryAllocator;
+using executorch::runtime::MemoryManager;
+using executorch::runtime::Method;
+using executorch::runtime::MethodLoadOptions;
+using executorch::runtime::MethodMeta;
+using executorch::runtime::Program;
+using executorch::runtime::Result;
+using executorch::runtime::Span;
+
+namespace {
+
+constexpr int kTimedRuns = 10;
+constexpr size_t kNumThreads = 4;
+constexpr size_t kMethodAllocatorBytes = 4 * 1024 * 1024;
+
+void set_sharing_mode(WorkspaceSharingMode mode) {
+  BackendOptions<1> options;
+  if (options.set_option(
+          workspace_sharing_mode_option_key, static_cast<int>(mode)) !=
+          Error::Ok ||
+      executorch::runtime::set_option("XnnpackBackend", options.view()) !=
+          Error::Ok) {
+    std::fprintf(stderr, "Failed to set the workspace sharing mode\n");
+    std::exit(1);
+  }
+}
+
+/**
+ * Returns the fastest of kTimedRuns loads of the "forward" method of
+ * `program` with `options`, in milliseconds. Each load gets fresh memory, and
+ * the time to destroy the method is not counted.
+ */
+double time_loads(const Program& program, const MethodLoadOptions& options) {
+  Result<MethodMeta> method_meta = program.method_meta("forward");
+  if (!method_meta.ok()) {
+    std::fprintf(stderr, "The program has no forward method\n");
+    std::exit(1);
+  }
+
+  auto best = std::chrono::steady_clock::duration::max();
+  for (int run = 0; run < kTimedRuns; ++run) {
+    auto method_allocator_pool =
+        std::make_unique<uint8_t[]>(kMethodAllocatorBytes);
+    MemoryAllocator method_allocator(
+        kMethodAllocatorBytes, method_allocator_pool.get());
+    std::vector<std::unique_ptr<uint8_t[]>> planned_buffers;
+    std::vector<Span<uint8_t>> planned_spans;
+    for (size_t id = 0; id < method_meta->num_memory_planned_buffers(); ++id) {
+      // .get() always succeeds since id < num_memory_planned_buffers().
+      const size_t size = static_cast<size_t>(
+          method_meta->memory_planned_buffer_size(id).get());
+      planned_buffers.push_back(std::make_unique<uint8_t[]>(size));
+      planned_spans.push_back({planned_buffers.back().get(), size});
+    }
+    HierarchicalAllocator planned_memory(
+        {planned_spans.data(), planned_spans.size()});
+    MemoryManager memory_manager(&method_allocator, &planned_memory);
+
+    const auto start = std::chrono::steady_clock::now();
+    Result<Method> method = program.load_method(
+        "forward", &memory_manager, nullptr, nullptr, options);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    if (!method.ok()) {
+      std::fprintf(
+          stderr,
+          "Loading forward failed with 0x%" PRIx32 "\n",
+          static_cast<uint32_t>(method.error()));
+      std::exit(1);
+    }
+    best = std::min(best, elapsed);
+  }
+  return std::chrono::duration<double, std::milli>(best).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::fprintf(stderr, "Usage: %s <program.pte>\n", argv[0]);
+    return 1;
+  }
+  executorch::runtime::runtime_init();
+
+  Result<FileDataLoader> loader = FileDataLoader::from(argv[1]);
+  if (!loader.ok()) {
+    std::fprintf(stderr, "Failed to open %s\n", argv[1]);
+    return 1;
+  }
+  Result<Program> program = Program::load(&loader.get());
+  if (!program.ok()) {
+    std::fprintf(stderr, "Failed to load %s\n", argv[1]);
+    return 1;
+  }
+
+  ThreadPool init_threadpool(kNumThreads);
+  ThreadPoolTaskRunner runner(&init_threadpool);
+  MethodLoadOptions sequential;
+  MethodLoadOptions parallel;
+  parallel.delegate_init_runner = &runner;
+
+  std::printf(
+      "Loading forward, best of %d runs, %zu init threads:\n",
+      kTimedRuns,
+      kNumThreads);
+  const WorkspaceSharingMode modes[] = {
+      WorkspaceSharingMode::Disabled, WorkspaceSharingMode::PerModel};
+  const char* mode_names[] = {"Disabled", "PerModel"};
+  for (size_t i = 0; i < 2; ++i) {
+    set_sharing_mode(modes[i]);
+    const double sequential_ms = time_loads(program.get(), sequential);
+    const double parallel_ms = time_loads(program.get(), parallel);
+    std::printf(
+        "  workspace sharing %s:\n"
+        "    sequential init: %.2f ms\n"
+        "    parallel init:   %.2f ms (speedup %.2fx)\n",
+        mode_names[i],
+        sequential_ms,
+        parallel_ms,
+        sequential_ms / parallel_ms);
+  }
+  return 0;
+}
@@ -31,6 +31,40 @@ def define_common_targets():
         ],
     )
 
+    # Not a test: run it by hand to time XNNExecutor.
+    runtime.cxx_binary(
+        name = "xnnexecutor_benchmark",
+        srcs = ["runtime/xnnexecutor_benchmark.cpp"],
+        deps = [
+            third_party_dep("XNNPACK"),
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/backends/xnnpack:xnnpack_backend",
+        ],
+    )
+
+    # Not a test: run it by hand on a program with several XNNPACK partitions,
+    # e.g. exported_xnnp_delegated_programs[ModuleLinearPartitioned.pte].
+    runtime.cxx_binary(
+        name = "xnnpack_load_benchmark",
+        srcs = ["runtime/xnnpack_load_benchmark.cpp"],
+        deps = [
+            "//executorch/backends/xnnpack:xnnpack_backend",
+            "//executorch/extension/data_loader:file_data_loader",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable:generated_lib",
+            "//executorch/runtime/executor:program",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_workspace_manager",
+        srcs = ["runtime/test_workspace_manager.cpp"],
+        deps = [
+            third_party_dep("XNNPACK"),
+            "//executorch/backends/xnnpack:xnnpack_backend",
+        ],
+    )
+
     runtime.cxx_test(
         name = "test_xnn_weights_cache",
         srcs = ["runtime/test_xnn_weights_cache.cpp"],
@@ -53,6 +87,7 @@ def define_common_targets():
                 "//executorch/extension/data_loader:file_data_loader",
                 "//executorch/backends/xnnpack:xnnpack_backend",
                 "//executorch/extension/flat_tensor:flat_tensor_data_map",
+                "//executorch/extension/runner_util:inputs",
             ],
             env = {
                 # The tests use these vars to find the program files to load.
@@ -238,6 +238,18 @@ class ComputeCodegenUnboxedKernels:
             return_type_gen = et_cpp.returns_type
             arguments = sig.arguments(include_context=False)
             kernel_call = f"{kernel_meta.cpp_namespace}::{kernel_meta.kernel}"
+        # Record the unboxed kernel that the Kernel calls, so that the runtime
+        # can tell which implementation an operator resolved to. The
+        # declarations also have an overload without the context, so name the
+        # one that is called. ATen kernels are never fused, so they go without.
+        native_kernel_arg = ""
+        if not self.use_aten_lib:
+            arg_types = ", ".join(a.type for a in sig.arguments())
+            native_kernel_arg = (
+                ",\n    ::executorch::ET_RUNTIME_NAMESPACE::native_kernel_id("
+                f"static_cast<{sig.returns_type().cpp_type()} (*)({arg_types})>("
+                f"&{kernel_call}))"
+            )
         # parse arguments into C++ code
         binding_list, code_list = Unboxing(
             argument_type_gen=argument_type_gen
@@ -312,7 +324,7 @@ Kernel(
         {event_tracer_output_logging}
         {return_assignment}
 {exception_boundary_end}
-    }}
+    }}{native_kernel_arg}
 ),
 """
                 for k in used_kernel_keys
@@ -520,7 +520,8 @@ Kernel(
 
         *stack[0] = EValue(result_);
 
-    }
+    },
+    ::executorch::ET_RUNTIME_NAMESPACE::native_kernel_id(static_cast<bool (*)(torch::executor::KernelRuntimeContext &)>(&at::native::default_kernel))
 ),
 """
         )
@@ -619,7 +620,8 @@ Kernel(
 
         *stack[0] = EValue(result_);
 
-    }
+    },
+    ::executorch::ET_RUNTIME_NAMESPACE::native_kernel_id(static_cast<bool (*)(torch::executor::KernelRuntimeContext &)>(&at::native::default_kernel))
 ),
 """
         )
@@ -649,7 +651,8 @@ Kernel(
           ET_LOG(Error, "Kernel threw an exception: %s", ex.what());
           context.fail(torch::executor::Error::Internal);
         }
-    }
+    },
+    ::executorch::ET_RUNTIME_NAMESPACE::native_kernel_id(static_cast<bool (*)(torch::executor::KernelRuntimeContext &)>(&at::native::default_kernel))
 ),
 """
         )
@@ -690,7 +693,8 @@ Kernel(
 
         *stack[0] = EValue(result_);
 
-    }
+    },
+    ::executorch::ET_RUNTIME_NAMESPACE::native_kernel_id(static_cast<bool (*)(torch::executor::KernelRuntimeContext &)>(&at::native::default_kernel))
 ),
 """
         )
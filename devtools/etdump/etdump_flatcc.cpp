@@ -8,6 +8,8 @@
 
 #include <executorch/devtools/etdump/etdump_flatcc.h>
 
+#include <cinttypes>
+#include <cstdlib>
 #include <cstring>
 
 #include <executorch/devtools/etdump/data_sinks/buffer_data_sink.h>
@@ -143,6 +145,7 @@ ETDumpGen::ETDumpGen(Span<uint8_t> buffer) {
 }
 
 ETDumpGen::~ETDumpGen() {
+  clear_stream_ring();
   flatcc_builder_clear(builder_);
   if (!is_static_etdump()) {
     free(builder_);
@@ -153,6 +156,11 @@ void ETDumpGen::reset() {
   state_ = State::Init;
   num_blocks_ = 0;
   data_sink_ = nullptr;
+  start_etdump();
+}
+
+void ETDumpGen::start_etdump() {
+  blocks_in_builder_ = 0;
   flatcc_builder_reset(builder_);
   flatbuffers_buffer_start(builder_, etdump_ETDump_file_identifier);
   etdump_ETDump_start_as_root_with_size(builder_);
@@ -161,17 +169,37 @@ void ETDumpGen::reset() {
   etdump_ETDump_run_data_push_start(builder_);
 }
 
-void ETDumpGen::create_event_block(const char* name) {
+void ETDumpGen::end_block() {
   if (state_ == State::AddingEvents) {
     etdump_RunData_events_end(builder_);
-  } else if (state_ == State::Done) {
+  } else if (state_ == State::AddingAllocators) {
+    etdump_RunData_allocators_end(builder_);
+  }
+}
+
+void ETDumpGen::create_event_block(const char* name) {
+  if (state_ == State::Done) {
     reset();
+  } else if (stream_sink_ != nullptr && blocks_in_builder_ > 0) {
+    Error err = stream_current_block();
+    if (err != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Failed to stream ETDump block with error 0x%" PRIx32,
+          static_cast<uint32_t>(err));
+      if (stream_error_ == Error::Ok) {
+        stream_error_ = err;
+      }
+    }
+  } else {
+    end_block();
   }
-  if (num_blocks_ > 0) {
+  if (blocks_in_builder_ > 0) {
     etdump_ETDump_run_data_push_end(builder_);
     etdump_ETDump_run_data_push_start(builder_);
   }
   ++num_blocks_;
+  ++blocks_in_builder_;
   etdump_RunData_name_create_strn(builder_, name, strlen(name));
   if (bundled_input_index_ != -1) {
     etdump_RunData_bundled_input_index_add(builder_, bundled_input_index_);
@@ -512,36 +540,163 @@ void ETDumpGen::track_allocation(
   etdump_RunData_events_push_end(builder_);
 }
 
+ETDumpResult ETDumpGen::finish_etdump() {
+  etdump_ETDump_run_data_push_end(builder_);
+  etdump_ETDump_run_data_end(builder_);
+  etdump_ETDump_ref_t root = etdump_ETDump_end(builder_);
+  flatbuffers_buffer_end(builder_, root);
+  ETDumpResult result;
+  if (alloc_.data) {
+    result.buf = alloc_.front_cursor;
+    result.size = alloc_.out_size - alloc_.front_left;
+  } else {
+    result.buf = flatcc_builder_finalize_aligned_buffer(builder_, &result.size);
+  }
+  return result;
+}
+
 ETDumpResult ETDumpGen::get_etdump_data() {
   ETDumpResult result;
-  if (state_ == State::AddingEvents) {
-    etdump_RunData_events_end(builder_);
-  } else if (state_ == State::AddingAllocators) {
-    etdump_RunData_allocators_end(builder_);
-  } else if (state_ == State::Init) {
+  if (stream_sink_ != nullptr) {
+    if (state_ != State::Done) {
+      Result<bool> flushed = flush_stream();
+      if (!flushed.ok()) {
+        ET_LOG(
+            Error,
+            "Failed to flush ETDump stream with error 0x%" PRIx32,
+            static_cast<uint32_t>(flushed.error()));
+      }
+    }
     result.buf = nullptr;
     result.size = 0;
+    state_ = State::Done;
     return result;
   }
-  etdump_ETDump_run_data_push_end(builder_);
-  etdump_ETDump_run_data_end(builder_);
-  etdump_ETDump_ref_t root = etdump_ETDump_end(builder_);
-  flatbuffers_buffer_end(builder_, root);
+  if (state_ == State::Init) {
+    result.buf = nullptr;
+    result.size = 0;
+    return result;
+  }
+  end_block();
+  result = finish_etdump();
   if (num_blocks_ == 0) {
     result = {nullptr, 0};
-  } else {
-    if (alloc_.data) {
-      result.buf = alloc_.front_cursor;
-      result.size = alloc_.out_size - alloc_.front_left;
-    } else {
-      result.buf =
-          flatcc_builder_finalize_aligned_buffer(builder_, &result.size);
-    }
   }
   state_ = State::Done;
   return result;
 }
 
+Error ETDumpGen::stream_current_block() {
+  end_block();
+  ETDumpResult block = finish_etdump();
+  Error err = Error::Ok;
+  if (block.buf == nullptr) {
+    err = Error::MemoryAllocationFailed;
+  } else if (stream_ring_capacity_ == 0) {
+    Result<size_t> ret = stream_sink_->write(block.buf, block.size);
+    if (!ret.ok()) {
+      err = ret.error();
+    }
+    if (!is_static_etdump()) {
+      free(block.buf);
+    }
+  } else {
+    void* buf = block.buf;
+    if (is_static_etdump()) {
+      // The static build buffer is reused for the next block, so the ring
+      // buffer needs its own copy.
+      buf = malloc(block.size);
+      if (buf != nullptr) {
+        memcpy(buf, block.buf, block.size);
+      } else {
+        err = Error::MemoryAllocationFailed;
+      }
+    }
+    if (buf != nullptr) {
+      if (stream_ring_size_ == stream_ring_capacity_) {
+        // Drop the oldest block to make room.
+        free(stream_ring_[stream_ring_begin_].buf);
+        stream_ring_[stream_ring_begin_] = {buf, block.size};
+        stream_ring_begin_ = (stream_ring_begin_ + 1) % stream_ring_capacity_;
+      } else {
+        stream_ring_
+            [(stream_ring_begin_ + stream_ring_size_) % stream_ring_capacity_] =
+                {buf, block.size};
+        ++stream_ring_size_;
+      }
+    }
+  }
+  if (is_static_etdump()) {
+    alloc_.reset_out_buffer();
+  }
+  start_etdump();
+  state_ = State::Init;
+  return err;
+}
+
+void ETDumpGen::clear_stream_ring() {
+  for (size_t i = 0; i < stream_ring_size_; ++i) {
+    free(stream_ring_[(stream_ring_begin_ + i) % stream_ring_capacity_].buf);
+  }
+  free(stream_ring_);
+  stream_ring_ = nullptr;
+  stream_ring_capacity_ = 0;
+  stream_ring_begin_ = 0;
+  stream_ring_size_ = 0;
+}
+
+Result<bool> ETDumpGen::set_stream_sink(
+    DataSinkBase* sink,
+    size_t ring_buffer_blocks) {
+  ET_CHECK_OR_RETURN_ERROR(
+      blocks_in_builder_ == 0 || state_ == State::Done,
+      InvalidState,
+      "The stream sink can only be set before the first block is created or after get_etdump_data()");
+  clear_stream_ring();
+  stream_error_ = Error::Ok;
+  stream_sink_ = nullptr;
+  if (sink != nullptr && ring_buffer_blocks > 0) {
+    stream_ring_ = static_cast<StreamedBlock*>(
+        malloc(ring_buffer_blocks * sizeof(StreamedBlock)));
+    ET_CHECK_OR_RETURN_ERROR(
+        stream_ring_ != nullptr,
+        MemoryAllocationFailed,
+        "Failed to allocate a ring buffer of %zu ETDump blocks",
+        ring_buffer_blocks);
+    stream_ring_capacity_ = ring_buffer_blocks;
+  }
+  stream_sink_ = sink;
+  return true;
+}
+
+Result<bool> ETDumpGen::flush_stream() {
+  ET_CHECK_OR_RETURN_ERROR(
+      stream_sink_ != nullptr, InvalidState, "No stream sink is set");
+  Error err = stream_error_;
+  stream_error_ = Error::Ok;
+  if (blocks_in_builder_ > 0 && state_ != State::Done) {
+    Error block_err = stream_current_block();
+    if (err == Error::Ok) {
+      err = block_err;
+    }
+  }
+  for (; stream_ring_size_ > 0; --stream_ring_size_) {
+    StreamedBlock& block = stream_ring_[stream_ring_begin_];
+    if (err == Error::Ok) {
+      Result<size_t> ret = stream_sink_->write(block.buf, block.size);
+      if (!ret.ok()) {
+        err = ret.error();
+      }
+    }
+    free(block.buf);
+    stream_ring_begin_ = (stream_ring_begin_ + 1) % stream_ring_capacity_;
+  }
+  if (err != Error::Ok) {
+    return err;
+  }
+  return true;
+}
+
 Result<bool> ETDumpGen::set_debug_buffer(Span<uint8_t> buffer) {
   Result<BufferDataSink> bds_ret = BufferDataSink::create(buffer);
   ET_CHECK_OR_RETURN_ERROR(
@@ -45,6 +45,12 @@ struct ETDumpStaticAllocator {
     front_left = out_size;
   }
 
+  // Discards everything emitted into the build buffer so it can be reused.
+  void reset_out_buffer() {
+    front_cursor = &data[data_size + out_size];
+    front_left = out_size;
+  }
+
   // Pointer to backing buffer to allocate from.
   uint8_t* data{nullptr};
 
@@ -156,6 +162,56 @@ class ETDumpGen : public ::executorch::runtime::EventTracer {
 
   Result<bool> set_debug_buffer(::executorch::runtime::Span<uint8_t> buffer);
   void set_data_sink(DataSinkBase* data_sink);
+
+  /**
+   * Streams the ETDump to `sink` instead of accumulating every block in the
+   * builder. A block is complete once the next one is created. At that point
+   * it is serialized on its own, as a size-prefixed ETDump flatbuffer that
+   * holds only that block, and the builder is reset. This keeps the memory
+   * used by ETDumpGen bounded by the size of one block instead of the whole
+   * run.
+   *
+   * The stream is a sequence of these flatbuffers. Data sinks that align
+   * their writes may put zero padding between them.
+   * executorch.devtools.etdump.serialize.deserialize_from_etdump_flatcc_stream
+   * merges them back into a single ETDump.
+   *
+   * The stream sink is kept until it is replaced, including across reset().
+   *
+   * @param[in] sink Receives the serialized blocks. Must outlive its use by
+   *     this ETDumpGen. Pass nullptr to turn streaming off.
+   * @param[in] ring_buffer_blocks If 0, each block is written to `sink` as soon
+   *     as it is complete. Otherwise only the last `ring_buffer_blocks`
+   *     complete blocks are kept, in heap memory, and older blocks are
+   *     dropped. The kept blocks are written to `sink` by flush_stream().
+   *
+   * @retval true Streaming was configured.
+   * @retval Error::InvalidState A block is under construction. Call this
+   *     before the first block is created or after get_etdump_data().
+   * @retval Error::MemoryAllocationFailed The ring buffer could not be
+   *     allocated.
+   */
+  Result<bool> set_stream_sink(
+      DataSinkBase* sink,
+      size_t ring_buffer_blocks = 0);
+
+  /**
+   * Completes the current block, if any, and writes it along with all blocks
+   * held in the ring buffer to the stream sink, oldest first. Blocks whose
+   * serialization or write failed since the last flush are reported here.
+   *
+   * @retval true All blocks were written.
+   * @retval Error::InvalidState No stream sink is set.
+   * @retval Other The first error returned by the sink, or
+   *     Error::MemoryAllocationFailed if a block could not be serialized. The
+   *     affected blocks are dropped.
+   */
+  Result<bool> flush_stream();
+
+  /**
+   * Finishes the ETDump and returns it. When streaming, this flushes the
+   * stream instead and returns an empty result.
+   */
   ETDumpResult get_etdump_data();
   size_t get_num_blocks();
   DataSinkBase* get_data_sink();
@@ -171,9 +227,28 @@ class ETDumpGen : public ::executorch::runtime::EventTracer {
     Done,
   };
 
+  // A complete block serialized by the streaming mode.
+  struct StreamedBlock {
+    void* buf;
+    size_t size;
+  };
+
   void check_ready_to_add_events();
   int64_t create_string_entry(const char* name);
 
+  // Starts a new ETDump in the builder, ready for the first block.
+  void start_etdump();
+  // Closes the allocators or events of the block under construction.
+  void end_block();
+  // Ends the ETDump in the builder and returns the serialized buffer. It is
+  // heap allocated unless the ETDump is static.
+  ETDumpResult finish_etdump();
+  // Serializes the block under construction for the stream sink and starts a
+  // new ETDump in the builder.
+  ::executorch::runtime::Error stream_current_block();
+  // Frees the blocks held in the ring buffer and the ring buffer itself.
+  void clear_stream_ring();
+
   /**
    * Templated helper function used to log various types of intermediate output.
    * Supported types include tensor, tensor array, int, bool and double.
@@ -188,6 +263,9 @@ class ETDumpGen : public ::executorch::runtime::EventTracer {
 
   struct flatcc_builder* builder_;
   size_t num_blocks_ = 0;
+  // Blocks in the ETDump under construction. Differs from num_blocks_ when
+  // streaming.
+  size_t blocks_in_builder_ = 0;
   DataSinkBase* data_sink_;
 
   // It is only for set_debug_buffer function.
@@ -198,6 +276,16 @@ class ETDumpGen : public ::executorch::runtime::EventTracer {
   struct internal::ETDumpStaticAllocator alloc_;
 
   EventTracerFilterBase* filter_ = nullptr;
+
+  DataSinkBase* stream_sink_ = nullptr;
+  // Ring buffer of the last complete blocks, used when streaming with
+  // ring_buffer_blocks > 0.
+  StreamedBlock* stream_ring_ = nullptr;
+  size_t stream_ring_capacity_ = 0;
+  size_t stream_ring_begin_ = 0;
+  size_t stream_ring_size_ = 0;
+  // First streaming error since the last flush_stream().
+  ::executorch::runtime::Error stream_error_ = ::executorch::runtime::Error::Ok;
 };
 
 } // namespace etdump
@@ -0,0 +1,471 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/devtools/etdump/sampling_event_tracer.h>
+
+#include <cstring>
+
+#include <executorch/runtime/platform/assert.h>
+
+using ::executorch::aten::Tensor;
+using ::executorch::runtime::AllocatorID;
+using ::executorch::runtime::ArrayRef;
+using ::executorch::runtime::ChainID;
+using ::executorch::runtime::DebugHandle;
+using ::executorch::runtime::DelegateDebugIdType;
+using ::executorch::runtime::DelegateDebugIntId;
+using ::executorch::runtime::EValue;
+using ::executorch::runtime::EventTracerEntry;
+using ::executorch::runtime::EventTracerFilterBase;
+using ::executorch::runtime::kUnsetDelegateDebugIntId;
+using ::executorch::runtime::LoggedEValueType;
+using ::executorch::runtime::Result;
+using ::executorch::runtime::Span;
+
+namespace executorch {
+namespace etdump {
+
+namespace {
+
+// Entries of events that are not sampled carry this event id.
+constexpr int64_t kNotSampled = -1;
+
+// The histogram has kSubBuckets linear buckets per power of two of the
+// duration, which bounds the relative error of a bucket to 1 / kSubBuckets / 2
+// around its midpoint.
+constexpr uint64_t kSubBucketBits = 2;
+constexpr uint64_t kSubBuckets = 1 << kSubBucketBits;
+
+int highest_bit(uint64_t value) {
+  int bit = 0;
+  while (value >>= 1) {
+    ++bit;
+  }
+  return bit;
+}
+
+size_t bucket_index(uint64_t ticks, size_t num_buckets) {
+  if (ticks < kSubBuckets) {
+    return ticks;
+  }
+  const int octave = highest_bit(ticks);
+  const uint64_t sub_bucket =
+      (ticks >> (octave - kSubBucketBits)) & (kSubBuckets - 1);
+  const size_t index = (octave - kSubBucketBits + 1) * kSubBuckets + sub_bucket;
+  return index < num_buckets ? index : num_buckets - 1;
+}
+
+// Returns the midpoint of the durations that fall in the given bucket.
+uint64_t bucket_value(size_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  const uint64_t shift = index / kSubBuckets - 1;
+  const uint64_t lower = (kSubBuckets + index % kSubBuckets) << shift;
+  return lower + ((uint64_t(1) << shift) >> 1);
+}
+
+uint64_t hash_event(
+    const char* name,
+    ChainID chain_id,
+    DebugHandle debug_handle,
+    DelegateDebugIntId delegate_debug_index) {
+  // FNV-1a over the stored part of the name and the ids.
+  uint64_t hash = 0xcbf29ce484222325ull;
+  auto mix = [&hash](uint64_t byte) {
+    hash ^= byte;
+    hash *= 0x100000001b3ull;
+  };
+  if (name != nullptr) {
+    for (size_t i = 0;
+         i < SamplingEventTracer::kMaxNameLength && name[i] != '\0';
+         ++i) {
+      mix(static_cast<uint8_t>(name[i]));
+    }
+  }
+  for (uint64_t id : {static_cast<uint64_t>(static_cast<uint32_t>(chain_id)),
+                      static_cast<uint64_t>(debug_handle),
+                      static_cast<uint64_t>(
+                          static_cast<uint32_t>(delegate_debug_index))}) {
+    for (int i = 0; i < 4; ++i) {
+      mix((id >> (8 * i)) & 0xff);
+    }
+  }
+  // Zero marks an empty slot.
+  return hash != 0 ? hash : 1;
+}
+
+} // namespace
+
+SamplingEventTracer::SamplingEventTracer(
+    uint32_t execution_sample_period,
+    uint32_t event_sample_period,
+    size_t max_events,
+    EventTracer* forward_to)
+    : execution_sample_period_(execution_sample_period),
+      event_sample_period_(event_sample_period),
+      num_slots_(max_events),
+      slots_(new Slot[max_events]),
+      forward_to_(forward_to),
+      rng_state_(0x9e3779b97f4a7c15ull) {
+  ET_CHECK_MSG(
+      execution_sample_period_ > 0 && event_sample_period_ > 0,
+      "Sample periods must be at least 1");
+}
+
+SamplingEventTracer::~SamplingEventTracer() = default;
+
+bool SamplingEventTracer::sample_event() {
+  if (!sampling_block_) {
+    return false;
+  }
+  if (event_sample_period_ == 1) {
+    return true;
+  }
+  // xorshift64
+  rng_state_ ^= rng_state_ << 13;
+  rng_state_ ^= rng_state_ >> 7;
+  rng_state_ ^= rng_state_ << 17;
+  return rng_state_ % event_sample_period_ == 0;
+}
+
+int64_t SamplingEventTracer::find_slot(
+    const char* name,
+    ChainID chain_id,
+    DebugHandle debug_handle,
+    DelegateDebugIntId delegate_debug_index) {
+  const uint64_t key =
+      hash_event(name, chain_id, debug_handle, delegate_debug_index);
+  for (size_t probe = 0; probe < num_slots_; ++probe) {
+    const size_t index = (key + probe) % num_slots_;
+    Slot& slot = slots_[index];
+    uint64_t slot_key = slot.key.load(std::memory_order_acquire);
+    if (slot_key == 0) {
+      if (slot.key.compare_exchange_strong(
+              slot_key, key, std::memory_order_acq_rel)) {
+        size_t length = 0;
+        if (name != nullptr) {
+          while (length < kMaxNameLength && name[length] != '\0') {
+            ++length;
+          }
+          memcpy(slot.name, name, length);
+        }
+        slot.name[length] = '\0';
+        slot.chain_id = chain_id;
+        slot.debug_handle = debug_handle;
+        slot.delegate_debug_index = delegate_debug_index;
+        slot.ready.store(true, std::memory_order_release);
+        return index;
+      }
+      // Another thread claimed the slot first, slot_key now holds its key.
+    }
+    if (slot_key == key) {
+      return index;
+    }
+  }
+  num_dropped_events_.fetch_add(1, std::memory_order_relaxed);
+  return kNotSampled;
+}
+
+void SamplingEventTracer::add_sample(
+    int64_t slot_index,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time) {
+  Slot& slot = slots_[slot_index];
+  const uint64_t ticks = end_time > start_time ? end_time - start_time : 0;
+  slot.count.fetch_add(1, std::memory_order_relaxed);
+  slot.total_ticks.fetch_add(ticks, std::memory_order_relaxed);
+  slot.histogram[bucket_index(ticks, kNumBuckets)].fetch_add(
+      1, std::memory_order_relaxed);
+}
+
+void SamplingEventTracer::sync_forward_to() {
+  forward_to_->set_chain_debug_handle(chain_id_, debug_handle_);
+  forward_to_->set_bundled_input_index(bundled_input_index_);
+}
+
+void SamplingEventTracer::create_event_block(const char* name) {
+  sampling_block_ = num_blocks_ % execution_sample_period_ == 0;
+  ++num_blocks_;
+  forwarding_block_ = sampling_block_ && forward_to_ != nullptr;
+  if (forwarding_block_) {
+    sync_forward_to();
+    forward_to_->create_event_block(name);
+  }
+}
+
+EventTracerEntry SamplingEventTracer::start_profiling(
+    const char* name,
+    ChainID chain_id,
+    DebugHandle debug_handle) {
+  EventTracerEntry prof_entry;
+  prof_entry.delegate_event_id_type = DelegateDebugIdType::kNone;
+  if (chain_id == -1) {
+    prof_entry.chain_id = chain_id_;
+    prof_entry.debug_handle = debug_handle_;
+  } else {
+    prof_entry.chain_id = chain_id;
+    prof_entry.debug_handle = debug_handle;
+  }
+  if (!sample_event()) {
+    prof_entry.event_id = kNotSampled;
+    prof_entry.start_time = 0;
+    return prof_entry;
+  }
+  prof_entry.event_id = find_slot(
+      name,
+      prof_entry.chain_id,
+      prof_entry.debug_handle,
+      kUnsetDelegateDebugIntId);
+  prof_entry.start_time = runtime::pal_current_ticks();
+  return prof_entry;
+}
+
+void SamplingEventTracer::end_profiling(EventTracerEntry prof_entry) {
+  if (prof_entry.event_id == kNotSampled) {
+    return;
+  }
+  const et_timestamp_t end_time = runtime::pal_current_ticks();
+  add_sample(prof_entry.event_id, prof_entry.start_time, end_time);
+  if (forwarding_block_) {
+    const Slot& slot = slots_[prof_entry.event_id];
+    sync_forward_to();
+    EventTracerEntry forwarded_entry = forward_to_->start_profiling(
+        slot.name, prof_entry.chain_id, prof_entry.debug_handle);
+    forwarded_entry.start_time = prof_entry.start_time;
+    forward_to_->end_profiling(forwarded_entry);
+  }
+}
+
+EventTracerEntry SamplingEventTracer::start_profiling_delegate(
+    const char* name,
+    DelegateDebugIntId delegate_debug_index) {
+  EventTracerEntry prof_entry;
+  prof_entry.delegate_event_id_type =
+      name == nullptr ? DelegateDebugIdType::kInt : DelegateDebugIdType::kStr;
+  prof_entry.chain_id = chain_id_;
+  prof_entry.debug_handle = debug_handle_;
+  if (!sample_event()) {
+    prof_entry.event_id = kNotSampled;
+    prof_entry.start_time = 0;
+    return prof_entry;
+  }
+  prof_entry.event_id =
+      find_slot(name, chain_id_, debug_handle_, delegate_debug_index);
+  prof_entry.start_time = runtime::pal_current_ticks();
+  return prof_entry;
+}
+
+void SamplingEventTracer::end_profiling_delegate(
+    EventTracerEntry prof_entry,
+    const void* metadata,
+    size_t metadata_len) {
+  if (prof_entry.event_id == kNotSampled) {
+    return;
+  }
+  const et_timestamp_t end_time = runtime::pal_current_ticks();
+  add_sample(prof_entry.event_id, prof_entry.start_time, end_time);
+  if (forwarding_block_) {
+    const Slot& slot = slots_[prof_entry.event_id];
+    sync_forward_to();
+    forward_to_->log_profiling_delegate(
+        slot.delegate_debug_index == kUnsetDelegateDebugIntId ? slot.name
+                                                              : nullptr,
+        slot.delegate_debug_index,
+        prof_entry.start_time,
+        end_time,
+        metadata,
+        metadata_len);
+  }
+}
+
+void SamplingEventTracer::log_profiling_delegate(
+    const char* name,
+    DelegateDebugIntId delegate_debug_index,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time,
+    const void* metadata,
+    size_t metadata_len) {
+  if (!sample_event()) {
+    return;
+  }
+  int64_t slot =
+      find_slot(name, chain_id_, debug_handle_, delegate_debug_index);
+  if (slot != kNotSampled) {
+    add_sample(slot, start_time, end_time);
+  }
+  if (forwarding_block_) {
+    sync_forward_to();
+    forward_to_->log_profiling_delegate(
+        name,
+        delegate_debug_index,
+        start_time,
+        end_time,
+        metadata,
+        metadata_len);
+  }
+}
+
+void SamplingEventTracer::track_allocation(AllocatorID id, size_t size) {
+  if (forwarding_block_) {
+    sync_forward_to();
+    forward_to_->track_allocation(id, size);
+  }
+}
+
+AllocatorID SamplingEventTracer::track_allocator(const char* name) {
+  if (forwarding_block_) {
+    return forward_to_->track_allocator(name);
+  }
+  return 0;
+}
+
+Result<bool> SamplingEventTracer::log_evalue(
+    const EValue& evalue,
+    LoggedEValueType evalue_type) {
+  if (forwarding_block_) {
+    sync_forward_to();
+    return forward_to_->log_evalue(evalue, evalue_type);
+  }
+  return false;
+}
+
+Result<bool> SamplingEventTracer::log_intermediate_output_delegate(
+    const char* name,
+    DelegateDebugIntId delegate_debug_index,
+    const Tensor& output) {
+  if (forwarding_block_) {
+    sync_forward_to();
+    return forward_to_->log_intermediate_output_delegate(
+        name, delegate_debug_index, output);
+  }
+  return false;
+}
+
+Result<bool> SamplingEventTracer::log_intermediate_output_delegate(
+    const char* name,
+    DelegateDebugIntId delegate_debug_index,
+    const ArrayRef<Tensor> output) {
+  if (forwarding_block_) {
+    sync_forward_to();
+    return forward_to_->log_intermediate_output_delegate(
+        name, delegate_debug_index, output);
+  }
+  return false;
+}
+
+Result<bool> SamplingEventTracer::log_intermediate_output_delegate(
+    const char* name,
+    DelegateDebugIntId delegate_debug_index,
+    const int& output) {
+  if (forwarding_block_) {
+    sync_forward_to();
+    return forward_to_->log_intermediate_output_delegate(
+        name, delegate_debug_index, output);
+  }
+  return false;
+}
+
+Result<bool> SamplingEventTracer::log_intermediate_output_delegate(
+    const char* name,
+    DelegateDebugIntId delegate_debug_index,
+    const bool& output) {
+  if (forwarding_block_) {
+    sync_forward_to();
+    return forward_to_->log_intermediate_output_delegate(
+        name, delegate_debug_index, output);
+  }
+  return false;
+}
+
+Result<bool> SamplingEventTracer::log_intermediate_output_delegate(
+    const char* name,
+    DelegateDebugIntId delegate_debug_index,
+    const double& output) {
+  if (forwarding_block_) {
+    sync_forward_to();
+    return forward_to_->log_intermediate_output_delegate(
+        name, delegate_debug_index, output);
+  }
+  return false;
+}
+
+void SamplingEventTracer::set_delegation_intermediate_output_filter(
+    EventTracerFilterBase* event_tracer_filter) {
+  if (forward_to_ != nullptr) {
+    forward_to_->set_delegation_intermediate_output_filter(event_tracer_filter);
+  }
+}
+
+size_t SamplingEventTracer::get_event_stats(
+    Span<SampledEventStats> stats) const {
+  size_t num_stats = 0;
+  for (size_t i = 0; i < num_slots_ && num_stats < stats.size(); ++i) {
+    const Slot& slot = slots_[i];
+    if (!slot.ready.load(std::memory_order_acquire)) {
+      continue;
+    }
+    uint32_t histogram[kNumBuckets];
+    uint64_t num_samples = 0;
+    for (size_t b = 0; b < kNumBuckets; ++b) {
+      histogram[b] = slot.histogram[b].load(std::memory_order_relaxed);
+      num_samples += histogram[b];
+    }
+    SampledEventStats& event_stats = stats[num_stats++];
+    event_stats.name = slot.name;
+    event_stats.chain_id = slot.chain_id;
+    event_stats.debug_handle = slot.debug_handle;
+    event_stats.delegate_debug_index = slot.delegate_debug_index;
+    event_stats.count = slot.count.load(std::memory_order_relaxed);
+    event_stats.total_ticks = slot.total_ticks.load(std::memory_order_relaxed);
+    event_stats.p50_ticks = 0;
+    event_stats.p99_ticks = 0;
+    // The smallest durations whose rank is at least 50% and 99% of the
+    // samples.
+    const uint64_t p50_rank = (num_samples * 50 + 99) / 100;
+    const uint64_t p99_rank = (num_samples * 99 + 99) / 100;
+    uint64_t rank = 0;
+    bool found_p50 = false;
+    for (size_t b = 0; b < kNumBuckets && rank < p99_rank; ++b) {
+      if (histogram[b] == 0) {
+        continue;
+      }
+      rank += histogram[b];
+      if (!found_p50 && rank >= p50_rank) {
+        found_p50 = true;
+        event_stats.p50_ticks = bucket_value(b);
+      }
+      if (rank >= p99_rank) {
+        event_stats.p99_ticks = bucket_value(b);
+      }
+    }
+  }
+  return num_stats;
+}
+
+size_t SamplingEventTracer::get_num_events() const {
+  size_t num_events = 0;
+  for (size_t i = 0; i < num_slots_; ++i) {
+    if (slots_[i].ready.load(std::memory_order_acquire)) {
+      ++num_events;
+    }
+  }
+  return num_events;
+}
+
+uint64_t SamplingEventTracer::get_num_dropped_events() const {
+  return num_dropped_events_.load(std::memory_order_relaxed);
+}
+
+void SamplingEventTracer::reset_stats() {
+  slots_.reset(new Slot[num_slots_]);
+  num_dropped_events_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace etdump
+} // namespace executorch
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include <executorch/runtime/core/event_tracer.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/platform/platform.h>
+
+namespace executorch {
+namespace etdump {
+
+/**
+ * Latency statistics of one profiled event, as aggregated by
+ * SamplingEventTracer. Durations are in ticks, see
+ * executorch::runtime::pal_ticks_to_ns_multiplier().
+ */
+struct SampledEventStats {
+  /// Name of the event, truncated to kMaxNameLength characters. For delegate
+  /// events profiled by integer id this is empty.
+  const char* name;
+  ::executorch::runtime::ChainID chain_id;
+  ::executorch::runtime::DebugHandle debug_handle;
+  /// Delegate debug id of delegate events profiled by integer id, or
+  /// kUnsetDelegateDebugIntId.
+  ::executorch::runtime::DelegateDebugIntId delegate_debug_index;
+  /// Number of samples.
+  uint64_t count;
+  /// Sum of the durations of all samples.
+  uint64_t total_ticks;
+  /// Median and 99th percentile duration, estimated from a histogram with a
+  /// relative error of at most 12.5%.
+  uint64_t p50_ticks;
+  uint64_t p99_ticks;
+};
+
+/**
+ * An EventTracer that profiles only a sample of events, cheaply enough to be
+ * left on in production.
+ *
+ * One in `execution_sample_period` event blocks (i.e. executions of a Method)
+ * is sampled, and within a sampled block each profiling event is kept with a
+ * probability of 1 / `event_sample_period`. Events that are not sampled are
+ * neither timestamped nor recorded, so they only cost a virtual call and a
+ * random draw.
+ *
+ * Each sampled event updates the statistics of its event, identified by its
+ * name, chain id, debug handle and delegate debug id, in a fixed-size table.
+ * Recording never blocks or allocates, and get_event_stats() can be called
+ * from another thread while events are recorded. Events that do not fit in
+ * the table are counted by get_num_dropped_events().
+ *
+ * The sampled events of sampled blocks can also be forwarded to another
+ * EventTracer, e.g. an ETDumpGen, to get full traces for a sample of the
+ * executions.
+ *
+ * Like other EventTracers, an instance must only be used to record events by
+ * one thread at a time.
+ */
+class SamplingEventTracer : public ::executorch::runtime::EventTracer {
+ public:
+  /// Maximum number of characters of an event name that are stored.
+  static constexpr size_t kMaxNameLength = 63;
+
+  /**
+   * @param[in] execution_sample_period Sample one event block in this many.
+   *     Must be at least 1.
+   * @param[in] event_sample_period Sample each profiling event of a sampled
+   *     block with a probability of one in this many. Must be at least 1.
+   * @param[in] max_events The number of distinct events that can be
+   *     aggregated.
+   * @param[in] forward_to If not null, the sampled events of sampled blocks
+   *     are also recorded by this EventTracer. Must outlive this object.
+   */
+  explicit SamplingEventTracer(
+      uint32_t execution_sample_period = 1,
+      uint32_t event_sample_period = 1,
+      size_t max_events = 256,
+      ::executorch::runtime::EventTracer* forward_to = nullptr);
+  ~SamplingEventTracer() override;
+
+  SamplingEventTracer(const SamplingEventTracer&) = delete;
+  SamplingEventTracer& operator=(const SamplingEventTracer&) = delete;
+
+  void create_event_block(const char* name) override;
+  ::executorch::runtime::EventTracerEntry start_profiling(
+      const char* name,
+      ::executorch::runtime::ChainID chain_id =
+          ::executorch::runtime::kUnsetChainId,
+      ::executorch::runtime::DebugHandle debug_handle =
+          ::executorch::runtime::kUnsetDebugHandle) override;
+  void end_profiling(
+      ::executorch::runtime::EventTracerEntry prof_entry) override;
+  ::executorch::runtime::EventTracerEntry start_profiling_delegate(
+      const char* name,
+      ::executorch::runtime::DelegateDebugIntId delegate_debug_index) override;
+  void end_profiling_delegate(
+      ::executorch::runtime::EventTracerEntry prof_entry,
+      const void* metadata,
+      size_t metadata_len) override;
+  void log_profiling_delegate(
+      const char* name,
+      ::executorch::runtime::DelegateDebugIntId delegate_debug_index,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time,
+      const void* metadata,
+      size_t metadata_len) override;
+  void track_allocation(::executorch::runtime::AllocatorID id, size_t size)
+      override;
+  ::executorch::runtime::AllocatorID track_allocator(const char* name) override;
+  ::executorch::runtime::Result<bool> log_evalue(
+      const ::executorch::runtime::EValue& evalue,
+      ::executorch::runtime::LoggedEValueType evalue_type) override;
+  ::executorch::runtime::Result<bool> log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DelegateDebugIntId delegate_debug_index,
+      const executorch::aten::Tensor& output) override;
+  ::executorch::runtime::Result<bool> log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DelegateDebugIntId delegate_debug_index,
+      const ::executorch::runtime::ArrayRef<executorch::aten::Tensor> output)
+      override;
+  ::executorch::runtime::Result<bool> log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DelegateDebugIntId delegate_debug_index,
+      const int& output) override;
+  ::executorch::runtime::Result<bool> log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DelegateDebugIntId delegate_debug_index,
+      const bool& output) override;
+  ::executorch::runtime::Result<bool> log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DelegateDebugIntId delegate_debug_index,
+      const double& output) override;
+  void set_delegation_intermediate_output_filter(
+      ::executorch::runtime::EventTracerFilterBase* event_tracer_filter)
+      override;
+
+  /**
+   * Copies the statistics of the events recorded so far into `stats`.
+   *
+   * @param[out] stats Receives the statistics, in no particular order. The
+   *     names point into this object and stay valid until it is destroyed.
+   *
+   * @return The number of entries written, at most `stats.size()`.
+   */
+  size_t get_event_stats(
+      ::executorch::runtime::Span<SampledEventStats> stats) const;
+
+  /// Returns the number of distinct events recorded so far.
+  size_t get_num_events() const;
+
+  /// Returns the number of sampled events that did not fit in the table.
+  uint64_t get_num_dropped_events() const;
+
+  /// Clears all statistics. Must not be called while events are recorded.
+  void reset_stats();
+
+ private:
+  static constexpr size_t kNumBuckets = 128;
+
+  // The statistics of one event. A slot is claimed by setting its key, after
+  // which its identifying fields are written and published with `ready`.
+  struct Slot {
+    std::atomic<uint64_t> key{0};
+    std::atomic<bool> ready{false};
+    char name[kMaxNameLength + 1];
+    ::executorch::runtime::ChainID chain_id;
+    ::executorch::runtime::DebugHandle debug_handle;
+    ::executorch::runtime::DelegateDebugIntId delegate_debug_index;
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> total_ticks{0};
+    std::atomic<uint32_t> histogram[kNumBuckets] = {};
+  };
+
+  bool sample_event();
+  // Returns the index of the slot of the given event, claiming a new one if
+  // needed, or -1 if the table is full.
+  int64_t find_slot(
+      const char* name,
+      ::executorch::runtime::ChainID chain_id,
+      ::executorch::runtime::DebugHandle debug_handle,
+      ::executorch::runtime::DelegateDebugIntId delegate_debug_index);
+  void add_sample(
+      int64_t slot,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time);
+  void sync_forward_to();
+
+  const uint32_t execution_sample_period_;
+  const uint32_t event_sample_period_;
+  const size_t num_slots_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<uint64_t> num_dropped_events_{0};
+  ::executorch::runtime::EventTracer* forward_to_;
+
+  uint64_t num_blocks_ = 0;
+  // Whether the current block is sampled. Events recorded before the first
+  // block are sampled too.
+  bool sampling_block_ = true;
+  // Whether the current block is forwarded to forward_to_.
+  bool forwarding_block_ = false;
+  uint64_t rng_state_;
+};
+
+} // namespace etdump
+} // namespace executorch
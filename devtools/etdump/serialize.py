@@ -8,6 +8,7 @@
 
 import json
 import os
+import struct
 import tempfile
 
 import pkg_resources
@@ -108,3 +109,40 @@ def deserialize_from_etdump_flatcc(
     return _deserialize_from_json_to_etdump_flatcc(
         _convert_from_flatcc(data, size_prefixed)
     )
+
+
+def deserialize_from_etdump_flatcc_stream(data: bytes) -> ETDumpFlatCC:
+    """
+    Given the output of an ETDumpGen that streams its blocks to a data sink, this
+    function will deserialize it and return a single ETDump holding the run data
+    of every block in the order they were written.
+    Args:
+        data: A sequence of size-prefixed etdump binary blobs, each holding one or
+            more blocks. They may be separated by zero padding, as added by data
+            sinks that align their writes.
+    Returns:
+        Deserialized ETDump python object.
+    """
+    etdump = ETDumpFlatCC(version=0, run_data=[])
+    num_etdumps = 0
+    offset = 0
+    while offset + 4 <= len(data):
+        (size,) = struct.unpack_from("<I", data, offset)
+        offset += 4
+        if size == 0:
+            # Padding between two etdumps.
+            continue
+        if offset + size > len(data):
+            raise ValueError(
+                f"Truncated etdump stream: {size} bytes expected at offset {offset}, "
+                f"but only {len(data) - offset} are left"
+            )
+        block = deserialize_from_etdump_flatcc(
+            data[offset : offset + size], size_prefixed=False
+        )
+        if num_etdumps == 0:
+            etdump.version = block.version
+        etdump.run_data.extend(block.run_data)
+        num_etdumps += 1
+        offset += size
+    return etdump
@@ -122,6 +122,26 @@ def define_common_targets():
             ],
         )
 
+        runtime.cxx_library(
+            name = "sampling_event_tracer" + aten_suffix,
+            srcs = [
+                "sampling_event_tracer.cpp",
+            ],
+            exported_headers = [
+                "sampling_event_tracer.h",
+            ],
+            deps = [
+                "//executorch/runtime/platform:platform",
+            ],
+            exported_deps = [
+                "//executorch/runtime/core:event_tracer" + aten_suffix,
+            ],
+            visibility = [
+                "//executorch/...",
+                "@EXECUTORCH_CLIENTS",
+            ],
+        )
+
         runtime.cxx_library(
             name = "etdump_flatcc" + aten_suffix,
             srcs = [
@@ -9,6 +9,8 @@
 #include <gtest/gtest.h>
 #include <cstdio>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <executorch/devtools/etdump/data_sinks/buffer_data_sink.h>
 #include <executorch/devtools/etdump/data_sinks/file_data_sink.h>
@@ -49,6 +51,44 @@ using ::executorch::etdump::FileDataSink;
 
 using ::executorch::etdump::ETDumpFilter;
 
+namespace {
+
+// Returns the names of the blocks in a stream of size-prefixed ETDumps, as
+// written by ETDumpGen to its stream sink.
+std::vector<std::string> get_streamed_block_names(
+    const uint8_t* data,
+    size_t size) {
+  std::vector<std::string> names;
+  size_t offset = 0;
+  while (offset + sizeof(uint32_t) <= size) {
+    uint32_t etdump_size = 0;
+    memcpy(&etdump_size, data + offset, sizeof(etdump_size));
+    if (etdump_size == 0) {
+      // Padding added by the data sink.
+      offset += sizeof(uint32_t);
+      continue;
+    }
+    size_t buf_size = 0;
+    void* buf = flatbuffers_read_size_prefix(
+        const_cast<uint8_t*>(data + offset), &buf_size);
+    etdump_ETDump_table_t etdump =
+        etdump_ETDump_as_root_with_identifier(buf, etdump_ETDump_file_identifier);
+    EXPECT_NE(etdump, nullptr);
+    if (etdump == nullptr) {
+      break;
+    }
+    etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+    for (size_t i = 0; i < etdump_RunData_vec_len(run_data_vec); ++i) {
+      names.emplace_back(
+          etdump_RunData_name(etdump_RunData_vec_at(run_data_vec, i)));
+    }
+    offset += sizeof(uint32_t) + buf_size;
+  }
+  return names;
+}
+
+} // namespace
+
 class ProfilerETDumpTest : public ::testing::Test {
  protected:
   void SetUp() override {
@@ -1019,3 +1059,100 @@ TEST_F(ProfilerETDumpTest, LogWithNullptrAndUnsetDebugHandle) {
       /*expected_log=*/false,
       /*expected_ok=*/false);
 }
+
+TEST_F(ProfilerETDumpTest, StreamBlocksToDataSink) {
+  const size_t stream_size = 64 * 1024;
+  std::vector<uint8_t> stream_buf(stream_size);
+  for (size_t i = 0; i < 2; i++) {
+    Result<BufferDataSink> sink =
+        BufferDataSink::create(stream_buf.data(), stream_size);
+    ASSERT_TRUE(sink.ok());
+    ASSERT_TRUE(etdump_gen[i]->set_stream_sink(&sink.get()).ok());
+
+    etdump_gen[i]->create_event_block("block_0");
+    AllocatorID allocator_id =
+        etdump_gen[i]->track_allocator("test_allocator");
+    etdump_gen[i]->track_allocation(allocator_id, 64);
+    EXPECT_EQ(sink->get_used_bytes(), 0);
+
+    // Creating a block completes the previous one, which is written out.
+    etdump_gen[i]->create_event_block("block_1");
+    size_t used_bytes = sink->get_used_bytes();
+    EXPECT_GT(used_bytes, 0);
+    EventTracerEntry entry = etdump_gen[i]->start_profiling("test_event", 0, 1);
+    etdump_gen[i]->end_profiling(entry);
+
+    etdump_gen[i]->create_event_block("block_2");
+    EXPECT_GT(sink->get_used_bytes(), used_bytes);
+    entry = etdump_gen[i]->start_profiling("test_event", 0, 1);
+    etdump_gen[i]->end_profiling(entry);
+
+    // The blocks live in the sink, not in the returned buffer.
+    ETDumpResult result = etdump_gen[i]->get_etdump_data();
+    EXPECT_EQ(result.buf, nullptr);
+    EXPECT_EQ(result.size, 0);
+    EXPECT_EQ(etdump_gen[i]->get_num_blocks(), 3);
+
+    std::vector<std::string> names =
+        get_streamed_block_names(stream_buf.data(), sink->get_used_bytes());
+    EXPECT_EQ(
+        names, std::vector<std::string>({"block_0", "block_1", "block_2"}));
+
+    // Streaming carries over to the next run.
+    Result<BufferDataSink> next_sink =
+        BufferDataSink::create(stream_buf.data(), stream_size);
+    ASSERT_TRUE(next_sink.ok());
+    ASSERT_TRUE(etdump_gen[i]->set_stream_sink(&next_sink.get()).ok());
+    etdump_gen[i]->create_event_block("block_3");
+    ASSERT_TRUE(etdump_gen[i]->flush_stream().ok());
+    names = get_streamed_block_names(
+        stream_buf.data(), next_sink->get_used_bytes());
+    EXPECT_EQ(names, std::vector<std::string>({"block_3"}));
+
+    ASSERT_TRUE(etdump_gen[i]->set_stream_sink(nullptr).ok());
+  }
+}
+
+TEST_F(ProfilerETDumpTest, StreamRingBufferKeepsLastBlocks) {
+  const size_t stream_size = 64 * 1024;
+  std::vector<uint8_t> stream_buf(stream_size);
+  for (size_t i = 0; i < 2; i++) {
+    Result<BufferDataSink> sink =
+        BufferDataSink::create(stream_buf.data(), stream_size);
+    ASSERT_TRUE(sink.ok());
+    ASSERT_TRUE(etdump_gen[i]
+                    ->set_stream_sink(&sink.get(), /*ring_buffer_blocks=*/2)
+                    .ok());
+
+    const char* block_names[] = {
+        "block_0", "block_1", "block_2", "block_3", "block_4"};
+    for (const char* name : block_names) {
+      etdump_gen[i]->create_event_block(name);
+      EventTracerEntry entry =
+          etdump_gen[i]->start_profiling("test_event", 0, 1);
+      etdump_gen[i]->end_profiling(entry);
+    }
+    // Nothing is written until the stream is flushed.
+    EXPECT_EQ(sink->get_used_bytes(), 0);
+
+    ASSERT_TRUE(etdump_gen[i]->flush_stream().ok());
+    std::vector<std::string> names =
+        get_streamed_block_names(stream_buf.data(), sink->get_used_bytes());
+    EXPECT_EQ(names, std::vector<std::string>({"block_3", "block_4"}));
+
+    ASSERT_TRUE(etdump_gen[i]->set_stream_sink(nullptr).ok());
+  }
+}
+
+TEST_F(ProfilerETDumpTest, SetStreamSinkDuringBlockFails) {
+  std::vector<uint8_t> stream_buf(1024);
+  Result<BufferDataSink> sink =
+      BufferDataSink::create(stream_buf.data(), stream_buf.size());
+  ASSERT_TRUE(sink.ok());
+  for (size_t i = 0; i < 2; i++) {
+    etdump_gen[i]->create_event_block("test_block");
+    Result<bool> result = etdump_gen[i]->set_stream_sink(&sink.get());
+    EXPECT_EQ(result.error(), Error::InvalidState);
+    EXPECT_EQ(etdump_gen[i]->flush_stream().error(), Error::InvalidState);
+  }
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include <executorch/devtools/etdump/etdump_flatcc.h>
+#include <executorch/devtools/etdump/sampling_event_tracer.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using ::executorch::etdump::ETDumpGen;
+using ::executorch::etdump::ETDumpResult;
+using ::executorch::etdump::SampledEventStats;
+using ::executorch::etdump::SamplingEventTracer;
+using ::executorch::runtime::EventTracerEntry;
+using ::executorch::runtime::kUnsetDelegateDebugIntId;
+using ::executorch::runtime::Span;
+
+class SamplingEventTracerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+
+  static std::vector<SampledEventStats> get_stats(
+      const SamplingEventTracer& tracer) {
+    std::vector<SampledEventStats> stats(tracer.get_num_events());
+    stats.resize(tracer.get_event_stats({stats.data(), stats.size()}));
+    return stats;
+  }
+
+  // Runs one "execution" with `num_instructions` profiled instructions.
+  static void execute(SamplingEventTracer& tracer, int num_instructions) {
+    tracer.create_event_block("Execute");
+    for (int i = 0; i < num_instructions; ++i) {
+      tracer.set_chain_debug_handle(0, i);
+      EventTracerEntry entry = tracer.start_profiling("OPERATOR_CALL");
+      tracer.end_profiling(entry);
+    }
+    tracer.set_chain_debug_handle(
+        ::executorch::runtime::kUnsetChainId,
+        ::executorch::runtime::kUnsetDebugHandle);
+  }
+};
+
+TEST_F(SamplingEventTracerTest, AggregatesEachEvent) {
+  SamplingEventTracer tracer;
+  for (int i = 0; i < 10; ++i) {
+    execute(tracer, 3);
+  }
+
+  std::vector<SampledEventStats> stats = get_stats(tracer);
+  ASSERT_EQ(stats.size(), 3);
+  std::vector<bool> seen(3, false);
+  for (const SampledEventStats& event_stats : stats) {
+    EXPECT_STREQ(event_stats.name, "OPERATOR_CALL");
+    EXPECT_EQ(event_stats.chain_id, 0);
+    ASSERT_LT(event_stats.debug_handle, 3);
+    seen[event_stats.debug_handle] = true;
+    EXPECT_EQ(event_stats.count, 10);
+    EXPECT_LE(event_stats.p50_ticks, event_stats.p99_ticks);
+  }
+  EXPECT_EQ(seen, std::vector<bool>(3, true));
+  EXPECT_EQ(tracer.get_num_dropped_events(), 0);
+
+  tracer.reset_stats();
+  EXPECT_EQ(tracer.get_num_events(), 0);
+}
+
+TEST_F(SamplingEventTracerTest, SamplesOneInNExecutions) {
+  SamplingEventTracer tracer(/*execution_sample_period=*/4);
+  for (int i = 0; i < 8; ++i) {
+    execute(tracer, 1);
+  }
+
+  std::vector<SampledEventStats> stats = get_stats(tracer);
+  ASSERT_EQ(stats.size(), 1);
+  EXPECT_EQ(stats[0].count, 2);
+}
+
+TEST_F(SamplingEventTracerTest, SamplesSubsetOfEvents) {
+  SamplingEventTracer tracer(
+      /*execution_sample_period=*/1, /*event_sample_period=*/10);
+  execute(tracer, 1);
+  for (int i = 0; i < 9999; ++i) {
+    EventTracerEntry entry = tracer.start_profiling("OPERATOR_CALL", 0, 0);
+    tracer.end_profiling(entry);
+  }
+
+  std::vector<SampledEventStats> stats = get_stats(tracer);
+  ASSERT_EQ(stats.size(), 1);
+  EXPECT_GT(stats[0].count, 800);
+  EXPECT_LT(stats[0].count, 1200);
+}
+
+TEST_F(SamplingEventTracerTest, EstimatesPercentiles) {
+  SamplingEventTracer tracer;
+  tracer.create_event_block("Execute");
+  for (int i = 0; i < 98; ++i) {
+    tracer.log_profiling_delegate(
+        "delegate_event", kUnsetDelegateDebugIntId, 1000, 1100, nullptr, 0);
+  }
+  for (int i = 0; i < 2; ++i) {
+    tracer.log_profiling_delegate(
+        "delegate_event", kUnsetDelegateDebugIntId, 1000, 11000, nullptr, 0);
+  }
+
+  std::vector<SampledEventStats> stats = get_stats(tracer);
+  ASSERT_EQ(stats.size(), 1);
+  EXPECT_STREQ(stats[0].name, "delegate_event");
+  EXPECT_EQ(stats[0].count, 100);
+  EXPECT_EQ(stats[0].total_ticks, 98 * 100 + 2 * 10000);
+  EXPECT_NEAR(stats[0].p50_ticks, 100, 100 * 0.125);
+  EXPECT_NEAR(stats[0].p99_ticks, 10000, 10000 * 0.125);
+}
+
+TEST_F(SamplingEventTracerTest, DropsEventsThatDoNotFit) {
+  SamplingEventTracer tracer(
+      /*execution_sample_period=*/1,
+      /*event_sample_period=*/1,
+      /*max_events=*/2);
+  execute(tracer, 3);
+
+  EXPECT_EQ(tracer.get_num_events(), 2);
+  EXPECT_EQ(tracer.get_num_dropped_events(), 1);
+}
+
+TEST_F(SamplingEventTracerTest, ForwardsSampledExecutions) {
+  ETDumpGen etdump_gen;
+  SamplingEventTracer tracer(
+      /*execution_sample_period=*/2,
+      /*event_sample_period=*/1,
+      /*max_events=*/256,
+      &etdump_gen);
+  for (int i = 0; i < 4; ++i) {
+    execute(tracer, 2);
+  }
+
+  EXPECT_EQ(etdump_gen.get_num_blocks(), 2);
+  ETDumpResult result = etdump_gen.get_etdump_data();
+  ASSERT_NE(result.buf, nullptr);
+  free(result.buf);
+}
@@ -8,6 +8,7 @@
 
 import difflib
 import json
+import struct
 import unittest
 from pprint import pformat
 from typing import List
@@ -16,6 +17,7 @@ import executorch.devtools.etdump.schema_flatcc as flatcc
 
 from executorch.devtools.etdump.serialize import (
     deserialize_from_etdump_flatcc,
+    deserialize_from_etdump_flatcc_stream,
     serialize_to_etdump_flatcc,
 )
 from executorch.exir._serialize._dataclass import _DataclassEncoder
@@ -140,3 +142,20 @@ class TestSerializeFlatCC(unittest.TestCase):
                 )
             ),
         )
+
+    def test_deserialize_stream(self) -> None:
+        program = get_sample_etdump_flatcc()
+        run_data = program.run_data[0]
+        first = flatcc.ETDumpFlatCC(version=0, run_data=[run_data])
+        second = flatcc.ETDumpFlatCC(version=0, run_data=[run_data, run_data])
+
+        stream = b""
+        for etdump in (first, second):
+            serialized = serialize_to_etdump_flatcc(etdump)
+            stream += struct.pack("<I", len(serialized)) + serialized
+            # Padding as added by a data sink that aligns its writes.
+            stream += b"\0" * (-len(stream) % 64)
+
+        deserialized_obj = deserialize_from_etdump_flatcc_stream(stream)
+        self.assertEqual(deserialized_obj.version, 0)
+        self.assertEqual(deserialized_obj.run_data, [run_data] * 3)
@@ -33,3 +33,15 @@ def define_common_targets():
             "//executorch/runtime/platform:platform",
         ],
     )
+
+    runtime.cxx_test(
+        name = "sampling_event_tracer_test",
+        srcs = [
+            "sampling_event_tracer_test.cpp",
+        ],
+        deps = [
+            "//executorch/devtools/etdump:etdump_flatcc",
+            "//executorch/devtools/etdump:sampling_event_tracer",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
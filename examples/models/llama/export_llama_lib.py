@@ -1158,6 +1158,7 @@ def _load_llama_model_metadata(
     n_layers: int,
     vocab_size: int,
     metadata_str: Optional[str] = None,
+    use_sliding_window_kv_cache: bool = False,
 ):
     is_fairseq2 = weight_type == WeightType.FAIRSEQ2
     metadata = {
@@ -1170,6 +1171,7 @@ def _load_llama_model_metadata(
         "use_kv_cache": use_kv_cache,
         "use_sdpa_with_kv_cache": use_sdpa_with_kv_cache,
         "enable_dynamic_shape": enable_dynamic_shape,
+        "use_sliding_window_kv_cache": use_sliding_window_kv_cache,
     }
     if metadata_str:
         try:
@@ -1248,6 +1250,7 @@ def _load_llama_model(llm_config: LlmConfig) -> "LLMEdgeManager":
             #  Module]`.
             model.vocab_size,
             llm_config.base.metadata,
+            use_sliding_window_kv_cache=bool(llm_config.model.local_global_attention),
         ),
     )
 
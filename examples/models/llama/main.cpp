@@ -9,7 +9,10 @@
 
 #include <gflags/gflags.h>
 
+#include <vector>
+
 #include <executorch/examples/models/llama/runner/runner.h>
+#include <executorch/extension/llm/runner/stats.h>
 
 #if defined(ET_USE_THREADPOOL)
 #include <executorch/extension/threadpool/cpuinfo_utils.h>
@@ -54,6 +57,11 @@ DEFINE_int32(
 
 DEFINE_bool(warmup, false, "Whether to run a warmup run.");
 
+DEFINE_int32(
+    benchmark_iterations,
+    0,
+    "If > 0, generate this many times from the prompt and report the distribution of the prompt evaluation and generation rates across the runs.");
+
 int32_t main(int32_t argc, char** argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
@@ -109,6 +117,28 @@ int32_t main(int32_t argc, char** argv) {
   // generate
   executorch::extension::llm::GenerationConfig config{
       .seq_len = seq_len, .temperature = temperature};
+  if (FLAGS_benchmark_iterations > 0) {
+    config.echo = false;
+    std::vector<executorch::extension::llm::Stats> runs;
+    for (int32_t i = 0; i < FLAGS_benchmark_iterations; ++i) {
+      // Prefill the whole prompt in every run.
+      runner->clear_prefix_cache();
+      auto error = runner->generate(
+          prompt,
+          config,
+          {},
+          [&runs](const executorch::extension::llm::Stats& stats) {
+            runs.push_back(stats);
+          });
+      if (error != executorch::runtime::Error::Ok) {
+        ET_LOG(Error, "Failed to run benchmark iteration %d", i);
+        return 1;
+      }
+    }
+    executorch::extension::llm::print_benchmark_report(
+        executorch::extension::llm::summarize_benchmark(runs));
+    return 0;
+  }
   auto error = runner->generate(prompt, config);
   if (error != executorch::runtime::Error::Ok) {
     ET_LOG(Error, "Failed to warmup llama runner");
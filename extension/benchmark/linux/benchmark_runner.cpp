@@ -0,0 +1,729 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * Benchmarks the methods of an ExecuTorch program on Linux.
+ *
+ * For each method it reports the time to load the program, to initialize the
+ * method and to run the first inference, followed by latency percentiles over
+ * a number of timed iterations after a warmup, optionally for several
+ * threadpool sizes. It also reports the peak RSS and how much of the method
+ * and temp allocator pools were used. The results can be written as JSON for
+ * regression tracking.
+ */
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include <executorch/extension/data_loader/buffer_data_loader.h>
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/extension/flat_tensor/flat_tensor_data_map.h>
+#include <executorch/extension/runner_util/inputs.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/runtime.h>
+#if defined(ET_BUNDLE_IO)
+#include <executorch/devtools/bundled_program/bundled_program.h>
+#endif // ET_BUNDLE_IO
+
+#if defined(ET_USE_THREADPOOL)
+#include <executorch/extension/threadpool/cpuinfo_utils.h>
+#include <executorch/extension/threadpool/threadpool.h>
+#include <executorch/extension/threadpool/threadpool_guard.h>
+#endif // ET_USE_THREADPOOL
+
+DEFINE_string(
+    model_path,
+    "model.pte",
+    "Model serialized in flatbuffer format. With bundled input support, this "
+    "can also be a bundled program.");
+DEFINE_string(data_path, "", "Optional .ptd file with the model's data.");
+DEFINE_string(
+    method_name,
+    "",
+    "Method to benchmark. Defaults to all methods of the program.");
+DEFINE_uint32(warmup, 3, "Number of untimed executions before timing.");
+DEFINE_uint32(iterations, 10, "Number of timed executions.");
+DEFINE_string(
+    inputs,
+    "ones",
+    "Input data: 'ones', 'random' or, for bundled programs, 'bundled'.");
+DEFINE_uint32(seed, 0, "Seed for random inputs.");
+DEFINE_uint32(
+    bundled_input_index,
+    0,
+    "Index of the bundled test set to use with --inputs=bundled.");
+DEFINE_string(
+    cpu_threads,
+    "",
+    "Comma-separated threadpool sizes to benchmark, e.g. '1,2,4'. Defaults to "
+    "the number of performant cores.");
+DEFINE_uint32(
+    method_allocator_pool_size,
+    64 * 1024 * 1024,
+    "Size in bytes of the pool for the metadata of a loaded method.");
+DEFINE_uint32(
+    temp_allocator_pool_size,
+    16 * 1024 * 1024,
+    "Size in bytes of the pool for temporary allocations of kernels.");
+DEFINE_string(json_path, "", "If set, write the results as JSON to this path.");
+
+using executorch::extension::BufferDataLoader;
+using executorch::extension::FileDataLoader;
+using executorch::extension::FlatTensorDataMap;
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::EValue;
+using executorch::runtime::HierarchicalAllocator;
+using executorch::runtime::MemoryAllocator;
+using executorch::runtime::MemoryManager;
+using executorch::runtime::Method;
+using executorch::runtime::MethodMeta;
+using executorch::runtime::NamedDataMap;
+using executorch::runtime::Program;
+using executorch::runtime::Result;
+using executorch::runtime::Span;
+using executorch::runtime::TensorInfo;
+using executorch::runtime::etensor::TensorImpl;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ms(Clock::time_point start, Clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/// A MemoryAllocator over a fixed pool that remembers how much of the pool
+/// was ever in use, including across resets.
+class HighWaterMarkAllocator final : public MemoryAllocator {
+ public:
+  explicit HighWaterMarkAllocator(uint32_t size)
+      : HighWaterMarkAllocator(std::make_unique<uint8_t[]>(size), size) {}
+
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override {
+    void* ptr = MemoryAllocator::allocate(size, alignment);
+    if (ptr != nullptr) {
+      high_water_mark_ = std::max(
+          high_water_mark_,
+          static_cast<size_t>(
+              static_cast<uint8_t*>(ptr) + size - base_address()));
+    }
+    return ptr;
+  }
+
+  size_t high_water_mark() const {
+    return high_water_mark_;
+  }
+
+ private:
+  HighWaterMarkAllocator(std::unique_ptr<uint8_t[]> pool, uint32_t size)
+      : MemoryAllocator(size, pool.get()), pool_(std::move(pool)) {}
+
+  std::unique_ptr<uint8_t[]> pool_;
+  size_t high_water_mark_ = 0;
+};
+
+enum class InputKind { kOnes, kRandom, kBundled };
+
+/// Fills a tensor with random values: floats in [-1, 1), and integers and
+/// booleans in [0, 2) so that index inputs stay in range like the default
+/// ones do.
+void fill_random(executorch::aten::Tensor tensor, std::mt19937& rng) {
+  std::uniform_real_distribution<float> real(-1.0f, 1.0f);
+  std::uniform_int_distribution<int> integer(0, 1);
+#define FILL_REAL_CASE(T, n)                         \
+  case executorch::aten::ScalarType::n: {            \
+    T* data = tensor.mutable_data_ptr<T>();          \
+    for (ssize_t i = 0; i < tensor.numel(); ++i) {   \
+      data[i] = static_cast<T>(real(rng));           \
+    }                                                \
+    return;                                          \
+  }
+#define FILL_INT_CASE(T, n)                          \
+  case executorch::aten::ScalarType::n: {            \
+    T* data = tensor.mutable_data_ptr<T>();          \
+    for (ssize_t i = 0; i < tensor.numel(); ++i) {   \
+      data[i] = static_cast<T>(integer(rng));        \
+    }                                                \
+    return;                                          \
+  }
+  switch (tensor.scalar_type()) {
+    ET_FORALL_FLOATH_TYPES(FILL_REAL_CASE)
+    FILL_REAL_CASE(executorch::aten::BFloat16, BFloat16)
+    ET_FORALL_INT_TYPES(FILL_INT_CASE)
+    FILL_INT_CASE(bool, Bool)
+    default:
+      memset(tensor.mutable_data_ptr(), 0, tensor.nbytes());
+      return;
+  }
+#undef FILL_REAL_CASE
+#undef FILL_INT_CASE
+}
+
+struct LatencyStats {
+  double min_ms = 0;
+  double mean_ms = 0;
+  double p50_ms = 0;
+  double p90_ms = 0;
+  double p99_ms = 0;
+  double max_ms = 0;
+};
+
+/// Nearest-rank percentile of sorted samples.
+double percentile(const std::vector<double>& sorted, double p) {
+  size_t rank = static_cast<size_t>(std::ceil(p / 100 * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+LatencyStats compute_latency_stats(std::vector<double> samples) {
+  LatencyStats stats;
+  if (samples.empty()) {
+    return stats;
+  }
+  std::sort(samples.begin(), samples.end());
+  double sum = 0;
+  for (double sample : samples) {
+    sum += sample;
+  }
+  stats.min_ms = samples.front();
+  stats.mean_ms = sum / samples.size();
+  stats.p50_ms = percentile(samples, 50);
+  stats.p90_ms = percentile(samples, 90);
+  stats.p99_ms = percentile(samples, 99);
+  stats.max_ms = samples.back();
+  return stats;
+}
+
+struct RunResult {
+  uint32_t threads;
+  LatencyStats latency;
+};
+
+struct MethodResult {
+  std::string name;
+  double init_ms = 0;
+  double first_inference_ms = 0;
+  size_t planned_memory_bytes = 0;
+  size_t method_allocator_bytes = 0;
+  size_t temp_allocator_bytes = 0;
+  std::vector<RunResult> runs;
+};
+
+/// The data of a bundled program, which must stay alive while its inputs are
+/// used.
+struct ProgramFile {
+  std::unique_ptr<DataLoader> loader;
+  std::vector<uint8_t> bundled_program_data;
+};
+
+#if defined(ET_BUNDLE_IO)
+std::vector<uint8_t> read_file(const char* path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  ET_CHECK_MSG(file.is_open(), "Could not open '%s'", path);
+  std::vector<uint8_t> data(file.tellg());
+  file.seekg(0);
+  ET_CHECK_MSG(
+      file.read(reinterpret_cast<char*>(data.data()), data.size()),
+      "Could not read '%s'",
+      path);
+  return data;
+}
+
+/// Returns true if the file behind `loader` is a bundled program. Only reads
+/// the start of the file, where the flatbuffer identifier lives.
+bool is_bundled_program_file(const FileDataLoader& loader, const char* path) {
+  Result<size_t> file_size = loader.size();
+  ET_CHECK_MSG(
+      file_size.ok(),
+      "Could not get the size of '%s': 0x%" PRIx32,
+      path,
+      static_cast<uint32_t>(file_size.error()));
+  if (file_size.get() < Program::kMinHeadBytes) {
+    // Too short to be any kind of program; let Program::load() report it.
+    return false;
+  }
+  std::vector<uint8_t> header(Program::kMinHeadBytes);
+  Error status = loader.load_into(
+      0,
+      header.size(),
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program),
+      header.data());
+  ET_CHECK_MSG(
+      status == Error::Ok,
+      "Could not read the header of '%s': 0x%" PRIx32,
+      path,
+      static_cast<uint32_t>(status));
+  return executorch::bundled_program::is_bundled_program(
+      header.data(), header.size());
+}
+#endif // ET_BUNDLE_IO
+
+ProgramFile open_program_file(const char* path) {
+  ProgramFile program_file;
+  Result<FileDataLoader> loader = FileDataLoader::from(path);
+  ET_CHECK_MSG(
+      loader.ok(),
+      "FileDataLoader::from() failed on '%s': 0x%" PRIx32,
+      path,
+      static_cast<uint32_t>(loader.error()));
+#if defined(ET_BUNDLE_IO)
+  if (is_bundled_program_file(loader.get(), path)) {
+    // The inputs of a bundled program are read from the whole file, so it is
+    // read into memory only in this case.
+    std::vector<uint8_t> data = read_file(path);
+    const void* program_data = nullptr;
+    size_t program_data_len = 0;
+    Error status = executorch::bundled_program::get_program_data(
+        data.data(), data.size(), &program_data, &program_data_len);
+    ET_CHECK_MSG(
+        status == Error::Ok,
+        "get_program_data() failed on '%s': 0x%" PRIx32,
+        path,
+        static_cast<uint32_t>(status));
+    program_file.loader =
+        std::make_unique<BufferDataLoader>(program_data, program_data_len);
+    program_file.bundled_program_data = std::move(data);
+    return program_file;
+  }
+#endif // ET_BUNDLE_IO
+  program_file.loader =
+      std::make_unique<FileDataLoader>(std::move(loader.get()));
+  return program_file;
+}
+
+std::vector<uint32_t> parse_thread_counts(const std::string& list) {
+  std::vector<uint32_t> thread_counts;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) {
+      thread_counts.push_back(static_cast<uint32_t>(std::stoul(item)));
+    }
+  }
+  if (thread_counts.empty()) {
+#if defined(ET_USE_THREADPOOL)
+    thread_counts.push_back(
+        ::executorch::extension::cpuinfo::get_num_performant_cores());
+#else
+    thread_counts.push_back(1);
+#endif // ET_USE_THREADPOOL
+  }
+  return thread_counts;
+}
+
+#if !defined(ET_USE_THREADPOOL)
+void warn_if_multithreaded(uint32_t num_threads) {
+  if (num_threads != 1) {
+    ET_LOG(
+        Info,
+        "Built without a threadpool, running single-threaded instead of with %" PRIu32
+        " threads.",
+        num_threads);
+  }
+}
+#endif // !ET_USE_THREADPOOL
+
+/// Like prepare_input_tensors(), but fills the tensor inputs with random
+/// values.
+executorch::extension::BufferCleanup prepare_random_inputs(
+    Method& method,
+    std::mt19937& rng) {
+  MethodMeta method_meta = method.method_meta();
+  const size_t num_inputs = method_meta.num_inputs();
+  void** buffers = static_cast<void**>(malloc(num_inputs * sizeof(void*)));
+  ET_CHECK_MSG(buffers != nullptr, "malloc() failed");
+  size_t num_buffers = 0;
+  for (size_t i = 0; i < num_inputs; ++i) {
+    Result<executorch::runtime::Tag> tag = method_meta.input_tag(i);
+    ET_CHECK_MSG(tag.ok(), "Could not get the tag of input %zu", i);
+    if (tag.get() != executorch::runtime::Tag::Tensor) {
+      continue;
+    }
+    Result<TensorInfo> tensor_meta = method_meta.input_tensor_meta(i);
+    ET_CHECK_MSG(tensor_meta.ok(), "Could not get the meta of input %zu", i);
+    void* data = malloc(tensor_meta->nbytes());
+    ET_CHECK_MSG(
+        data != nullptr || tensor_meta->nbytes() == 0,
+        "malloc(%zu) failed for input %zu",
+        tensor_meta->nbytes(),
+        i);
+    buffers[num_buffers++] = data;
+    TensorImpl impl(
+        tensor_meta->scalar_type(),
+        tensor_meta->sizes().size(),
+        const_cast<TensorImpl::SizesType*>(tensor_meta->sizes().data()),
+        data,
+        const_cast<TensorImpl::DimOrderType*>(
+            tensor_meta->dim_order().data()));
+    executorch::aten::Tensor tensor(&impl);
+    fill_random(tensor, rng);
+    Error status = method.set_input(tensor, i);
+    ET_CHECK_MSG(
+        status == Error::Ok,
+        "Could not set input %zu: 0x%" PRIx32,
+        i,
+        static_cast<uint32_t>(status));
+  }
+  return executorch::extension::BufferCleanup({buffers, num_buffers});
+}
+
+/// Sets the inputs of `method` and returns the buffers that back them.
+executorch::extension::BufferCleanup prepare_inputs(
+    Method& method,
+    InputKind input_kind,
+    const ProgramFile& program_file,
+    std::mt19937& rng) {
+#if defined(ET_BUNDLE_IO)
+  if (input_kind == InputKind::kBundled) {
+    Error status = executorch::bundled_program::load_bundled_input(
+        method,
+        const_cast<uint8_t*>(program_file.bundled_program_data.data()),
+        FLAGS_bundled_input_index);
+    ET_CHECK_MSG(
+        status == Error::Ok,
+        "load_bundled_input() failed: 0x%" PRIx32,
+        static_cast<uint32_t>(status));
+    return executorch::extension::BufferCleanup({});
+  }
+#else
+  (void)program_file;
+#endif // ET_BUNDLE_IO
+  // Inputs must be prepared again before every execution, since memory
+  // planning may reuse their space.
+  if (input_kind == InputKind::kRandom) {
+    return prepare_random_inputs(method, rng);
+  }
+  auto inputs = executorch::extension::prepare_input_tensors(method);
+  ET_CHECK_MSG(
+      inputs.ok(),
+      "Could not prepare inputs: 0x%" PRIx32,
+      static_cast<uint32_t>(inputs.error()));
+  return std::move(inputs.get());
+}
+
+double execute_once(
+    Method& method,
+    InputKind input_kind,
+    const ProgramFile& program_file,
+    std::mt19937& rng) {
+  auto inputs = prepare_inputs(method, input_kind, program_file, rng);
+  const Clock::time_point start = Clock::now();
+  Error status = method.execute();
+  const Clock::time_point end = Clock::now();
+  ET_CHECK_MSG(
+      status == Error::Ok,
+      "Execution failed with status 0x%" PRIx32,
+      static_cast<uint32_t>(status));
+  return elapsed_ms(start, end);
+}
+
+MethodResult benchmark_method(
+    const Program& program,
+    const char* method_name,
+    const NamedDataMap* data_map,
+    const std::vector<uint32_t>& thread_counts,
+    InputKind input_kind,
+    const ProgramFile& program_file) {
+  MethodResult result;
+  result.name = method_name;
+
+  Result<MethodMeta> method_meta = program.method_meta(method_name);
+  ET_CHECK_MSG(
+      method_meta.ok(),
+      "Failed to get method_meta for %s: 0x%" PRIx32,
+      method_name,
+      static_cast<uint32_t>(method_meta.error()));
+
+  HighWaterMarkAllocator method_allocator(FLAGS_method_allocator_pool_size);
+  HighWaterMarkAllocator temp_allocator(FLAGS_temp_allocator_pool_size);
+  std::vector<std::unique_ptr<uint8_t[]>> planned_buffers;
+  std::vector<Span<uint8_t>> planned_spans;
+  for (size_t id = 0; id < method_meta->num_memory_planned_buffers(); ++id) {
+    const size_t buffer_size =
+        static_cast<size_t>(method_meta->memory_planned_buffer_size(id).get());
+    planned_buffers.push_back(std::make_unique<uint8_t[]>(buffer_size));
+    planned_spans.push_back({planned_buffers.back().get(), buffer_size});
+    result.planned_memory_bytes += buffer_size;
+  }
+  HierarchicalAllocator planned_memory(
+      {planned_spans.data(), planned_spans.size()});
+  MemoryManager memory_manager(
+      &method_allocator, &planned_memory, &temp_allocator);
+
+  std::mt19937 rng(FLAGS_seed);
+  for (size_t t = 0; t < thread_counts.size(); ++t) {
+    // Delegates such as XNNPACK bind to the threadpool that is current when
+    // the method is loaded, so every thread count gets a threadpool of its own
+    // and loads the method again under it. Declared first, the threadpool
+    // outlives the method.
+#if defined(ET_USE_THREADPOOL)
+    ::executorch::extension::threadpool::ThreadPool threadpool(
+        thread_counts[t]);
+    ::executorch::extension::threadpool::UseThreadPoolGuard threadpool_guard(
+        &threadpool);
+#else
+    warn_if_multithreaded(thread_counts[t]);
+#endif // ET_USE_THREADPOOL
+    method_allocator.reset();
+    temp_allocator.reset();
+    Clock::time_point start = Clock::now();
+    Result<Method> method = program.load_method(
+        method_name, &memory_manager, /*event_tracer=*/nullptr, data_map);
+    const double init_ms = elapsed_ms(start, Clock::now());
+    ET_CHECK_MSG(
+        method.ok(),
+        "Loading of method %s failed with status 0x%" PRIx32,
+        method_name,
+        static_cast<uint32_t>(method.error()));
+    if (t == 0) {
+      result.init_ms = init_ms;
+    }
+
+    for (uint32_t i = 0; i < FLAGS_warmup; ++i) {
+      double latency = execute_once(*method, input_kind, program_file, rng);
+      if (t == 0 && i == 0) {
+        result.first_inference_ms = latency;
+      }
+    }
+    std::vector<double> samples;
+    samples.reserve(FLAGS_iterations);
+    for (uint32_t i = 0; i < FLAGS_iterations; ++i) {
+      samples.push_back(execute_once(*method, input_kind, program_file, rng));
+    }
+    if (t == 0 && FLAGS_warmup == 0 && !samples.empty()) {
+      result.first_inference_ms = samples.front();
+    }
+    result.runs.push_back({thread_counts[t], compute_latency_stats(samples)});
+  }
+  result.method_allocator_bytes = method_allocator.high_water_mark();
+  result.temp_allocator_bytes = temp_allocator.high_water_mark();
+  return result;
+}
+
+/// Peak resident set size of this process in bytes.
+size_t get_peak_rss_bytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+  // ru_maxrss is in kilobytes on Linux.
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;
+}
+
+std::string json_escape(const std::string& str) {
+  std::string escaped;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      // JSON strings can't hold raw control characters.
+      char buf[7];
+      snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
+      escaped += buf;
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+std::string results_to_json_string(
+    double program_load_ms,
+    size_t peak_rss_bytes,
+    const std::vector<MethodResult>& results) {
+  std::stringstream ss;
+  ss << "{\"model_path\":\"" << json_escape(FLAGS_model_path) << "\","
+     << "\"data_path\":\"" << json_escape(FLAGS_data_path) << "\","
+     << "\"inputs\":\"" << json_escape(FLAGS_inputs) << "\","
+     << "\"warmup\":" << FLAGS_warmup << ","
+     << "\"iterations\":" << FLAGS_iterations << ","
+     << "\"program_load_ms\":" << program_load_ms << ","
+     << "\"peak_rss_bytes\":" << peak_rss_bytes << ","
+     << "\"methods\":[";
+  for (size_t m = 0; m < results.size(); ++m) {
+    const MethodResult& result = results[m];
+    ss << (m > 0 ? "," : "") << "{\"name\":\"" << json_escape(result.name)
+       << "\"," << "\"init_ms\":" << result.init_ms << ","
+       << "\"first_inference_ms\":" << result.first_inference_ms << ","
+       << "\"planned_memory_bytes\":" << result.planned_memory_bytes << ","
+       << "\"method_allocator_bytes\":" << result.method_allocator_bytes
+       << "," << "\"temp_allocator_bytes\":" << result.temp_allocator_bytes
+       << "," << "\"runs\":[";
+    for (size_t r = 0; r < result.runs.size(); ++r) {
+      const RunResult& run = result.runs[r];
+      ss << (r > 0 ? "," : "") << "{\"threads\":" << run.threads << ","
+         << "\"min_ms\":" << run.latency.min_ms << ","
+         << "\"mean_ms\":" << run.latency.mean_ms << ","
+         << "\"p50_ms\":" << run.latency.p50_ms << ","
+         << "\"p90_ms\":" << run.latency.p90_ms << ","
+         << "\"p99_ms\":" << run.latency.p99_ms << ","
+         << "\"max_ms\":" << run.latency.max_ms << "}";
+    }
+    ss << "]}";
+  }
+  ss << "]}";
+  return ss.str();
+}
+
+void print_results(
+    double program_load_ms,
+    size_t peak_rss_bytes,
+    const std::vector<MethodResult>& results) {
+  printf("Program load: %.3f ms\n", program_load_ms);
+  for (const MethodResult& result : results) {
+    printf(
+        "Method %s: init %.3f ms, first inference %.3f ms\n"
+        "  planned memory %zu bytes, method allocator %zu bytes, "
+        "temp allocator %zu bytes\n",
+        result.name.c_str(),
+        result.init_ms,
+        result.first_inference_ms,
+        result.planned_memory_bytes,
+        result.method_allocator_bytes,
+        result.temp_allocator_bytes);
+    for (const RunResult& run : result.runs) {
+      printf(
+          "  %" PRIu32
+          " thread(s): min %.3f  mean %.3f  p50 %.3f  p90 %.3f  p99 %.3f  "
+          "max %.3f (ms)\n",
+          run.threads,
+          run.latency.min_ms,
+          run.latency.mean_ms,
+          run.latency.p50_ms,
+          run.latency.p90_ms,
+          run.latency.p99_ms,
+          run.latency.max_ms);
+    }
+  }
+  printf("Peak RSS: %.3f MiB\n", peak_rss_bytes / 1024.0 / 1024.0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  executorch::runtime::runtime_init();
+
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (argc != 1) {
+    std::string msg = "Extra commandline args:";
+    for (int i = 1 /* skip argv[0] (program name) */; i < argc; i++) {
+      msg += std::string(" ") + argv[i];
+    }
+    ET_LOG(Error, "%s", msg.c_str());
+    return 1;
+  }
+
+  InputKind input_kind;
+  if (FLAGS_inputs == "ones") {
+    input_kind = InputKind::kOnes;
+  } else if (FLAGS_inputs == "random") {
+    input_kind = InputKind::kRandom;
+  } else if (FLAGS_inputs == "bundled") {
+    input_kind = InputKind::kBundled;
+  } else {
+    ET_LOG(Error, "Unknown --inputs '%s'", FLAGS_inputs.c_str());
+    return 1;
+  }
+  const std::vector<uint32_t> thread_counts =
+      parse_thread_counts(FLAGS_cpu_threads);
+
+  const char* model_path = FLAGS_model_path.c_str();
+  Clock::time_point start = Clock::now();
+  ProgramFile program_file = open_program_file(model_path);
+  Result<Program> program = Program::load(program_file.loader.get());
+  const double program_load_ms = elapsed_ms(start, Clock::now());
+  if (!program.ok()) {
+    ET_LOG(Error, "Failed to parse model file %s", model_path);
+    return 1;
+  }
+  if (input_kind == InputKind::kBundled &&
+      program_file.bundled_program_data.empty()) {
+    ET_LOG(
+        Error,
+        "--inputs=bundled needs a bundled program and bundled input support");
+    return 1;
+  }
+
+  std::unique_ptr<FileDataLoader> data_loader;
+  std::optional<FlatTensorDataMap> data_map;
+  if (!FLAGS_data_path.empty()) {
+    Result<FileDataLoader> loader =
+        FileDataLoader::from(FLAGS_data_path.c_str());
+    ET_CHECK_MSG(
+        loader.ok(),
+        "FileDataLoader::from() failed on '%s': 0x%" PRIx32,
+        FLAGS_data_path.c_str(),
+        static_cast<uint32_t>(loader.error()));
+    data_loader = std::make_unique<FileDataLoader>(std::move(loader.get()));
+    Result<FlatTensorDataMap> map = FlatTensorDataMap::load(data_loader.get());
+    ET_CHECK_MSG(
+        map.ok(),
+        "Failed to load data file '%s': 0x%" PRIx32,
+        FLAGS_data_path.c_str(),
+        static_cast<uint32_t>(map.error()));
+    data_map.emplace(std::move(map.get()));
+  }
+  const NamedDataMap* named_data_map = data_map ? &*data_map : nullptr;
+
+  std::vector<std::string> method_names;
+  if (!FLAGS_method_name.empty()) {
+    method_names.push_back(FLAGS_method_name);
+  } else {
+    for (size_t i = 0; i < program->num_methods(); ++i) {
+      method_names.push_back(program->get_method_name(i).get());
+    }
+  }
+
+  std::vector<MethodResult> results;
+  for (const std::string& method_name : method_names) {
+    ET_LOG(Info, "Benchmarking method %s", method_name.c_str());
+    results.push_back(benchmark_method(
+        *program,
+        method_name.c_str(),
+        named_data_map,
+        thread_counts,
+        input_kind,
+        program_file));
+  }
+
+  const size_t peak_rss_bytes = get_peak_rss_bytes();
+  print_results(program_load_ms, peak_rss_bytes, results);
+  if (!FLAGS_json_path.empty()) {
+    std::ofstream json_file(FLAGS_json_path);
+    if (!json_file) {
+      ET_LOG(Error, "Failed to open '%s'", FLAGS_json_path.c_str());
+      return 1;
+    }
+    json_file << results_to_json_string(
+                     program_load_ms, peak_rss_bytes, results)
+              << std::endl;
+    ET_LOG(Info, "Results written to '%s'.", FLAGS_json_path.c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,49 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "get_oss_build_kwargs", "runtime")
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    # Benchmarks the methods of a program. Contains a main() function; link it
+    # against the desired kernel and backend implementations.
+    runtime.cxx_library(
+        name = "benchmark_runner_lib",
+        srcs = ["benchmark_runner.cpp"],
+        compiler_flags = ["-Wno-global-constructors"],
+        preprocessor_flags = [
+            "-DET_BUNDLE_IO",
+            "-DET_USE_THREADPOOL",
+        ],
+        deps = [
+            "//executorch/devtools/bundled_program:runtime",
+            "//executorch/extension/data_loader:buffer_data_loader",
+            "//executorch/extension/data_loader:file_data_loader",
+            "//executorch/extension/flat_tensor:flat_tensor_data_map",
+            "//executorch/extension/runner_util:inputs",
+            "//executorch/extension/threadpool:cpuinfo_utils",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/runtime/executor:program",
+        ],
+        external_deps = [
+            "gflags",
+        ],
+        define_static_target = True,
+        visibility = [
+            "//executorch/...",
+        ],
+    )
+
+    runtime.cxx_binary(
+        name = "benchmark_runner",
+        srcs = [],
+        deps = [
+            ":benchmark_runner_lib",
+            "//executorch/configurations:optimized_native_cpu_ops",
+            "//executorch/kernels/quantized:generated_lib",
+        ],
+        define_static_target = True,
+        **get_oss_build_kwargs()
+    )
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/prefetching_data_loader.h>
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstring>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/platform/log.h>
+
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+namespace executorch {
+namespace extension {
+
+namespace {
+
+/// Stride used to fault in prefetched data. Touching every 4 KiB also covers
+/// platforms with larger pages.
+constexpr size_t kTouchStride = 4096;
+
+/**
+ * Reads one byte of every page in the buffer. For loaders that map the file
+ * lazily (e.g. MmapDataLoader), this is what actually pulls the data in from
+ * storage; for loaders that copy into memory it is a cheap no-op.
+ */
+void touch_pages(const FreeableBuffer& buffer) {
+  const volatile uint8_t* data =
+      static_cast<const volatile uint8_t*>(buffer.data());
+  for (size_t i = 0; i < buffer.size(); i += kTouchStride) {
+    (void)data[i];
+  }
+}
+
+} // namespace
+
+PrefetchingDataLoader::~PrefetchingDataLoader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+Error PrefetchingDataLoader::prefetch(const std::vector<Segment>& segments) {
+  Result<size_t> total_size = loader_->size();
+  if (!total_size.ok()) {
+    return total_size.error();
+  }
+  for (const auto& segment : segments) {
+    ET_CHECK_OR_RETURN_ERROR(
+        segment.offset <= total_size.get() &&
+            segment.size <= total_size.get() - segment.offset,
+        InvalidArgument,
+        "Segment offset %zu + size %zu > loader size %zu",
+        segment.offset,
+        segment.size,
+        total_size.get());
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& segment : segments) {
+      if (entry_index_.count(segment.offset) > 0) {
+        continue;
+      }
+      // A range that was already loaded is recorded as done, so the worker
+      // skips it.
+      State state = State::Pending;
+      auto loaded = loaded_ranges_.find(segment.offset);
+      if (loaded != loaded_ranges_.end()) {
+        if (loaded->second == segment.size) {
+          state = State::Done;
+        }
+        loaded_ranges_.erase(loaded);
+      }
+      entry_index_.emplace(segment.offset, entries_.size());
+      entries_.push_back(Entry{segment, state, std::nullopt});
+    }
+    if (!worker_.joinable()) {
+      worker_ = std::thread([this]() { worker_loop(); });
+    }
+  }
+  cv_.notify_all();
+  return Error::Ok;
+}
+
+void PrefetchingDataLoader::worker_loop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    // Skip segments that were requested before the worker got to them.
+    while (next_entry_ < entries_.size() &&
+           entries_[next_entry_].state != State::Pending) {
+      next_entry_++;
+    }
+    if (stop_) {
+      return;
+    }
+    if (next_entry_ == entries_.size()) {
+      cv_.wait(lock);
+      continue;
+    }
+    const size_t index = next_entry_;
+    const Segment segment = entries_[index].segment;
+    if (in_flight_bytes_ > 0 &&
+        in_flight_bytes_ + segment.size > max_in_flight_bytes_) {
+      // Wait for a consumer to free up some of the budget.
+      cv_.wait(lock);
+      continue;
+    }
+    next_entry_++;
+    entries_[index].state = State::Loading;
+    in_flight_bytes_ += segment.size;
+
+    lock.unlock();
+    Result<FreeableBuffer> buffer =
+        loader_->load(segment.offset, segment.size, segment.segment_info);
+    if (buffer.ok()) {
+      touch_pages(buffer.get());
+    }
+    lock.lock();
+
+    Entry& entry = entries_[index];
+    if (buffer.ok()) {
+      entry.buffer.emplace(std::move(buffer.get()));
+      entry.state = State::Ready;
+    } else {
+      ET_LOG(
+          Info,
+          "Prefetching offset %zu size %zu failed with 0x%" PRIx32
+          "; it will be loaded on demand",
+          segment.offset,
+          segment.size,
+          static_cast<uint32_t>(buffer.error()));
+      entry.state = State::Done;
+      in_flight_bytes_ -= segment.size;
+    }
+    cv_.notify_all();
+  }
+}
+
+std::optional<FreeableBuffer> PrefetchingDataLoader::take_prefetched(
+    size_t offset,
+    size_t size) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = entry_index_.find(offset);
+  if (it == entry_index_.end() || entries_[it->second].segment.size != size) {
+    if (!worker_.joinable()) {
+      // Remember reads that happen before prefetching starts, so prefetch()
+      // does not read them again.
+      loaded_ranges_[offset] = size;
+    }
+    return std::nullopt;
+  }
+  const size_t index = it->second;
+  // Entries may be appended (and moved) while waiting, so look the entry up
+  // again by index afterwards.
+  cv_.wait(lock, [&]() { return entries_[index].state != State::Loading; });
+  Entry& entry = entries_[index];
+  if (entry.state != State::Ready) {
+    // Not started or failed; the caller will read it directly.
+    entry.state = State::Done;
+    return std::nullopt;
+  }
+  std::optional<FreeableBuffer> buffer(std::move(*entry.buffer));
+  entry.buffer.reset();
+  entry.state = State::Done;
+  in_flight_bytes_ -= size;
+  cv_.notify_all();
+  return buffer;
+}
+
+Result<FreeableBuffer> PrefetchingDataLoader::load(
+    size_t offset,
+    size_t size,
+    const DataLoader::SegmentInfo& segment_info) const {
+  std::optional<FreeableBuffer> prefetched = take_prefetched(offset, size);
+  if (prefetched.has_value()) {
+    return std::move(*prefetched);
+  }
+  return loader_->load(offset, size, segment_info);
+}
+
+Error PrefetchingDataLoader::load_into(
+    size_t offset,
+    size_t size,
+    const SegmentInfo& segment_info,
+    void* buffer) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      buffer != nullptr, InvalidArgument, "Destination buffer cannot be null");
+  std::optional<FreeableBuffer> prefetched = take_prefetched(offset, size);
+  if (prefetched.has_value()) {
+    std::memcpy(buffer, prefetched->data(), size);
+    return Error::Ok;
+  }
+  return loader_->load_into(offset, size, segment_info, buffer);
+}
+
+Result<size_t> PrefetchingDataLoader::size() const {
+  return loader_->size();
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * A DataLoader that wraps another DataLoader and reads segments ahead of time
+ * on a background thread.
+ *
+ * Callers describe the segments they are about to need with `prefetch()`. A
+ * worker thread then loads them, in order, through the wrapped loader, and
+ * touches every page of the result so that mmap-backed loaders actually pull
+ * the data in from storage. A later `load()` or `load_into()` of exactly the
+ * same range is served from the prefetched buffer (waiting for it if its read
+ * is still in progress); every other request goes straight to the wrapped
+ * loader. This lets disk I/O for one segment overlap with the work the runtime
+ * does on the previous one, e.g. delegate initialization or weight packing.
+ *
+ * To bound memory use, the worker stops reading ahead while the prefetched
+ * but not yet consumed data exceeds `max_in_flight_bytes`. Prefetched segments
+ * that are never loaded keep counting against that budget until this loader
+ * is destroyed.
+ *
+ * Typical use with a Program:
+ *
+ * @code
+ *   PrefetchingDataLoader loader(&file_loader);
+ *   Result<Program> program = Program::load(&loader);
+ *   std::vector<PrefetchingDataLoader::Segment> segments;
+ *   for (size_t i = 0; i < program->num_segments(); ++i) {
+ *     auto location = program->get_segment_location(i);
+ *     segments.push_back(
+ *         {location->offset, location->size, location->segment_info});
+ *   }
+ *   loader.prefetch(segments);
+ *   program->load_method("forward", &memory_manager);
+ * @endcode
+ *
+ * The wrapped loader must support concurrent calls to `load()`, which is the
+ * case for the loaders in this directory. The wrapped loader must outlive this
+ * instance.
+ */
+class PrefetchingDataLoader final : public executorch::runtime::DataLoader {
+ public:
+  /// Default cap on prefetched data that has not been consumed yet.
+  static constexpr size_t kDefaultMaxInFlightBytes = 256 * 1024 * 1024;
+
+  /// A range of the wrapped loader to read ahead of time.
+  struct Segment {
+    /// Offset of the range, in bytes.
+    size_t offset;
+    /// Size of the range, in bytes.
+    size_t size;
+    /// Passed to the wrapped loader when the range is read. For a segment of
+    /// a Program, use the one from `Program::get_segment_location()`.
+    DataLoader::SegmentInfo segment_info =
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::External);
+  };
+
+  /**
+   * Creates a new PrefetchingDataLoader that wraps `loader`.
+   *
+   * @param[in] loader The loader to read from. Must outlive this instance.
+   * @param[in] max_in_flight_bytes The maximum number of prefetched bytes that
+   *     may be waiting to be consumed. A single segment larger than this is
+   *     still prefetched, but only once nothing else is in flight.
+   */
+  explicit PrefetchingDataLoader(
+      executorch::runtime::DataLoader* loader,
+      size_t max_in_flight_bytes = kDefaultMaxInFlightBytes)
+      : loader_(loader), max_in_flight_bytes_(max_in_flight_bytes) {}
+
+  /// Stops the background thread and frees any unconsumed segments.
+  ~PrefetchingDataLoader() override;
+
+  /**
+   * Queues segments to be read in the background, in the given order.
+   *
+   * Segments that were loaded through this instance before the first call
+   * (e.g. the constant segment, which `Program::load()` reads eagerly), or
+   * that are already queued, are skipped. May be called more than once.
+   *
+   * @param[in] segments The ranges to read ahead of time.
+   *
+   * @retval Error::Ok The segments were queued.
+   * @retval Error::InvalidArgument A segment lies outside the wrapped loader.
+   */
+  ET_NODISCARD executorch::runtime::Error prefetch(
+      const std::vector<Segment>& segments);
+
+  ET_NODISCARD
+  executorch::runtime::Result<executorch::runtime::FreeableBuffer> load(
+      size_t offset,
+      size_t size,
+      const DataLoader::SegmentInfo& segment_info) const override;
+
+  ET_NODISCARD executorch::runtime::Error load_into(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info,
+      void* buffer) const override;
+
+  ET_NODISCARD executorch::runtime::Result<size_t> size() const override;
+
+ private:
+  enum class State {
+    /// Queued; the worker has not started reading it.
+    Pending,
+    /// The worker is reading it.
+    Loading,
+    /// Read successfully and waiting to be consumed.
+    Ready,
+    /// Consumed, abandoned, or failed to load; requests go to the loader.
+    Done,
+  };
+
+  struct Entry {
+    Segment segment;
+    State state;
+    std::optional<executorch::runtime::FreeableBuffer> buffer;
+  };
+
+  // Not copyable or movable: the worker thread refers to this instance.
+  PrefetchingDataLoader(const PrefetchingDataLoader&) = delete;
+  PrefetchingDataLoader& operator=(const PrefetchingDataLoader&) = delete;
+  PrefetchingDataLoader(PrefetchingDataLoader&&) = delete;
+  PrefetchingDataLoader& operator=(PrefetchingDataLoader&&) = delete;
+
+  /**
+   * Hands over the prefetched buffer for [offset, offset + size), waiting for
+   * an in-progress read to finish. Returns nullopt if the range was not
+   * prefetched and the caller should read it from the wrapped loader.
+   */
+  std::optional<executorch::runtime::FreeableBuffer> take_prefetched(
+      size_t offset,
+      size_t size) const;
+
+  void worker_loop();
+
+  executorch::runtime::DataLoader* const loader_;
+  const size_t max_in_flight_bytes_;
+
+  mutable std::mutex mutex_;
+  mutable std::condition_variable cv_;
+  mutable std::vector<Entry> entries_;
+  /// Maps a segment offset to its index in entries_.
+  mutable std::unordered_map<size_t, size_t> entry_index_;
+  /// Sizes of the ranges that were loaded before the first prefetch(), by
+  /// offset. An entry is dropped once prefetch() has seen its offset, and
+  /// none are added after the first prefetch(), so this only ever holds the
+  /// reads done before prefetching started.
+  mutable std::unordered_map<size_t, size_t> loaded_ranges_;
+  /// Bytes that are being read or are waiting to be consumed.
+  mutable size_t in_flight_bytes_ = 0;
+  size_t next_entry_ = 0;
+  bool stop_ = false;
+  std::thread worker_;
+};
+
+} // namespace extension
+} // namespace executorch
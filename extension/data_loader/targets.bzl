@@ -94,3 +94,17 @@ def define_common_targets():
             "//executorch/runtime/core:core",
         ],
     )
+
+    runtime.cxx_library(
+        name = "prefetching_data_loader",
+        srcs = ["prefetching_data_loader.cpp"],
+        exported_headers = ["prefetching_data_loader.h"],
+        visibility = [
+            "//executorch/test/...",
+            "//executorch/extension/data_loader/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+    )
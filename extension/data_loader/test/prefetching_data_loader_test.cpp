@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/prefetching_data_loader.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/data_loader/buffer_data_loader.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::testing;
+using executorch::extension::BufferDataLoader;
+using executorch::extension::PrefetchingDataLoader;
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+namespace {
+
+// Wraps a BufferDataLoader and counts the calls that reach it.
+class CountingDataLoader final : public DataLoader {
+ public:
+  CountingDataLoader(const void* data, size_t size) : loader_(data, size) {}
+
+  ET_NODISCARD Result<FreeableBuffer> load(
+      size_t offset,
+      size_t size,
+      const DataLoader::SegmentInfo& segment_info) const override {
+    num_loads_++;
+    return loader_.load(offset, size, segment_info);
+  }
+
+  ET_NODISCARD Result<size_t> size() const override {
+    return loader_.size();
+  }
+
+  size_t num_loads() const {
+    return num_loads_;
+  }
+
+ private:
+  BufferDataLoader loader_;
+  mutable std::atomic<size_t> num_loads_{0};
+};
+
+// Waits up to a few seconds for the wrapped loader to see `expected` loads.
+bool wait_for_loads(const CountingDataLoader& loader, size_t expected) {
+  for (int i = 0; i < 500 && loader.num_loads() < expected; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return loader.num_loads() == expected;
+}
+
+} // namespace
+
+class PrefetchingDataLoaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+
+    for (size_t i = 0; i < sizeof(data_); ++i) {
+      data_[i] = static_cast<uint8_t>(i);
+    }
+  }
+
+  uint8_t data_[256];
+};
+
+TEST_F(PrefetchingDataLoaderTest, PrefetchedSegmentsAreServedOnce) {
+  CountingDataLoader inner(data_, sizeof(data_));
+  PrefetchingDataLoader loader(&inner);
+
+  ASSERT_EQ(loader.prefetch({{0, 16}, {16, 32}, {100, 8}}), Error::Ok);
+  EXPECT_TRUE(wait_for_loads(inner, 3));
+
+  // Loading the same ranges returns the prefetched data without touching the
+  // wrapped loader again.
+  for (const auto& range :
+       std::vector<std::pair<size_t, size_t>>{{16, 32}, {0, 16}, {100, 8}}) {
+    Result<FreeableBuffer> fb = loader.load(
+        range.first,
+        range.second,
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend));
+    ASSERT_EQ(fb.error(), Error::Ok);
+    ASSERT_EQ(fb->size(), range.second);
+    EXPECT_EQ(0, std::memcmp(fb->data(), data_ + range.first, range.second));
+  }
+  EXPECT_EQ(inner.num_loads(), 3);
+
+  // A second load of a consumed range goes to the wrapped loader.
+  Result<FreeableBuffer> fb = loader.load(
+      0, 16, DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend));
+  ASSERT_EQ(fb.error(), Error::Ok);
+  EXPECT_EQ(inner.num_loads(), 4);
+}
+
+TEST_F(PrefetchingDataLoaderTest, UnknownRangesPassThrough) {
+  CountingDataLoader inner(data_, sizeof(data_));
+  PrefetchingDataLoader loader(&inner);
+
+  ASSERT_EQ(loader.prefetch({{0, 16}}), Error::Ok);
+  EXPECT_TRUE(wait_for_loads(inner, 1));
+
+  // Same offset but a different size is a different range.
+  Result<FreeableBuffer> fb = loader.load(
+      0, 8, DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+  ASSERT_EQ(fb.error(), Error::Ok);
+  EXPECT_EQ(0, std::memcmp(fb->data(), data_, 8));
+  EXPECT_EQ(inner.num_loads(), 2);
+
+  Result<size_t> size = loader.size();
+  ASSERT_EQ(size.error(), Error::Ok);
+  EXPECT_EQ(*size, sizeof(data_));
+}
+
+TEST_F(PrefetchingDataLoaderTest, LoadIntoUsesPrefetchedData) {
+  CountingDataLoader inner(data_, sizeof(data_));
+  PrefetchingDataLoader loader(&inner);
+
+  ASSERT_EQ(loader.prefetch({{32, 64}}), Error::Ok);
+  EXPECT_TRUE(wait_for_loads(inner, 1));
+
+  uint8_t buffer[64];
+  ASSERT_EQ(
+      loader.load_into(
+          32,
+          sizeof(buffer),
+          DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Mutable),
+          buffer),
+      Error::Ok);
+  EXPECT_EQ(0, std::memcmp(buffer, data_ + 32, sizeof(buffer)));
+  EXPECT_EQ(inner.num_loads(), 1);
+}
+
+TEST_F(PrefetchingDataLoaderTest, InFlightBytesAreBounded) {
+  CountingDataLoader inner(data_, sizeof(data_));
+  // Room for two 32-byte segments.
+  PrefetchingDataLoader loader(&inner, /*max_in_flight_bytes=*/64);
+
+  ASSERT_EQ(
+      loader.prefetch({{0, 32}, {32, 32}, {64, 32}, {96, 32}}), Error::Ok);
+  EXPECT_TRUE(wait_for_loads(inner, 2));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(inner.num_loads(), 2);
+
+  // Consuming a segment lets the next one be read.
+  {
+    Result<FreeableBuffer> fb = loader.load(
+        0, 32, DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend));
+    ASSERT_EQ(fb.error(), Error::Ok);
+  }
+  EXPECT_TRUE(wait_for_loads(inner, 3));
+
+  // Segments the worker has not reached yet are read on demand, and are not
+  // read again by the worker afterwards.
+  {
+    Result<FreeableBuffer> fb = loader.load(
+        96,
+        32,
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend));
+    ASSERT_EQ(fb.error(), Error::Ok);
+    EXPECT_EQ(0, std::memcmp(fb->data(), data_ + 96, 32));
+  }
+  EXPECT_EQ(inner.num_loads(), 4);
+  for (size_t offset : {32, 64}) {
+    Result<FreeableBuffer> fb = loader.load(
+        offset,
+        32,
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend));
+    ASSERT_EQ(fb.error(), Error::Ok);
+    EXPECT_EQ(0, std::memcmp(fb->data(), data_ + offset, 32));
+  }
+  EXPECT_EQ(inner.num_loads(), 4);
+}
+
+TEST_F(PrefetchingDataLoaderTest, SkipsRangesAlreadyLoaded) {
+  CountingDataLoader inner(data_, sizeof(data_));
+  PrefetchingDataLoader loader(&inner);
+
+  Result<FreeableBuffer> fb = loader.load(
+      0, 16, DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Constant));
+  ASSERT_EQ(fb.error(), Error::Ok);
+  EXPECT_EQ(inner.num_loads(), 1);
+
+  ASSERT_EQ(loader.prefetch({{0, 16}, {16, 16}}), Error::Ok);
+  EXPECT_TRUE(wait_for_loads(inner, 2));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(inner.num_loads(), 2);
+
+  // Prefetching the same ranges again reads nothing.
+  ASSERT_EQ(loader.prefetch({{0, 16}, {16, 16}}), Error::Ok);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(inner.num_loads(), 2);
+}
+
+TEST_F(PrefetchingDataLoaderTest, OutOfBoundsPrefetchFails) {
+  CountingDataLoader inner(data_, sizeof(data_));
+  PrefetchingDataLoader loader(&inner);
+
+  EXPECT_EQ(
+      loader.prefetch({{0, 16}, {sizeof(data_) - 8, 16}}),
+      Error::InvalidArgument);
+  EXPECT_EQ(loader.prefetch({{sizeof(data_) + 1, 0}}), Error::InvalidArgument);
+  EXPECT_EQ(inner.num_loads(), 0);
+}
@@ -59,3 +59,14 @@ def define_common_targets():
             "//executorch/extension/data_loader:mmap_data_loader",
         ],
     )
+
+    runtime.cxx_test(
+        name = "prefetching_data_loader_test",
+        srcs = [
+            "prefetching_data_loader_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/data_loader:buffer_data_loader",
+            "//executorch/extension/data_loader:prefetching_data_loader",
+        ],
+    )
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Propose draft tokens for speculative decoding.
+
+#include <executorch/extension/llm/runner/drafter.h>
+
+#include <algorithm>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::runtime::Error;
+
+PromptLookupDrafter::PromptLookupDrafter(
+    int32_t max_ngram_size,
+    int32_t min_ngram_size)
+    : max_ngram_size_(max_ngram_size),
+      min_ngram_size_(std::max<int32_t>(min_ngram_size, 1)) {}
+
+Error PromptLookupDrafter::draft(
+    const std::vector<uint64_t>& tokens,
+    int32_t max_draft_tokens,
+    std::vector<uint64_t>& draft_tokens) {
+  draft_tokens.clear();
+  const int64_t num_tokens = tokens.size();
+  if (max_draft_tokens <= 0) {
+    return Error::Ok;
+  }
+  // Prefer the longest suffix, and the most recent match of it.
+  int64_t max_ngram_size = std::min<int64_t>(max_ngram_size_, num_tokens - 1);
+  for (int64_t n = max_ngram_size; n >= min_ngram_size_; --n) {
+    auto suffix = tokens.end() - n;
+    for (int64_t start = num_tokens - n - 1; start >= 0; --start) {
+      auto match = tokens.begin() + start;
+      if (std::equal(suffix, tokens.end(), match)) {
+        auto end = std::min(match + n + max_draft_tokens, tokens.end());
+        draft_tokens.assign(match + n, end);
+        return Error::Ok;
+      }
+    }
+  }
+  return Error::Ok;
+}
+
+DraftModelDrafter::DraftModelDrafter(
+    TextDecoderRunner* draft_decoder_runner,
+    bool enable_parallel_prefill,
+    int64_t max_seq_len)
+    : draft_decoder_runner_(draft_decoder_runner),
+      draft_prefiller_(
+          draft_decoder_runner,
+          /*use_kv_cache=*/true,
+          enable_parallel_prefill,
+          max_seq_len) {}
+
+Error DraftModelDrafter::draft(
+    const std::vector<uint64_t>& tokens,
+    int32_t max_draft_tokens,
+    std::vector<uint64_t>& draft_tokens) {
+  draft_tokens.clear();
+  if (max_draft_tokens <= 0 || tokens.empty()) {
+    return Error::Ok;
+  }
+
+  // Keep the prefix the draft model has already seen. The last token is
+  // always fed, to get the logits that follow it.
+  auto mismatch = std::mismatch(
+      fed_tokens_.begin(), fed_tokens_.end(), tokens.begin(), tokens.end() - 1);
+  fed_tokens_.erase(mismatch.first, fed_tokens_.end());
+
+  std::vector<uint64_t> new_tokens(mismatch.second, tokens.end());
+  int64_t pos = fed_tokens_.size();
+  // Forget everything in case the draft model fails halfway through.
+  std::vector<uint64_t> fed_tokens = std::move(fed_tokens_);
+  fed_tokens_.clear();
+
+  auto next_token = draft_prefiller_.prefill(new_tokens, pos);
+  ET_CHECK_OK_OR_RETURN_ERROR(next_token.error());
+  fed_tokens.insert(fed_tokens.end(), new_tokens.begin(), new_tokens.end());
+
+  uint64_t cur_token = next_token.get();
+  draft_tokens.push_back(cur_token);
+  auto tokens_managed =
+      from_blob(&cur_token, {1, 1}, executorch::aten::ScalarType::Long);
+  while (draft_tokens.size() < static_cast<size_t>(max_draft_tokens)) {
+    auto logits_res =
+        draft_decoder_runner_->step(tokens_managed, fed_tokens.size());
+    ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
+    fed_tokens.push_back(cur_token);
+    cur_token = draft_decoder_runner_->logits_to_token(logits_res.get());
+    draft_tokens.push_back(cur_token);
+  }
+  fed_tokens_ = std::move(fed_tokens);
+  return Error::Ok;
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
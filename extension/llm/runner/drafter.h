@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Propose draft tokens for speculative decoding.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/llm/runner/text_prefiller.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Proposes tokens that are likely to follow a sequence, for
+ * SpeculativeTokenGenerator to verify against the target model. Drafts must
+ * be deterministic for the verification to preserve the target model's
+ * sampling distribution.
+ */
+class ET_EXPERIMENTAL Drafter {
+ public:
+  virtual ~Drafter() = default;
+
+  /**
+   * Draft the tokens that follow the given sequence.
+   * @param tokens The sequence so far, ending with the last accepted token.
+   * @param max_draft_tokens Maximum number of tokens to draft.
+   * @param draft_tokens Output, cleared and filled with at most
+   * max_draft_tokens tokens. Left empty if there is nothing to propose.
+   * @return The error code.
+   */
+  virtual ::executorch::runtime::Error draft(
+      const std::vector<uint64_t>& tokens,
+      int32_t max_draft_tokens,
+      std::vector<uint64_t>& draft_tokens) = 0;
+};
+
+/**
+ * Drafts by prompt lookup: finds the most recent earlier occurrence of the
+ * last few tokens of the sequence and proposes the tokens that followed it.
+ * This needs no draft model and works well when the output copies from the
+ * prompt, e.g. summarization, code editing or retrieval-augmented answers.
+ */
+class ET_EXPERIMENTAL PromptLookupDrafter : public Drafter {
+ public:
+  /**
+   * @param max_ngram_size Length of the longest suffix to look up.
+   * @param min_ngram_size Length of the shortest suffix to look up.
+   */
+  explicit PromptLookupDrafter(
+      int32_t max_ngram_size = 3,
+      int32_t min_ngram_size = 1);
+
+  ::executorch::runtime::Error draft(
+      const std::vector<uint64_t>& tokens,
+      int32_t max_draft_tokens,
+      std::vector<uint64_t>& draft_tokens) override;
+
+ private:
+  int32_t max_ngram_size_;
+  int32_t min_ngram_size_;
+};
+
+/**
+ * Drafts greedily with a smaller model that shares the tokenizer of the
+ * target model. The draft model keeps its own KV cache. Tokens it has already
+ * seen are not fed again, and positions after a rejected draft are simply
+ * overwritten.
+ */
+class ET_EXPERIMENTAL DraftModelDrafter : public Drafter {
+ public:
+  /**
+   * @param draft_decoder_runner Runs the draft model. Not owned, must outlive
+   * the drafter.
+   * @param enable_parallel_prefill Whether the draft model accepts more than
+   * one token per step.
+   * @param max_seq_len Maximum number of tokens per step of the draft model.
+   */
+  DraftModelDrafter(
+      TextDecoderRunner* draft_decoder_runner,
+      bool enable_parallel_prefill,
+      int64_t max_seq_len = 128);
+
+  ::executorch::runtime::Error draft(
+      const std::vector<uint64_t>& tokens,
+      int32_t max_draft_tokens,
+      std::vector<uint64_t>& draft_tokens) override;
+
+ private:
+  TextDecoderRunner* draft_decoder_runner_;
+  TextPrefiller draft_prefiller_;
+  // The tokens in the draft model's KV cache, by position.
+  std::vector<uint64_t> fed_tokens_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -28,6 +28,11 @@ struct GenerationConfig {
   // Whether to echo the input prompt in the output
   bool echo = true;
 
+  // Whether to skip prefilling the start of the prompt that is already in the
+  // KV cache from the previous generation. Models with a sliding window KV
+  // cache never reuse it.
+  bool reuse_prompt_prefix = true;
+
   // Maximum number of new tokens to generate
   // If the max_context_len metadata that's serialized in the .pte file exists,
   // then the number of prompt tokens + max_new_tokens won't exceed
@@ -49,10 +54,22 @@ struct GenerationConfig {
   // Temperature for sampling (higher = more random)
   float temperature = 0.8f;
 
+  // Number of most likely tokens to sample from, 0 disables top-k filtering.
+  int32_t topk = 0;
+
+  // Minimum probability of a sampled token relative to the most likely one,
+  // 0 disables min-p filtering.
+  float minp = 0.0f;
+
   // Number of eos and bos to add to the prompt
   int32_t num_bos = 0;
   int32_t num_eos = 0;
 
+  // Number of draft tokens to verify per decode step with speculative
+  // decoding, 0 disables it. The runner must have a speculative token
+  // generator, and the model must return the logits of every input token.
+  int32_t num_draft_tokens = 0;
+
   /**
    * Resolve the maximum number of new tokens to generate based on constraints.
    *
@@ -8,7 +8,9 @@
 
 // Implementation of helper utilities for creating and configuring LLM runners
 
+#include <executorch/extension/llm/runner/drafter.h>
 #include <executorch/extension/llm/runner/llm_runner_helper.h>
+#include <executorch/extension/llm/runner/speculative_token_generator.h>
 #include <executorch/extension/llm/runner/stats.h>
 #include <executorch/extension/llm/runner/text_llm_runner.h>
 #include <executorch/extension/llm/runner/text_prefiller.h>
@@ -81,6 +83,7 @@ std::unordered_map<std::string, int64_t> get_llm_metadata(
       {llm::kMaxContextLen, 128},
       {llm::kUseKVCache, true},
       {llm::kUseSDPAWithKVCache, false},
+      {llm::kUseSlidingWindowKVCache, false},
   });
 
   // Read metadata from the model
@@ -185,6 +188,18 @@ std::unique_ptr<TextLLMRunner> create_text_llm_runner(
 
   // Create text_token_generator with stats
   auto stats = std::make_unique<Stats>();
+  // Speculative decoding verifies several tokens per step, which needs a KV
+  // cache model with dynamic shape. Draft by prompt lookup, which needs no
+  // extra model.
+  std::unique_ptr<SpeculativeTokenGenerator> speculative_token_generator;
+  if (metadata.at(kUseKVCache) && metadata.at(kEnableDynamicShape)) {
+    speculative_token_generator = std::make_unique<SpeculativeTokenGenerator>(
+        tokenizer.get(),
+        text_decoder_runner.get(),
+        std::make_unique<PromptLookupDrafter>(),
+        std::make_unique<std::unordered_set<uint64_t>>(*eos_ids),
+        stats.get());
+  }
   auto text_token_generator = std::make_unique<TextTokenGenerator>(
       tokenizer.get(),
       text_decoder_runner.get(),
@@ -193,7 +208,7 @@ std::unique_ptr<TextLLMRunner> create_text_llm_runner(
       stats.get());
 
   // Create and return the Runner instance
-  return std::make_unique<TextLLMRunner>(
+  auto runner = std::make_unique<TextLLMRunner>(
       std::move(metadata),
       std::move(tokenizer),
       std::move(module),
@@ -203,6 +218,9 @@ std::unique_ptr<TextLLMRunner> create_text_llm_runner(
       std::move(text_token_generator),
       std::move(stats),
       temperature);
+  runner->set_speculative_token_generator(
+      std::move(speculative_token_generator));
+  return runner;
 }
 
 } // namespace llm
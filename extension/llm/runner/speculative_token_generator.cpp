@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Generate tokens in a loop, several per step with speculative decoding.
+
+#include <executorch/extension/llm/runner/speculative_token_generator.h>
+
+#include <algorithm>
+
+#include <executorch/extension/llm/runner/util.h>
+#include <executorch/extension/tensor/tensor.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+SpeculativeTokenGenerator::SpeculativeTokenGenerator(
+    ::tokenizers::Tokenizer* tokenizer,
+    TextDecoderRunner* text_decoder_runner,
+    std::unique_ptr<Drafter> drafter,
+    std::unique_ptr<std::unordered_set<uint64_t>>&& eos_ids,
+    Stats* stats)
+    : tokenizer_(tokenizer),
+      text_decoder_runner_(text_decoder_runner),
+      drafter_(std::move(drafter)),
+      eos_ids_(std::move(eos_ids)),
+      stats_(stats) {}
+
+Result<int64_t> SpeculativeTokenGenerator::generate(
+    std::vector<uint64_t> tokens,
+    int64_t start_pos,
+    int32_t max_new_tokens,
+    int32_t num_draft_tokens,
+    float temperature,
+    const std::function<void(const std::string&)>& token_callback,
+    std::vector<uint64_t>* generated_tokens) {
+  ET_CHECK_MSG(
+      !tokens.empty(), "Token generation loop shouldn't take empty tokens");
+  int64_t pos = start_pos; // position of tokens.back() in the sequence
+  int64_t num_generated_tokens = 0;
+  int64_t num_drafted_tokens = 0;
+  int64_t num_accepted_tokens = 0;
+
+  std::vector<uint64_t> draft_tokens;
+  std::vector<uint64_t> token_data;
+
+  should_stop_ = false;
+
+  bool done = false;
+  while (!done && num_generated_tokens < max_new_tokens) {
+    // Leave room for the token sampled after the last draft token.
+    int32_t max_draft_tokens = std::min<int64_t>(
+        num_draft_tokens, max_new_tokens - num_generated_tokens - 1);
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        drafter_->draft(tokens, max_draft_tokens, draft_tokens));
+    if (draft_tokens.size() > static_cast<size_t>(max_draft_tokens)) {
+      draft_tokens.resize(max_draft_tokens);
+    }
+    num_drafted_tokens += draft_tokens.size();
+
+    token_data.assign(1, tokens.back());
+    token_data.insert(
+        token_data.end(), draft_tokens.begin(), draft_tokens.end());
+    const int64_t num_input_tokens = token_data.size();
+    auto tokens_managed = from_blob(
+        token_data.data(),
+        {1, static_cast<int>(num_input_tokens)},
+        executorch::aten::ScalarType::Long);
+
+    // Run the model
+    auto logits_res = text_decoder_runner_->step(tokens_managed, pos);
+    ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
+    executorch::aten::Tensor& logits_tensor = logits_res.get();
+    ET_CHECK_OR_RETURN_ERROR(
+        draft_tokens.empty() ||
+            (logits_tensor.dim() == 3 &&
+             logits_tensor.size(1) == num_input_tokens),
+        InvalidProgram,
+        "Speculative decoding needs the logits of all %" PRId64
+        " input tokens, export the model with full logits",
+        num_input_tokens);
+
+    // Sample after each input token, and move on to the next one only while
+    // the draft token fed there is the one that was sampled.
+    for (int64_t i = 0; i < num_input_tokens; ++i) {
+      int64_t position = logits_tensor.dim() == 3
+          ? logits_tensor.size(1) - num_input_tokens + i
+          : 0;
+      uint64_t prev_token = tokens.back();
+
+      stats_->on_sampling_begin();
+      uint64_t cur_token = text_decoder_runner_->logits_to_token(
+          logits_tensor, 0, position, temperature);
+      stats_->on_sampling_end();
+
+      tokens.push_back(cur_token);
+      if (generated_tokens != nullptr) {
+        generated_tokens->push_back(cur_token);
+      }
+      num_generated_tokens++;
+      pos++;
+
+      // print the token as string, decode it with the Tokenizer object
+      if (token_callback) {
+        token_callback(
+            ET_UNWRAP_TOKENIZER(tokenizer_->decode(prev_token, cur_token)));
+      }
+
+      // data-dependent terminating condition: we have n_eos_ number of EOS
+      if (should_stop_ || eos_ids_->find(cur_token) != eos_ids_->end()) {
+        done = true;
+        break;
+      }
+      if (i == num_input_tokens - 1 || cur_token != draft_tokens[i]) {
+        break;
+      }
+      num_accepted_tokens++;
+    }
+  }
+
+  ET_LOG(
+      Info,
+      "Accepted %" PRId64 " of %" PRId64 " draft tokens",
+      num_accepted_tokens,
+      num_drafted_tokens);
+  return num_generated_tokens;
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
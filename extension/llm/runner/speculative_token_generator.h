@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Generate tokens in a loop, several per step with speculative decoding.
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <executorch/extension/llm/runner/drafter.h>
+#include <executorch/extension/llm/runner/stats.h>
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <pytorch/tokenizers/tokenizer.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Token generation loop with speculative decoding. Each step feeds the last
+ * accepted token followed by the tokens proposed by a Drafter to the model in
+ * a single forward pass, then samples after every input position. Draft
+ * tokens are accepted as long as they match what was sampled, so one step
+ * emits between one and num_draft_tokens + 1 tokens.
+ *
+ * Since drafts are deterministic, accepting a draft token exactly when it is
+ * sampled keeps the output distribution of the model, at any temperature.
+ *
+ * The model must accept a variable number of tokens per step and return the
+ * logits of every input position, i.e. be exported with dynamic shape and
+ * full logits. KV cache entries written for rejected draft tokens are left in
+ * place; they lie past the current position and are overwritten by the next
+ * step.
+ */
+class ET_EXPERIMENTAL SpeculativeTokenGenerator {
+ public:
+  SpeculativeTokenGenerator(
+      ::tokenizers::Tokenizer* tokenizer,
+      TextDecoderRunner* text_decoder_runner,
+      std::unique_ptr<Drafter> drafter,
+      std::unique_ptr<std::unordered_set<uint64_t>>&& eos_ids,
+      Stats* stats);
+
+  virtual ~SpeculativeTokenGenerator() = default;
+
+  /**
+   * Token generation loop.
+   * @param tokens prompt tokens as well as the first token generated by
+   * prefill.
+   * @param start_pos the position of the last token in tokens.
+   * @param max_new_tokens Maximum number of new tokens to generate.
+   * @param num_draft_tokens Maximum number of draft tokens to verify per step.
+   * @param temperature controls the randomness of predictions by scaling the
+   * logits before applying softmax.
+   * @param token_callback what to do after a token is generated.
+   * @param generated_tokens if not null, every generated token is appended to
+   * it.
+   * @return how many tokens are generated.
+   */
+  ::executorch::runtime::Result<int64_t> generate(
+      std::vector<uint64_t> tokens,
+      int64_t start_pos,
+      int32_t max_new_tokens,
+      int32_t num_draft_tokens,
+      float temperature = 0.0f,
+      const std::function<void(const std::string&)>& token_callback = {},
+      std::vector<uint64_t>* generated_tokens = nullptr);
+
+  /**
+   * Stop the generation loop.
+   */
+  inline void stop() {
+    should_stop_ = true;
+  }
+
+  /**
+   * Load the necessary resources for SpeculativeTokenGenerator.
+   * This method should be called before using the generate() method.
+   */
+  ::executorch::runtime::Error load() {
+    return text_decoder_runner_->load();
+  }
+
+  /**
+   * Check if the SpeculativeTokenGenerator has been successfully loaded.
+   * @return True if the resources are loaded, false otherwise.
+   */
+  bool inline is_loaded() const {
+    return tokenizer_->is_loaded() && text_decoder_runner_->is_method_loaded();
+  }
+
+ private:
+  /**
+   * Note: SpeculativeTokenGenerator does not own the tokenizer_ and
+   * text_decoder_runner_, see TextTokenGenerator.
+   */
+  ::tokenizers::Tokenizer* tokenizer_;
+  TextDecoderRunner* text_decoder_runner_;
+  std::unique_ptr<Drafter> drafter_;
+  std::unique_ptr<std::unordered_set<uint64_t>> eos_ids_;
+
+  // state machine
+  bool should_stop_ = false;
+
+  // stats
+  Stats* stats_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
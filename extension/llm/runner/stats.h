@@ -10,14 +10,31 @@
 #pragma once
 #include <executorch/extension/llm/runner/util.h>
 #include <executorch/runtime/platform/log.h>
+#include <algorithm>
 #include <cinttypes>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace executorch {
 namespace extension {
 namespace llm {
 
+// Per-sequence stats for batched generation, see
+// TextLLMRunner::generate_batch().
+struct ET_EXPERIMENTAL SequenceStats {
+  // Token count from the prompt of this sequence
+  int64_t num_prompt_tokens = 0;
+  // Token count generated for this sequence
+  int64_t num_generated_tokens = 0;
+  // start_ms: When the sequence was admitted into a batch.
+  long start_ms = 0;
+  // first_token_ms: When the first token of this sequence was generated.
+  long first_token_ms = 0;
+  // end_ms: When the sequence hit EOS or its token limit.
+  long end_ms = 0;
+};
+
 struct ET_EXPERIMENTAL Stats {
   // Scaling factor for timestamps - in this case, we use ms.
   const long SCALING_FACTOR_UNITS_PER_SECOND = 1000;
@@ -49,6 +66,9 @@ struct ET_EXPERIMENTAL Stats {
   int64_t num_prompt_tokens;
   // Token count from generated (total - prompt)
   int64_t num_generated_tokens;
+  // One entry per sequence when generating a batch, empty otherwise. The
+  // token counts above are then the totals over all sequences.
+  std::vector<SequenceStats> sequences;
   inline void on_sampling_begin() {
     aggregate_sampling_timer_start_timestamp = time_in_ms();
   }
@@ -75,6 +95,7 @@ struct ET_EXPERIMENTAL Stats {
     aggregate_sampling_time_ms = 0;
     num_prompt_tokens = 0;
     num_generated_tokens = 0;
+    sequences.clear();
     aggregate_sampling_timer_start_timestamp = 0;
   }
 
@@ -156,6 +177,147 @@ inline void print_report(const Stats& stats) {
       stats.num_prompt_tokens + stats.num_generated_tokens,
       (double)stats.aggregate_sampling_time_ms /
           stats.SCALING_FACTOR_UNITS_PER_SECOND);
+
+  if (stats.sequences.empty()) {
+    return;
+  }
+  ET_LOG(
+      Info,
+      "\tAggregate over %zu sequences:\t%" PRIu64
+      " tokens\t\t Rate: \t%f (tokens/second)",
+      stats.sequences.size(),
+      stats.num_generated_tokens,
+      inference_time_ms > 0 ? stats.num_generated_tokens / inference_time_ms *
+              stats.SCALING_FACTOR_UNITS_PER_SECOND
+                            : 0);
+  for (size_t i = 0; i < stats.sequences.size(); ++i) {
+    const SequenceStats& seq = stats.sequences[i];
+    double seq_time_ms = (double)(seq.end_ms - seq.start_ms);
+    ET_LOG(
+        Info,
+        "\t\tSequence %zu: %" PRIu64 " prompt, %" PRIu64
+        " generated tokens:\t%f (seconds)\t\t Rate: \t%f (tokens/second)",
+        i,
+        seq.num_prompt_tokens,
+        seq.num_generated_tokens,
+        seq_time_ms / stats.SCALING_FACTOR_UNITS_PER_SECOND,
+        seq_time_ms > 0 ? seq.num_generated_tokens / seq_time_ms *
+                stats.SCALING_FACTOR_UNITS_PER_SECOND
+                        : 0);
+  }
+}
+
+// Rate at which the prompt was evaluated, in tokens/second.
+inline double prompt_eval_tokens_per_second(const Stats& stats) {
+  double prompt_eval_time =
+      (double)(stats.prompt_eval_end_ms - stats.inference_start_ms);
+  return prompt_eval_time > 0 ? stats.num_prompt_tokens / prompt_eval_time *
+          stats.SCALING_FACTOR_UNITS_PER_SECOND
+                              : 0;
+}
+
+// Rate at which tokens were generated after the prompt, in tokens/second.
+inline double generated_tokens_per_second(const Stats& stats) {
+  double eval_time =
+      (double)(stats.inference_end_ms - stats.prompt_eval_end_ms);
+  return eval_time > 0 ? stats.num_generated_tokens / eval_time *
+          stats.SCALING_FACTOR_UNITS_PER_SECOND
+                       : 0;
+}
+
+// Distribution of one metric over the runs of a benchmark.
+struct ET_EXPERIMENTAL MetricSummary {
+  double min = 0;
+  double mean = 0;
+  double p50 = 0;
+  double max = 0;
+};
+
+inline MetricSummary summarize_metric(std::vector<double> values) {
+  MetricSummary summary;
+  if (values.empty()) {
+    return summary;
+  }
+  std::sort(values.begin(), values.end());
+  double sum = 0;
+  for (double value : values) {
+    sum += value;
+  }
+  summary.min = values.front();
+  summary.mean = sum / values.size();
+  summary.p50 = values[(values.size() - 1) / 2];
+  summary.max = values.back();
+  return summary;
+}
+
+// Summary of the Stats of repeated generate() calls.
+struct ET_EXPERIMENTAL BenchmarkSummary {
+  size_t num_runs = 0;
+  MetricSummary prompt_eval_tokens_per_second;
+  MetricSummary generated_tokens_per_second;
+  MetricSummary time_to_first_token_ms;
+};
+
+inline BenchmarkSummary summarize_benchmark(const std::vector<Stats>& runs) {
+  std::vector<double> prompt_rates;
+  std::vector<double> generation_rates;
+  std::vector<double> first_token_times;
+  for (const Stats& stats : runs) {
+    prompt_rates.push_back(prompt_eval_tokens_per_second(stats));
+    generation_rates.push_back(generated_tokens_per_second(stats));
+    first_token_times.push_back(
+        (double)(stats.first_token_ms - stats.inference_start_ms));
+  }
+  BenchmarkSummary summary;
+  summary.num_runs = runs.size();
+  summary.prompt_eval_tokens_per_second = summarize_metric(prompt_rates);
+  summary.generated_tokens_per_second = summarize_metric(generation_rates);
+  summary.time_to_first_token_ms = summarize_metric(first_token_times);
+  return summary;
+}
+
+inline std::string benchmark_summary_to_json_string(
+    const BenchmarkSummary& summary) {
+  auto metric_to_json = [](const MetricSummary& metric) {
+    std::stringstream ss;
+    ss << "{\"min\":" << metric.min << "," << "\"mean\":" << metric.mean
+       << "," << "\"p50\":" << metric.p50 << "," << "\"max\":" << metric.max
+       << "}";
+    return ss.str();
+  };
+  std::stringstream ss;
+  ss << "{\"num_runs\":" << summary.num_runs << ","
+     << "\"prompt_eval_tokens_per_second\":"
+     << metric_to_json(summary.prompt_eval_tokens_per_second) << ","
+     << "\"generated_tokens_per_second\":"
+     << metric_to_json(summary.generated_tokens_per_second) << ","
+     << "\"time_to_first_token_ms\":"
+     << metric_to_json(summary.time_to_first_token_ms) << "}";
+  return ss.str();
+}
+
+inline void print_benchmark_report(const BenchmarkSummary& summary) {
+  printf(
+      "PyTorchObserverBenchmark %s\n",
+      benchmark_summary_to_json_string(summary).c_str());
+
+  auto log_metric = [](const char* name, const MetricSummary& metric) {
+    ET_LOG(
+        Info,
+        "\t%s:\tmin %f\tmean %f\tp50 %f\tmax %f",
+        name,
+        metric.min,
+        metric.mean,
+        metric.p50,
+        metric.max);
+  };
+  ET_LOG(Info, "\tBenchmark over %zu runs:", summary.num_runs);
+  log_metric(
+      "Prompt evaluation (tokens/second)",
+      summary.prompt_eval_tokens_per_second);
+  log_metric(
+      "Generation (tokens/second)", summary.generated_tokens_per_second);
+  log_metric("Time to first token (ms)", summary.time_to_first_token_ms);
 }
 
 } // namespace llm
@@ -167,6 +329,7 @@ namespace llm {
 // TODO(T197294990): Remove these deprecated aliases once all users have moved
 // to the new `::executorch` namespaces.
 using ::executorch::extension::llm::print_report;
+using ::executorch::extension::llm::SequenceStats;
 using ::executorch::extension::llm::Stats;
 } // namespace llm
 } // namespace executorch
@@ -18,6 +18,15 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "test_stats",
+        srcs = ["test_stats.cpp"],
+        deps = [
+            "//executorch/extension/llm/runner:stats",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
+
     runtime.cxx_test(
         name = "test_text_llm_runner",
         srcs = ["test_text_llm_runner.cpp"],
@@ -36,3 +45,12 @@ def define_common_targets():
             "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
         ],
     )
+
+    runtime.cxx_test(
+        name = "test_speculative_token_generator",
+        srcs = ["test_speculative_token_generator.cpp"],
+        deps = [
+            "//executorch/extension/llm/runner:speculative_token_generator",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+        ],
+    )
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ * @lint-ignore-every CLANGTIDY facebook-hte-Deprecated
+ */
+
+#include <executorch/extension/llm/runner/drafter.h>
+#include <executorch/extension/llm/runner/speculative_token_generator.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::llm::DraftModelDrafter;
+using executorch::extension::llm::PromptLookupDrafter;
+using executorch::extension::llm::SpeculativeTokenGenerator;
+using executorch::extension::llm::Stats;
+using executorch::extension::llm::TextDecoderRunner;
+using executorch::runtime::Error;
+using executorch::runtime::Result;
+using executorch::runtime::testing::TensorFactory;
+
+class MockTokenizer : public ::tokenizers::Tokenizer {
+ public:
+  MOCK_METHOD(::tokenizers::Error, load, (const std::string&), ());
+  MOCK_METHOD(bool, is_loaded, (), (const));
+  MOCK_METHOD(
+      ::tokenizers::Result<std::vector<uint64_t>>,
+      encode,
+      (const std::string&, int8_t, int8_t),
+      (const));
+  MOCK_METHOD(
+      ::tokenizers::Result<std::string>,
+      decode,
+      (uint64_t, uint64_t),
+      (const));
+  MOCK_METHOD(uint64_t, bos_tok, (), (const));
+  MOCK_METHOD(uint64_t, eos_tok, (), (const));
+  MOCK_METHOD(uint64_t, vocab_size, (), (const));
+};
+
+class MockTextDecoderRunner : public TextDecoderRunner {
+ public:
+  MockTextDecoderRunner() : TextDecoderRunner(nullptr, nullptr) {}
+  MOCK_METHOD(
+      Result<executorch::aten::Tensor>,
+      step,
+      (executorch::extension::TensorPtr&, int64_t),
+      ());
+  MOCK_METHOD(bool, is_method_loaded, (), ());
+  MOCK_METHOD(::executorch::runtime::Error, load, (), ());
+};
+
+class SpeculativeTokenGeneratorTest : public Test {
+ protected:
+  static constexpr int32_t kVocabSize = 8;
+
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+    ON_CALL(tokenizer_, decode).WillByDefault([](uint64_t, uint64_t) {
+      return ::tokenizers::Result<std::string>("token");
+    });
+    // The model predicts (token + 1) % kVocabSize after every input token, and
+    // returns the logits of all of them.
+    ON_CALL(text_decoder_runner_, step)
+        .WillByDefault(
+            [this](executorch::extension::TensorPtr& tokens, int64_t pos) {
+              const auto* data = tokens->const_data_ptr<int64_t>();
+              std::vector<uint64_t> input(data, data + tokens->numel());
+              inputs_.push_back(input);
+              positions_.push_back(pos);
+              std::vector<float> logits(input.size() * kVocabSize, 0.0f);
+              for (size_t i = 0; i < input.size(); ++i) {
+                logits[i * kVocabSize + (input[i] + 1) % kVocabSize] = 1.0f;
+              }
+              return Result<executorch::aten::Tensor>(tf_.make(
+                  {1, static_cast<int32_t>(input.size()), kVocabSize},
+                  logits));
+            });
+  }
+
+  NiceMock<MockTokenizer> tokenizer_;
+  NiceMock<MockTextDecoderRunner> text_decoder_runner_;
+  Stats stats_;
+  TensorFactory<executorch::aten::ScalarType::Float> tf_;
+  std::vector<std::vector<uint64_t>> inputs_;
+  std::vector<int64_t> positions_;
+};
+
+// Test that the drafter proposes what followed the most recent earlier
+// occurrence of the longest suffix it can find
+TEST(PromptLookupDrafterTest, DraftsFromEarlierOccurrence) {
+  PromptLookupDrafter drafter;
+  std::vector<uint64_t> draft_tokens;
+
+  EXPECT_EQ(drafter.draft({1, 2, 3, 4, 5, 2, 3}, 3, draft_tokens), Error::Ok);
+  EXPECT_THAT(draft_tokens, ElementsAre(4, 5, 2));
+
+  EXPECT_EQ(drafter.draft({1, 2, 3, 4, 5, 2, 3}, 1, draft_tokens), Error::Ok);
+  EXPECT_THAT(draft_tokens, ElementsAre(4));
+
+  // {9, 3} appears later than {2, 3} but is shorter than the {8, 2, 3} match.
+  EXPECT_EQ(
+      drafter.draft({8, 2, 3, 7, 9, 3, 6, 8, 2, 3}, 2, draft_tokens),
+      Error::Ok);
+  EXPECT_THAT(draft_tokens, ElementsAre(7, 9));
+
+  EXPECT_EQ(drafter.draft({1, 2, 3}, 3, draft_tokens), Error::Ok);
+  EXPECT_TRUE(draft_tokens.empty());
+}
+
+// Test that matching drafts are all accepted, plus the token sampled after the
+// last one
+TEST_F(SpeculativeTokenGeneratorTest, AcceptsMatchingDraftTokens) {
+  SpeculativeTokenGenerator generator(
+      &tokenizer_,
+      &text_decoder_runner_,
+      std::make_unique<PromptLookupDrafter>(),
+      std::make_unique<std::unordered_set<uint64_t>>(
+          std::unordered_set<uint64_t>{100}),
+      &stats_);
+
+  std::vector<uint64_t> generated_tokens;
+  int callback_count = 0;
+  auto num_generated = generator.generate(
+      {0, 1, 2, 3, 4, 5, 6, 7, 0, 1},
+      /*start_pos=*/9,
+      /*max_new_tokens=*/8,
+      /*num_draft_tokens=*/3,
+      /*temperature=*/0.0f,
+      [&callback_count](const std::string&) { callback_count++; },
+      &generated_tokens);
+
+  ASSERT_EQ(num_generated.error(), Error::Ok);
+  EXPECT_EQ(num_generated.get(), 8);
+  EXPECT_EQ(callback_count, 8);
+  EXPECT_THAT(generated_tokens, ElementsAre(2, 3, 4, 5, 6, 7, 0, 1));
+  // Each step verifies 3 draft tokens and emits 4.
+  ASSERT_EQ(inputs_.size(), 2);
+  EXPECT_THAT(inputs_[0], ElementsAre(1, 2, 3, 4));
+  EXPECT_THAT(inputs_[1], ElementsAre(5, 6, 7, 0));
+  EXPECT_THAT(positions_, ElementsAre(9, 13));
+}
+
+// Test that verification stops at the first draft token that was not sampled,
+// and that the next step continues from there
+TEST_F(SpeculativeTokenGeneratorTest, StopsAtFirstRejectedDraftToken) {
+  SpeculativeTokenGenerator generator(
+      &tokenizer_,
+      &text_decoder_runner_,
+      std::make_unique<PromptLookupDrafter>(),
+      std::make_unique<std::unordered_set<uint64_t>>(
+          std::unordered_set<uint64_t>{100}),
+      &stats_);
+
+  std::vector<uint64_t> generated_tokens;
+  auto num_generated = generator.generate(
+      {5, 6, 7, 5},
+      /*start_pos=*/3,
+      /*max_new_tokens=*/4,
+      /*num_draft_tokens=*/3,
+      /*temperature=*/0.0f,
+      {},
+      &generated_tokens);
+
+  ASSERT_EQ(num_generated.error(), Error::Ok);
+  // 6 and 7 are accepted, 0 is sampled instead of the drafted 5.
+  EXPECT_THAT(generated_tokens, ElementsAre(6, 7, 0, 1));
+  ASSERT_EQ(inputs_.size(), 2);
+  EXPECT_THAT(inputs_[0], ElementsAre(5, 6, 7, 5));
+  EXPECT_THAT(inputs_[1], ElementsAre(0));
+  EXPECT_THAT(positions_, ElementsAre(3, 6));
+}
+
+// Test that the draft model only sees tokens it has not processed yet
+TEST_F(SpeculativeTokenGeneratorTest, DraftModelReusesItsKVCache) {
+  ON_CALL(text_decoder_runner_, is_method_loaded())
+      .WillByDefault(Return(true));
+  DraftModelDrafter drafter(
+      &text_decoder_runner_, /*enable_parallel_prefill=*/true);
+  std::vector<uint64_t> draft_tokens;
+
+  EXPECT_EQ(drafter.draft({5, 6}, 3, draft_tokens), Error::Ok);
+  EXPECT_THAT(draft_tokens, ElementsAre(7, 0, 1));
+  // The draft model has now seen {5, 6, 7, 0}. The target accepted 7 but
+  // sampled 4 instead of 0.
+  EXPECT_EQ(drafter.draft({5, 6, 7, 4}, 2, draft_tokens), Error::Ok);
+  EXPECT_THAT(draft_tokens, ElementsAre(5, 6));
+
+  ASSERT_EQ(inputs_.size(), 5);
+  EXPECT_THAT(inputs_[0], ElementsAre(5, 6));
+  EXPECT_THAT(inputs_[3], ElementsAre(4));
+  EXPECT_THAT(positions_, ElementsAre(0, 2, 3, 3, 4));
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/stats.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::llm::BenchmarkSummary;
+using executorch::extension::llm::benchmark_summary_to_json_string;
+using executorch::extension::llm::generated_tokens_per_second;
+using executorch::extension::llm::prompt_eval_tokens_per_second;
+using executorch::extension::llm::Stats;
+using executorch::extension::llm::summarize_benchmark;
+using executorch::extension::llm::summarize_metric;
+
+class StatsTest : public Test {
+ protected:
+  // Stats of a run that evaluates 100 prompt tokens in `prompt_ms` and then
+  // generates 50 tokens in `generation_ms`.
+  static Stats make_stats(long prompt_ms, long generation_ms) {
+    Stats stats;
+    stats.reset(/*all_stats=*/true);
+    stats.inference_start_ms = 1000;
+    stats.prompt_eval_end_ms = 1000 + prompt_ms;
+    stats.first_token_ms = 1000 + prompt_ms;
+    stats.inference_end_ms = 1000 + prompt_ms + generation_ms;
+    stats.num_prompt_tokens = 100;
+    stats.num_generated_tokens = 50;
+    return stats;
+  }
+};
+
+TEST_F(StatsTest, TokensPerSecond) {
+  Stats stats = make_stats(/*prompt_ms=*/200, /*generation_ms=*/1000);
+  EXPECT_DOUBLE_EQ(prompt_eval_tokens_per_second(stats), 500);
+  EXPECT_DOUBLE_EQ(generated_tokens_per_second(stats), 50);
+
+  // Empty intervals don't divide by zero.
+  Stats empty = make_stats(/*prompt_ms=*/0, /*generation_ms=*/0);
+  EXPECT_EQ(prompt_eval_tokens_per_second(empty), 0);
+  EXPECT_EQ(generated_tokens_per_second(empty), 0);
+}
+
+TEST_F(StatsTest, SummarizeMetric) {
+  auto summary = summarize_metric({4, 1, 3, 2});
+  EXPECT_EQ(summary.min, 1);
+  EXPECT_EQ(summary.mean, 2.5);
+  EXPECT_EQ(summary.p50, 2);
+  EXPECT_EQ(summary.max, 4);
+
+  auto empty = summarize_metric({});
+  EXPECT_EQ(empty.min, 0);
+  EXPECT_EQ(empty.max, 0);
+}
+
+TEST_F(StatsTest, SummarizeBenchmark) {
+  std::vector<Stats> runs;
+  runs.push_back(make_stats(/*prompt_ms=*/100, /*generation_ms=*/500));
+  runs.push_back(make_stats(/*prompt_ms=*/200, /*generation_ms=*/1000));
+  runs.push_back(make_stats(/*prompt_ms=*/400, /*generation_ms=*/2000));
+
+  BenchmarkSummary summary = summarize_benchmark(runs);
+  EXPECT_EQ(summary.num_runs, 3);
+  EXPECT_DOUBLE_EQ(summary.prompt_eval_tokens_per_second.min, 250);
+  EXPECT_DOUBLE_EQ(summary.prompt_eval_tokens_per_second.p50, 500);
+  EXPECT_DOUBLE_EQ(summary.prompt_eval_tokens_per_second.max, 1000);
+  EXPECT_DOUBLE_EQ(summary.generated_tokens_per_second.min, 25);
+  EXPECT_DOUBLE_EQ(summary.generated_tokens_per_second.max, 100);
+  EXPECT_DOUBLE_EQ(summary.time_to_first_token_ms.p50, 200);
+
+  std::string json = benchmark_summary_to_json_string(summary);
+  EXPECT_NE(json.find("\"num_runs\":3"), std::string::npos);
+  EXPECT_NE(
+      json.find("\"generated_tokens_per_second\":{\"min\":25,"),
+      std::string::npos);
+}
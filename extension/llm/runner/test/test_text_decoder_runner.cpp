@@ -119,6 +119,19 @@ TEST_F(TextDecoderRunnerTest, LogitsToTokenWithTemperature) {
   EXPECT_LT(token, 4);
 }
 
+// Test that set_sampling_options() applies top-k filtering to logits_to_token()
+TEST_F(TextDecoderRunnerTest, LogitsToTokenWithTopK) {
+  TensorFactory<executorch::aten::ScalarType::Float> tf_float;
+  runner_->set_sampling_options(/*topk=*/1, /*minp=*/0.0f);
+
+  for (int i = 0; i < 10; i++) {
+    // Sampling overwrites the logits with probabilities, so make them anew.
+    auto logits = tf_float.make({1, 4}, {0.1f, 0.2f, 0.8f, 0.4f});
+    // With top-k of 1, only the most likely token (index 2) can be sampled
+    EXPECT_EQ(runner_->logits_to_token(logits, 1.0f), 2);
+  }
+}
+
 // Test step() method with all available PTE models
 TEST_F(TextDecoderRunnerTest, StepWithAllModels) {
   // List of all environment variables for PTE models
@@ -70,6 +70,12 @@ class MockTextDecoderRunner : public TextDecoderRunner {
       step,
       (executorch::extension::TensorPtr&, int64_t),
       ());
+  MOCK_METHOD(
+      Result<executorch::aten::Tensor>,
+      step_batch,
+      (executorch::extension::TensorPtr&, const std::vector<int64_t>&),
+      ());
+  MOCK_METHOD(bool, has_per_sequence_positions, (), ());
   MOCK_METHOD(bool, is_method_loaded, (), ());
   MOCK_METHOD(Result<uint64_t>, prefill, (std::vector<uint64_t>&, int64_t), ());
   MOCK_METHOD(::executorch::runtime::Error, load, (), ());
@@ -381,3 +387,430 @@ TEST_F(RunnerTest, GenerateFromPosErrorsWithNegativeMaxNewTokens) {
   // Verify that an InvalidArgument error is returned
   EXPECT_EQ(err, Error::InvalidArgument);
 }
+
+// Test that generate_batch() runs every prompt, batch_size at a time, and
+// reports per-sequence stats
+TEST_F(RunnerTest, GenerateBatchRunsAllPromptsInBatches) {
+  auto tokenizer = createMockTokenizer();
+  auto text_decoder_runner = createMockTextDecoderRunner();
+  auto text_prefiller = createMockTextPrefiller(text_decoder_runner.get());
+
+  // Return one row of logits per sequence in the batch.
+  std::vector<float> batch_logits = {
+      0.1f, 0.2f, 0.3f, 0.4f, 0.1f, 0.2f, 0.3f, 0.4f};
+  executorch::aten::Tensor batch_tensor = tf.make({2, 4}, batch_logits);
+  std::vector<int64_t> positions;
+  EXPECT_CALL(*text_decoder_runner, step(_, _))
+      .WillRepeatedly([&](executorch::extension::TensorPtr& tokens,
+                          int64_t start_pos) {
+        EXPECT_EQ(tokens->size(0), 2);
+        EXPECT_EQ(tokens->size(1), 1);
+        positions.push_back(start_pos);
+        return Result<executorch::aten::Tensor>(batch_tensor);
+      });
+
+  std::unique_ptr<executorch::llm::Stats> stats =
+      std::make_unique<executorch::llm::Stats>();
+  auto text_token_generator = createTextTokenGenerator(
+      tokenizer.get(), text_decoder_runner.get(), stats.get());
+
+  TextLLMRunner runner(
+      createDefaultMetadata(),
+      std::unique_ptr<::tokenizers::Tokenizer>(tokenizer.release()),
+      std::make_unique<MockModule>(),
+      std::move(text_decoder_runner),
+      std::unique_ptr<::executorch::extension::llm::TextPrefiller>(
+          text_prefiller.release()),
+      std::make_unique<executorch::extension::llm::IOManager>(),
+      std::move(text_token_generator),
+      std::move(stats));
+
+  GenerationConfig config;
+  config.max_new_tokens = 5;
+  config.temperature = 0.0f;
+  config.warming = true;
+
+  std::vector<int> counts(3);
+  int64_t num_sequences = 0;
+  int64_t num_generated_tokens = 0;
+  Error err = runner.generate_batch(
+      {"a", "b", "c"},
+      config,
+      /*batch_size=*/2,
+      [&counts](size_t i, const std::string&) { counts[i]++; },
+      [&](const Stats& stats) {
+        num_sequences = stats.sequences.size();
+        num_generated_tokens = stats.num_generated_tokens;
+      });
+
+  EXPECT_EQ(err, Error::Ok);
+  EXPECT_THAT(counts, ElementsAre(5, 5, 5));
+  EXPECT_EQ(num_sequences, 3);
+  EXPECT_EQ(num_generated_tokens, 15);
+  // Two batches of 3 prompt tokens and 4 fed back generated tokens each, both
+  // starting from position 0.
+  ASSERT_EQ(positions.size(), 14);
+  EXPECT_EQ(positions[0], 0);
+  EXPECT_EQ(positions[6], 6);
+  EXPECT_EQ(positions[7], 0);
+}
+
+// Test that TextTokenGenerator::generate_batch() tracks prompt length and EOS
+// per sequence
+TEST_F(RunnerTest, GenerateBatchStopsSequencesIndependently) {
+  auto tokenizer = createMockTokenizer();
+  auto text_decoder_runner = createMockTextDecoderRunner();
+
+  // Sequence 0 always samples token 3, which is EOS, sequence 1 samples 1.
+  std::vector<float> batch_logits = {
+      0.1f, 0.2f, 0.3f, 0.4f, 0.1f, 0.4f, 0.3f, 0.2f};
+  executorch::aten::Tensor batch_tensor = tf.make({2, 4}, batch_logits);
+  std::vector<std::vector<uint64_t>> fed;
+  EXPECT_CALL(*text_decoder_runner, step(_, _))
+      .WillRepeatedly([&](executorch::extension::TensorPtr& tokens, int64_t) {
+        const auto* data = tokens->const_data_ptr<int64_t>();
+        fed.push_back({static_cast<uint64_t>(data[0]),
+                       static_cast<uint64_t>(data[1])});
+        return Result<executorch::aten::Tensor>(batch_tensor);
+      });
+
+  Stats stats;
+  TextTokenGenerator generator(
+      tokenizer.get(),
+      text_decoder_runner.get(),
+      true, // use_kv_cache
+      std::make_unique<std::unordered_set<uint64_t>>(
+          std::unordered_set<uint64_t>{3}),
+      &stats);
+
+  std::vector<std::vector<uint64_t>> sequences = {{7, 8, 9}, {5}};
+  std::vector<executorch::extension::llm::SequenceStats> sequence_stats;
+  auto steps = generator.generate_batch(
+      sequences, 0, {10, 4}, 0.0f, {}, sequence_stats);
+
+  ASSERT_EQ(steps.error(), Error::Ok);
+  // Sequence 1 feeds 1 prompt and 3 generated tokens.
+  EXPECT_EQ(steps.get(), 4);
+  EXPECT_THAT(sequences[0], ElementsAre(7, 8, 9, 3));
+  EXPECT_THAT(sequences[1], ElementsAre(5, 1, 1, 1, 1));
+  // Sequence 0 keeps feeding its prompt, then repeats EOS once finished.
+  ASSERT_EQ(fed.size(), 4);
+  EXPECT_THAT(fed[0], ElementsAre(7, 5));
+  EXPECT_THAT(fed[1], ElementsAre(8, 1));
+  EXPECT_THAT(fed[2], ElementsAre(9, 1));
+  EXPECT_THAT(fed[3], ElementsAre(3, 1));
+  ASSERT_EQ(sequence_stats.size(), 2);
+  EXPECT_EQ(sequence_stats[0].num_prompt_tokens, 3);
+  EXPECT_EQ(sequence_stats[0].num_generated_tokens, 1);
+  EXPECT_EQ(sequence_stats[1].num_generated_tokens, 4);
+}
+
+// Test that TextTokenGenerator::generate_batch() feeds the prompt tokens that
+// all sequences still have to feed in one step
+TEST_F(RunnerTest, GenerateBatchPrefillsCommonPromptLength) {
+  auto tokenizer = createMockTokenizer();
+  auto text_decoder_runner = createMockTextDecoderRunner();
+
+  std::vector<float> batch_logits = {
+      0.1f, 0.2f, 0.3f, 0.4f, 0.1f, 0.4f, 0.3f, 0.2f};
+  executorch::aten::Tensor batch_tensor = tf.make({2, 4}, batch_logits);
+  std::vector<int64_t> num_columns;
+  std::vector<int64_t> positions;
+  EXPECT_CALL(*text_decoder_runner, step(_, _))
+      .WillRepeatedly([&](executorch::extension::TensorPtr& tokens,
+                          int64_t start_pos) {
+        num_columns.push_back(tokens->size(1));
+        positions.push_back(start_pos);
+        return Result<executorch::aten::Tensor>(batch_tensor);
+      });
+
+  Stats stats;
+  TextTokenGenerator generator(
+      tokenizer.get(),
+      text_decoder_runner.get(),
+      true, // use_kv_cache
+      std::make_unique<std::unordered_set<uint64_t>>(
+          std::unordered_set<uint64_t>{}),
+      &stats);
+
+  std::vector<std::vector<uint64_t>> sequences = {{7, 8, 9, 10}, {5, 6}};
+  std::vector<executorch::extension::llm::SequenceStats> sequence_stats;
+  auto steps = generator.generate_batch(
+      sequences,
+      0,
+      {2, 2},
+      0.0f,
+      {},
+      sequence_stats,
+      /*max_prefill_tokens=*/8);
+
+  ASSERT_EQ(steps.error(), Error::Ok);
+  EXPECT_EQ(steps.get(), 5);
+  EXPECT_THAT(sequences[0], ElementsAre(7, 8, 9, 10, 3, 3));
+  EXPECT_THAT(sequences[1], ElementsAre(5, 6, 1, 1));
+  // Both prompts are prefilled up to the length of the shorter one, then
+  // sequence 1 samples while sequence 0 feeds the rest of its prompt.
+  EXPECT_THAT(num_columns, ElementsAre(2, 1, 1, 1));
+  EXPECT_THAT(positions, ElementsAre(0, 2, 3, 4));
+}
+
+// Test that TextTokenGenerator::generate_continuous_batch() gives a slot to
+// the next sequence as soon as its sequence ends, at its own positions
+TEST_F(RunnerTest, GenerateContinuousBatchRefillsFinishedSlots) {
+  auto tokenizer = createMockTokenizer();
+  auto text_decoder_runner = createMockTextDecoderRunner();
+
+  // Slot 0 always samples token 3, which is EOS, slot 1 samples 1.
+  std::vector<float> batch_logits = {
+      0.1f, 0.2f, 0.3f, 0.4f, 0.1f, 0.4f, 0.3f, 0.2f};
+  executorch::aten::Tensor batch_tensor = tf.make({2, 4}, batch_logits);
+  std::vector<std::vector<uint64_t>> fed;
+  std::vector<std::vector<int64_t>> positions;
+  EXPECT_CALL(*text_decoder_runner, step_batch(_, _))
+      .WillRepeatedly([&](executorch::extension::TensorPtr& tokens,
+                          const std::vector<int64_t>& start_positions) {
+        const auto* data = tokens->const_data_ptr<int64_t>();
+        fed.push_back({static_cast<uint64_t>(data[0]),
+                       static_cast<uint64_t>(data[1])});
+        positions.push_back(start_positions);
+        return Result<executorch::aten::Tensor>(batch_tensor);
+      });
+
+  Stats stats;
+  TextTokenGenerator generator(
+      tokenizer.get(),
+      text_decoder_runner.get(),
+      true, // use_kv_cache
+      std::make_unique<std::unordered_set<uint64_t>>(
+          std::unordered_set<uint64_t>{3}),
+      &stats);
+
+  std::vector<std::vector<uint64_t>> sequences = {{7}, {5}, {8, 9}};
+  std::vector<executorch::extension::llm::SequenceStats> sequence_stats;
+  auto steps = generator.generate_continuous_batch(
+      sequences, /*batch_size=*/2, {10, 4, 10}, 0.0f, {}, sequence_stats);
+
+  ASSERT_EQ(steps.error(), Error::Ok);
+  EXPECT_EQ(steps.get(), 4);
+  EXPECT_THAT(sequences[0], ElementsAre(7, 3));
+  EXPECT_THAT(sequences[1], ElementsAre(5, 1, 1, 1, 1));
+  EXPECT_THAT(sequences[2], ElementsAre(8, 9, 3));
+  // Sequence 2 takes slot 0 right after sequence 0 hits EOS, and starts over
+  // at position 0 while sequence 1 keeps going. Slot 0 then pads.
+  ASSERT_EQ(fed.size(), 4);
+  EXPECT_THAT(fed[0], ElementsAre(7, 5));
+  EXPECT_THAT(fed[1], ElementsAre(8, 1));
+  EXPECT_THAT(fed[2], ElementsAre(9, 1));
+  EXPECT_THAT(fed[3], ElementsAre(7, 1));
+  EXPECT_THAT(positions[0], ElementsAre(0, 0));
+  EXPECT_THAT(positions[1], ElementsAre(0, 1));
+  EXPECT_THAT(positions[2], ElementsAre(1, 2));
+  EXPECT_THAT(positions[3], ElementsAre(0, 3));
+  ASSERT_EQ(sequence_stats.size(), 3);
+  EXPECT_EQ(sequence_stats[0].num_generated_tokens, 1);
+  EXPECT_EQ(sequence_stats[1].num_generated_tokens, 4);
+  EXPECT_EQ(sequence_stats[2].num_prompt_tokens, 2);
+  EXPECT_EQ(sequence_stats[2].num_generated_tokens, 1);
+}
+
+// Test that generate_batch() batches continuously when the model takes a
+// position per sequence
+TEST_F(RunnerTest, GenerateBatchUsesPerSequencePositions) {
+  auto tokenizer = createMockTokenizer();
+  auto text_decoder_runner = createMockTextDecoderRunner();
+  auto text_prefiller = createMockTextPrefiller(text_decoder_runner.get());
+
+  std::vector<float> batch_logits = {
+      0.1f, 0.2f, 0.3f, 0.4f, 0.1f, 0.2f, 0.3f, 0.4f};
+  executorch::aten::Tensor batch_tensor = tf.make({2, 4}, batch_logits);
+  ON_CALL(*text_decoder_runner, has_per_sequence_positions())
+      .WillByDefault(Return(true));
+  EXPECT_CALL(*text_decoder_runner, step(_, _)).Times(0);
+  int64_t num_steps = 0;
+  EXPECT_CALL(*text_decoder_runner, step_batch(_, _))
+      .WillRepeatedly([&](executorch::extension::TensorPtr&,
+                          const std::vector<int64_t>&) {
+        num_steps++;
+        return Result<executorch::aten::Tensor>(batch_tensor);
+      });
+
+  std::unique_ptr<executorch::llm::Stats> stats =
+      std::make_unique<executorch::llm::Stats>();
+  auto text_token_generator = createTextTokenGenerator(
+      tokenizer.get(), text_decoder_runner.get(), stats.get());
+
+  TextLLMRunner runner(
+      createDefaultMetadata(),
+      std::unique_ptr<::tokenizers::Tokenizer>(tokenizer.release()),
+      std::make_unique<MockModule>(),
+      std::move(text_decoder_runner),
+      std::unique_ptr<::executorch::extension::llm::TextPrefiller>(
+          text_prefiller.release()),
+      std::make_unique<executorch::extension::llm::IOManager>(),
+      std::move(text_token_generator),
+      std::move(stats));
+
+  GenerationConfig config;
+  config.max_new_tokens = 5;
+  config.temperature = 0.0f;
+  config.warming = true;
+
+  std::vector<int> counts(3);
+  int64_t num_sequences = 0;
+  Error err = runner.generate_batch(
+      {"a", "b", "c"},
+      config,
+      /*batch_size=*/2,
+      [&counts](size_t i, const std::string&) { counts[i]++; },
+      [&](const Stats& stats) { num_sequences = stats.sequences.size(); });
+
+  EXPECT_EQ(err, Error::Ok);
+  EXPECT_THAT(counts, ElementsAre(5, 5, 5));
+  EXPECT_EQ(num_sequences, 3);
+  // Prompt "c" takes the first free slot and runs 3 prompt and 4 fed back
+  // generated tokens after the 7 steps of the first two.
+  EXPECT_EQ(num_steps, 14);
+}
+
+// Test that generate() only prefills the part of the prompt that is not
+// already in the KV cache
+TEST_F(RunnerTest, GenerateReusesCachedPromptPrefix) {
+  auto tokenizer = createMockTokenizer();
+  auto text_decoder_runner = createMockTextDecoderRunner();
+  auto text_prefiller = createMockTextPrefiller(text_decoder_runner.get());
+
+  EXPECT_CALL(*tokenizer, encode(_, _, _))
+      .WillOnce(Return(::tokenizers::Result<std::vector<uint64_t>>(
+          std::vector<uint64_t>{1, 2, 3})))
+      .WillOnce(Return(::tokenizers::Result<std::vector<uint64_t>>(
+          std::vector<uint64_t>{1, 2, 3, 4, 3, 9})))
+      .WillOnce(Return(::tokenizers::Result<std::vector<uint64_t>>(
+          std::vector<uint64_t>{1, 2, 7})));
+
+  std::vector<std::vector<uint64_t>> prefilled;
+  std::vector<int64_t> prefill_positions;
+  EXPECT_CALL(*text_prefiller, prefill(_, _))
+      .WillRepeatedly([&](std::vector<uint64_t>& tokens, int64_t& start_pos) {
+        prefilled.push_back(tokens);
+        prefill_positions.push_back(start_pos);
+        return Result<uint64_t>(4);
+      });
+
+  std::unique_ptr<executorch::llm::Stats> stats =
+      std::make_unique<executorch::llm::Stats>();
+  auto text_token_generator = createTextTokenGenerator(
+      tokenizer.get(), text_decoder_runner.get(), stats.get());
+
+  TextLLMRunner runner(
+      createDefaultMetadata(),
+      std::unique_ptr<::tokenizers::Tokenizer>(tokenizer.release()),
+      std::make_unique<MockModule>(),
+      std::move(text_decoder_runner),
+      std::unique_ptr<::executorch::extension::llm::TextPrefiller>(
+          text_prefiller.release()),
+      std::make_unique<executorch::extension::llm::IOManager>(),
+      std::move(text_token_generator),
+      std::move(stats));
+
+  GenerationConfig config;
+  config.max_new_tokens = 3;
+  config.temperature = 0.0f;
+  config.echo = false;
+
+  // Prefill samples 4, then decoding samples 3 twice. The last 3 is never fed
+  // to the model, so the cache holds {1, 2, 3, 4, 3}.
+  EXPECT_EQ(runner.generate("first", config), Error::Ok);
+  EXPECT_EQ(runner.generate("second", config), Error::Ok);
+  EXPECT_EQ(runner.generate("third", config), Error::Ok);
+
+  ASSERT_EQ(prefilled.size(), 3);
+  EXPECT_THAT(prefilled[0], ElementsAre(1, 2, 3));
+  EXPECT_EQ(prefill_positions[0], 0);
+  EXPECT_THAT(prefilled[1], ElementsAre(9));
+  EXPECT_EQ(prefill_positions[1], 5);
+  EXPECT_THAT(prefilled[2], ElementsAre(7));
+  EXPECT_EQ(prefill_positions[2], 2);
+}
+
+// Test that generate() prefills the whole prompt when the model has a sliding
+// window KV cache or prefix reuse is turned off
+TEST_F(RunnerTest, GenerateDoesNotReusePromptPrefixWhenUnsafeOrDisabled) {
+  for (bool sliding_window : {true, false}) {
+    auto tokenizer = createMockTokenizer();
+    auto text_decoder_runner = createMockTextDecoderRunner();
+    auto text_prefiller = createMockTextPrefiller(text_decoder_runner.get());
+
+    EXPECT_CALL(*tokenizer, encode(_, _, _))
+        .WillRepeatedly(Return(::tokenizers::Result<std::vector<uint64_t>>(
+            std::vector<uint64_t>{1, 2, 3})));
+
+    std::vector<std::vector<uint64_t>> prefilled;
+    EXPECT_CALL(*text_prefiller, prefill(_, _))
+        .WillRepeatedly([&](std::vector<uint64_t>& tokens, int64_t&) {
+          prefilled.push_back(tokens);
+          return Result<uint64_t>(4);
+        });
+
+    std::unique_ptr<executorch::llm::Stats> stats =
+        std::make_unique<executorch::llm::Stats>();
+    auto text_token_generator = createTextTokenGenerator(
+        tokenizer.get(), text_decoder_runner.get(), stats.get());
+
+    auto metadata = createDefaultMetadata();
+    metadata["use_sliding_window_kv_cache"] = sliding_window;
+    TextLLMRunner runner(
+        metadata,
+        std::unique_ptr<::tokenizers::Tokenizer>(tokenizer.release()),
+        std::make_unique<MockModule>(),
+        std::move(text_decoder_runner),
+        std::unique_ptr<::executorch::extension::llm::TextPrefiller>(
+            text_prefiller.release()),
+        std::make_unique<executorch::extension::llm::IOManager>(),
+        std::move(text_token_generator),
+        std::move(stats));
+
+    GenerationConfig config;
+    config.max_new_tokens = 3;
+    config.temperature = 0.0f;
+    config.echo = false;
+    config.reuse_prompt_prefix = sliding_window;
+
+    EXPECT_EQ(runner.generate("first", config), Error::Ok);
+    EXPECT_EQ(runner.generate("first", config), Error::Ok);
+
+    ASSERT_EQ(prefilled.size(), 2);
+    EXPECT_THAT(prefilled[0], ElementsAre(1, 2, 3));
+    EXPECT_THAT(prefilled[1], ElementsAre(1, 2, 3));
+  }
+}
+
+// Test that generate() refuses speculative decoding without a speculative
+// token generator
+TEST_F(RunnerTest, GenerateErrorsWithDraftTokensButNoSpeculativeGenerator) {
+  auto tokenizer = createMockTokenizer();
+  auto text_decoder_runner = createMockTextDecoderRunner();
+  auto text_prefiller = createMockTextPrefiller(text_decoder_runner.get());
+
+  std::unique_ptr<executorch::llm::Stats> stats =
+      std::make_unique<executorch::llm::Stats>();
+  auto text_token_generator = createTextTokenGenerator(
+      tokenizer.get(), text_decoder_runner.get(), stats.get());
+
+  TextLLMRunner runner(
+      createDefaultMetadata(),
+      std::unique_ptr<::tokenizers::Tokenizer>(tokenizer.release()),
+      std::make_unique<MockModule>(),
+      std::move(text_decoder_runner),
+      std::unique_ptr<::executorch::extension::llm::TextPrefiller>(
+          text_prefiller.release()),
+      std::make_unique<executorch::extension::llm::IOManager>(),
+      std::move(text_token_generator),
+      std::move(stats));
+
+  GenerationConfig config;
+  config.max_new_tokens = 5;
+  config.echo = false;
+  config.num_draft_tokens = 4;
+
+  EXPECT_EQ(runner.generate("test prompt", config), Error::InvalidArgument);
+}
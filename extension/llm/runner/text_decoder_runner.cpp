@@ -57,41 +57,19 @@ TextDecoderRunner::TextDecoderRunner(Module* module, IOManager* io_manager)
     if (numel > 1) {
       // If we are here, model is exported with cache_positions, create a tensor
       // with the same length as input_ids. Assuming the last dimension is the
-      // one with the variable token length, for example [1, S] or [1, 1, S]
-      sizes_vec[sizes_vec.size() - 1] = tokens->numel();
+      // one with the variable token length, for example [B, S] or [B, 1, S]
+      auto num_tokens = tokens->size(tokens->dim() - 1);
+      sizes_vec[sizes_vec.size() - 1] = num_tokens;
       start_pos_tensor = empty(sizes_vec, ::executorch::aten::ScalarType::Long);
       torch::executor::native::arange_out_impl(
-          start_pos, start_pos + tokens->numel(), 1.0, *start_pos_tensor);
+          start_pos, start_pos + num_tokens, 1.0, *start_pos_tensor);
     } else {
       // Assuming model is exported with input_pos, create a tensor with size 1
       start_pos_tensor = from_blob(
           &start_pos, sizes_vec, ::executorch::aten::ScalarType::Long);
     }
 
-    std::vector<runtime::EValue> inputs;
-    auto method_err = module_->method("forward");
-    ET_CHECK_OK_OR_RETURN_ERROR(method_err.error());
-    auto& method = *(method_err.get());
-
-    auto inputs_res =
-        io_manager_->prepare_decode(tokens, start_pos_tensor, method);
-    ET_CHECK_OK_OR_RETURN_ERROR(inputs_res.error());
-    inputs = inputs_res.get();
-    auto outputs_res = module_->forward(inputs);
-    ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
-
-    auto update_err = io_manager_->update_decode(method, outputs_res.get());
-    ET_CHECK_OK_OR_RETURN_ERROR(update_err);
-
-    ET_CHECK_MSG(
-        outputs_res.get().size() == 1,
-        "More then one output returned from executing LLM.");
-    ET_CHECK_MSG(
-        outputs_res.get()[0].isTensor(),
-        "Non Tensor Output returned from executing LLM");
-
-    // Return the logits tensor
-    return outputs_res.get()[0].toTensor();
+    return run_decode(tokens, start_pos_tensor);
   } else { // no kv cache
     (void)start_pos; // unused
 
@@ -109,6 +87,69 @@ TextDecoderRunner::TextDecoderRunner(Module* module, IOManager* io_manager)
   }
 }
 
+::executorch::runtime::Result<executorch::aten::Tensor>
+TextDecoderRunner::step_batch(
+    TensorPtr& tokens,
+    const std::vector<int64_t>& start_positions) {
+  ET_CHECK_OR_RETURN_ERROR(
+      has_per_sequence_positions(),
+      InvalidState,
+      "The model takes a single position for the whole batch");
+  ET_CHECK_OR_RETURN_ERROR(
+      tokens->dim() == 2 &&
+          static_cast<size_t>(tokens->size(0)) == start_positions.size(),
+      InvalidArgument,
+      "Expected [batch, num_tokens] tokens for %zu sequences",
+      start_positions.size());
+  // Sequence i feeds its tokens at positions start_positions[i],
+  // start_positions[i] + 1, ...
+  const auto batch_size = tokens->size(0);
+  const auto num_tokens = tokens->size(1);
+  TensorPtr positions = empty(
+      {batch_size, num_tokens}, ::executorch::aten::ScalarType::Long);
+  auto* position_data = positions->mutable_data_ptr<int64_t>();
+  for (size_t i = 0; i < start_positions.size(); ++i) {
+    for (int64_t j = 0; j < num_tokens; ++j) {
+      position_data[i * num_tokens + j] = start_positions[i] + j;
+    }
+  }
+  return run_decode(tokens, positions);
+}
+
+bool TextDecoderRunner::has_per_sequence_positions() {
+  auto method_meta = module_->method_meta("forward");
+  if (!method_meta.ok() || method_meta->num_inputs() < 2) {
+    return false;
+  }
+  auto second_input_info = method_meta->input_tensor_meta(1);
+  return second_input_info.ok() && second_input_info->sizes().size() == 2;
+}
+
+::executorch::runtime::Result<executorch::aten::Tensor>
+TextDecoderRunner::run_decode(TensorPtr& tokens, TensorPtr& positions) {
+  auto method_err = module_->method("forward");
+  ET_CHECK_OK_OR_RETURN_ERROR(method_err.error());
+  auto& method = *(method_err.get());
+
+  auto inputs_res = io_manager_->prepare_decode(tokens, positions, method);
+  ET_CHECK_OK_OR_RETURN_ERROR(inputs_res.error());
+  auto outputs_res = module_->forward(inputs_res.get());
+  ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
+
+  auto update_err = io_manager_->update_decode(method, outputs_res.get());
+  ET_CHECK_OK_OR_RETURN_ERROR(update_err);
+
+  ET_CHECK_MSG(
+      outputs_res.get().size() == 1,
+      "More then one output returned from executing LLM.");
+  ET_CHECK_MSG(
+      outputs_res.get()[0].isTensor(),
+      "Non Tensor Output returned from executing LLM");
+
+  // Return the logits tensor
+  return outputs_res.get()[0].toTensor();
+}
+
 } // namespace llm
 } // namespace extension
 } // namespace executorch
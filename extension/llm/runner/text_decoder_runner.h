@@ -16,6 +16,9 @@
 #include <executorch/extension/tensor/tensor.h>
 #include <executorch/runtime/platform/compiler.h>
 
+#include <ctime>
+#include <vector>
+
 namespace executorch {
 namespace extension {
 namespace llm {
@@ -37,6 +40,28 @@ class ET_EXPERIMENTAL TextDecoderRunner {
       TensorPtr& input,
       int64_t start_pos);
 
+  /**
+   * Run LLM text decoder on a batch whose sequences are at different positions
+   * in the KV cache. Requires a model that takes a position per sequence, see
+   * has_per_sequence_positions().
+   * @param input The input to the LLM Module, of shape [batch, num_tokens].
+   * @param start_positions The position in KV cache of the first input token
+   * of each sequence.
+   * @return The output of the LLM Module. This will be a tensor of logits.
+   */
+  virtual ::executorch::runtime::Result<executorch::aten::Tensor> step_batch(
+      TensorPtr& input,
+      const std::vector<int64_t>& start_positions);
+
+  /**
+   * Check if the Module takes the cache positions of every sequence in the
+   * batch, as a [batch, num_tokens] tensor, instead of one position shared by
+   * the whole batch. Only such a Module can run sequences at different
+   * positions, see step_batch().
+   * @return True if the Module takes a position per sequence.
+   */
+  virtual bool has_per_sequence_positions();
+
   /**
    * Load the Module for text decode purpose.
    * @return The error code.
@@ -57,6 +82,19 @@ class ET_EXPERIMENTAL TextDecoderRunner {
     should_stop_ = true;
   }
 
+  /**
+   * Set the top-k and min-p filtering of the tokens sampled by
+   * logits_to_token() with a nonzero temperature.
+   * @param topk The number of most likely tokens to sample from, 0 disables
+   * top-k filtering.
+   * @param minp The minimum probability of a sampled token relative to the
+   * most likely one, 0 disables min-p filtering.
+   */
+  inline void set_sampling_options(int32_t topk, float minp) {
+    sampler_topk_ = topk;
+    sampler_minp_ = minp;
+  }
+
   /**
    * Sample the next token from the logits tensor.
    * @param logits_tensor The logits tensor.
@@ -67,6 +105,42 @@ class ET_EXPERIMENTAL TextDecoderRunner {
   inline int32_t logits_to_token(
       const executorch::aten::Tensor& logits_tensor,
       const float temperature = 0.0f) {
+    return logits_to_token(logits_tensor, /*batch_index=*/0, temperature);
+  }
+
+  /**
+   * Sample the next token of one sequence from a batched logits tensor.
+   * @param logits_tensor The logits tensor, of shape [batch, vocab_size] or
+   * [batch, seq_length, vocab_size].
+   * @param batch_index The sequence within the batch to sample for.
+   * @param temperature The temperature parameter used to control randomness in
+   * sampling.
+   * @return The next token.
+   */
+  inline int32_t logits_to_token(
+      const executorch::aten::Tensor& logits_tensor,
+      size_t batch_index,
+      const float temperature) {
+    int64_t position = logits_tensor.dim() == 3 ? logits_tensor.size(1) - 1 : 0;
+    return logits_to_token(logits_tensor, batch_index, position, temperature);
+  }
+
+  /**
+   * Sample the token that follows one input position of a sequence.
+   * @param logits_tensor The logits tensor, of shape [batch, vocab_size] or
+   * [batch, seq_length, vocab_size].
+   * @param batch_index The sequence within the batch to sample for.
+   * @param position The input position within the sequence to sample after,
+   * must be 0 for a [batch, vocab_size] tensor.
+   * @param temperature The temperature parameter used to control randomness in
+   * sampling.
+   * @return The next token.
+   */
+  inline int32_t logits_to_token(
+      const executorch::aten::Tensor& logits_tensor,
+      size_t batch_index,
+      int64_t position,
+      const float temperature) {
     int32_t result = 0;
     ET_SWITCH_THREE_TYPES(
         Float,
@@ -78,17 +152,39 @@ class ET_EXPERIMENTAL TextDecoderRunner {
         CTYPE,
         [&]() {
           // If the logit_tensor rank is 3, the shape is [batch, seq_length,
-          // vocab_size], get the last logits, sample and return. Else the model
-          // outputs the last logit, directly sample and return.
+          // vocab_size], get the logits at position, sample and return. Else
+          // the model outputs the last logit, directly sample and return.
           auto* logits = logits_tensor.mutable_data_ptr<CTYPE>();
           ssize_t vocab_size = logits_tensor.size(logits_tensor.dim() - 1);
           if (logits_tensor.dim() == 3) {
             auto num_tokens = logits_tensor.size(1);
-            logits += (num_tokens - 1) * vocab_size;
+            logits += (batch_index * num_tokens + position) * vocab_size;
+          } else {
+            logits += batch_index * vocab_size;
+          }
+          // Reuse the sampler, and its scratch buffers, across tokens.
+          if (sampler_ == nullptr || sampler_vocab_size_ != vocab_size ||
+              sampler_temperature_ != temperature ||
+              sampler_built_topk_ != sampler_topk_ ||
+              sampler_built_minp_ != sampler_minp_) {
+            if (sampler_topk_ == 0 && sampler_minp_ == 0.0f) {
+              // @lint-ignore CLANGTIDY facebook-hte-Deprecated
+              sampler_ = std::make_unique<Sampler>(vocab_size, temperature);
+            } else {
+              sampler_ = std::make_unique<Sampler>(
+                  vocab_size,
+                  temperature,
+                  kTopp,
+                  sampler_topk_,
+                  sampler_minp_,
+                  std::time(nullptr));
+            }
+            sampler_vocab_size_ = vocab_size;
+            sampler_temperature_ = temperature;
+            sampler_built_topk_ = sampler_topk_;
+            sampler_built_minp_ = sampler_minp_;
           }
-          // @lint-ignore CLANGTIDY facebook-hte-Deprecated
-          Sampler sampler(vocab_size, temperature);
-          result = sampler.sample(logits);
+          result = sampler_->sample(logits);
         });
     return result;
   }
@@ -104,6 +200,22 @@ class ET_EXPERIMENTAL TextDecoderRunner {
   Module* module_;
   IOManager* io_manager_;
   bool should_stop_{false};
+
+ private:
+  // Runs the decode method with the tokens and their cache positions.
+  ::executorch::runtime::Result<executorch::aten::Tensor> run_decode(
+      TensorPtr& tokens,
+      TensorPtr& positions);
+
+  std::unique_ptr<Sampler> sampler_;
+  ssize_t sampler_vocab_size_ = 0;
+  float sampler_temperature_ = 0.0f;
+  // The filtering set by set_sampling_options(), and the filtering that
+  // sampler_ was created with.
+  int32_t sampler_topk_ = 0;
+  float sampler_minp_ = 0.0f;
+  int32_t sampler_built_topk_ = 0;
+  float sampler_built_minp_ = 0.0f;
 };
 
 } // namespace llm
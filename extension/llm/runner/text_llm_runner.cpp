@@ -10,6 +10,8 @@
 // A simple llama2 runner that includes preprocessing and post processing logic.
 // The module takes in a string as input and emits a string as output.
 
+#include <algorithm>
+
 #include <executorch/extension/llm/runner/io_manager/io_manager.h>
 #include <executorch/extension/llm/runner/text_llm_runner.h>
 #include <executorch/extension/llm/runner/util.h>
@@ -44,6 +46,11 @@ TextLLMRunner::TextLLMRunner(
       text_token_generator_(std::move(text_token_generator)),
       stats_(std::move(stats)),
       temperature_(temperature) {
+  auto use_kv_cache = metadata_.find(kUseKVCache);
+  use_kv_cache_ = use_kv_cache != metadata_.end() && use_kv_cache->second;
+  auto sliding_window = metadata_.find(kUseSlidingWindowKVCache);
+  use_sliding_window_kv_cache_ =
+      sliding_window != metadata_.end() && sliding_window->second;
   // Note: This constructor assumes that text_prefiller and text_token_generator
   // already have references to the Module and TextDecoderRunner they need
 }
@@ -117,6 +124,7 @@ Error TextLLMRunner::generate_from_pos(
 
   stats_->inference_start_ms = time_in_ms();
   shouldStop_ = false;
+  text_decoder_runner_->set_sampling_options(config.topk, config.minp);
 
   ::tokenizers::Result<std::vector<uint64_t>> encode_res = tokenizer_->encode(
       prompt,
@@ -170,8 +178,39 @@ Error TextLLMRunner::generate_from_pos(
   if (config.echo) {
     wrapped_callback(prompt);
   }
-  int64_t pos = start_pos;
-  auto prefill_res = text_prefiller_->prefill(prompt_tokens, pos);
+
+  // Skip the longest prefix of the prompt that is already in the KV cache at
+  // the same positions. At least one token is prefilled to get the logits.
+  // Only a contiguous run of known tokens from position 0 is tracked, so
+  // starting past its end forgets it. A sliding window KV cache overwrites
+  // the oldest positions, so what it holds can't be told from the tokens.
+  bool track_tokens = use_kv_cache_ && !use_sliding_window_kv_cache_ &&
+      config.reuse_prompt_prefix &&
+      start_pos <= static_cast<int64_t>(cached_tokens_.size());
+  int64_t num_cached_tokens = 0;
+  if (track_tokens) {
+    auto mismatch = std::mismatch(
+        prompt_tokens.begin(),
+        prompt_tokens.end() - 1,
+        cached_tokens_.begin() + start_pos,
+        cached_tokens_.end());
+    num_cached_tokens = mismatch.first - prompt_tokens.begin();
+  }
+  // Forget the cached tokens until generation succeeds, in case it fails
+  // halfway through.
+  std::vector<uint64_t> resident_tokens = std::move(cached_tokens_);
+  cached_tokens_.clear();
+  if (num_cached_tokens > 0) {
+    RUNNER_ET_LOG(
+        config.warming,
+        "Reusing %" PRId64 " prompt tokens from the KV cache",
+        num_cached_tokens);
+  }
+
+  std::vector<uint64_t> prefill_tokens(
+      prompt_tokens.begin() + num_cached_tokens, prompt_tokens.end());
+  int64_t pos = start_pos + num_cached_tokens;
+  auto prefill_res = text_prefiller_->prefill(prefill_tokens, pos);
   ET_CHECK_OK_OR_RETURN_ERROR(prefill_res.error());
   uint64_t cur_token = prefill_res.get();
   stats_->first_token_ms = time_in_ms();
@@ -189,12 +228,45 @@ Error TextLLMRunner::generate_from_pos(
   prompt_tokens.push_back(cur_token);
 
   // Generate max_new_tokens - 1 because prefill already generated 1 token.
-  int64_t num_generated_tokens = ET_UNWRAP(text_token_generator_->generate(
-      prompt_tokens,
-      num_prompt_tokens,
-      max_new_tokens - 1,
-      temperature_ == -1.0f ? config.temperature : temperature_,
-      wrapped_callback));
+  std::vector<uint64_t> generated_tokens;
+  float temperature = temperature_ == -1.0f ? config.temperature : temperature_;
+  int64_t num_generated_tokens = 0;
+  if (config.num_draft_tokens > 0) {
+    ET_CHECK_OR_RETURN_ERROR(
+        speculative_token_generator_ != nullptr && use_kv_cache_,
+        InvalidArgument,
+        "Speculative decoding needs a KV cache model and a speculative token generator");
+    num_generated_tokens = ET_UNWRAP(speculative_token_generator_->generate(
+        prompt_tokens,
+        start_pos + num_prompt_tokens,
+        max_new_tokens - 1,
+        config.num_draft_tokens,
+        temperature,
+        wrapped_callback,
+        &generated_tokens));
+  } else {
+    num_generated_tokens = ET_UNWRAP(text_token_generator_->generate(
+        prompt_tokens,
+        start_pos + num_prompt_tokens,
+        max_new_tokens - 1,
+        temperature,
+        wrapped_callback,
+        &generated_tokens));
+  }
+
+  if (track_tokens) {
+    // prompt_tokens ends with the token from prefill. Everything but the last
+    // sampled token has been fed to the model.
+    resident_tokens.resize(start_pos);
+    resident_tokens.insert(
+        resident_tokens.end(), prompt_tokens.begin(), prompt_tokens.end());
+    resident_tokens.insert(
+        resident_tokens.end(),
+        generated_tokens.begin(),
+        generated_tokens.end());
+    resident_tokens.pop_back();
+    cached_tokens_ = std::move(resident_tokens);
+  }
 
   stats_->inference_end_ms = time_in_ms();
   if (!config.warming) {
@@ -232,6 +304,150 @@ Error TextLLMRunner::generate(
   return generate_from_pos(prompt, 0, config, token_callback, stats_callback);
 }
 
+Error TextLLMRunner::generate_batch(
+    const std::vector<std::string>& prompts,
+    const GenerationConfig& config,
+    int32_t batch_size,
+    std::function<void(size_t, const std::string&)> token_callback,
+    std::function<void(const Stats&)> stats_callback) {
+  ET_CHECK_OR_RETURN_ERROR(
+      !prompts.empty(), InvalidArgument, "Expected at least 1 prompt");
+  ET_CHECK_OR_RETURN_ERROR(
+      batch_size > 0,
+      InvalidArgument,
+      "Batch size %" PRId32 " must be positive",
+      batch_size);
+  if (!is_loaded()) {
+    stats_->model_load_start_ms = time_in_ms();
+    ET_CHECK_OK_OR_RETURN_ERROR(load());
+    stats_->model_load_end_ms = time_in_ms();
+  }
+
+  stats_->inference_start_ms = time_in_ms();
+  stats_->first_token_ms = 0;
+  stats_->num_prompt_tokens = 0;
+  stats_->num_generated_tokens = 0;
+  stats_->sequences.clear();
+  shouldStop_ = false;
+  text_decoder_runner_->set_sampling_options(config.topk, config.minp);
+  // Batches overwrite the KV cache rows a single sequence runs in.
+  cached_tokens_.clear();
+
+  int64_t max_context_len = metadata_.at(kMaxContextLen);
+  std::vector<std::vector<uint64_t>> prompt_tokens;
+  std::vector<int32_t> max_new_tokens;
+  prompt_tokens.reserve(prompts.size());
+  max_new_tokens.reserve(prompts.size());
+  for (const auto& prompt : prompts) {
+    ::tokenizers::Result<std::vector<uint64_t>> encode_res = tokenizer_->encode(
+        prompt,
+        /*bos=*/config.num_bos,
+        /*eos=*/config.num_eos);
+    ET_CHECK_TK_OK_OR_RETURN_ERROR(
+        encode_res.error(), "Failed to encode prompt %s", prompt.c_str());
+    prompt_tokens.push_back(encode_res.get());
+
+    int num_prompt_tokens = prompt_tokens.back().size();
+    ET_CHECK_OR_RETURN_ERROR(
+        num_prompt_tokens >= 1 && num_prompt_tokens < max_context_len,
+        InvalidArgument,
+        "num_prompt_tokens %d must be in [1, max_context_len %" PRId64 ")",
+        num_prompt_tokens,
+        max_context_len);
+    max_new_tokens.push_back(
+        config.resolve_max_new_tokens(max_context_len, num_prompt_tokens));
+    ET_CHECK_OR_RETURN_ERROR(
+        max_new_tokens.back() > 0,
+        InvalidArgument,
+        "Max new tokens %d is less than or equal to 0",
+        max_new_tokens.back());
+  }
+
+  // Prompts are prefilled together when the model accepts several tokens per
+  // step.
+  int64_t max_prefill_tokens = 1;
+  auto dynamic_shape = metadata_.find(kEnableDynamicShape);
+  auto max_seq_len = metadata_.find(kMaxSeqLen);
+  if (use_kv_cache_ && dynamic_shape != metadata_.end() &&
+      dynamic_shape->second && max_seq_len != metadata_.end()) {
+    max_prefill_tokens = max_seq_len->second;
+  }
+  const float temperature =
+      temperature_ == -1.0f ? config.temperature : temperature_;
+  std::vector<SequenceStats> sequence_stats;
+  auto add_sequence_stats = [this, &sequence_stats](size_t num_sequences) {
+    for (size_t i = 0; i < num_sequences; ++i) {
+      const SequenceStats& seq = sequence_stats[i];
+      if (seq.num_generated_tokens > 0 &&
+          (stats_->first_token_ms == 0 ||
+           seq.first_token_ms < stats_->first_token_ms)) {
+        stats_->first_token_ms = seq.first_token_ms;
+      }
+      stats_->num_prompt_tokens += seq.num_prompt_tokens;
+      stats_->num_generated_tokens += seq.num_generated_tokens;
+      stats_->sequences.push_back(seq);
+    }
+  };
+
+  if (use_kv_cache_ && text_decoder_runner_->has_per_sequence_positions()) {
+    // Every sequence has its own positions, so a finished sequence's slot is
+    // refilled right away.
+    auto steps = text_token_generator_->generate_continuous_batch(
+        prompt_tokens,
+        batch_size,
+        max_new_tokens,
+        temperature,
+        token_callback,
+        sequence_stats,
+        max_prefill_tokens);
+    ET_CHECK_OK_OR_RETURN_ERROR(steps.error());
+    add_sequence_stats(prompts.size());
+  } else {
+    std::vector<std::vector<uint64_t>> sequences(batch_size);
+    std::vector<int32_t> sequence_max_new_tokens(batch_size);
+    for (size_t begin = 0; begin < prompts.size() && !shouldStop_;
+         begin += batch_size) {
+      size_t num_sequences =
+          std::min(prompts.size() - begin, static_cast<size_t>(batch_size));
+      for (size_t i = 0; i < static_cast<size_t>(batch_size); ++i) {
+        // The model's batch size is static, pad a partial batch with copies of
+        // its first prompt that generate nothing.
+        bool is_padding = i >= num_sequences;
+        sequences[i] = prompt_tokens[begin + (is_padding ? 0 : i)];
+        sequence_max_new_tokens[i] = is_padding ? 0 : max_new_tokens[begin + i];
+      }
+
+      auto steps = text_token_generator_->generate_batch(
+          sequences,
+          /*start_pos=*/0,
+          sequence_max_new_tokens,
+          temperature,
+          [&token_callback, begin](size_t i, const std::string& piece) {
+            if (token_callback) {
+              token_callback(begin + i, piece);
+            }
+          },
+          sequence_stats,
+          max_prefill_tokens);
+      ET_CHECK_OK_OR_RETURN_ERROR(steps.error());
+      add_sequence_stats(num_sequences);
+    }
+  }
+
+  // Prompts are consumed by the decode loop, so prompt evaluation ends with
+  // the first generated token.
+  stats_->prompt_eval_end_ms = stats_->first_token_ms;
+  stats_->inference_end_ms = time_in_ms();
+
+  if (!config.warming) {
+    print_report(*stats_);
+  }
+  if (stats_callback) {
+    stats_callback(*stats_);
+  }
+  return Error::Ok;
+}
+
 Error TextLLMRunner::warmup(const std::string& prompt, int32_t max_new_tokens) {
   // Create a GenerationConfig for warmup
   GenerationConfig config{
@@ -245,9 +461,22 @@ Error TextLLMRunner::warmup(const std::string& prompt, int32_t max_new_tokens) {
   return err;
 }
 
+void TextLLMRunner::set_speculative_token_generator(
+    std::unique_ptr<SpeculativeTokenGenerator> speculative_token_generator) {
+  speculative_token_generator_ = std::move(speculative_token_generator);
+}
+
+void TextLLMRunner::clear_prefix_cache() {
+  cached_tokens_.clear();
+}
+
 void TextLLMRunner::stop() {
+  shouldStop_ = true;
   if (is_loaded()) {
     text_token_generator_->stop();
+    if (speculative_token_generator_) {
+      speculative_token_generator_->stop();
+    }
   } else {
     ET_LOG(Error, "Token generator is not loaded, cannot stop");
   }
@@ -16,8 +16,10 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <executorch/extension/llm/runner/irunner.h>
+#include <executorch/extension/llm/runner/speculative_token_generator.h>
 #include <executorch/extension/llm/runner/stats.h>
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
 #include <executorch/extension/llm/runner/text_prefiller.h>
@@ -108,6 +110,11 @@ class ET_EXPERIMENTAL TextLLMRunner : public IRunner {
    * start position until max tokens to generate is reached or eos token is
    * generated, then returns generated text and perf stats through callbacks.
    *
+   * The runner remembers which tokens are in the KV cache. When the prompt
+   * starts with tokens already in the cache at the same positions, e.g. a
+   * shared system prompt or the chat history of a previous turn, only the
+   * rest of the prompt is prefilled.
+   *
    * @param prompt The input text to generate from
    * @param start_pos The starting position in KV cache of the input
    * @param config Configuration parameters for text generation (e.g.,
@@ -124,6 +131,37 @@ class ET_EXPERIMENTAL TextLLMRunner : public IRunner {
       std::function<void(const std::string&)> token_callback = {},
       std::function<void(const Stats&)> stats_callback = {}) override;
 
+  /**
+   * @brief Generates text for several prompts in batches
+   *
+   * The prompts are queued and run batch_size at a time, through a single
+   * forward pass per decode step. The model must have been exported with a
+   * batch dimension of batch_size. If the model takes a position per sequence
+   * ([batch, num_tokens] cache positions), a slot freed by a sequence that hit
+   * EOS or its token limit is refilled from the queue right away (continuous
+   * batching). Otherwise every sequence in a batch shares the KV cache
+   * positions of the batch, so the slot is only refilled once the rest of its
+   * batch is done. If the model accepts a dynamic number of tokens, the prompt
+   * tokens that all running sequences have in common are prefilled in one
+   * step.
+   *
+   * @param prompts The input texts to generate from
+   * @param config Configuration parameters for text generation, applied to
+   * every prompt
+   * @param batch_size Number of sequences per forward pass
+   * @param token_callback Function called for each generated token with the
+   * index of its prompt and the decoded text
+   * @param stats_callback Function called with performance statistics,
+   * including per-sequence stats
+   * @return ::executorch::runtime::Error Success or error status
+   */
+  ::executorch::runtime::Error generate_batch(
+      const std::vector<std::string>& prompts,
+      const GenerationConfig& config,
+      int32_t batch_size,
+      std::function<void(size_t, const std::string&)> token_callback = {},
+      std::function<void(const Stats&)> stats_callback = {});
+
   /**
    * @brief Warms up the model with a sample prompt
    *
@@ -137,6 +175,22 @@ class ET_EXPERIMENTAL TextLLMRunner : public IRunner {
   ::executorch::runtime::Error warmup(
       const std::string& prompt,
       int32_t max_new_tokens);
+  /**
+   * @brief Sets the generator used when GenerationConfig::num_draft_tokens
+   * is positive
+   *
+   * @param speculative_token_generator Speculative decoding loop, sharing the
+   * tokenizer, text decoder runner and stats of this runner
+   */
+  void set_speculative_token_generator(
+      std::unique_ptr<SpeculativeTokenGenerator> speculative_token_generator);
+  /**
+   * @brief Forgets which tokens are in the KV cache
+   *
+   * The next generation prefills its whole prompt. Call this after changing
+   * the KV cache outside of this runner.
+   */
+  void clear_prefix_cache();
   /**
    * @brief Stops the ongoing text generation process
    *
@@ -161,6 +215,7 @@ class ET_EXPERIMENTAL TextLLMRunner : public IRunner {
   std::unique_ptr<TextPrefiller> text_prefiller_;
   std::unique_ptr<IOManager> io_manager_;
   std::unique_ptr<TextTokenGenerator> text_token_generator_;
+  std::unique_ptr<SpeculativeTokenGenerator> speculative_token_generator_;
 
   // Stats
   std::unique_ptr<Stats> stats_;
@@ -168,6 +223,12 @@ class ET_EXPERIMENTAL TextLLMRunner : public IRunner {
   // temperature.
   // Deprecated, we should rely on the temperature in GenerationConfig instead.
   float temperature_ = -1.0f;
+
+  // Prefix reuse is only possible with a KV cache that keeps every position.
+  bool use_kv_cache_ = false;
+  bool use_sliding_window_kv_cache_ = false;
+  // The tokens in the KV cache, by position, as of the last generation.
+  std::vector<uint64_t> cached_tokens_;
 };
 
 } // namespace executorch::extension::llm
@@ -46,6 +46,8 @@ class ET_EXPERIMENTAL TextTokenGenerator {
    * random predictions, while a lower temperature results in more deterministic
    * predictions.
    * @param token_callback what to do after a token is generated.
+   * @param generated_tokens if not null, every generated token is appended to
+   * it.
    * @return how many tokens are generated.
    */
   inline ::executorch::runtime::Result<int64_t> generate(
@@ -53,7 +55,8 @@ class ET_EXPERIMENTAL TextTokenGenerator {
       int64_t start_pos,
       int32_t max_new_tokens,
       float temperature = 0.0f,
-      const std::function<void(const std::string&)>& token_callback = {}) {
+      const std::function<void(const std::string&)>& token_callback = {},
+      std::vector<uint64_t>* generated_tokens = nullptr) {
     ET_CHECK_MSG(
         !tokens.empty(), "Token generation loop shouldn't take empty tokens");
     int64_t pos = start_pos; // position in the sequence
@@ -95,6 +98,9 @@ class ET_EXPERIMENTAL TextTokenGenerator {
       cur_token =
           text_decoder_runner_->logits_to_token(logits_tensor, temperature);
       stats_->on_sampling_end();
+      if (generated_tokens != nullptr) {
+        generated_tokens->push_back(cur_token);
+      }
 
       pos++;
 
@@ -127,6 +133,334 @@ class ET_EXPERIMENTAL TextTokenGenerator {
     return pos - start_pos;
   }
 
+  /**
+   * Batched token generation loop. Every sequence advances through the same
+   * forward pass, one token per sequence per step, so the weights are read
+   * once per step for the whole batch.
+   *
+   * The decode method takes a single position for the whole batch, so all
+   * sequences occupy the same KV cache positions. Prompt tokens that every
+   * unfinished sequence still has to feed are fed together, up to
+   * `max_prefill_tokens` per step. A sequence whose prompt is longer than the
+   * others keeps feeding its prompt tokens while the others already sample,
+   * and a finished sequence keeps feeding its last token until the whole batch
+   * is done. Its slot can't be given to another sequence before then: the new
+   * sequence would start at the shared position and attend to the KV cache
+   * entries of the finished one. Models that take a position per sequence
+   * can refill it right away, see generate_continuous_batch().
+   *
+   * @param sequences prompt tokens of each sequence, one per batch row of the
+   * model. Generated tokens are appended in place.
+   * @param start_pos the position of the first prompt token of every sequence.
+   * @param max_new_tokens maximum number of new tokens per sequence. A
+   * sequence with a limit of 0 only pads the batch.
+   * @param temperature controls the randomness of predictions, see generate().
+   * @param token_callback what to do after a token is generated. Called with
+   * the index of the sequence the token belongs to.
+   * @param sequence_stats token counts and timestamps of each sequence,
+   * resized to the number of sequences.
+   * @param max_prefill_tokens maximum number of prompt tokens per sequence to
+   * feed in one step. Must be 1 unless the decode method accepts a dynamic
+   * number of tokens.
+   * @return how many tokens of each sequence were fed to the model.
+   */
+  inline ::executorch::runtime::Result<int64_t> generate_batch(
+      std::vector<std::vector<uint64_t>>& sequences,
+      int64_t start_pos,
+      const std::vector<int32_t>& max_new_tokens,
+      float temperature,
+      const std::function<void(size_t, const std::string&)>& token_callback,
+      std::vector<SequenceStats>& sequence_stats,
+      int64_t max_prefill_tokens = 1) {
+    const size_t batch_size = sequences.size();
+    ET_CHECK_OR_RETURN_ERROR(
+        batch_size > 0 && max_new_tokens.size() == batch_size,
+        InvalidArgument,
+        "Expected one token limit per sequence, got %zu for %zu sequences",
+        max_new_tokens.size(),
+        batch_size);
+
+    long start_ms = time_in_ms();
+    sequence_stats.assign(batch_size, SequenceStats{});
+    std::vector<bool> done(batch_size);
+    size_t num_active = 0;
+    for (size_t i = 0; i < batch_size; ++i) {
+      ET_CHECK_OR_RETURN_ERROR(
+          !sequences[i].empty(),
+          InvalidArgument,
+          "Sequence %zu has no prompt tokens",
+          i);
+      sequence_stats[i].num_prompt_tokens = sequences[i].size();
+      sequence_stats[i].start_ms = start_ms;
+      done[i] = max_new_tokens[i] <= 0;
+      num_active += done[i] ? 0 : 1;
+    }
+
+    std::vector<uint64_t> token_data;
+    // Number of tokens of each sequence fed to the model so far.
+    int64_t num_fed = 0;
+
+    should_stop_ = false;
+
+    while (num_active > 0) {
+      // Feed as many new columns as every unfinished sequence has tokens for.
+      // Sequences that already sample have exactly one.
+      int64_t num_new_columns = std::max<int64_t>(max_prefill_tokens, 1);
+      for (size_t i = 0; i < batch_size; ++i) {
+        if (!done[i]) {
+          num_new_columns = std::min<int64_t>(
+              num_new_columns, sequences[i].size() - num_fed);
+        }
+      }
+      // With kv cache only the new columns are fed, otherwise the whole
+      // sequence is recomputed. A sequence that is shorter than a column being
+      // fed has finished, so it repeats its last token.
+      int64_t first_column = use_kv_cache_ ? num_fed : 0;
+      int64_t num_columns = num_fed + num_new_columns - first_column;
+      token_data.resize(batch_size * num_columns);
+      for (size_t i = 0; i < batch_size; ++i) {
+        const auto& seq = sequences[i];
+        for (int64_t c = 0; c < num_columns; ++c) {
+          size_t column = first_column + c;
+          token_data[i * num_columns + c] =
+              column < seq.size() ? seq[column] : seq.back();
+        }
+      }
+      auto tokens_managed = from_blob(
+          token_data.data(),
+          {static_cast<int>(batch_size), static_cast<int>(num_columns)},
+          executorch::aten::ScalarType::Long);
+
+      auto logits_res =
+          text_decoder_runner_->step(tokens_managed, start_pos + first_column);
+      ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
+      executorch::aten::Tensor& logits_tensor = logits_res.get();
+      num_fed += num_new_columns;
+
+      for (size_t i = 0; i < batch_size; ++i) {
+        // Skip finished sequences and those still consuming their prompt.
+        if (done[i] || sequences[i].size() > static_cast<size_t>(num_fed)) {
+          continue;
+        }
+        uint64_t prev_token = sequences[i].back();
+
+        stats_->on_sampling_begin();
+        uint64_t cur_token = text_decoder_runner_->logits_to_token(
+            logits_tensor, i, temperature);
+        stats_->on_sampling_end();
+
+        sequences[i].push_back(cur_token);
+        SequenceStats& seq_stats = sequence_stats[i];
+        if (seq_stats.num_generated_tokens++ == 0) {
+          seq_stats.first_token_ms = time_in_ms();
+        }
+
+        if (token_callback) {
+          token_callback(
+              i,
+              ET_UNWRAP_TOKENIZER(tokenizer_->decode(prev_token, cur_token)));
+        }
+
+        if (eos_ids_->find(cur_token) != eos_ids_->end() ||
+            seq_stats.num_generated_tokens >= max_new_tokens[i]) {
+          done[i] = true;
+          seq_stats.end_ms = time_in_ms();
+          num_active--;
+        }
+      }
+
+      if (should_stop_) {
+        break;
+      }
+    }
+
+    long end_ms = time_in_ms();
+    for (size_t i = 0; i < batch_size; ++i) {
+      if (!done[i]) {
+        sequence_stats[i].end_ms = end_ms;
+      }
+    }
+    return num_fed;
+  }
+
+  /**
+   * Continuous batching loop, for models that take a position per sequence
+   * (see TextDecoderRunner::has_per_sequence_positions()). Every slot of the
+   * batch runs one sequence at its own KV cache positions, starting from 0,
+   * and is given the next queued sequence as soon as its sequence ends, so the
+   * batch stays full while there are sequences left. The model must mask KV
+   * cache entries past each sequence's position, so that a new sequence does
+   * not attend to the entries that the previous one left in its slot.
+   *
+   * Prompt tokens that every running sequence still has to feed are fed
+   * together, up to `max_prefill_tokens` per step, so a sequence that joins
+   * while others sample feeds its prompt one token per step. A slot with no
+   * sequence left feeds padding at position 0.
+   *
+   * @param sequences prompt tokens of every sequence, in the order they are
+   * admitted into the batch. Generated tokens are appended in place.
+   * @param batch_size number of sequences per forward pass, the batch
+   * dimension of the model.
+   * @param max_new_tokens maximum number of new tokens per sequence. A
+   * sequence with a limit of 0 is skipped.
+   * @param temperature controls the randomness of predictions, see generate().
+   * @param token_callback what to do after a token is generated. Called with
+   * the index of the sequence the token belongs to.
+   * @param sequence_stats token counts and timestamps of each sequence,
+   * resized to the number of sequences.
+   * @param max_prefill_tokens maximum number of prompt tokens per sequence to
+   * feed in one step. Must be 1 unless the decode method accepts a dynamic
+   * number of tokens.
+   * @return how many steps were run.
+   */
+  inline ::executorch::runtime::Result<int64_t> generate_continuous_batch(
+      std::vector<std::vector<uint64_t>>& sequences,
+      size_t batch_size,
+      const std::vector<int32_t>& max_new_tokens,
+      float temperature,
+      const std::function<void(size_t, const std::string&)>& token_callback,
+      std::vector<SequenceStats>& sequence_stats,
+      int64_t max_prefill_tokens = 1) {
+    const size_t num_sequences = sequences.size();
+    ET_CHECK_OR_RETURN_ERROR(
+        use_kv_cache_,
+        InvalidState,
+        "Continuous batching needs a model with a KV cache");
+    ET_CHECK_OR_RETURN_ERROR(
+        batch_size > 0 && num_sequences > 0 &&
+            max_new_tokens.size() == num_sequences,
+        InvalidArgument,
+        "Expected one token limit per sequence, got %zu for %zu sequences",
+        max_new_tokens.size(),
+        num_sequences);
+    sequence_stats.assign(num_sequences, SequenceStats{});
+    for (size_t i = 0; i < num_sequences; ++i) {
+      ET_CHECK_OR_RETURN_ERROR(
+          !sequences[i].empty(),
+          InvalidArgument,
+          "Sequence %zu has no prompt tokens",
+          i);
+      sequence_stats[i].num_prompt_tokens = sequences[i].size();
+    }
+
+    constexpr size_t kNoSequence = static_cast<size_t>(-1);
+    // The sequence that each slot runs, and how many of its tokens were fed
+    // to the model, which is also the position of its next token.
+    std::vector<size_t> slot_sequence(batch_size, kNoSequence);
+    std::vector<int64_t> slot_num_fed(batch_size, 0);
+    size_t next_sequence = 0;
+    size_t num_active = 0;
+    auto admit = [&](size_t slot) {
+      long now_ms = time_in_ms();
+      while (next_sequence < num_sequences &&
+             max_new_tokens[next_sequence] <= 0) {
+        sequence_stats[next_sequence].start_ms = now_ms;
+        sequence_stats[next_sequence].end_ms = now_ms;
+        next_sequence++;
+      }
+      if (next_sequence < num_sequences) {
+        sequence_stats[next_sequence].start_ms = now_ms;
+        slot_sequence[slot] = next_sequence++;
+        num_active++;
+      } else {
+        slot_sequence[slot] = kNoSequence;
+      }
+      slot_num_fed[slot] = 0;
+    };
+    for (size_t slot = 0; slot < batch_size; ++slot) {
+      admit(slot);
+    }
+
+    const uint64_t pad_token = sequences[0][0];
+    std::vector<uint64_t> token_data;
+    std::vector<int64_t> start_positions(batch_size);
+    int64_t num_steps = 0;
+
+    should_stop_ = false;
+
+    while (num_active > 0) {
+      // Feed as many columns as every running sequence has tokens for.
+      // Sequences that already sample have exactly one.
+      int64_t num_columns = std::max<int64_t>(max_prefill_tokens, 1);
+      for (size_t slot = 0; slot < batch_size; ++slot) {
+        if (slot_sequence[slot] != kNoSequence) {
+          num_columns = std::min<int64_t>(
+              num_columns,
+              sequences[slot_sequence[slot]].size() - slot_num_fed[slot]);
+        }
+      }
+      token_data.resize(batch_size * num_columns);
+      for (size_t slot = 0; slot < batch_size; ++slot) {
+        const size_t i = slot_sequence[slot];
+        for (int64_t c = 0; c < num_columns; ++c) {
+          token_data[slot * num_columns + c] = i == kNoSequence
+              ? pad_token
+              : sequences[i][slot_num_fed[slot] + c];
+        }
+        start_positions[slot] = slot_num_fed[slot];
+      }
+      auto tokens_managed = from_blob(
+          token_data.data(),
+          {static_cast<int>(batch_size), static_cast<int>(num_columns)},
+          executorch::aten::ScalarType::Long);
+
+      auto logits_res =
+          text_decoder_runner_->step_batch(tokens_managed, start_positions);
+      ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
+      executorch::aten::Tensor& logits_tensor = logits_res.get();
+      num_steps++;
+
+      for (size_t slot = 0; slot < batch_size; ++slot) {
+        const size_t i = slot_sequence[slot];
+        if (i == kNoSequence) {
+          continue;
+        }
+        slot_num_fed[slot] += num_columns;
+        // Skip sequences still consuming their prompt.
+        if (sequences[i].size() > static_cast<size_t>(slot_num_fed[slot])) {
+          continue;
+        }
+        uint64_t prev_token = sequences[i].back();
+
+        stats_->on_sampling_begin();
+        uint64_t cur_token = text_decoder_runner_->logits_to_token(
+            logits_tensor, slot, temperature);
+        stats_->on_sampling_end();
+
+        sequences[i].push_back(cur_token);
+        SequenceStats& seq_stats = sequence_stats[i];
+        if (seq_stats.num_generated_tokens++ == 0) {
+          seq_stats.first_token_ms = time_in_ms();
+        }
+
+        if (token_callback) {
+          token_callback(
+              i,
+              ET_UNWRAP_TOKENIZER(tokenizer_->decode(prev_token, cur_token)));
+        }
+
+        if (eos_ids_->find(cur_token) != eos_ids_->end() ||
+            seq_stats.num_generated_tokens >= max_new_tokens[i]) {
+          seq_stats.end_ms = time_in_ms();
+          num_active--;
+          admit(slot);
+        }
+      }
+
+      if (should_stop_) {
+        break;
+      }
+    }
+
+    long end_ms = time_in_ms();
+    for (size_t slot = 0; slot < batch_size; ++slot) {
+      if (slot_sequence[slot] != kNoSequence) {
+        sequence_stats[slot_sequence[slot]].end_ms = end_ms;
+      }
+    }
+    return num_steps;
+  }
+
   /**
    * Stop the generation loop.
    */
@@ -74,50 +74,102 @@ int32_t Sampler::sample_topp(T* probabilities, float coin) {
   // top-p sampling (or "nucleus sampling") samples from the smallest set of
   // tokens that exceed probability topp. This way we never sample tokens that
   // have very low probabilities and are less likely to go "off the rails".
+  // Top-k and min-p filtering, when enabled, are applied to the candidates
+  // first.
   // coin is a random number in [0, 1), usually from random_f32()
-  int n = vocab_size_;
-  int n0 = 0;
-  // quicksort indices in descending order of probabilities
+  const int n = vocab_size_;
+  const bool use_topp = topp_ > 0 && topp_ < 1;
+  const bool filtered = topk_ > 0 || minp_ > 0;
+
   // values smaller than (1 - topp) / (n - 1) cannot be part of the result
-  // so for efficiency we crop these out as candidates before sorting
-  std::unique_ptr<ProbIndex<T>[]> probindex =
-      std::make_unique<ProbIndex<T>[]>(vocab_size_);
+  // so for efficiency we crop these out as candidates before selecting. This
+  // only holds for the full distribution, not for a filtered one.
+  float cutoff = use_topp && !filtered && n > 1 ? (1.0f - topp_) / (n - 1)
+                                                : 0.0f;
+  if (minp_ > 0) {
+    const int max_i = sample_argmax(probabilities);
+    cutoff = std::max(cutoff, minp_ * static_cast<float>(probabilities[max_i]));
+  }
 
-  const float cutoff = (1.0f - topp_) / (n - 1);
+  if (probindex_.size() != static_cast<size_t>(n)) {
+    probindex_.resize(n);
+  }
+  ProbIndex<float>* candidates = probindex_.data();
+  int n0 = 0;
   for (int i = 0; i < n; i++) {
-    if (probabilities[i] >= cutoff) {
-      probindex[n0].index = i;
-      probindex[n0].prob = probabilities[i];
+    const float prob = static_cast<float>(probabilities[i]);
+    if (prob >= cutoff) {
+      candidates[n0].index = i;
+      candidates[n0].prob = prob;
       n0++;
     }
   }
+  if (n0 == 0) {
+    return sample_argmax(probabilities);
+  }
 
-  auto compare = [](const ProbIndex<T>& a, const ProbIndex<T>& b) {
+  auto less = [](const ProbIndex<float>& a, const ProbIndex<float>& b) {
+    return a.prob < b.prob;
+  };
+  auto greater = [](const ProbIndex<float>& a, const ProbIndex<float>& b) {
     return a.prob > b.prob;
   };
-  std::sort(probindex.get(), probindex.get() + n0, compare);
+  if (topk_ > 0 && n0 > topk_) {
+    // Partition so that the topk most likely candidates come first.
+    std::nth_element(
+        candidates, candidates + topk_ - 1, candidates + n0, greater);
+    n0 = topk_;
+  }
 
-  // truncate the list where cumulative probability exceeds topp
-  T cumulative_prob = 0;
-  int last_idx = n0 - 1; // in case of rounding errors consider all elements
+  float total = 0;
   for (int i = 0; i < n0; i++) {
-    cumulative_prob += probindex[i].prob;
-    if (cumulative_prob > topp_) {
-      last_idx = i;
-      break; // we've exceeded topp by including last_idx
+    total += candidates[i].prob;
+  }
+
+  if (!use_topp) {
+    // Every remaining candidate can be sampled, in any order.
+    const float r = coin * total;
+    float cdf = 0;
+    for (int i = 0; i < n0; i++) {
+      cdf += candidates[i].prob;
+      if (r < cdf) {
+        return candidates[i].index;
+      }
+    }
+    return candidates[n0 - 1].index; // in case of rounding errors
+  }
+
+  // Top-p applies to the distribution left after top-k and min-p filtering,
+  // renormalized to sum to 1. Rather than dividing every candidate by the
+  // total, scale topp to the candidates' probability mass instead.
+  const float topp_mass = filtered ? topp_ * total : topp_;
+
+  // Pop candidates from a max-heap in descending order of probability until
+  // the cumulative probability exceeds topp. This only orders the nucleus
+  // instead of sorting every candidate. Popped candidates are stored at the
+  // back of the array, most likely last.
+  std::make_heap(candidates, candidates + n0, less);
+  float cumulative_prob = 0;
+  int first_idx = n0; // in case of rounding errors consider all elements
+  while (first_idx > 0) {
+    std::pop_heap(candidates, candidates + first_idx, less);
+    first_idx--;
+    cumulative_prob += candidates[first_idx].prob;
+    if (cumulative_prob > topp_mass) {
+      break; // we've exceeded topp by including first_idx
     }
   }
 
   // sample from the truncated list
-  const T& r = coin * cumulative_prob;
-  T cdf = 0;
-  for (int i = 0; i <= last_idx; i++) {
-    cdf += probindex[i].prob;
+  const float r = coin * cumulative_prob;
+  float cdf = 0;
+  for (int i = n0 - 1; i >= first_idx; i--) {
+    cdf += candidates[i].prob;
     if (r < cdf) {
-      return probindex[i].index;
+      return candidates[i].index;
     }
   }
-  return probindex[last_idx].index; // in case of rounding errors
+  return candidates[first_idx].index; // in case of rounding errors
 }
 
 Sampler::Sampler(
@@ -130,30 +182,83 @@ Sampler::Sampler(
       topp_(topp),
       rng_state_(rng_seed) {}
 
+Sampler::Sampler(
+    int vocab_size,
+    float temperature,
+    float topp,
+    int32_t topk,
+    float minp,
+    unsigned long long rng_seed)
+    : vocab_size_(vocab_size),
+      inv_temperature_(static_cast<bool>(temperature) ? 1.0f / temperature : 0),
+      topp_(topp),
+      topk_(topk),
+      minp_(minp),
+      rng_state_(rng_seed) {}
+
 Sampler::Sampler(int vocab_size, float temperature)
     : vocab_size_(vocab_size),
       inv_temperature_(static_cast<bool>(temperature) ? 1.0f / temperature : 0),
       topp_(kTopp),
       rng_state_(std::time(nullptr)) {}
 
+// Number of independent accumulators that softmax() reduces into. Unlike a
+// single running max or sum, they have no loop-carried dependency from one
+// element to the next, so the compiler can keep them in one SIMD register.
+constexpr int kSoftmaxLanes = 8;
+
+// Kept out of line: inlined into sample(), it leaves too few registers for the
+// argmax loop there.
 template <typename T>
-static void softmax(T* x, int size) {
+ET_NOINLINE static void softmax(T* x, int size, float inv_temperature) {
+  // Scales by the temperature and normalizes in float, without changing the
+  // logits in place first.
+  const int vec_size = size - size % kSoftmaxLanes;
   // find max value (for numerical stability)
-  T max_val = x[0];
-  for (int i = 1; i < size; i++) {
-    if (x[i] > max_val) {
-      max_val = x[i];
+  float max_val = static_cast<float>(x[0]);
+  if (vec_size > 0) {
+    float max_lanes[kSoftmaxLanes];
+    for (int j = 0; j < kSoftmaxLanes; j++) {
+      max_lanes[j] = static_cast<float>(x[j]);
+    }
+    for (int i = kSoftmaxLanes; i < vec_size; i += kSoftmaxLanes) {
+      for (int j = 0; j < kSoftmaxLanes; j++) {
+        const float v = static_cast<float>(x[i + j]);
+        max_lanes[j] = max_lanes[j] < v ? v : max_lanes[j];
+      }
+    }
+    for (int j = 0; j < kSoftmaxLanes; j++) {
+      max_val = std::max(max_val, max_lanes[j]);
     }
   }
-  // exp and sum
-  T sum = 0;
-  for (int i = 0; i < size; i++) {
-    x[i] = expf(x[i] - max_val);
-    sum += x[i];
+  for (int i = vec_size; i < size; i++) {
+    max_val = std::max(max_val, static_cast<float>(x[i]));
+  }
+  // exp and sum, with the temperature folded into the exponent:
+  // exp((x - max) / temperature)
+  float sum_lanes[kSoftmaxLanes] = {};
+  for (int i = 0; i < vec_size; i += kSoftmaxLanes) {
+    for (int j = 0; j < kSoftmaxLanes; j++) {
+      const float e =
+          expf((static_cast<float>(x[i + j]) - max_val) * inv_temperature);
+      x[i + j] = e;
+      sum_lanes[j] += e;
+    }
+  }
+  float sum = 0;
+  for (int j = 0; j < kSoftmaxLanes; j++) {
+    sum += sum_lanes[j];
+  }
+  for (int i = vec_size; i < size; i++) {
+    const float e =
+        expf((static_cast<float>(x[i]) - max_val) * inv_temperature);
+    x[i] = e;
+    sum += e;
   }
   // normalize
+  const float inv_sum = 1.0f / sum;
   for (int i = 0; i < size; i++) {
-    x[i] /= sum;
+    x[i] = static_cast<float>(x[i]) * inv_sum;
   }
 }
 
@@ -177,20 +282,17 @@ int32_t Sampler::sample(T* logits) {
     // greedy argmax sampling: take the token with the highest probability
     next = sample_argmax(logits);
   } else {
-    // apply the temperature to the logits
-    for (int q = 0; q < vocab_size_; q++) {
-      logits[q] *= inv_temperature_;
-    }
-    // apply softmax to the logits to get the probabilities for next token
-    softmax(logits, vocab_size_);
+    // apply the temperature and softmax to the logits to get the
+    // probabilities for next token
+    softmax(logits, vocab_size_, inv_temperature_);
     // flip a (float) coin (this is our source of entropy for sampling)
     float coin = random_f32(&rng_state_);
     // we sample from this distribution to get the next token
-    if (topp_ <= 0 || topp_ >= 1) {
+    if ((topp_ <= 0 || topp_ >= 1) && topk_ <= 0 && minp_ <= 0) {
       // simply sample from the predicted probability distribution
       next = sample_mult(logits, coin);
     } else {
-      // top-p (nucleus) sampling, clamping the least likely tokens to zero
+      // top-k/min-p/top-p sampling, clamping the least likely tokens to zero
       next = sample_topp(logits, coin);
     }
   }
@@ -14,6 +14,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <vector>
 #ifdef USE_ATEN_LIB
 #include <torch/torch.h>
 #endif
@@ -42,6 +43,21 @@ class ET_EXPERIMENTAL Sampler {
       float topp,
       unsigned long long rng_seed);
 
+  /**
+   * Creates a sampler that can combine top-k, min-p and top-p filtering.
+   * Tokens are first restricted to the `topk` most likely ones (if topk > 0),
+   * then to the ones whose probability is at least `minp` times that of the
+   * most likely token (if minp > 0), and finally to the smallest set whose
+   * cumulative probability exceeds `topp` (if 0 < topp < 1).
+   */
+  Sampler(
+      int32_t vocab_size,
+      float temperature,
+      float topp,
+      int32_t topk,
+      float minp,
+      unsigned long long rng_seed);
+
   Sampler(int32_t vocab_size, float temperature);
 
   template <typename T>
@@ -60,7 +76,14 @@ class ET_EXPERIMENTAL Sampler {
   // reciprocal of temperature, or 0 if temperature == 0.
   float inv_temperature_;
   float topp_;
+  // number of most likely tokens to sample from, or 0 to disable top-k.
+  int32_t topk_ = 0;
+  // minimum probability relative to the most likely token, or 0 to disable.
+  float minp_ = 0.0f;
   unsigned long long rng_state_;
+  // Scratch space for the filtered candidates, allocated on first use and
+  // reused for every following token.
+  std::vector<ProbIndex<float>> probindex_;
 };
 
 } // namespace llm
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * Measures how long Sampler::sample() takes per token for the vocabulary
+ * sizes of common LLMs, with greedy, top-p, top-k and min-p sampling.
+ *
+ * Not a test: run it by hand and compare the times before and after changes
+ * to the sampler.
+ */
+
+#include <executorch/extension/llm/sampler/sampler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using ::executorch::extension::llm::Sampler;
+
+namespace {
+
+constexpr int kSamplesPerRun = 100;
+constexpr int kTimedRuns = 10;
+
+/**
+ * Returns the fastest of kTimedRuns runs of kSamplesPerRun calls of
+ * `sampler.sample()`, in microseconds per call. sample() overwrites the logits
+ * it is given, so every call gets a fresh copy of `logits`, and the copy is
+ * timed too.
+ */
+double time_samples(Sampler& sampler, const std::vector<float>& logits) {
+  std::vector<float> scratch(logits.size());
+  int32_t checksum = 0;
+  auto best = std::chrono::steady_clock::duration::max();
+  for (int run = 0; run < kTimedRuns; ++run) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kSamplesPerRun; ++i) {
+      std::copy(logits.begin(), logits.end(), scratch.begin());
+      checksum += sampler.sample(scratch.data());
+    }
+    best = std::min(best, std::chrono::steady_clock::now() - start);
+  }
+  // Keep the compiler from dropping the calls.
+  if (checksum == -1) {
+    std::printf("%d\n", checksum);
+  }
+  return std::chrono::duration<double, std::micro>(best).count() /
+      kSamplesPerRun;
+}
+
+} // namespace
+
+int main() {
+  const int32_t vocab_sizes[] = {32000, 128256, 262144};
+  constexpr unsigned long long kSeed = 0;
+
+  std::printf(
+      "us per token, best of %d runs of %d tokens\n"
+      "%8s %8s %8s %8s %8s\n",
+      kTimedRuns,
+      kSamplesPerRun,
+      "vocab",
+      "argmax",
+      "top-p",
+      "top-k",
+      "min-p");
+  for (int32_t vocab_size : vocab_sizes) {
+    // LLM logits are roughly normally distributed.
+    std::mt19937 gen(0);
+    std::normal_distribution<float> dist(0.0f, 3.0f);
+    std::vector<float> logits(vocab_size);
+    for (auto& logit : logits) {
+      logit = dist(gen);
+    }
+
+    Sampler argmax(vocab_size, 0.0f, 0.9f, kSeed);
+    Sampler topp(vocab_size, 0.8f, 0.9f, kSeed);
+    Sampler topk(vocab_size, 0.8f, 1.0f, /*topk=*/50, /*minp=*/0.0f, kSeed);
+    Sampler minp(vocab_size, 0.8f, 1.0f, /*topk=*/0, /*minp=*/0.05f, kSeed);
+    std::printf(
+        "%8d %8.1f %8.1f %8.1f %8.1f\n",
+        vocab_size,
+        time_samples(argmax, logits),
+        time_samples(topp, logits),
+        time_samples(topk, logits),
+        time_samples(minp, logits));
+  }
+  return 0;
+}
@@ -22,3 +22,14 @@ def define_common_targets():
             "//caffe2:torch-cpp",
         ],
     )
+
+    # Not a test: run it by hand to time Sampler::sample().
+    runtime.cxx_binary(
+        name = "sampler_benchmark",
+        srcs = [
+            "sampler_benchmark.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/sampler:sampler",
+        ],
+    )
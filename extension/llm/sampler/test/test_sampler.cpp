@@ -11,9 +11,88 @@
 #include <gtest/gtest.h>
 #include <torch/torch.h>
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
 using namespace ::testing;
 using ::executorch::extension::llm::Sampler;
 
+namespace {
+// The sampler before it stopped allocating and sorting every candidate,
+// restricted to float logits.
+unsigned int reference_random_u32(unsigned long long* state) {
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return (*state * 0x2545F4914F6CDD1Dull) >> 32;
+}
+
+int32_t reference_sample(
+    std::vector<float>& logits,
+    float temperature,
+    float topp,
+    unsigned long long* rng_state) {
+  const int n = static_cast<int>(logits.size());
+  for (auto& logit : logits) {
+    logit *= 1.0f / temperature;
+  }
+  const float max_val = *std::max_element(logits.begin(), logits.end());
+  // Summed in 8 interleaved partial sums like the sampler, so that both round
+  // the same way.
+  float partial_sums[8] = {};
+  const int vec_size = n - n % 8;
+  for (int i = 0; i < vec_size; i++) {
+    logits[i] = expf(logits[i] - max_val);
+    partial_sums[i % 8] += logits[i];
+  }
+  float sum = 0;
+  for (float partial_sum : partial_sums) {
+    sum += partial_sum;
+  }
+  for (int i = vec_size; i < n; i++) {
+    logits[i] = expf(logits[i] - max_val);
+    sum += logits[i];
+  }
+  for (auto& logit : logits) {
+    logit /= sum;
+  }
+  const float coin = (reference_random_u32(rng_state) >> 8) / 16777216.0f;
+
+  std::vector<std::pair<float, int32_t>> candidates;
+  const float cutoff = (1.0f - topp) / (n - 1);
+  for (int i = 0; i < n; i++) {
+    if (logits[i] >= cutoff) {
+      candidates.emplace_back(logits[i], i);
+    }
+  }
+  std::sort(
+      candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first;
+      });
+  float cumulative_prob = 0;
+  size_t last_idx = candidates.size() - 1;
+  for (size_t i = 0; i < candidates.size(); i++) {
+    cumulative_prob += candidates[i].first;
+    if (cumulative_prob > topp) {
+      last_idx = i;
+      break;
+    }
+  }
+  const float r = coin * cumulative_prob;
+  float cdf = 0;
+  for (size_t i = 0; i <= last_idx; i++) {
+    cdf += candidates[i].first;
+    if (r < cdf) {
+      return candidates[i].second;
+    }
+  }
+  return candidates[last_idx].second;
+}
+} // namespace
+
 TEST(SamplerTest, TestArgMax) {
   Sampler sampler{
       /*vocab_size*/ 32000,
@@ -39,3 +118,112 @@ TEST(SamplerTest, TestArgMaxWithFP16) {
   input[0][0][396] = 1.0f;
   EXPECT_EQ(sampler.sample(input.data_ptr<c10::Half>()), 396);
 }
+
+TEST(SamplerTest, TestTopKOfOneIsArgMax) {
+  Sampler sampler{
+      /*vocab_size*/ 32000,
+      /*temperature*/ 1.0f,
+      /*topp*/ 1.0f,
+      /*topk*/ 1,
+      /*minp*/ 0.0f,
+      /*rng_seed*/ 0};
+  for (int i = 0; i < 10; i++) {
+    torch::Tensor input = torch::rand({1, 1, 32000}, at::kFloat);
+    input[0][0][396] = 2.0f;
+    EXPECT_EQ(sampler.sample(input.data_ptr<float>()), 396);
+  }
+}
+
+TEST(SamplerTest, TestTopKSamplesOnlyMostLikelyTokens) {
+  Sampler sampler{
+      /*vocab_size*/ 32000,
+      /*temperature*/ 1.0f,
+      /*topp*/ 1.0f,
+      /*topk*/ 2,
+      /*minp*/ 0.0f,
+      /*rng_seed*/ 0};
+  for (int i = 0; i < 100; i++) {
+    torch::Tensor input = torch::rand({1, 1, 32000}, at::kFloat);
+    input[0][0][10] = 5.0f;
+    input[0][0][20] = 5.0f;
+    int32_t token = sampler.sample(input.data_ptr<float>());
+    EXPECT_TRUE(token == 10 || token == 20);
+  }
+}
+
+TEST(SamplerTest, TestTopPAppliesToTopKCandidates) {
+  Sampler sampler{
+      /*vocab_size*/ 32000,
+      /*temperature*/ 1.0f,
+      /*topp*/ 0.5f,
+      /*topk*/ 2,
+      /*minp*/ 0.0f,
+      /*rng_seed*/ 42};
+  for (int i = 0; i < 100; i++) {
+    // Tokens 10 and 20 only hold a small part of the full distribution, but
+    // token 10 holds about 73% of what top-k keeps, which exceeds topp.
+    torch::Tensor input = torch::rand({1, 1, 32000}, at::kFloat);
+    input[0][0][10] = 5.0f;
+    input[0][0][20] = 4.0f;
+    EXPECT_EQ(sampler.sample(input.data_ptr<float>()), 10);
+  }
+}
+
+TEST(SamplerTest, TestMinP) {
+  Sampler sampler{
+      /*vocab_size*/ 32000,
+      /*temperature*/ 1.0f,
+      /*topp*/ 1.0f,
+      /*topk*/ 0,
+      /*minp*/ 0.5f,
+      /*rng_seed*/ 0};
+  for (int i = 0; i < 100; i++) {
+    // Only tokens 10 and 20 are at least half as likely as the most likely
+    // token.
+    torch::Tensor input = torch::rand({1, 1, 32000}, at::kFloat);
+    input[0][0][10] = 10.0f;
+    input[0][0][20] = 9.5f;
+    int32_t token = sampler.sample(input.data_ptr<float>());
+    EXPECT_TRUE(token == 10 || token == 20);
+  }
+}
+
+TEST(SamplerTest, TestTopPWithBFloat16) {
+  Sampler sampler{
+      /*vocab_size*/ 32000,
+      /*temperature*/ 1.0f,
+      /*topp*/ 0.5f,
+      /*rng_seed*/ 0};
+  for (int i = 0; i < 10; i++) {
+    // Token 396 alone holds more than half of the probability mass.
+    torch::Tensor input = torch::rand({1, 1, 32000}, at::kBFloat16);
+    input[0][0][396] = 20.0f;
+    EXPECT_EQ(sampler.sample(input.data_ptr<c10::BFloat16>()), 396);
+  }
+}
+
+TEST(SamplerTest, TestTopPMatchesReferenceImplementation) {
+  constexpr int32_t kVocabSize = 32000;
+  constexpr unsigned long long kSeed = 42;
+  for (float temperature : {0.7f, 1.0f, 1.3f}) {
+    for (float topp : {0.5f, 0.9f}) {
+      Sampler sampler{kVocabSize, temperature, topp, kSeed};
+      unsigned long long reference_rng_state = kSeed;
+      std::mt19937 gen(0);
+      std::normal_distribution<float> dist(0.0f, 3.0f);
+      for (int i = 0; i < 50; i++) {
+        std::vector<float> logits(kVocabSize);
+        for (auto& logit : logits) {
+          logit = dist(gen);
+        }
+        std::vector<float> reference_logits = logits;
+        EXPECT_EQ(
+            sampler.sample(logits.data()),
+            reference_sample(
+                reference_logits, temperature, topp, &reference_rng_state))
+            << "temperature " << temperature << ", topp " << topp
+            << ", draw " << i;
+      }
+    }
+  }
+}
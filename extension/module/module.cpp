@@ -197,23 +197,27 @@ runtime::Error Module::load_method(
     if (!planned_memory) {
       const auto method_metadata =
           ET_UNWRAP(program_->method_meta(method_name.c_str()));
-      const auto planned_buffers_count =
-          method_metadata.num_memory_planned_buffers();
-      method_holder.planned_buffers.reserve(planned_buffers_count);
-      method_holder.planned_spans.reserve(planned_buffers_count);
-
-      for (auto index = 0; index < planned_buffers_count; ++index) {
-        const auto buffer_size =
-            method_metadata.memory_planned_buffer_size(index).get();
-        method_holder.planned_buffers.emplace_back(buffer_size);
-        method_holder.planned_spans.emplace_back(
-            method_holder.planned_buffers.back().data(), buffer_size);
+      method_holder.planned_memory_pool = planned_memory_pool_;
+      if (method_holder.planned_memory_pool) {
+        // Grow the shared buffers for all methods while nothing leases them,
+        // so that methods can be loaded in any order.
+        for (size_t index = 0; index < program_->num_methods(); ++index) {
+          const auto name = ET_UNWRAP(program_->get_method_name(index));
+          const auto meta = ET_UNWRAP(program_->method_meta(name));
+          const auto error = method_holder.planned_memory_pool->reserve(meta);
+          // The pool has leases; lease() fails below if this method doesn't
+          // fit.
+          if (error != runtime::Error::InvalidState) {
+            ET_CHECK_OK_OR_RETURN_ERROR(error);
+          }
+        }
+      } else {
+        method_holder.planned_memory_pool =
+            std::make_shared<PlannedMemoryPool>();
       }
       method_holder.planned_memory =
-          std::make_unique<runtime::HierarchicalAllocator>(runtime::Span(
-              method_holder.planned_spans.data(),
-              method_holder.planned_spans.size()));
-      planned_memory = method_holder.planned_memory.get();
+          ET_UNWRAP(method_holder.planned_memory_pool->lease(method_metadata));
+      planned_memory = method_holder.planned_memory->planned_memory();
     }
     method_holder.memory_manager = std::make_unique<runtime::MemoryManager>(
         memory_allocator_.get(), planned_memory, temp_allocator_.get());
@@ -221,7 +225,8 @@ runtime::Error Module::load_method(
         method_name.c_str(),
         method_holder.memory_manager.get(),
         event_tracer ? event_tracer : this->event_tracer(),
-        data_map_.get()));
+        data_map_.get(),
+        method_load_options_));
     method_holder.inputs.resize(method_holder.method->inputs_size());
     methods_.emplace(method_name, std::move(method_holder));
   }
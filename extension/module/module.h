@@ -14,6 +14,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include <executorch/extension/module/planned_memory_pool.h>
 #include <executorch/runtime/executor/program.h>
 
 #ifdef USE_ATEN_LIB
@@ -174,7 +175,9 @@ class Module {
    *
    * @param[in] method_name The name of the method to load.
    * @param[in] planned_memory The memory-planned buffers to use for mutable
-   * tensor data when executing a method.
+   * tensor data when executing a method. When not given, the buffers come from
+   * the pool set with set_planned_memory_pool(), or from a pool of the
+   * method's own.
    * @param[in] event_tracer Per-method event tracer to profile/trace methods
    * individually. When not given, the event tracer passed to the Module
    * constructor is used. Otherwise, this per-method event tracer takes
@@ -510,6 +513,35 @@ class Module {
     return event_tracer_.get();
   }
 
+  /**
+   * Sets the options to load methods with, e.g. to initialize their backend
+   * delegates in parallel. Only affects methods loaded after this call.
+   *
+   * @param[in] options The options to use. Any TaskRunner it points to must
+   * outlive the calls that load methods.
+   */
+  inline void set_method_load_options(
+      const runtime::MethodLoadOptions& options) {
+    method_load_options_ = options;
+  }
+
+  /**
+   * Sets the pool that methods loaded after this call take their
+   * memory-planned buffers from, unless load_method() is given planned memory.
+   * By default, each method maps buffers of its own.
+   *
+   * The pool may be shared with other Modules, and must only be shared by
+   * methods that can use the same memory; see PlannedMemoryPool. Before a
+   * method leases memory from the pool, the pool reserves room for all methods
+   * of the program, which only costs address space until they run.
+   *
+   * @param[in] pool The pool to use, or nullptr to go back to the default.
+   */
+  inline void set_planned_memory_pool(
+      std::shared_ptr<PlannedMemoryPool> pool) {
+    planned_memory_pool_ = std::move(pool);
+  }
+
   ET_NODISCARD
   runtime::Span<uint8_t> debug_buffer() {
     return runtime::Span<uint8_t>(debug_buffer_.data(), debug_buffer_.size());
@@ -517,9 +549,8 @@ class Module {
 
  private:
   struct MethodHolder {
-    std::vector<std::vector<uint8_t>> planned_buffers;
-    std::vector<runtime::Span<uint8_t>> planned_spans;
-    std::unique_ptr<runtime::HierarchicalAllocator> planned_memory;
+    std::shared_ptr<PlannedMemoryPool> planned_memory_pool;
+    std::unique_ptr<PlannedMemoryPool::Lease> planned_memory;
     std::unique_ptr<runtime::MemoryManager> memory_manager;
     std::unique_ptr<Method> method;
     std::vector<runtime::EValue> inputs;
@@ -536,6 +567,8 @@ class Module {
   std::unique_ptr<runtime::DataLoader> data_map_loader_;
   std::unique_ptr<NamedDataMap> data_map_;
   std::vector<uint8_t> debug_buffer_;
+  runtime::MethodLoadOptions method_load_options_;
+  std::shared_ptr<PlannedMemoryPool> planned_memory_pool_;
 
  protected:
   std::unordered_map<std::string, MethodHolder> methods_;
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/planned_memory_pool.h>
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <executorch/extension/data_loader/mman.h>
+#include <executorch/runtime/platform/assert.h>
+#include <executorch/runtime/platform/log.h>
+
+namespace executorch {
+namespace extension {
+
+using runtime::Error;
+using runtime::MethodMeta;
+using runtime::Result;
+using runtime::Span;
+
+namespace {
+
+#if defined(MAP_HUGETLB)
+// The huge page size to map, which mappings of huge pages must be a multiple
+// of. It is passed to mmap() explicitly, so that systems whose default huge
+// page size is different (e.g. 1GB) don't round the mapping up further or
+// fail it.
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+#if defined(MAP_HUGE_2MB)
+constexpr int kHugePageSizeFlag = MAP_HUGE_2MB;
+#elif defined(MAP_HUGE_SHIFT)
+// log2(kHugePageSize); glibc defines MAP_HUGE_SHIFT but not MAP_HUGE_2MB.
+constexpr int kHugePageSizeFlag = 21 << MAP_HUGE_SHIFT;
+#else
+constexpr int kHugePageSizeFlag = 0;
+#endif
+#endif
+
+size_t round_up(size_t size, size_t alignment) {
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+PlannedMemoryPool::Lease::Lease(
+    PlannedMemoryPool* pool,
+    std::vector<Span<uint8_t>> spans)
+    : pool_(pool),
+      spans_(std::move(spans)),
+      planned_memory_({spans_.data(), spans_.size()}) {
+  pool_->num_leases_++;
+}
+
+PlannedMemoryPool::Lease::~Lease() {
+  pool_->num_leases_--;
+}
+
+PlannedMemoryPool::PlannedMemoryPool(HugePages huge_pages)
+    : huge_pages_(huge_pages) {}
+
+PlannedMemoryPool::~PlannedMemoryPool() {
+  ET_CHECK_MSG(
+      num_leases_ == 0,
+      "%zu leases outlive their PlannedMemoryPool",
+      num_leases_);
+  for (const auto& buffer : buffers_) {
+    unmap_buffer(buffer);
+  }
+}
+
+Error PlannedMemoryPool::reserve(const MethodMeta& method_meta) {
+  const size_t num_buffers = method_meta.num_memory_planned_buffers();
+  for (size_t index = 0; index < num_buffers; ++index) {
+    const auto size = static_cast<size_t>(
+        method_meta.memory_planned_buffer_size(index).get());
+    if (index < buffers_.size() && size <= buffers_[index].size) {
+      continue;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        num_leases_ == 0,
+        InvalidState,
+        "Planned buffer %zu of %s needs %zu bytes, but the pool maps %zu and "
+        "can't grow while methods lease memory from it; reserve() room for "
+        "all methods first",
+        index,
+        method_meta.name(),
+        size,
+        index < buffers_.size() ? buffers_[index].size : 0);
+    auto buffer = map_buffer(size);
+    if (!buffer.ok()) {
+      return buffer.error();
+    }
+    if (index < buffers_.size()) {
+      unmap_buffer(buffers_[index]);
+      buffers_[index] = buffer.get();
+    } else {
+      // Indices below this one were handled by earlier iterations.
+      buffers_.push_back(buffer.get());
+    }
+  }
+  return Error::Ok;
+}
+
+Result<std::unique_ptr<PlannedMemoryPool::Lease>> PlannedMemoryPool::lease(
+    const MethodMeta& method_meta) {
+  ET_CHECK_OK_OR_RETURN_ERROR(reserve(method_meta));
+  const size_t num_buffers = method_meta.num_memory_planned_buffers();
+  std::vector<Span<uint8_t>> spans;
+  spans.reserve(num_buffers);
+  for (size_t index = 0; index < num_buffers; ++index) {
+    spans.emplace_back(
+        buffers_[index].data,
+        static_cast<size_t>(
+            method_meta.memory_planned_buffer_size(index).get()));
+  }
+  return std::unique_ptr<Lease>(new Lease(this, std::move(spans)));
+}
+
+size_t PlannedMemoryPool::mapped_size() const {
+  size_t size = 0;
+  for (const auto& buffer : buffers_) {
+    size += buffer.size;
+  }
+  return size;
+}
+
+Result<PlannedMemoryPool::Buffer> PlannedMemoryPool::map_buffer(
+    size_t size) const {
+  if (size == 0) {
+    // mmap() fails for empty mappings.
+    return Buffer{nullptr, 0};
+  }
+#if defined(MAP_HUGETLB)
+  if (huge_pages_ == HugePages::Reserved) {
+    const size_t mapped_size = round_up(size, kHugePageSize);
+    void* data = ::mmap(
+        nullptr,
+        mapped_size,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | kHugePageSizeFlag,
+        -1,
+        0);
+    if (data != MAP_FAILED) {
+      return Buffer{static_cast<uint8_t*>(data), mapped_size};
+    }
+    ET_LOG(
+        Info,
+        "Mapping %zu bytes of huge pages failed: %s (%d); using regular pages",
+        mapped_size,
+        ::strerror(errno),
+        errno);
+  }
+#endif
+  const size_t mapped_size = round_up(size, get_os_page_size());
+  void* data = ::mmap(
+      nullptr,
+      mapped_size,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS,
+      -1,
+      0);
+  if (data == MAP_FAILED) {
+    ET_LOG(
+        Error,
+        "mmap(..., size=%zu, ...) failed: %s (%d)",
+        mapped_size,
+        ::strerror(errno),
+        errno);
+    return Error::MemoryAllocationFailed;
+  }
+#if defined(MADV_HUGEPAGE)
+  if (huge_pages_ == HugePages::Transparent) {
+    if (::madvise(data, mapped_size, MADV_HUGEPAGE) != 0) {
+      ET_LOG(
+          Info,
+          "madvise(MADV_HUGEPAGE) failed: %s (%d) (ignored)",
+          ::strerror(errno),
+          errno);
+    }
+  }
+#endif
+  return Buffer{static_cast<uint8_t*>(data), mapped_size};
+}
+
+void PlannedMemoryPool::unmap_buffer(const Buffer& buffer) {
+  if (buffer.data == nullptr) {
+    return;
+  }
+  if (::munmap(buffer.data, buffer.size) != 0) {
+    ET_LOG(
+        Error,
+        "munmap(%p, %zu) failed: %s (%d) (ignored)",
+        buffer.data,
+        buffer.size,
+        ::strerror(errno),
+        errno);
+  }
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <executorch/runtime/core/hierarchical_allocator.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/executor/method_meta.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * Provides the memory-planned buffers of methods from page-aligned anonymous
+ * memory mappings. The OS only commits a page when a method first touches it,
+ * so parts of a memory plan that a run never reaches, like the unused context
+ * length of a KV cache, take address space but no memory.
+ *
+ * Buffer `i` of every method that leases memory from a pool is backed by the
+ * same mapping, which is as large as the largest of them. Methods that share a
+ * pool must never execute at the same time, and must not keep state in their
+ * planned memory from one execution to the next, since the other methods
+ * overwrite it. E.g. prefill and decode methods that keep their caches in
+ * memory that is not planned, or the methods of Modules that run one after
+ * the other.
+ *
+ * Not thread safe.
+ */
+class PlannedMemoryPool final {
+ public:
+  /// Whether the buffers use huge pages, which cut TLB misses on large
+  /// buffers.
+  enum class HugePages {
+    /// Use regular pages.
+    None,
+    /// Ask the OS to back the buffers with transparent huge pages, where it
+    /// supports them (MADV_HUGEPAGE).
+    Transparent,
+    /// Map the buffers from the pool of huge pages that the system reserved
+    /// (MAP_HUGETLB), and fall back to regular pages if it has too few free.
+    Reserved,
+  };
+
+  /**
+   * The planned memory of one method, backed by the buffers of a pool. The
+   * buffers can't grow while any lease of the pool exists, and a lease must
+   * not outlive its pool.
+   */
+  class Lease final {
+   public:
+    ~Lease();
+
+    /// The planned memory to pass to the MemoryManager of the method.
+    runtime::HierarchicalAllocator* planned_memory() {
+      return &planned_memory_;
+    }
+
+   private:
+    Lease(PlannedMemoryPool* pool, std::vector<runtime::Span<uint8_t>> spans);
+
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    Lease(Lease&&) = delete;
+    Lease& operator=(Lease&&) = delete;
+
+    PlannedMemoryPool* pool_;
+    std::vector<runtime::Span<uint8_t>> spans_;
+    runtime::HierarchicalAllocator planned_memory_;
+
+    friend class PlannedMemoryPool;
+  };
+
+  explicit PlannedMemoryPool(HugePages huge_pages = HugePages::None);
+  ~PlannedMemoryPool();
+
+  PlannedMemoryPool(const PlannedMemoryPool&) = delete;
+  PlannedMemoryPool& operator=(const PlannedMemoryPool&) = delete;
+  PlannedMemoryPool(PlannedMemoryPool&&) = delete;
+  PlannedMemoryPool& operator=(PlannedMemoryPool&&) = delete;
+
+  /**
+   * Grows the buffers of the pool to fit the planned memory of a method.
+   * Buffers can only grow while the pool has no leases, so reserve room for
+   * all methods that share the pool before leasing memory for any of them.
+   *
+   * @param[in] method_meta The metadata of the method.
+   *
+   * @retval Error::Ok The buffers fit the method.
+   * @retval Error::InvalidState A buffer has to grow, but the pool has leases.
+   * @retval Error::MemoryAllocationFailed A buffer could not be mapped.
+   */
+  ET_NODISCARD runtime::Error reserve(
+      const runtime::MethodMeta& method_meta);
+
+  /**
+   * Leases the planned memory of a method from the buffers of the pool,
+   * growing them first if needed.
+   *
+   * @param[in] method_meta The metadata of the method.
+   *
+   * @returns The lease, or an error that reserve() would return.
+   */
+  ET_NODISCARD runtime::Result<std::unique_ptr<Lease>> lease(
+      const runtime::MethodMeta& method_meta);
+
+  /**
+   * Returns the number of bytes that the buffers of the pool map, which is
+   * more than they commit until methods touch all of their pages.
+   */
+  size_t mapped_size() const;
+
+ private:
+  struct Buffer {
+    uint8_t* data;
+    size_t size;
+  };
+
+  ET_NODISCARD runtime::Result<Buffer> map_buffer(size_t size) const;
+  static void unmap_buffer(const Buffer& buffer);
+
+  const HugePages huge_pages_;
+  std::vector<Buffer> buffers_;
+  size_t num_leases_ = 0;
+};
+
+} // namespace extension
+} // namespace executorch
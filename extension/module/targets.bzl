@@ -14,9 +14,11 @@ def define_common_targets():
             name = "module" + aten_suffix,
             srcs = [
                 "module.cpp",
+                "planned_memory_pool.cpp",
             ],
             exported_headers = [
                 "module.h",
+                "planned_memory_pool.h",
             ],
             visibility = [
                 "@EXECUTORCH_CLIENTS",
@@ -8,10 +8,16 @@
 
 #include <executorch/extension/module/module.h>
 
+#include <algorithm>
 #include <array>
 #include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/extension/tensor/tensor.h>
@@ -20,6 +26,25 @@
 using namespace ::executorch::extension;
 using namespace ::executorch::runtime;
 
+namespace {
+
+#if defined(__linux__)
+// Returns how many of the pages in [data, data + size) are resident, or -1 if
+// mincore() fails.
+ssize_t count_resident_pages(void* data, size_t size) {
+  const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  std::vector<unsigned char> resident((size + page_size - 1) / page_size);
+  if (::mincore(data, size, resident.data()) != 0) {
+    return -1;
+  }
+  return std::count_if(resident.begin(), resident.end(), [](unsigned char r) {
+    return (r & 1) != 0;
+  });
+}
+#endif
+
+} // namespace
+
 class ModuleTest : public ::testing::Test {
  protected:
   static void SetUpTestSuite() {
@@ -485,3 +510,80 @@ TEST_F(ModuleTest, TestPTD) {
   auto tensor = make_tensor_ptr({2, 2}, {2.f, 3.f, 4.f, 2.f});
   ASSERT_EQ(module.forward(tensor).error(), Error::Ok);
 }
+
+TEST_F(ModuleTest, TestSharedPlannedMemoryPool) {
+  auto pool = std::make_shared<PlannedMemoryPool>();
+  Module module1(model_path_);
+  Module module2(add_mul_path_, add_mul_data_path_);
+  module1.set_planned_memory_pool(pool);
+  module2.set_planned_memory_pool(pool);
+
+  const auto meta1 = module1.method_meta("forward");
+  ASSERT_EQ(meta1.error(), Error::Ok);
+  const auto meta2 = module2.method_meta("forward");
+  ASSERT_EQ(meta2.error(), Error::Ok);
+  ASSERT_EQ(pool->reserve(meta1.get()), Error::Ok);
+  ASSERT_EQ(pool->reserve(meta2.get()), Error::Ok);
+  const auto mapped_size = pool->mapped_size();
+
+  auto tensor = make_tensor_ptr({2, 2}, {1.f, 2.f, 3.f, 4.f});
+  const auto result1 = module1.execute("forward", {tensor, tensor, 1.0});
+  ASSERT_EQ(result1.error(), Error::Ok);
+  const auto expected = make_tensor_ptr({2, 2}, {2.f, 4.f, 6.f, 8.f});
+  EXPECT_TENSOR_CLOSE(result1->at(0).toTensor(), *expected.get());
+
+  EXPECT_EQ(module2.forward(tensor).error(), Error::Ok);
+
+  // Both methods lease the buffers that were reserved for them.
+  EXPECT_EQ(pool->mapped_size(), mapped_size);
+}
+
+TEST_F(ModuleTest, TestPlannedMemoryPoolWithHugePages) {
+  for (const auto huge_pages :
+       {PlannedMemoryPool::HugePages::Transparent,
+        PlannedMemoryPool::HugePages::Reserved}) {
+    Module module(model_path_);
+    auto pool = std::make_shared<PlannedMemoryPool>(huge_pages);
+    module.set_planned_memory_pool(pool);
+    const auto meta = module.method_meta("forward");
+    ASSERT_EQ(meta.error(), Error::Ok);
+    ASSERT_EQ(meta->num_memory_planned_buffers(), 1u);
+
+#if defined(__linux__)
+    const auto planned_size =
+        static_cast<size_t>(meta->memory_planned_buffer_size(0).get());
+    // Returns where the pool maps the planned buffer of the method.
+    const auto buffer_data = [&]() -> void* {
+      auto lease = pool->lease(meta.get());
+      EXPECT_EQ(lease.error(), Error::Ok);
+      if (!lease.ok()) {
+        return nullptr;
+      }
+      auto data =
+          lease.get()->planned_memory()->get_offset_address(0, 0, planned_size);
+      EXPECT_EQ(data.error(), Error::Ok);
+      return data.ok() ? data.get() : nullptr;
+    };
+
+    // Mapping the buffer commits none of it.
+    void* data = buffer_data();
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(count_resident_pages(data, pool->mapped_size()), 0);
+#endif
+
+    auto tensor = make_tensor_ptr({2, 2}, {1.f, 2.f, 3.f, 4.f});
+
+    // Falls back to regular pages where huge pages are not available.
+    const auto result = module.execute("forward", {tensor, tensor, 1.0});
+    ASSERT_EQ(result.error(), Error::Ok);
+
+    const auto expected = make_tensor_ptr({2, 2}, {2.f, 4.f, 6.f, 8.f});
+    EXPECT_TENSOR_CLOSE(result->at(0).toTensor(), *expected.get());
+
+#if defined(__linux__)
+    // Running the method commits the pages that it touched.
+    EXPECT_EQ(buffer_data(), data);
+    EXPECT_GT(count_resident_pages(data, pool->mapped_size()), 0);
+#endif
+  }
+}
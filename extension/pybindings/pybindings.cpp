@@ -10,6 +10,8 @@
 #include <cstdio>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <unordered_map>
 
@@ -99,6 +101,7 @@ using torch::executor::ETDumpGen;
 #ifndef USE_ATEN_LIB
 using ::executorch::extension::alias_attensor_to_etensor;
 using ::executorch::extension::alias_etensor_to_attensor;
+using ::executorch::extension::executorch_to_torch_scalar_type;
 using ::executorch::extension::torch_to_executorch_scalar_type;
 #endif // !USE_ATEN_LIB
 
@@ -126,6 +129,103 @@ void write_data_to_file(const std::string& path, void* buf, size_t size) {
   }
 }
 
+/**
+ * Redirects std::cout and std::cerr to Python's sys.stdout and sys.stderr for
+ * the duration of a bound call, like py::scoped_ostream_redirect and
+ * py::scoped_estream_redirect, but steps aside while the call releases the GIL
+ * through GilRelease.
+ *
+ * The pybind11 redirections swap the buffers of the process-wide streams and
+ * put the previous ones back when they end, which is only correct if the
+ * redirections of different threads never overlap. Keeping them within the
+ * periods a thread holds the GIL guarantees that.
+ */
+class StreamRedirect final {
+ public:
+  StreamRedirect() : previous_(current_) {
+    current_ = this;
+    resume();
+  }
+
+  ~StreamRedirect() {
+    suspend();
+    current_ = previous_;
+  }
+
+  StreamRedirect(const StreamRedirect&) = delete;
+  StreamRedirect& operator=(const StreamRedirect&) = delete;
+  StreamRedirect(StreamRedirect&&) = delete;
+  StreamRedirect& operator=(StreamRedirect&&) = delete;
+
+  /// The innermost redirection active on the calling thread, if any.
+  static StreamRedirect* current() {
+    return current_;
+  }
+
+  void suspend() {
+    err_.reset();
+    out_.reset();
+  }
+
+  void resume() {
+    out_.emplace();
+    err_.emplace();
+  }
+
+ private:
+  static inline thread_local StreamRedirect* current_ = nullptr;
+
+  StreamRedirect* previous_;
+  std::optional<py::scoped_ostream_redirect> out_;
+  std::optional<py::scoped_estream_redirect> err_;
+};
+
+/**
+ * Releases the GIL for its lifetime, suspending the calling thread's
+ * StreamRedirect meanwhile. Output written while the GIL is released goes to
+ * the process's own stdout and stderr.
+ */
+class GilRelease final {
+ public:
+  GilRelease() : redirect_(StreamRedirect::current()) {
+    if (redirect_ != nullptr) {
+      redirect_->suspend();
+    }
+    release_.emplace();
+  }
+
+  ~GilRelease() {
+    release_.reset();
+    if (redirect_ != nullptr) {
+      redirect_->resume();
+    }
+  }
+
+  GilRelease(const GilRelease&) = delete;
+  GilRelease& operator=(const GilRelease&) = delete;
+  GilRelease(GilRelease&&) = delete;
+  GilRelease& operator=(GilRelease&&) = delete;
+
+ private:
+  StreamRedirect* redirect_;
+  std::optional<py::gil_scoped_release> release_;
+};
+
+/// Locks `mutex` with the GIL released. A thread holding the mutex may need to
+/// re-acquire the GIL to marshal outputs after executing, so waiting on the
+/// mutex while holding the GIL could deadlock.
+std::unique_lock<std::mutex> lock_without_gil(std::mutex& mutex) {
+  GilRelease release;
+  return std::unique_lock<std::mutex>(mutex);
+}
+
+/// Executes `method` with the GIL released so that other Python threads,
+/// including ones running other modules, can make progress meanwhile.
+Error execute_without_gil(Method& method) {
+  GilRelease release;
+  return method.execute();
+}
+
 void setup_output_storage(
     Method& method,
     const std::vector<Span<uint8_t>>& output_storages) {
@@ -154,6 +254,239 @@ void setup_output_storage(
   }
 }
 
+/// Converts the `outputs` argument of the functions that execute a method to
+/// one entry per method output. Entries for outputs without a destination
+/// tensor are undefined.
+std::vector<at::Tensor> parse_output_tensors(
+    const py::object& outputs,
+    size_t num_outputs) {
+  std::vector<at::Tensor> output_tensors(num_outputs);
+  if (outputs.is_none()) {
+    return output_tensors;
+  }
+  const auto sequence = outputs.cast<py::sequence>();
+  if (py::len(sequence) != num_outputs) {
+    throw std::runtime_error(
+        "Expected " + std::to_string(num_outputs) +
+        " output tensors (or None), got " +
+        std::to_string(py::len(sequence)));
+  }
+  for (size_t i = 0; i < num_outputs; ++i) {
+    py::object output = sequence[i];
+    if (!output.is_none()) {
+      output_tensors[i] = output.cast<at::Tensor>();
+    }
+  }
+  return output_tensors;
+}
+
+/**
+ * The buffers that the tensor outputs of one method are written into, kept
+ * across its executions.
+ *
+ * Outputs that are not memory planned are written into the caller's tensor if
+ * one is given, and otherwise into a buffer owned by this class. The tensors
+ * handed to Python keep that buffer alive: it is reused by a later execution
+ * once Python has dropped every tensor that refers to it, and replaced by a
+ * new one otherwise, so these outputs are never copied or overwritten.
+ *
+ * Memory planned outputs live in the method's own memory, which cannot be
+ * redirected. When one is returned without a clone, Python gets an alias of
+ * that memory, and the next prepare() moves each alias that is still alive to
+ * a copy of its own before the execution overwrites the memory. Aliases that
+ * were dropped by then cost no copy at all.
+ */
+class OutputBuffers final {
+ public:
+  OutputBuffers() = default;
+  OutputBuffers(OutputBuffers&&) = default;
+  OutputBuffers& operator=(OutputBuffers&&) = default;
+
+  /// Copies out the aliases that are still alive, since the method's memory
+  /// is about to be freed.
+  ~OutputBuffers() {
+    detach_planned_aliases();
+  }
+
+  /**
+   * Points the tensor outputs of `method` that are not memory planned at the
+   * buffers for its next execution. Defined entries of `output_tensors` are
+   * used as the destination of the corresponding output.
+   */
+  void prepare(Method& method, const std::vector<at::Tensor>& output_tensors) {
+    detach_planned_aliases();
+    const auto num_outputs = method.outputs_size();
+    // Drop the previous execution's references first, so that they do not
+    // count as users of the owned buffers.
+    storages_.assign(num_outputs, at::Tensor());
+    owned_.resize(num_outputs);
+    auto meta = method.method_meta();
+    for (size_t i = 0; i < num_outputs; ++i) {
+      auto output_type = meta.output_tag(i);
+      THROW_IF_ERROR(
+          output_type.error(), "Failed to get output type for output %zu", i);
+      if (output_type.get() != Tag::Tensor) {
+        // Skip allocating storage for non-tensor outputs.
+        continue;
+      }
+      const auto& output_tensor_meta = meta.output_tensor_meta(i);
+      THROW_IF_ERROR(
+          output_tensor_meta.error(),
+          "Failed to get output tensor meta for output %zu",
+          i);
+      if (output_tensor_meta.get().is_memory_planned()) {
+        // Memory planned outputs are written to the method's own memory.
+        continue;
+      }
+      const size_t output_size = output_tensor_meta.get().nbytes();
+      if (i >= output_tensors.size() || !output_tensors[i].defined()) {
+        if (!owned_[i].defined() || owned_[i].use_count() > 1) {
+          // Python still holds the last result written here; leave it alone.
+          owned_[i] = at::empty(
+              {static_cast<int64_t>(output_size)},
+              at::TensorOptions(at::kByte));
+        }
+        storages_[i] = owned_[i];
+        continue;
+      }
+      const at::Tensor& output = output_tensors[i];
+#ifdef USE_ATEN_LIB
+      const auto expected_dtype = output_tensor_meta.get().scalar_type();
+#else
+      const auto expected_dtype = executorch_to_torch_scalar_type(
+          output_tensor_meta.get().scalar_type());
+#endif
+      if (output.scalar_type() != expected_dtype || !output.is_contiguous() ||
+          output.nbytes() < output_size) {
+        throw std::runtime_error(
+            "Output tensor " + std::to_string(i) + " for method " +
+            method.method_meta().name() + " should be a contiguous " +
+            c10::toString(expected_dtype) + " tensor of at least " +
+            std::to_string(output_size) + " bytes.");
+      }
+      storages_[i] = output;
+    }
+
+    std::vector<Span<uint8_t>> spans(num_outputs);
+    for (size_t i = 0; i < num_outputs; ++i) {
+      if (storages_[i].defined()) {
+        spans[i] = Span<uint8_t>(
+            static_cast<uint8_t*>(storages_[i].data_ptr()),
+            storages_[i].nbytes());
+      }
+    }
+    setup_output_storage(method, spans);
+  }
+
+  /// Where each output of the last execution was written, one entry per
+  /// output. Entries of memory planned and non-tensor outputs are undefined.
+  const std::vector<at::Tensor>& storages() const {
+    return storages_;
+  }
+
+  /// Returns a tensor that aliases `tensor`, a memory planned output, until
+  /// the next prepare().
+  at::Tensor alias_planned_output(const at::Tensor& tensor) {
+    at::Tensor alias = at::from_blob(
+        tensor.data_ptr(), tensor.sizes(), tensor.strides(), tensor.options());
+    planned_aliases_.emplace_back(alias.getIntrusivePtr());
+    return alias;
+  }
+
+ private:
+  void detach_planned_aliases() {
+    for (const auto& weak_alias : planned_aliases_) {
+      at::Tensor alias(weak_alias.lock());
+      if (alias.defined()) {
+        alias.set_(alias.clone());
+      }
+    }
+    planned_aliases_.clear();
+  }
+
+  /// Buffers allocated for outputs without a caller-provided tensor.
+  std::vector<at::Tensor> owned_;
+  /// Where each output of the last execution was written.
+  std::vector<at::Tensor> storages_;
+  /// Tensors handed out by alias_planned_output() since the last prepare().
+  std::vector<
+      c10::weak_intrusive_ptr<c10::TensorImpl, c10::UndefinedTensorImpl>>
+      planned_aliases_;
+};
+
+/**
+ * Converts the outputs of an execution to Python objects.
+ *
+ * Tensor outputs that were written into `buffers` are returned without a
+ * copy. Memory planned outputs are copied into their entry of
+ * `output_tensors` if there is one, cloned if `clone_outputs` is true, and
+ * otherwise aliased until the next execution; see OutputBuffers.
+ */
+py::list get_outputs_as_py_list(
+    const std::vector<EValue>& outputs,
+    OutputBuffers& buffers,
+    const std::vector<at::Tensor>& output_tensors,
+    bool clone_outputs) {
+  const auto& output_storages = buffers.storages();
+  const auto outputs_size = outputs.size();
+  py::list list(outputs_size);
+  for (size_t i = 0; i < outputs_size; ++i) {
+    auto& v = outputs[i];
+    if (Tag::None == v.tag) {
+      list[i] = py::none();
+    } else if (Tag::Int == v.tag) {
+      list[i] = py::cast(v.toInt());
+    } else if (Tag::Double == v.tag) {
+      list[i] = py::cast(v.toDouble());
+    } else if (Tag::Bool == v.tag) {
+      list[i] = py::cast(v.toBool());
+    } else if (Tag::String == v.tag) {
+      list[i] = py::cast(std::string(v.toString().data()));
+    } else if (Tag::Tensor == v.tag) {
+#ifdef USE_ATEN_LIB
+      at::Tensor tensor = v.toTensor();
+#else
+      at::Tensor tensor = alias_attensor_to_etensor(v.toTensor());
+#endif
+      const bool has_storage =
+          i < output_storages.size() && output_storages[i].defined();
+      const bool has_output_tensor =
+          i < output_tensors.size() && output_tensors[i].defined();
+      if (has_storage && has_output_tensor &&
+          output_tensors[i].sizes() == tensor.sizes() &&
+          output_tensors[i].strides() == tensor.strides()) {
+        // Already written in place with the shape the caller gave.
+        list[i] = py::cast(output_tensors[i]);
+      } else if (has_output_tensor && !has_storage) {
+        at::Tensor output = output_tensors[i];
+        output.resize_(tensor.sizes());
+        output.copy_(tensor);
+        list[i] = py::cast(output);
+      } else if (has_storage) {
+        // Alias the output and tie the lifetime of its buffer to the alias.
+        // This leaves the shape of a caller's output tensor alone when a
+        // dynamic output comes out smaller than it.
+        at::Tensor storage = output_storages[i];
+        list[i] = py::cast(at::from_blob(
+            tensor.data_ptr(),
+            tensor.sizes(),
+            tensor.strides(),
+            [storage](void*) {},
+            tensor.options()));
+      } else if (clone_outputs) {
+        // Clone so the outputs in python do not share a lifetime with the
+        // module object
+        list[i] = py::cast(tensor.clone());
+      } else {
+        list[i] = py::cast(buffers.alias_planned_output(tensor));
+      }
+    } else {
+      ET_ASSERT_UNREACHABLE_MSG("Invalid model output type");
+    }
+  }
+  return list;
+}
+
 class Module final {
  public:
   explicit Module(
@@ -269,7 +602,7 @@ class Module final {
     if (output_storages) {
       setup_output_storage(method, *output_storages);
     }
-    Error execute_status = method.execute();
+    Error execute_status = execute_without_gil(method);
     THROW_IF_ERROR(
         execute_status,
         "method->execute() failed with error 0x%" PRIx32,
@@ -706,7 +1039,9 @@ struct PyModule final {
   py::list run_method(
       const std::string& method_name,
       const py::sequence& inputs,
-      bool clone_outputs = true) {
+      bool clone_outputs = true,
+      const py::object& outputs = py::none()) {
+    auto lock = lock_without_gil(*mutex_);
     const auto inputs_size = py::len(inputs);
     std::vector<EValue> cpp_inputs;
     cpp_inputs.reserve(inputs_size);
@@ -793,31 +1128,32 @@ struct PyModule final {
       }
     }
 
-    const auto& method = module_->get_method(method_name);
-    const auto num_outputs = method.outputs_size();
-    output_storages_ = make_output_storages(method);
-    std::vector<Span<uint8_t>> output_storage_spans(num_outputs);
-    for (int i = 0; i < output_storages_.size(); ++i) {
-      output_storage_spans[i] =
-          Span<uint8_t>(output_storages_[i].data(), output_storages_[i].size());
-    }
-    auto outputs =
-        module_->run_method(method_name, cpp_inputs, output_storage_spans);
+    auto& method = module_->get_method(method_name);
+    const auto output_tensors =
+        parse_output_tensors(outputs, method.outputs_size());
+    auto& buffers = output_buffers_[method_name];
+    buffers.prepare(method, output_tensors);
+    auto cpp_outputs = module_->run_method(method_name, cpp_inputs);
 
     // Retrieve outputs
-    return get_outputs_as_py_list(outputs, clone_outputs);
+    return get_outputs_as_py_list(
+        cpp_outputs, buffers, output_tensors, clone_outputs);
   }
 
-  py::list forward(const py::sequence& inputs, bool clone_outputs = true) {
-    return run_method("forward", inputs, clone_outputs);
+  py::list forward(
+      const py::sequence& inputs,
+      bool clone_outputs = true,
+      const py::object& outputs = py::none()) {
+    return run_method("forward", inputs, clone_outputs, outputs);
   }
 
   py::list forward_single_input(
       const torch::Tensor& inputTensor,
-      bool clone_outputs = true) {
+      bool clone_outputs = true,
+      const py::object& outputs = py::none()) {
     py::list py_list;
     py_list.append(py::cast(inputTensor));
-    return run_method("forward", py_list, clone_outputs);
+    return run_method("forward", py_list, clone_outputs, outputs);
   }
 
   bool has_etdump() {
@@ -827,6 +1163,7 @@ struct PyModule final {
   void write_etdump_result_to_file(
       const std::string& path,
       const py::object& debug_buffer_path) {
+    auto lock = lock_without_gil(*mutex_);
     if (!has_etdump()) {
       throw std::runtime_error("No etdump found");
     }
@@ -857,6 +1194,7 @@ struct PyModule final {
       PyBundledModule& m,
       const std::string method_name,
       size_t testset_idx) {
+    auto lock = lock_without_gil(*mutex_);
     const void* bundled_program_ptr = m.get_bundled_program_ptr();
     Error status = executorch::BUNDLED_PROGRAM_NAMESPACE::load_bundled_input(
         module_->get_method(method_name), bundled_program_ptr, testset_idx);
@@ -872,6 +1210,7 @@ struct PyModule final {
       size_t testset_idx,
       double rtol = 1e-5,
       double atol = 1e-8) {
+    auto lock = lock_without_gil(*mutex_);
     const void* bundled_program_ptr = m.get_bundled_program_ptr();
     auto& method = module_->get_method(method_name);
     Error status = executorch::BUNDLED_PROGRAM_NAMESPACE::load_bundled_input(
@@ -880,7 +1219,7 @@ struct PyModule final {
         status,
         "load_bundled_input failed with status 0x%" PRIx32,
         static_cast<uint32_t>(status));
-    py::list outputs = plan_execute(method_name);
+    py::list outputs = plan_execute_locked(method_name);
     status = executorch::BUNDLED_PROGRAM_NAMESPACE::verify_method_outputs(
         method, bundled_program_ptr, testset_idx, rtol, atol);
     THROW_IF_ERROR(
@@ -892,64 +1231,30 @@ struct PyModule final {
 
   py::list plan_execute(
       const std::string method_name,
-      bool clone_outputs = true) {
+      bool clone_outputs = true,
+      const py::object& outputs = py::none()) {
+    auto lock = lock_without_gil(*mutex_);
+    return plan_execute_locked(method_name, clone_outputs, outputs);
+  }
+
+  py::list plan_execute_locked(
+      const std::string method_name,
+      bool clone_outputs = true,
+      const py::object& outputs = py::none()) {
     auto& method = module_->get_method(method_name);
     // Need to pre-allocate space for outputs just like in run_method.
-    const auto num_outputs = method.outputs_size();
-    output_storages_ = make_output_storages(method);
-    std::vector<Span<uint8_t>> output_storage_spans(num_outputs);
-    for (int i = 0; i < output_storages_.size(); ++i) {
-      output_storage_spans[i] =
-          Span<uint8_t>(output_storages_[i].data(), output_storages_[i].size());
-    }
-    setup_output_storage(method, output_storage_spans);
-    auto status = method.execute();
+    const auto output_tensors =
+        parse_output_tensors(outputs, method.outputs_size());
+    auto& buffers = output_buffers_[method_name];
+    buffers.prepare(method, output_tensors);
+    auto status = execute_without_gil(method);
     THROW_IF_ERROR(
         status,
         "executing execution plan for method 'forward' failed with error: 0x%" PRIx32,
         static_cast<uint32_t>(status));
-    const auto outputs = module_->get_outputs(method_name);
-    return get_outputs_as_py_list(outputs, clone_outputs);
-  }
-
-  py::list get_outputs_as_py_list(
-      const std::vector<EValue>& outputs,
-      bool clone_outputs = true) {
-    const auto outputs_size = outputs.size();
-    py::list list(outputs_size);
-    for (size_t i = 0; i < outputs_size; ++i) {
-      auto& v = outputs[i];
-      if (Tag::None == v.tag) {
-        list[i] = py::none();
-      } else if (Tag::Int == v.tag) {
-        list[i] = py::cast(v.toInt());
-      } else if (Tag::Double == v.tag) {
-        list[i] = py::cast(v.toDouble());
-      } else if (Tag::Bool == v.tag) {
-        list[i] = py::cast(v.toBool());
-      } else if (Tag::String == v.tag) {
-        list[i] = py::cast(std::string(v.toString().data()));
-      } else if (Tag::Tensor == v.tag) {
-#ifdef USE_ATEN_LIB
-        // Clone so the outputs in python do not share a lifetime with the
-        // module object
-        if (clone_outputs) {
-          list[i] = py::cast(v.toTensor().clone());
-        } else {
-          list[i] = py::cast(v.toTensor());
-        }
-#else
-        if (clone_outputs) {
-          list[i] = py::cast(alias_attensor_to_etensor(v.toTensor()).clone());
-        } else {
-          list[i] = py::cast(alias_attensor_to_etensor(v.toTensor()));
-        }
-#endif
-      } else {
-        ET_ASSERT_UNREACHABLE_MSG("Invalid model output type");
-      }
-    }
-    return list;
+    const auto cpp_outputs = module_->get_outputs(method_name);
+    return get_outputs_as_py_list(
+        cpp_outputs, buffers, output_tensors, clone_outputs);
   }
 
   std::unique_ptr<PyMethodMeta> method_meta(const std::string method_name) {
@@ -963,43 +1268,11 @@ struct PyModule final {
 
  private:
   std::shared_ptr<Module> module_;
-  // Need to keep-alive output storages until they can be compared in case of
-  // bundled programs.
-  std::vector<std::vector<uint8_t>> output_storages_;
-
-  std::vector<std::vector<uint8_t>> make_output_storages(const Method& method) {
-    const auto num_outputs = method.outputs_size();
-    // Create a buffer for each output tensor. Memory planned outputs and non
-    // tensor outputs get an empty buffer in this list which is ignored later.
-    std::vector<std::vector<uint8_t>> output_storages;
-    output_storages_.reserve(num_outputs);
-    auto meta = method.method_meta();
-    for (size_t i = 0; i < num_outputs; ++i) {
-      auto output_type = meta.output_tag(i);
-      THROW_IF_ERROR(
-          output_type.error(), "Failed to get output type for output %zu", i);
-      if (output_type.get() != Tag::Tensor) {
-        // Skip allocating storage for non-tensor outputs.
-        output_storages.emplace_back();
-        continue;
-      }
-      const auto& output_tensor_meta =
-          method.method_meta().output_tensor_meta(i);
-      THROW_IF_ERROR(
-          output_tensor_meta.error(),
-          "Failed to get output tensor meta for output %zu",
-          i);
-      if (output_tensor_meta.get().is_memory_planned()) {
-        // Skip allocating storage for planned memory outputs.
-        output_storages.emplace_back();
-        continue;
-      }
-      // Allocate storage for the output tensor.
-      const size_t output_size = output_tensor_meta.get().nbytes();
-      output_storages.emplace_back(output_size);
-    }
-    return output_storages;
-  }
+  // Where the outputs of each method are written; see OutputBuffers.
+  std::unordered_map<std::string, OutputBuffers> output_buffers_;
+  // Serializes calls on this module; see lock_without_gil(). Held by pointer
+  // so that the struct stays movable.
+  std::unique_ptr<std::mutex> mutex_ = std::make_unique<std::mutex>();
 };
 
 inline std::unique_ptr<DataLoader> loader_from_buffer(
@@ -1091,6 +1364,33 @@ struct PyMethod final {
         method_(std::move(method)) {}
 
   void set_inputs(const py::sequence& inputs) {
+    auto lock = lock_without_gil(*mutex_);
+    set_inputs_locked(inputs);
+  }
+
+  void execute(const py::object& outputs = py::none()) {
+    auto lock = lock_without_gil(*mutex_);
+    execute_locked(outputs);
+  }
+
+  py::list get_outputs(bool clone_outputs = true) {
+    auto lock = lock_without_gil(*mutex_);
+    return get_outputs_locked(clone_outputs);
+  }
+
+  /// Sets the inputs, executes and reads the outputs without letting calls
+  /// from other threads interleave.
+  py::list call(
+      const py::sequence& inputs,
+      bool clone_outputs = true,
+      const py::object& outputs = py::none()) {
+    auto lock = lock_without_gil(*mutex_);
+    set_inputs_locked(inputs);
+    execute_locked(outputs);
+    return get_outputs_locked(clone_outputs);
+  }
+
+  void set_inputs_locked(const py::sequence& inputs) {
     const auto inputs_size = py::len(inputs);
     std::vector<EValue> cpp_inputs;
     cpp_inputs.reserve(inputs_size);
@@ -1177,14 +1477,8 @@ struct PyMethod final {
         static_cast<uint32_t>(set_inputs_status));
   }
 
-  void execute() {
-    const auto num_outputs = method_->outputs_size();
-    allocate_output_storages();
-    std::vector<Span<uint8_t>> output_storage_spans(num_outputs);
-    for (int i = 0; i < output_storages_.size(); ++i) {
-      output_storage_spans[i] =
-          Span<uint8_t>(output_storages_[i].data(), output_storages_[i].size());
-    }
+  void execute_locked(const py::object& outputs = py::none()) {
+    output_tensors_ = parse_output_tensors(outputs, method_->outputs_size());
 #ifdef USE_ATEN_LIB
     // [TLS handling] This is to workaround an assertion failure
     // (https://fburl.com/code/302jyn8d) running `gelu` in ATen mode in fbcode
@@ -1198,15 +1492,15 @@ struct PyMethod final {
     c10::impl::ExcludeDispatchKeyGuard no_autograd(
         c10::autograd_dispatch_keyset);
 #endif
-    setup_output_storage(*method_, output_storage_spans);
-    Error execute_status = method_->execute();
+    output_buffers_.prepare(*method_, output_tensors_);
+    Error execute_status = execute_without_gil(*method_);
     THROW_IF_ERROR(
         execute_status,
         "method->execute() failed with error 0x%" PRIx32,
         static_cast<uint32_t>(execute_status));
   }
 
-  py::list get_outputs(bool clone_outputs = true) {
+  py::list get_outputs_locked(bool clone_outputs = true) {
     std::vector<EValue> result(method_->outputs_size());
 
     Error get_outputs_status =
@@ -1218,21 +1512,17 @@ struct PyMethod final {
         static_cast<uint32_t>(get_outputs_status));
 
     // Retrieve outputs
-    return get_outputs_as_py_list(result, clone_outputs);
-  }
-
-  py::list call(const py::sequence& inputs, bool clone_outputs = true) {
-    set_inputs(inputs);
-    execute();
-    return get_outputs(clone_outputs);
+    return get_outputs_as_py_list(
+        result, output_buffers_, output_tensors_, clone_outputs);
   }
 
   py::list call_single_input(
       const torch::Tensor& inputTensor,
-      bool clone_outputs = true) {
+      bool clone_outputs = true,
+      const py::object& outputs = py::none()) {
     py::list py_list;
     py_list.append(py::cast(inputTensor));
-    return call(py_list, clone_outputs);
+    return call(py_list, clone_outputs, outputs);
   }
 
   py::object get_attribute(const std::string& name) {
@@ -1261,85 +1551,12 @@ struct PyMethod final {
   // Method keeps a reference to the program, so we also need to keep this alive
   std::shared_ptr<ProgramState> state_;
   std::unique_ptr<Method> method_;
-  // Need to keep-alive output storages until they can be compared in case of
-  // bundled programs.
-  std::vector<std::vector<uint8_t>> output_storages_;
-
-  void allocate_output_storages() {
-    const auto num_outputs = method_->outputs_size();
-    // Skip if we already have the right number of storages.
-    if (output_storages_.size() == num_outputs) {
-      return;
-    }
-    // Create a buffer for each output tensor. Memory planned outputs and non
-    // tensor outputs get an empty buffer in this list which is ignored later.
-    output_storages_.reserve(num_outputs);
-    auto meta = method_->method_meta();
-    for (size_t i = 0; i < num_outputs; ++i) {
-      auto output_type = meta.output_tag(i);
-      THROW_IF_ERROR(
-          output_type.error(), "Failed to get output type for output %zu", i);
-      if (output_type.get() != Tag::Tensor) {
-        // Skip allocating storage for non-tensor outputs.
-        output_storages_.emplace_back();
-        continue;
-      }
-      const auto& output_tensor_meta =
-          method_->method_meta().output_tensor_meta(i);
-      THROW_IF_ERROR(
-          output_tensor_meta.error(),
-          "Failed to get output tensor meta for output %zu",
-          i);
-      if (output_tensor_meta.get().is_memory_planned()) {
-        // Skip allocating storage for planned memory outputs.
-        output_storages_.emplace_back();
-        continue;
-      }
-      // Allocate storage for the output tensor.
-      const size_t output_size = output_tensor_meta.get().nbytes();
-      output_storages_.emplace_back(output_size);
-    }
-  }
-
-  py::list get_outputs_as_py_list(
-      const std::vector<EValue>& outputs,
-      bool clone_outputs = true) {
-    const auto outputs_size = outputs.size();
-    py::list list(outputs_size);
-    for (size_t i = 0; i < outputs_size; ++i) {
-      auto& v = outputs[i];
-      if (Tag::None == v.tag) {
-        list[i] = py::none();
-      } else if (Tag::Int == v.tag) {
-        list[i] = py::cast(v.toInt());
-      } else if (Tag::Double == v.tag) {
-        list[i] = py::cast(v.toDouble());
-      } else if (Tag::Bool == v.tag) {
-        list[i] = py::cast(v.toBool());
-      } else if (Tag::String == v.tag) {
-        list[i] = py::cast(std::string(v.toString().data()));
-      } else if (Tag::Tensor == v.tag) {
-#ifdef USE_ATEN_LIB
-        // Clone so the outputs in python do not share a lifetime with the
-        // module object
-        if (clone_outputs) {
-          list[i] = py::cast(v.toTensor().clone());
-        } else {
-          list[i] = py::cast(v.toTensor());
-        }
-#else
-        if (clone_outputs) {
-          list[i] = py::cast(alias_attensor_to_etensor(v.toTensor()).clone());
-        } else {
-          list[i] = py::cast(alias_attensor_to_etensor(v.toTensor()));
-        }
-#endif
-      } else {
-        ET_ASSERT_UNREACHABLE_MSG("Invalid model output type");
-      }
-    }
-    return list;
-  }
+  // Where the outputs of the last execution were written; see OutputBuffers.
+  OutputBuffers output_buffers_;
+  std::vector<at::Tensor> output_tensors_;
+  // Serializes calls on this method; see lock_without_gil(). Held by pointer
+  // so that the struct stays movable.
+  std::unique_ptr<std::mutex> mutex_ = std::make_unique<std::mutex>();
 };
 
 struct PyProgram final {
@@ -1513,8 +1730,7 @@ py::bool_ is_available(const std::string& backend_name) {
 
 PYBIND11_MODULE(EXECUTORCH_PYTHON_MODULE_NAME, m) {
   // Redirects cout and cerr for function calls this guards to the python env.
-  auto call_guard = py::
-      call_guard<py::scoped_ostream_redirect, py::scoped_estream_redirect>();
+  auto call_guard = py::call_guard<StreamRedirect>();
 
   // Bind the verification enum to python.
   py::enum_<Program::Verification>(m, "Verification")
@@ -1598,6 +1814,7 @@ PYBIND11_MODULE(EXECUTORCH_PYTHON_MODULE_NAME, m) {
           &PyModule::plan_execute,
           py::arg("method_name"),
           py::arg("clone_outputs") = true,
+          py::arg("outputs") = py::none(),
           call_guard)
       .def(
           "method_meta",
@@ -1611,12 +1828,14 @@ PYBIND11_MODULE(EXECUTORCH_PYTHON_MODULE_NAME, m) {
           py::arg("method_name"),
           py::arg("inputs") = py::list(),
           py::arg("clone_outputs") = true,
+          py::arg("outputs") = py::none(),
           call_guard)
       .def(
           "forward",
           &PyModule::forward,
           py::arg("inputs") = py::list(),
           py::arg("clone_outputs") = true,
+          py::arg("outputs") = py::none(),
           call_guard)
       .def("has_etdump", &PyModule::has_etdump, call_guard)
       .def(
@@ -1630,12 +1849,14 @@ PYBIND11_MODULE(EXECUTORCH_PYTHON_MODULE_NAME, m) {
           &PyModule::forward,
           py::arg("inputs") = py::list(),
           py::arg("clone_outputs") = true,
+          py::arg("outputs") = py::none(),
           call_guard)
       .def(
           "__call__",
           &PyModule::forward_single_input,
           py::arg("inputs") = py::list(),
           py::arg("clone_outputs") = true,
+          py::arg("outputs") = py::none(),
           call_guard);
 
   py::class_<PyBundledModule>(m, "BundledModule");
@@ -1696,7 +1917,11 @@ PYBIND11_MODULE(EXECUTORCH_PYTHON_MODULE_NAME, m) {
           call_guard);
   py::class_<PyMethod>(m, "ExecuTorchMethod")
       .def("set_inputs", &PyMethod::set_inputs, py::arg("inputs"), call_guard)
-      .def("execute", &PyMethod::execute, call_guard)
+      .def(
+          "execute",
+          &PyMethod::execute,
+          py::arg("outputs") = py::none(),
+          call_guard)
       .def(
           "get_outputs",
           &PyMethod::get_outputs,
@@ -1707,24 +1932,28 @@ PYBIND11_MODULE(EXECUTORCH_PYTHON_MODULE_NAME, m) {
           &PyMethod::call,
           py::arg("inputs") = py::list(),
           py::arg("clone_outputs") = true,
+          py::arg("outputs") = py::none(),
           call_guard)
       .def(
           "call",
           &PyMethod::call_single_input,
           py::arg("inputs") = py::list(),
           py::arg("clone_outputs") = true,
+          py::arg("outputs") = py::none(),
           call_guard)
       .def(
           "__call__",
           &PyMethod::call,
           py::arg("inputs") = py::list(),
           py::arg("clone_outputs") = true,
+          py::arg("outputs") = py::none(),
           call_guard)
       .def(
           "__call__",
           &PyMethod::call_single_input,
           py::arg("inputs") = py::list(),
           py::arg("clone_outputs") = true,
+          py::arg("outputs") = py::none(),
           call_guard)
       .def(
           "get_attribute",
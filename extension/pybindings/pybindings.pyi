@@ -9,6 +9,7 @@ from __future__ import annotations
 
 from typing import Any, Dict, Enum, List, Optional, Sequence, Tuple
 
+import torch
 from executorch.exir._warnings import experimental
 
 @experimental("This API is experimental and subject to change without notice.")
@@ -27,25 +28,48 @@ class Verification(Enum):
 class ExecuTorchModule:
     """ExecuTorchModule is a Python wrapper around a C++ ExecuTorch program.
 
+    Methods run with the GIL released, so separate ExecuTorchModule instances
+    can execute in parallel from different Python threads. Calls on the same
+    instance are serialized. Output that the runtime writes to stdout or
+    stderr while the GIL is released is not redirected to ``sys.stdout`` and
+    ``sys.stderr``.
+
+    Tensor outputs that are not memory planned are returned without a copy.
+    Their buffer is reused by later calls once every tensor returned in it has
+    been dropped, so results that are still referenced are never overwritten.
+    Memory planned outputs are cloned unless ``clone_outputs`` is False, in
+    which case the returned tensors alias the module's memory until the next
+    call, which first copies out the ones that are still referenced.
+    ``outputs`` may give a tensor (or None) per output for the results to be
+    written into instead: outputs that are not memory planned are written to it
+    directly, and memory planned ones are copied into it.
+
     .. warning::
 
         This API is experimental and subject to change without notice.
     """
 
     # pyre-ignore[2, 3]: "Any" in parameter and return type annotations.
-    def __call__(self, inputs: Any, clone_outputs: bool = True) -> List[Any]: ...
+    def __call__(
+        self,
+        inputs: Any,  # pyre-ignore[2]: "Any" in parameter type annotations.
+        clone_outputs: bool = True,
+        outputs: Optional[Sequence[Optional[torch.Tensor]]] = None,
+    ) -> List[Any]: ...
     # pyre-ignore[2, 3]: "Any" in parameter and return type annotations.
     def run_method(
         self,
         method_name: str,
         inputs: Sequence[Any],  # pyre-ignore[2]: "Any" in parameter type annotations.
         clone_outputs: bool = True,
+        outputs: Optional[Sequence[Optional[torch.Tensor]]] = None,
     ) -> List[Any]: ...
     # pyre-ignore[2, 3]: "Any" in parameter and return type annotations.
     def forward(
         self,
         inputs: Sequence[Any],  # pyre-ignore[2]: "Any" in parameter type annotations.
         clone_outputs: bool = True,
+        outputs: Optional[Sequence[Optional[torch.Tensor]]] = None,
     ) -> List[Any]: ...
     # pyre-ignore[3]: "Any" in return type annotations.
     def plan_execute(self) -> List[Any]: ...
@@ -0,0 +1,103 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-unsafe
+
+"""
+Measures how well calls into the Python bindings scale across threads.
+
+The bindings release the GIL while a method executes, so threads that call
+separate modules should run their calls in parallel. This times the same
+number of calls made from one thread and from N threads, each thread with a
+module of its own, and prints the speedup.
+
+Not a test: run it by hand, e.g.
+
+    python -m executorch.extension.pybindings.test.benchmark_concurrent_calls \
+        --threads 4
+"""
+
+import argparse
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+import torch
+from executorch.extension.pybindings import portable_lib as runtime
+from executorch.extension.pybindings.test.make_test import create_program
+
+
+class ModuleMatmulChain(torch.nn.Module):
+    """A few matmuls, so that each call spends its time in the kernels."""
+
+    def __init__(self, size: int = 128, depth: int = 4):
+        super().__init__()
+        self.size = size
+        self.depth = depth
+
+    def forward(self, x, y):
+        for _ in range(self.depth):
+            x = torch.mm(x, y)
+        return x
+
+    def get_methods_to_export(self):
+        return ("forward",)
+
+    def get_inputs(self):
+        return (
+            torch.randn(self.size, self.size),
+            torch.randn(self.size, self.size) / self.size,
+        )
+
+
+def time_calls(modules, inputs, num_calls: int, num_threads: int) -> float:
+    """
+    Returns the fastest of a few runs of `num_calls` forward() calls split
+    across `num_threads` threads, in seconds. Thread i only calls modules[i].
+    """
+
+    def run(thread_index: int) -> None:
+        module = modules[thread_index]
+        for _ in range(num_calls // num_threads):
+            module.forward(inputs)
+
+    best = float("inf")
+    with ThreadPoolExecutor(max_workers=num_threads) as pool:
+        for _ in range(5):
+            start = time.perf_counter()
+            list(pool.map(run, range(num_threads)))
+            best = min(best, time.perf_counter() - start)
+    return best
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--threads", type=int, default=4)
+    parser.add_argument("--calls", type=int, default=64)
+    parser.add_argument("--size", type=int, default=128)
+    args = parser.parse_args()
+
+    program, inputs = create_program(ModuleMatmulChain(args.size))
+    modules = [
+        runtime._load_for_executorch_from_buffer(program.buffer)
+        for _ in range(args.threads)
+    ]
+    # Warm up every module.
+    for module in modules:
+        module.forward(inputs)
+
+    num_calls = args.calls - args.calls % args.threads
+    single = time_calls(modules, inputs, num_calls, 1)
+    multi = time_calls(modules, inputs, num_calls, args.threads)
+    print(
+        f"{num_calls} calls of {args.size}x{args.size} matmul chains: "
+        f"1 thread {single * 1000:.1f} ms, "
+        f"{args.threads} threads {multi * 1000:.1f} ms, "
+        f"speedup {single / multi:.2f}x (best of 5 runs)"
+    )
+
+
+if __name__ == "__main__":
+    main()
@@ -292,6 +292,37 @@ def make_test(  # noqa: C901
                 except Exception:
                     tester.assertTrue(str(out).find("The length of given input array"))
 
+        def test_concurrent_calls(tester):
+            from concurrent.futures import ThreadPoolExecutor
+
+            exported_program, _ = create_program(ModuleAdd())
+            num_threads = 4
+            inputs = [
+                (torch.full((2, 2), float(i)), torch.ones(2, 2))
+                for i in range(num_threads * 8)
+            ]
+
+            # Separate modules run in parallel; calls on a shared module and
+            # on a shared method are serialized. Every call must see its own
+            # inputs either way.
+            modules = [load_fn(exported_program.buffer) for _ in range(num_threads)]
+            shared_module = load_fn(exported_program.buffer)
+            shared_method = load_prog_fn(exported_program.buffer).load_method(
+                "forward"
+            )
+            callables = [
+                lambda i, x: modules[i % num_threads].forward(x),
+                lambda i, x: shared_module(x),
+                lambda i, x: shared_method(x),
+            ]
+            for fn in callables:
+                with ThreadPoolExecutor(max_workers=num_threads) as pool:
+                    outputs = list(
+                        pool.map(lambda args: fn(*args)[0], enumerate(inputs))
+                    )
+                for x, output in zip(inputs, outputs):
+                    tester.assertTrue(torch.allclose(output, x[0] + x[1]))
+
         def test_quantized_ops(tester):
             eager_module = ModuleAdd()
 
@@ -356,6 +387,66 @@ def make_test(  # noqa: C901
             # The test module returns the state. Check that its value is correct.
             tester.assertEqual(str(torch.ones(2, 2)), str(executorch_output[1]))
 
+        def test_output_tensors(tester):
+            unplanned_program, inputs = create_program(
+                ModuleAdd(),
+                et_config=ExecutorchBackendConfig(
+                    memory_planning_pass=MemoryPlanningPass(alloc_graph_output=False)
+                ),
+            )
+            executorch_module = load_fn(unplanned_program.buffer)
+
+            # Outputs that are not memory planned get a new buffer per call, so
+            # earlier results are not overwritten by later calls.
+            first = executorch_module.forward(inputs)[0]
+            second = executorch_module.forward((inputs[0], inputs[0] * 2))[0]
+            tester.assertNotEqual(first.data_ptr(), second.data_ptr())
+            tester.assertTrue(torch.allclose(first, inputs[0] + inputs[1]))
+            tester.assertTrue(torch.allclose(second, inputs[0] * 3))
+
+            # Once the results in a buffer are dropped, later calls reuse it.
+            second_data_ptr = second.data_ptr()
+            del first, second
+            third = executorch_module.forward(inputs)[0]
+            tester.assertEqual(third.data_ptr(), second_data_ptr)
+            tester.assertTrue(torch.allclose(third, inputs[0] + inputs[1]))
+
+            # They can also be written straight into caller-provided tensors.
+            out = torch.zeros(2, 2)
+            result = executorch_module.forward(inputs, outputs=[out])[0]
+            tester.assertEqual(result.data_ptr(), out.data_ptr())
+            tester.assertTrue(torch.allclose(out, inputs[0] + inputs[1]))
+
+            # A larger provided tensor keeps its shape, the result is a view of
+            # its start.
+            out = torch.zeros(8)
+            result = executorch_module.forward(inputs, outputs=[out])[0]
+            tester.assertEqual(out.shape, torch.Size([8]))
+            tester.assertEqual(result.shape, torch.Size([2, 2]))
+            tester.assertEqual(result.data_ptr(), out.data_ptr())
+            tester.assertTrue(torch.allclose(result, inputs[0] + inputs[1]))
+
+            # Memory planned outputs that are not cloned are copied out before
+            # the next call overwrites them.
+            planned_program, inputs = create_program(ModuleAdd())
+            executorch_module = load_fn(planned_program.buffer)
+            first = executorch_module.forward(inputs, clone_outputs=False)[0]
+            second = executorch_module.forward(
+                (inputs[0], inputs[0] * 2), clone_outputs=False
+            )[0]
+            tester.assertTrue(torch.allclose(first, inputs[0] + inputs[1]))
+            tester.assertTrue(torch.allclose(second, inputs[0] * 3))
+
+            # Memory planned outputs are copied into the provided tensor.
+            out = torch.zeros(2, 2)
+            result = executorch_module.forward(inputs, outputs=[out])[0]
+            tester.assertEqual(result.data_ptr(), out.data_ptr())
+            tester.assertTrue(torch.allclose(out, inputs[0] + inputs[1]))
+
+            # Provided tensors must match the output.
+            with tester.assertRaises(RuntimeError):
+                executorch_module.forward(inputs, outputs=[out, out])
+
         def test_channels_last(tester) -> None:
             # Create an ExecuTorch program from ModuleChannelsLast.
             model = ModuleChannelsLast()
@@ -941,11 +1032,13 @@ def make_test(  # noqa: C901
         test_module_callable(tester)
         test_module_single_input(tester)
         test_stderr_redirect(tester)
+        test_concurrent_calls(tester)
         test_quantized_ops(tester)
         test_channels_last(tester)
         test_channels_last_in_default_out(tester)
         test_unsupported_dim_order(tester)
         test_constant_output_not_memory_planned(tester)
+        test_output_tensors(tester)
         test_method_meta(tester)
         test_bad_name(tester)
         test_verification_config(tester)
@@ -12,11 +12,13 @@ def define_common_targets():
         "thread_parallel.cpp",
         "threadpool.cpp",
         "threadpool_guard.cpp",
+        "threadpool_task_runner.cpp",
     ] + (["fb/threadpool_use_n_threads.cpp"] if not runtime.is_oss else [])
 
     _THREADPOOL_HEADERS = [
         "threadpool.h",
         "threadpool_guard.h",
+        "threadpool_task_runner.h",
     ] + (["fb/threadpool_use_n_threads.h"] if not runtime.is_oss else [])
 
     runtime.cxx_library(
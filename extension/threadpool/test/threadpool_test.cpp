@@ -8,11 +8,14 @@
 
 #include <executorch/extension/threadpool/threadpool.h>
 
+#include <atomic>
 #include <mutex>
 #include <numeric>
 #include <random>
+#include <thread>
 
 #include <executorch/extension/threadpool/threadpool_guard.h>
+#include <executorch/extension/threadpool/threadpool_task_runner.h>
 
 #include <gtest/gtest.h>
 
@@ -192,3 +195,136 @@ TEST(TestNoThreadPoolGuard, TestRunWithGuard) {
   }
   ASSERT_EQ(inner, 6);
 }
+
+TEST(TestUseThreadPoolGuard, TestGuardSelectsThreadPool) {
+  auto global_pool = ::executorch::extension::threadpool::get_threadpool();
+  auto global_pthreadpool =
+      ::executorch::extension::threadpool::get_pthreadpool();
+  ASSERT_NE(global_pool, nullptr);
+
+  ::executorch::extension::threadpool::ThreadPool pool1(2);
+  ::executorch::extension::threadpool::ThreadPool pool2(3);
+  {
+    ::executorch::extension::threadpool::UseThreadPoolGuard g1(&pool1);
+    ASSERT_EQ(::executorch::extension::threadpool::get_threadpool(), &pool1);
+    auto pthreadpool1 = ::executorch::extension::threadpool::get_pthreadpool();
+    ASSERT_NE(pthreadpool1, nullptr);
+    ASSERT_NE(pthreadpool1, global_pthreadpool);
+    {
+      ::executorch::extension::threadpool::UseThreadPoolGuard g2(&pool2);
+      ASSERT_EQ(::executorch::extension::threadpool::get_threadpool(), &pool2);
+      ASSERT_EQ(
+          ::executorch::extension::threadpool::get_threadpool()
+              ->get_thread_count(),
+          3);
+    }
+    // Guard should restore prev value (pool1)
+    ASSERT_EQ(::executorch::extension::threadpool::get_threadpool(), &pool1);
+
+    // NoThreadPoolGuard still takes precedence.
+    ::executorch::extension::threadpool::NoThreadPoolGuard g3;
+    ASSERT_EQ(::executorch::extension::threadpool::get_pthreadpool(), nullptr);
+  }
+  ASSERT_EQ(::executorch::extension::threadpool::get_threadpool(), global_pool);
+  ASSERT_EQ(
+      ::executorch::extension::threadpool::get_pthreadpool(),
+      global_pthreadpool);
+}
+
+TEST(TestUseThreadPoolGuard, TestConcurrentCallersWithOwnThreadPools) {
+  constexpr size_t kNumCallers = 4;
+  constexpr size_t kRange = 1000;
+  std::vector<std::thread> callers;
+  std::vector<int64_t> sums(kNumCallers, 0);
+  for (size_t i = 0; i < kNumCallers; ++i) {
+    callers.emplace_back([i, &sums]() {
+      ::executorch::extension::threadpool::ThreadPool pool(2);
+      ::executorch::extension::threadpool::UseThreadPoolGuard guard(&pool);
+      std::atomic<int64_t> sum{0};
+      for (int iter = 0; iter < 10; ++iter) {
+        ::executorch::extension::threadpool::get_threadpool()->run(
+            [&sum](size_t task_id) { sum += task_id; }, kRange);
+      }
+      sums[i] = sum;
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  for (size_t i = 0; i < kNumCallers; ++i) {
+    EXPECT_EQ(sums[i], 10 * kRange * (kRange - 1) / 2);
+  }
+}
+
+TEST(TestUseThreadPoolGuard, SharedPthreadpoolOutlivesThreadPool) {
+  std::shared_ptr<pthreadpool> shared;
+  {
+    ::executorch::extension::threadpool::ThreadPool pool(2);
+    ::executorch::extension::threadpool::UseThreadPoolGuard guard(&pool);
+    shared = ::executorch::extension::threadpool::get_shared_pthreadpool();
+    ASSERT_NE(shared, nullptr);
+    EXPECT_EQ(
+        shared.get(), ::executorch::extension::threadpool::get_pthreadpool());
+  }
+
+  // The pool's threads can still run work after the ThreadPool is gone, the
+  // way an XNNPACK runtime created under the guard does.
+  std::atomic<int64_t> sum{0};
+  pthreadpool_parallelize_1d(
+      shared.get(),
+      [](void* context, size_t i) {
+        *static_cast<std::atomic<int64_t>*>(context) += i;
+      },
+      &sum,
+      100,
+      0u);
+  EXPECT_EQ(sum, 100 * 99 / 2);
+
+  ::executorch::extension::threadpool::NoThreadPoolGuard guard;
+  EXPECT_EQ(
+      ::executorch::extension::threadpool::get_shared_pthreadpool(), nullptr);
+}
+
+TEST(TestThreadPoolTaskRunner, TasksSeeCallersThreadPool) {
+  ::executorch::extension::threadpool::ThreadPool caller_pool(2);
+  ::executorch::extension::threadpool::ThreadPool task_pool(3);
+  ::executorch::extension::threadpool::ThreadPoolTaskRunner runner(&task_pool);
+
+  constexpr size_t kNumTasks = 16;
+  std::vector<::executorch::extension::threadpool::ThreadPool*> seen_pools(
+      kNumTasks, nullptr);
+  std::vector<int64_t> sums(kNumTasks, 0);
+  {
+    ::executorch::extension::threadpool::UseThreadPoolGuard guard(
+        &caller_pool);
+    runner.run(kNumTasks, [&](size_t i) {
+      auto pool = ::executorch::extension::threadpool::get_threadpool();
+      seen_pools[i] = pool;
+      // Tasks can run parallel work of their own on the caller's threadpool.
+      std::atomic<int64_t> sum{0};
+      pool->run([&sum](size_t task_id) { sum += task_id; }, 100);
+      sums[i] = sum;
+    });
+  }
+  for (size_t i = 0; i < kNumTasks; ++i) {
+    EXPECT_EQ(seen_pools[i], &caller_pool);
+    EXPECT_EQ(sums[i], 100 * 99 / 2);
+  }
+}
+
+TEST(TestThreadPoolTaskRunner, RunsOnCallingThreadWithNoThreadPoolGuard) {
+  ::executorch::extension::threadpool::ThreadPool task_pool(3);
+  ::executorch::extension::threadpool::ThreadPoolTaskRunner runner(&task_pool);
+
+  const auto caller = std::this_thread::get_id();
+  size_t num_tasks_run = 0;
+  {
+    ::executorch::extension::threadpool::NoThreadPoolGuard guard;
+    runner.run(5, [&](size_t /* i */) {
+      EXPECT_EQ(std::this_thread::get_id(), caller);
+      EXPECT_EQ(::executorch::extension::threadpool::get_pthreadpool(), nullptr);
+      ++num_tasks_run;
+    });
+  }
+  EXPECT_EQ(num_tasks_run, 5);
+}
@@ -52,7 +52,7 @@ bool ThreadPool::_unsafe_reset_threadpool(uint32_t new_thread_count) {
 
   std::lock_guard<std::mutex> lock{mutex_};
 
-  threadpool_.reset(pthreadpool_create(new_thread_count));
+  threadpool_.reset(pthreadpool_create(new_thread_count), pthreadpool_destroy);
   return true;
 }
 
@@ -96,6 +96,10 @@ void ThreadPool::run(
 // get_threadpool is not thread safe due to leak_corrupted_threadpool
 // Make this part threadsafe: TODO(kimishpatel)
 ThreadPool* get_threadpool() {
+  if (ThreadPool* const threadpool = UseThreadPoolGuard::current()) {
+    return threadpool;
+  }
+
   if (!cpuinfo_initialize()) {
     ET_LOG(Error, "cpuinfo initialization failed");
     return nullptr; // NOLINT(facebook-hte-NullableReturn)
@@ -142,4 +146,13 @@ pthreadpool_t get_pthreadpool() {
   return threadpool->threadpool_.get();
 }
 
+std::shared_ptr<pthreadpool> get_shared_pthreadpool() {
+  if (NoThreadPoolGuard::is_enabled()) {
+    return nullptr;
+  }
+  ThreadPool* const threadpool = get_threadpool();
+  ET_CHECK_MSG(threadpool, "Failed to acquire an instance of ThreadPool!");
+  return threadpool->threadpool_;
+}
+
 } // namespace executorch::extension::threadpool
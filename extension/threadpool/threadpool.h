@@ -56,12 +56,15 @@ class ThreadPool final {
    * This function is blocking.  All input is processed by the time it returns.
    * NoThreadPoolGuard (see threadpool_guard.h) can used to disable use of
    * multiple threads with the scope of the guard When NoThreadPoolGuard is not
-   * used all calls to run method are serialized.
+   * used all calls to run method of the same ThreadPool are serialized. Use
+   * separate ThreadPool instances, selected with UseThreadPoolGuard, to run
+   * work from several threads concurrently.
    */
   void run(const std::function<void(size_t)>& fn, size_t range);
 
  private:
   friend pthreadpool_t get_pthreadpool();
+  friend std::shared_ptr<pthreadpool> get_shared_pthreadpool();
 
  private:
   // This mutex is used inside get_thread_count API but it is not really needed
@@ -69,11 +72,15 @@ class ThreadPool final {
   // TODO(kimishpatel): Figure out if we will allow set_num_threads API, in
   // which case this mutex will be useful. Otherwise remove it.
   mutable std::mutex mutex_;
-  std::unique_ptr<pthreadpool, decltype(&pthreadpool_destroy)> threadpool_;
+  // Shared with the users of get_shared_pthreadpool(), which may outlive this
+  // ThreadPool or a reset of it.
+  std::shared_ptr<pthreadpool> threadpool_;
 };
 
 /**
- * Returns the singleton instance of ThreadPool for ATen/TH multithreading.
+ * Returns the ThreadPool for ATen/TH multithreading on the calling thread: the
+ * one selected by an active UseThreadPoolGuard, or else the global singleton
+ * instance.
  */
 ThreadPool* get_threadpool();
 
@@ -81,10 +88,21 @@ ThreadPool* get_threadpool();
  * Returns the underlying pthreadpool instance used by the implementation of
  * ThreadPool returned by `get_threadpool()`. Only for use in external libraries
  * so as to unify threading across internal (i.e. ATen, etc.) and external (e.g.
- * NNPACK, QNNPACK, XNNPACK) use cases.
+ * NNPACK, QNNPACK, XNNPACK) use cases. Returns nullptr when a
+ * NoThreadPoolGuard is active.
  */
 pthreadpool_t get_pthreadpool();
 
+/**
+ * Like get_pthreadpool(), but shares ownership of the pthreadpool instance: it
+ * stays alive for as long as the returned pointer does, even if its ThreadPool
+ * is destroyed or reset first. For external libraries that keep using the
+ * pthreadpool after the call, e.g. XNNPACK runtimes, which bind to the one
+ * that is current when they are created. Returns nullptr when a
+ * NoThreadPoolGuard is active.
+ */
+std::shared_ptr<pthreadpool> get_shared_pthreadpool();
+
 } // namespace executorch::extension::threadpool
 
 namespace torch::executorch::threadpool { // DEPRECATED
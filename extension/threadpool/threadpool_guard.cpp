@@ -20,4 +20,19 @@ void NoThreadPoolGuard::set_enabled(bool enabled) {
   NoThreadPoolGuard_enabled = enabled;
 }
 
+thread_local ThreadPool* UseThreadPoolGuard_threadpool = nullptr;
+
+ThreadPool* UseThreadPoolGuard::current() {
+  return UseThreadPoolGuard_threadpool;
+}
+
+UseThreadPoolGuard::UseThreadPoolGuard(ThreadPool* threadpool)
+    : prev_threadpool_(UseThreadPoolGuard_threadpool) {
+  UseThreadPoolGuard_threadpool = threadpool;
+}
+
+UseThreadPoolGuard::~UseThreadPoolGuard() {
+  UseThreadPoolGuard_threadpool = prev_threadpool_;
+}
+
 } // namespace executorch::extension::threadpool
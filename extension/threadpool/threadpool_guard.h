@@ -10,6 +10,8 @@
 
 namespace executorch::extension::threadpool {
 
+class ThreadPool;
+
 // A RAII, thread local (!) guard that enables or disables guard upon
 // construction, and sets it back to the original value upon destruction.
 struct NoThreadPoolGuard {
@@ -27,6 +29,37 @@ struct NoThreadPoolGuard {
   const bool prev_mode_;
 };
 
+// A RAII, thread local (!) guard that makes get_threadpool() and
+// get_pthreadpool() return `threadpool` on the current thread instead of the
+// global threadpool, and restores the previous one upon destruction. Code
+// that picks up the current threadpool (parallel_for, optimized kernels,
+// XNNPACK) then runs its parallel work on `threadpool`.
+//
+// Calls to ThreadPool::run are serialized per ThreadPool, so concurrent
+// callers that each use their own ThreadPool, e.g. one per request thread
+// sized to a share of the cores, do not wait on each other.
+//
+// XNNPACK delegates bind to the threadpool that is current when their Method
+// is loaded, and keep running on it wherever the Method is executed. They
+// share ownership of its pthreadpool, so `threadpool` itself may be destroyed
+// before the Method.
+//
+// `threadpool` must outlive the guard, and must not be null.
+struct UseThreadPoolGuard {
+  static ThreadPool* current();
+
+  explicit UseThreadPoolGuard(ThreadPool* threadpool);
+  ~UseThreadPoolGuard();
+
+  UseThreadPoolGuard(const UseThreadPoolGuard&) = delete;
+  UseThreadPoolGuard& operator=(const UseThreadPoolGuard&) = delete;
+  UseThreadPoolGuard(UseThreadPoolGuard&&) = delete;
+  UseThreadPoolGuard& operator=(UseThreadPoolGuard&&) = delete;
+
+ private:
+  ThreadPool* const prev_threadpool_;
+};
+
 } // namespace executorch::extension::threadpool
 
 namespace torch::executorch::threadpool { // DEPRECATED
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/threadpool/threadpool_task_runner.h>
+
+#include <executorch/extension/threadpool/threadpool.h>
+#include <executorch/extension/threadpool/threadpool_guard.h>
+#include <executorch/runtime/platform/assert.h>
+
+namespace executorch::extension::threadpool {
+
+ThreadPoolTaskRunner::ThreadPoolTaskRunner(ThreadPool* threadpool)
+    : threadpool_(threadpool) {
+  ET_CHECK_MSG(threadpool_ != nullptr, "threadpool must not be null");
+}
+
+void ThreadPoolTaskRunner::run(
+    size_t num_tasks,
+    runtime::FunctionRef<void(size_t)> task) {
+  ThreadPool* const caller_threadpool =
+      NoThreadPoolGuard::is_enabled() ? nullptr : get_threadpool();
+  if (caller_threadpool == nullptr) {
+    for (size_t i = 0; i < num_tasks; ++i) {
+      task(i);
+    }
+    return;
+  }
+  ET_CHECK_MSG(
+      caller_threadpool != threadpool_,
+      "Tasks cannot run on the threadpool that is current for the caller");
+
+  threadpool_->run(
+      [&](size_t i) {
+        // ThreadPool::run() disables threading on its workers. Give the task
+        // the threading environment of the caller instead.
+        NoThreadPoolGuard::set_enabled(false);
+        UseThreadPoolGuard guard(caller_threadpool);
+        task(i);
+        NoThreadPoolGuard::set_enabled(true);
+      },
+      num_tasks);
+}
+
+} // namespace executorch::extension::threadpool
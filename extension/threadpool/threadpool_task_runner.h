@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/task_runner.h>
+
+namespace executorch::extension::threadpool {
+
+class ThreadPool;
+
+// A runtime::TaskRunner that runs tasks on the workers of `threadpool`, e.g.
+// to initialize the delegates of a Method in parallel:
+//
+//   ThreadPool init_threadpool(4);
+//   ThreadPoolTaskRunner runner(&init_threadpool);
+//   MethodLoadOptions options;
+//   options.delegate_init_runner = &runner;
+//   program->load_method("forward", &memory_manager, nullptr, nullptr, options);
+//
+// Tasks see the threadpool that was current on the thread that called run(),
+// not `threadpool`, so that delegates which bind to the current threadpool
+// when they are initialized (e.g. XNNPACK) execute on the same threadpool as
+// they would after a sequential init. That threadpool must not be
+// `threadpool`: a task that waits on its own pool would deadlock.
+//
+// If the calling thread has a NoThreadPoolGuard enabled, tasks run one after
+// the other on the calling thread.
+//
+// `threadpool` must outlive the runner, and must not be null.
+class ThreadPoolTaskRunner final : public runtime::TaskRunner {
+ public:
+  explicit ThreadPoolTaskRunner(ThreadPool* threadpool);
+
+  void run(size_t num_tasks, runtime::FunctionRef<void(size_t)> task) override;
+
+ private:
+  ThreadPool* const threadpool_;
+};
+
+} // namespace executorch::extension::threadpool
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/training/optimizer/adamw.h>
+
+#include <cmath>
+
+#include <executorch/runtime/core/error.h>
+
+using ::executorch::runtime::Error;
+
+namespace executorch {
+namespace extension {
+namespace training {
+namespace optimizer {
+
+namespace {
+
+/**
+ * Applies one AdamW step to `n` elements of a parameter, fusing the weight
+ * decay, both moment updates and the parameter update into a single pass.
+ * `step` is the 1-based index of this step for the parameter.
+ */
+void adamw_update(
+    float* param,
+    const float* grad,
+    float* exp_avg,
+    float* exp_avg_sq,
+    size_t n,
+    const AdamWOptions& options,
+    size_t step) {
+  const double bias_correction1 =
+      1 - std::pow(options.beta1(), static_cast<double>(step));
+  const double bias_correction2 =
+      1 - std::pow(options.beta2(), static_cast<double>(step));
+
+  const float decay = 1 - options.lr() * options.weight_decay();
+  const float beta1 = options.beta1();
+  const float beta2 = options.beta2();
+  const float grad_scale1 = 1 - options.beta1();
+  const float grad_scale2 = 1 - options.beta2();
+  const float step_size = options.lr() / bias_correction1;
+  const float inv_sqrt_bias_correction2 = 1 / std::sqrt(bias_correction2);
+  const float eps = options.eps();
+  for (size_t i = 0; i < n; ++i) {
+    const float g = grad[i];
+    const float m = beta1 * exp_avg[i] + grad_scale1 * g;
+    const float v = beta2 * exp_avg_sq[i] + grad_scale2 * g * g;
+    exp_avg[i] = m;
+    exp_avg_sq[i] = v;
+    const float denom = std::sqrt(v) * inv_sqrt_bias_correction2 + eps;
+    param[i] = param[i] * decay - step_size * m / denom;
+  }
+}
+
+} // namespace
+
+bool AdamWParamGroup::has_options() const {
+  return options_ != nullptr;
+}
+
+AdamWOptions& AdamWParamGroup::options() {
+  return *options_.get();
+}
+
+const AdamWOptions& AdamWParamGroup::options() const {
+  return *options_.get();
+}
+
+void AdamWParamGroup::set_options(std::unique_ptr<AdamWOptions> options) {
+  options_ = std::move(options);
+}
+
+const std::map<std::string_view, executorch::aten::Tensor>&
+AdamWParamGroup::named_parameters() const {
+  return named_parameters_;
+}
+
+void AdamW::add_param_group(const AdamWParamGroup& param_group) {
+  AdamWParamGroup param_group_(param_group.named_parameters());
+  if (!param_group.has_options()) {
+    param_group_.set_options(defaults_->clone());
+  } else {
+    param_group_.set_options(param_group.options().clone());
+  }
+  for (const auto& named_parameter : param_group_.named_parameters()) {
+    const size_t numel = named_parameter.second.numel();
+    entries_.push_back(
+        {named_parameter.first,
+         named_parameter.second,
+         param_groups_.size(),
+         moments_.size()});
+    moments_.resize(moments_.size() + 2 * numel);
+  }
+  param_groups_.emplace_back(std::move(param_group_));
+
+  internal::sort_param_entries(entries_);
+  chunks_.clear();
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    internal::append_param_chunks(i, entries_[i].param.numel(), chunks_);
+  }
+}
+
+Error AdamW::step(const std::map<std::string_view, executorch::aten::Tensor>&
+                      named_gradients) {
+  Error err = internal::bind_gradients(entries_, named_gradients, gradients_);
+  if (err != Error::Ok) {
+    return err;
+  }
+  internal::for_each_param_chunk(
+      chunks_,
+      gradients_,
+      [&](const internal::ParamChunk& chunk, const float* grad) {
+        const internal::ParamEntry& entry = entries_[chunk.entry];
+        float* exp_avg = moments_.data() + entry.state_offset;
+        float* exp_avg_sq = exp_avg + entry.param.numel();
+        adamw_update(
+            entry.param.mutable_data_ptr<float>() + chunk.begin,
+            grad + chunk.begin,
+            exp_avg + chunk.begin,
+            exp_avg_sq + chunk.begin,
+            chunk.end - chunk.begin,
+            param_groups_[entry.group].options(),
+            entry.step + 1);
+      });
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    if (gradients_[i] != nullptr) {
+      entries_[i].step++;
+    }
+  }
+  return Error::Ok;
+}
+
+} // namespace optimizer
+} // namespace training
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * AdamW optimizer to perform on-device training. This uses the gradients
+ * calculated in the backwards pass of the loss function and updates the
+ * parameters such that it minimizes the loss.
+ *
+ * This follows torch.optim.AdamW (without amsgrad), but without the dependency
+ * on ATen Tensors and autograd. Plain Adam corresponds to a weight decay of 0.
+ */
+#pragma once
+
+#include <executorch/extension/training/optimizer/param_utils.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace executorch {
+namespace extension {
+namespace training {
+namespace optimizer {
+
+/**
+ * AdamW optimizer options. This contains options for performing training on a
+ * param group, such as the learning rate.
+ */
+class ET_EXPERIMENTAL AdamWOptions {
+ public:
+  /**
+   * Constructs a new AdamW optimizer options.
+   *
+   * This is used for customizing the AdamW optimizer for a given group of
+   * parameters.
+   *
+   * @param[in] lr The learning rate. This is the factor applied to the
+   *   normalized moving average of the gradient when updating the parameters.
+   * @param[in] beta1 The decay rate of the moving average of the gradient (the
+   *   first moment).
+   * @param[in] beta2 The decay rate of the moving average of the squared
+   *   gradient (the second moment).
+   * @param[in] eps Added to the denominator of the update to improve numerical
+   *   stability.
+   * @param[in] weight_decay The weight decay value. Unlike in SGD, this is
+   *   decoupled from the gradient: each step scales the parameters by
+   *   `1 - lr * weight_decay` before applying the update.
+   */
+  explicit AdamWOptions(
+      double lr = 1e-3,
+      double beta1 = 0.9,
+      double beta2 = 0.999,
+      double eps = 1e-8,
+      double weight_decay = 1e-2)
+      : lr_(lr),
+        beta1_(beta1),
+        beta2_(beta2),
+        eps_(eps),
+        weight_decay_(weight_decay) {}
+
+  std::unique_ptr<AdamWOptions> clone() const {
+    return std::make_unique<AdamWOptions>(
+        static_cast<const AdamWOptions&>(*this));
+  }
+
+  double lr() const {
+    return lr_;
+  }
+
+  double beta1() const {
+    return beta1_;
+  }
+
+  double beta2() const {
+    return beta2_;
+  }
+
+  double eps() const {
+    return eps_;
+  }
+
+  double weight_decay() const {
+    return weight_decay_;
+  }
+
+ private:
+  double lr_;
+  double beta1_;
+  double beta2_;
+  double eps_;
+  double weight_decay_;
+};
+
+/**
+ * AdamW optimizer param group. This contains the parameters and the
+ * AdamWOptions associated to it.
+ */
+class ET_EXPERIMENTAL AdamWParamGroup {
+ public:
+  // NOTE: In order to store `AdamWParamGroup` in a `std::vector`, it has
+  // to be copy-constructible.
+  AdamWParamGroup(const AdamWParamGroup& param_group)
+      : named_parameters_(param_group.named_parameters()),
+        options_(
+            param_group.has_options() ? param_group.options().clone()
+                                      : nullptr) {}
+  AdamWParamGroup& operator=(const AdamWParamGroup& param_group) {
+    this->named_parameters_ = param_group.named_parameters_;
+    this->options_ =
+        param_group.has_options() ? param_group.options().clone() : nullptr;
+    return *this;
+  }
+
+  /**
+   * Constructs an AdamW param group.
+   *
+   * @param[in] named_parameters The parameters to be optimized and their fully
+   * qualified names.
+   */
+  /* implicit */ AdamWParamGroup(
+      const std::map<std::string_view, executorch::aten::Tensor>&
+          named_parameters)
+      : named_parameters_(named_parameters) {}
+  AdamWParamGroup(
+      const std::map<std::string_view, executorch::aten::Tensor>&
+          named_parameters,
+      std::unique_ptr<AdamWOptions> options)
+      : named_parameters_(named_parameters), options_(std::move(options)) {}
+
+  bool has_options() const;
+  AdamWOptions& options();
+  const AdamWOptions& options() const;
+  void set_options(std::unique_ptr<AdamWOptions> options);
+  const std::map<std::string_view, executorch::aten::Tensor>& named_parameters()
+      const;
+
+ private:
+  std::map<std::string_view, executorch::aten::Tensor> named_parameters_;
+  std::unique_ptr<AdamWOptions> options_;
+};
+
+/**
+ * AdamW optimizer class. This is responsible for performing the optimization
+ * step.
+ *
+ * Parameters are resolved when their param group is added, and the moment
+ * estimates of all parameters live in a single arena. A step updates each
+ * element in a single fused pass, in parallel over chunks of the parameters
+ * when a threadpool is available. Only float parameters are supported.
+ */
+class ET_EXPERIMENTAL AdamW {
+ public:
+  explicit AdamW(
+      const std::vector<AdamWParamGroup>& param_groups,
+      AdamWOptions defaults)
+      : defaults_(std::make_unique<AdamWOptions>(defaults)) {
+    for (const auto& param_group : param_groups) {
+      add_param_group(param_group);
+    }
+  }
+
+  explicit AdamW(
+      const std::map<std::string_view, executorch::aten::Tensor>&
+          named_parameters,
+      AdamWOptions defaults)
+      : AdamW({AdamWParamGroup(named_parameters)}, defaults) {}
+
+  // Adds the given param_group to the optimizer's param_group list.
+  void add_param_group(const AdamWParamGroup& param_group);
+
+  /**
+   * Performs the optimization step. The gradients are not modified.
+   *
+   * @param[in] named_gradients The gradients of the tensors specified by the
+   * fully qualified name.
+   *
+   * @retval Error::Ok The parameters with a gradient were updated.
+   * @retval Error::InvalidArgument A parameter or gradient is not a float
+   *     tensor, or a gradient does not match the size of its parameter.
+   */
+  ::executorch::runtime::Error step(
+      const std::map<std::string_view, executorch::aten::Tensor>&
+          named_gradients);
+
+ private:
+  std::vector<AdamWParamGroup> param_groups_;
+  std::unique_ptr<AdamWOptions> defaults_;
+  /// All parameters, sorted by name.
+  std::vector<internal::ParamEntry> entries_;
+  std::vector<internal::ParamChunk> chunks_;
+  /// The first and then the second moment estimates of each parameter, back
+  /// to back.
+  std::vector<float> moments_;
+  /// The gradient of each entry during a step.
+  std::vector<const float*> gradients_;
+};
+
+} // namespace optimizer
+} // namespace training
+} // namespace extension
+} // namespace executorch
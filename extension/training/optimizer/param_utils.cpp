@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/training/optimizer/param_utils.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+
+#include <executorch/runtime/platform/log.h>
+
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using ::executorch::runtime::Error;
+
+namespace executorch {
+namespace extension {
+namespace training {
+namespace optimizer {
+namespace internal {
+
+void append_param_chunks(
+    size_t entry,
+    size_t numel,
+    std::vector<ParamChunk>& chunks) {
+  for (size_t begin = 0; begin < numel; begin += kParamChunkSize) {
+    chunks.push_back({entry, begin, std::min(begin + kParamChunkSize, numel)});
+  }
+}
+
+void sort_param_entries(std::vector<ParamEntry>& entries) {
+  std::stable_sort(
+      entries.begin(),
+      entries.end(),
+      [](const ParamEntry& a, const ParamEntry& b) { return a.name < b.name; });
+}
+
+Error bind_gradients(
+    const std::vector<ParamEntry>& entries,
+    const std::map<std::string_view, Tensor>& named_gradients,
+    std::vector<const float*>& gradients) {
+  gradients.assign(entries.size(), nullptr);
+  // Both sequences are sorted by name, so walk them in lockstep instead of
+  // looking up every parameter.
+  auto gradient_iter = named_gradients.begin();
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const ParamEntry& entry = entries[i];
+    while (gradient_iter != named_gradients.end() &&
+           gradient_iter->first < entry.name) {
+      ++gradient_iter;
+    }
+    if (gradient_iter == named_gradients.end()) {
+      break;
+    }
+    if (gradient_iter->first != entry.name) {
+      continue;
+    }
+    const Tensor& gradient = gradient_iter->second;
+    ET_CHECK_OR_RETURN_ERROR(
+        entry.param.scalar_type() == ScalarType::Float &&
+            gradient.scalar_type() == ScalarType::Float,
+        InvalidArgument,
+        "Parameter '%.*s' and its gradient must be float tensors",
+        static_cast<int>(entry.name.size()),
+        entry.name.data());
+    ET_CHECK_OR_RETURN_ERROR(
+        gradient.numel() == entry.param.numel(),
+        InvalidArgument,
+        "Gradient of '%.*s' has %" PRId64 " elements, expected %" PRId64,
+        static_cast<int>(entry.name.size()),
+        entry.name.data(),
+        static_cast<int64_t>(gradient.numel()),
+        static_cast<int64_t>(entry.param.numel()));
+    gradients[i] = gradient.const_data_ptr<float>();
+  }
+  return Error::Ok;
+}
+
+} // namespace internal
+} // namespace optimizer
+} // namespace training
+} // namespace extension
+} // namespace executorch
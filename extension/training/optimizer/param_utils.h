@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * Helpers shared by the fused optimizers. Not part of the public API.
+ */
+#pragma once
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+#include <map>
+#include <string_view>
+#include <vector>
+
+namespace executorch {
+namespace extension {
+namespace training {
+namespace optimizer {
+namespace internal {
+
+/**
+ * A parameter being optimized, resolved once when its param group is added.
+ */
+struct ParamEntry {
+  std::string_view name;
+  executorch::aten::Tensor param;
+  /// Index of the param group the parameter belongs to.
+  size_t group;
+  /// Offset of the parameter's state in the optimizer's state arena, in
+  /// elements.
+  size_t state_offset;
+  /// Number of steps that updated the parameter so far.
+  size_t step = 0;
+};
+
+/**
+ * A contiguous range of one parameter's elements. The optimizer's work is
+ * split into chunks up front so that a step can update small and large
+ * parameters in a single parallel loop.
+ */
+struct ParamChunk {
+  size_t entry;
+  size_t begin;
+  size_t end;
+};
+
+/// Upper bound on the number of elements in a ParamChunk.
+constexpr size_t kParamChunkSize = 16 * 1024;
+
+/**
+ * Appends the chunks covering `numel` elements of the parameter at index
+ * `entry` to `chunks`.
+ */
+void append_param_chunks(
+    size_t entry,
+    size_t numel,
+    std::vector<ParamChunk>& chunks);
+
+/**
+ * Sorts `entries` by parameter name so that bind_gradients() can match them
+ * to gradients with a single pass.
+ */
+void sort_param_entries(std::vector<ParamEntry>& entries);
+
+/**
+ * Finds the gradient of each parameter in `named_gradients`. `entries` must
+ * be sorted with sort_param_entries(). On success `gradients[i]` points to the
+ * data of the gradient of `entries[i]`, or is null if there is none.
+ *
+ * @retval Error::Ok The gradients were bound.
+ * @retval Error::InvalidArgument A parameter or its gradient is not a float
+ *     tensor, or they have different numbers of elements.
+ */
+::executorch::runtime::Error bind_gradients(
+    const std::vector<ParamEntry>& entries,
+    const std::map<std::string_view, executorch::aten::Tensor>&
+        named_gradients,
+    std::vector<const float*>& gradients);
+
+/**
+ * Runs `fn(chunk, gradient)` for every chunk whose parameter has a gradient,
+ * in parallel when a threadpool is available.
+ */
+template <typename Fn>
+void for_each_param_chunk(
+    const std::vector<ParamChunk>& chunks,
+    const std::vector<const float*>& gradients,
+    const Fn& fn) {
+  ::executorch::extension::parallel_for(
+      0, chunks.size(), 1, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const ParamChunk& chunk = chunks[i];
+          const float* gradient = gradients[chunk.entry];
+          if (gradient != nullptr) {
+            fn(chunk, gradient);
+          }
+        }
+      });
+}
+
+} // namespace internal
+} // namespace optimizer
+} // namespace training
+} // namespace extension
+} // namespace executorch
@@ -11,7 +11,6 @@
 #include <executorch/runtime/core/error.h>
 
 using executorch::aten::Tensor;
-using executorch::aten::TensorImpl;
 using ::executorch::runtime::Error;
 
 namespace executorch {
@@ -20,34 +19,51 @@ namespace training {
 namespace optimizer {
 
 namespace {
-void add_out_hack(
-    const Tensor& a,
-    const Tensor& b,
-    const double alpha,
-    Tensor& out) {
-  auto a_ptr = a.const_data_ptr<float>();
-  auto b_ptr = b.const_data_ptr<float>();
-  auto out_ptr = out.mutable_data_ptr<float>();
-  for (size_t i = 0; i < a.numel(); ++i) {
-    out_ptr[i] = a_ptr[i] + b_ptr[i] * alpha;
-  }
-}
 
-void mul_out_hack(const Tensor& a, const double alpha, Tensor& out) {
-  auto a_ptr = a.const_data_ptr<float>();
-  auto out_ptr = out.mutable_data_ptr<float>();
-  for (size_t i = 0; i < a.numel(); ++i) {
-    out_ptr[i] = a_ptr[i] * alpha;
+/**
+ * Applies one SGD step to `n` elements of a parameter, fusing weight decay,
+ * the momentum update and the parameter update into a single pass. `buf` is
+ * the momentum buffer, or null if momentum is disabled. When `first_step` is
+ * true the momentum buffer is initialized from the gradient.
+ */
+void sgd_update(
+    float* param,
+    const float* grad,
+    float* buf,
+    size_t n,
+    const SGDOptions& options,
+    bool first_step) {
+  const float lr = options.lr();
+  const float weight_decay = options.weight_decay();
+  const float momentum = options.momentum();
+  const float dampening_scale = 1 - options.dampening();
+  if (buf == nullptr) {
+    for (size_t i = 0; i < n; ++i) {
+      param[i] -= lr * (grad[i] + weight_decay * param[i]);
+    }
+  } else if (first_step) {
+    // The buffer starts out as the gradient, with no dampening.
+    const float scale = options.nesterov() ? lr * (1 + momentum) : lr;
+    for (size_t i = 0; i < n; ++i) {
+      const float d_p = grad[i] + weight_decay * param[i];
+      buf[i] = d_p;
+      param[i] -= scale * d_p;
+    }
+  } else if (options.nesterov()) {
+    for (size_t i = 0; i < n; ++i) {
+      const float d_p = grad[i] + weight_decay * param[i];
+      buf[i] = momentum * buf[i] + dampening_scale * d_p;
+      param[i] -= lr * (d_p + momentum * buf[i]);
+    }
+  } else {
+    for (size_t i = 0; i < n; ++i) {
+      const float d_p = grad[i] + weight_decay * param[i];
+      buf[i] = momentum * buf[i] + dampening_scale * d_p;
+      param[i] -= lr * buf[i];
+    }
   }
 }
 
-void clone_out_hack(const Tensor& a, Tensor& out) {
-  auto a_ptr = a.const_data_ptr<float>();
-  auto out_ptr = out.mutable_data_ptr<float>();
-  for (size_t i = 0; i < a.numel(); ++i) {
-    out_ptr[i] = a_ptr[i];
-  }
-}
 } // namespace
 
 bool SGDParamGroup::has_options() const {
@@ -78,90 +94,59 @@ void SGD::add_param_group(const SGDParamGroup& param_group) {
   } else {
     param_group_.set_options(param_group.options().clone());
   }
+  const bool use_momentum = param_group_.options().momentum() != 0;
+  for (const auto& named_parameter : param_group_.named_parameters()) {
+    const size_t numel = named_parameter.second.numel();
+    entries_.push_back(
+        {named_parameter.first,
+         named_parameter.second,
+         param_groups_.size(),
+         momentum_buffers_.size()});
+    if (use_momentum) {
+      momentum_buffers_.resize(momentum_buffers_.size() + numel);
+    }
+  }
   param_groups_.emplace_back(std::move(param_group_));
+
+  internal::sort_param_entries(entries_);
+  chunks_.clear();
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    internal::append_param_chunks(i, entries_[i].param.numel(), chunks_);
+  }
 }
 
 Error SGD::step(const std::map<std::string_view, executorch::aten::Tensor>&
                     named_gradients) {
-  for (auto& group : param_groups_) {
-    auto& options = static_cast<SGDOptions&>(group.options());
-    auto weight_decay = options.weight_decay();
-    auto momentum = options.momentum();
-    auto dampening = options.dampening();
-    auto nesterov = options.nesterov();
-
-    for (auto param_iter = group.named_parameters().begin();
-         param_iter != group.named_parameters().end();
-         ++param_iter) {
-      // if param name and gradient name match, run the optimizer step
-      const auto& named_gradient = named_gradients.find(param_iter->first);
-      if (named_gradient != named_gradients.end()) {
-        auto d_p = named_gradient->second;
-        auto p = param_iter->second;
-        if (weight_decay != 0) {
-          // uses weight_decay specified and adds it to the gradient
-          add_out_hack(d_p, p, weight_decay, d_p);
-        }
-        if (momentum != 0) {
-          Tensor buf(nullptr);
-          auto param_state = state_.find(p.unsafeGetTensorImpl());
-          // look for the momentum buffer for the given parameter. this is the
-          // momentum as of the previous epoch
-          if (param_state == state_.end()) {
-            // create a new momentum buffer if it doesn't exist. this memory
-            // needs to be freed when the optimizer is destroyed
-            void* buf_ptr = malloc(d_p.nbytes());
-
-#ifdef USE_ATEN_LIB
-            std::vector<int64_t> sizes(d_p.sizes().begin(), d_p.sizes().end());
-            buf = torch::from_blob(buf_ptr, sizes, d_p.scalar_type());
-#else
-            TensorImpl* buf_impl = new TensorImpl(
-                d_p.scalar_type(),
-                d_p.sizes().size(),
-                const_cast<TensorImpl::SizesType*>(d_p.sizes().data()),
-                buf_ptr,
-                const_cast<TensorImpl::DimOrderType*>(d_p.dim_order().data()));
-            buf = Tensor(buf_impl);
-#endif
-            clone_out_hack(d_p, buf);
-
-            // save the state of the momentum buffer to be reused in later
-            // epochs
-            auto state = std::make_unique<SGDParamState>(buf);
-            state_[p.unsafeGetTensorImpl()] = std::move(state);
-          } else {
-            buf = static_cast<SGDParamState&>(*param_state->second)
-                      .momentum_buffer();
-
-            // update the momentum buffer and apply dampening
-            mul_out_hack(buf, momentum, buf);
-            add_out_hack(buf, d_p, 1 - dampening, buf);
-          }
-          if (nesterov) {
-            // apply nesterov momentum
-            add_out_hack(d_p, buf, momentum, d_p);
-          } else {
-            d_p = buf;
-          }
-        }
-        // update the parameter using the gradient and learning rate
-        add_out_hack(p, d_p, -1 * options.lr(), p);
-      }
+  Error err = internal::bind_gradients(entries_, named_gradients, gradients_);
+  if (err != Error::Ok) {
+    return err;
+  }
+  internal::for_each_param_chunk(
+      chunks_,
+      gradients_,
+      [&](const internal::ParamChunk& chunk, const float* grad) {
+        const internal::ParamEntry& entry = entries_[chunk.entry];
+        const SGDOptions& options = param_groups_[entry.group].options();
+        float* buf = options.momentum() != 0
+            ? momentum_buffers_.data() + entry.state_offset + chunk.begin
+            : nullptr;
+        sgd_update(
+            entry.param.mutable_data_ptr<float>() + chunk.begin,
+            grad + chunk.begin,
+            buf,
+            chunk.end - chunk.begin,
+            options,
+            entry.step == 0);
+      });
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    if (gradients_[i] != nullptr) {
+      entries_[i].step++;
     }
   }
   return Error::Ok;
 }
 
-SGD::~SGD() {
-  for (const auto& state_kv : state_) {
-    auto state_tensor = static_cast<SGDParamState&>(*state_kv.second);
-    free(state_tensor.momentum_buffer().unsafeGetTensorImpl()->mutable_data());
-#ifndef USE_ATEN_LIB
-    delete state_tensor.momentum_buffer().unsafeGetTensorImpl();
-#endif
-  }
-}
+SGD::~SGD() = default;
 
 } // namespace optimizer
 } // namespace training
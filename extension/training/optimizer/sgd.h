@@ -16,6 +16,7 @@
  */
 #pragma once
 
+#include <executorch/extension/training/optimizer/param_utils.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <map>
@@ -29,6 +30,10 @@ namespace training {
 namespace optimizer {
 
 /**
+ * DEPRECATED: SGD keeps the momentum buffers of all parameters in an arena of
+ * its own and no longer uses this class. It is kept so that existing code
+ * still builds, and will be removed in a future release.
+ *
  * SGD optimizer state. This keeps track of the state of a given parameter to
  * be used in later epochs.
  */
@@ -175,6 +180,11 @@ class ET_EXPERIMENTAL SGDParamGroup {
 /**
  * SGD optimizer class. This is responsible for performing the optimization
  * step.
+ *
+ * Parameters are resolved when their param group is added, and the momentum
+ * buffers of all parameters live in a single arena. A step updates each
+ * element in a single fused pass, in parallel over chunks of the parameters
+ * when a threadpool is available. Only float parameters are supported.
  */
 class ET_EXPERIMENTAL SGD {
  public:
@@ -199,10 +209,14 @@ class ET_EXPERIMENTAL SGD {
   ~SGD();
 
   /**
-   * Performs the optimization step.
+   * Performs the optimization step. The gradients are not modified.
    *
    * @param[in] named_gradients The gradients of the tensors specified by the
    * fully qualified name.
+   *
+   * @retval Error::Ok The parameters with a gradient were updated.
+   * @retval Error::InvalidArgument A parameter or gradient is not a float
+   *     tensor, or a gradient does not match the size of its parameter.
    */
   ::executorch::runtime::Error step(
       const std::map<std::string_view, executorch::aten::Tensor>&
@@ -210,8 +224,14 @@ class ET_EXPERIMENTAL SGD {
 
  private:
   std::vector<SGDParamGroup> param_groups_;
-  std::unordered_map<void*, std::unique_ptr<SGDParamState>> state_;
   std::unique_ptr<SGDOptions> defaults_;
+  /// All parameters, sorted by name.
+  std::vector<internal::ParamEntry> entries_;
+  std::vector<internal::ParamChunk> chunks_;
+  /// Momentum buffers of the parameters in groups that use momentum.
+  std::vector<float> momentum_buffers_;
+  /// The gradient of each entry during a step.
+  std::vector<const float*> gradients_;
 };
 
 } // namespace optimizer
@@ -24,6 +24,24 @@ def define_common_targets():
         #         "//executorch/kernels/portable:generated_lib_headers",
         #     ]
 
+        runtime.cxx_library(
+            name = "param_utils" + aten_suffix,
+            srcs = [
+                "param_utils.cpp",
+            ],
+            exported_headers = [
+                "param_utils.h",
+            ],
+            exported_deps = [
+                "//executorch/extension/threadpool:threadpool",
+                "//executorch/runtime/core:core",
+                "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
+            ],
+            visibility = [
+                "//executorch/extension/training/optimizer/...",
+            ],
+        )
+
         runtime.cxx_library(
             name = "sgd" + aten_suffix,
             srcs = [
@@ -33,6 +51,7 @@ def define_common_targets():
                 "sgd.h",
             ],
             exported_deps = [
+                ":param_utils" + aten_suffix,
                 "//executorch/runtime/core:core",
                 "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
             ],  # + kernel_deps,
@@ -40,3 +59,21 @@ def define_common_targets():
                 "@EXECUTORCH_CLIENTS",
             ],
         )
+
+        runtime.cxx_library(
+            name = "adamw" + aten_suffix,
+            srcs = [
+                "adamw.cpp",
+            ],
+            exported_headers = [
+                "adamw.h",
+            ],
+            exported_deps = [
+                ":param_utils" + aten_suffix,
+                "//executorch/runtime/core:core",
+                "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
+            ],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+        )
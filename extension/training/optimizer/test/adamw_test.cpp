@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/training/optimizer/adamw.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+// @lint-ignore-every CLANGTIDY facebook-hte-CArray
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using ::executorch::extension::training::optimizer::AdamW;
+using ::executorch::extension::training::optimizer::AdamWOptions;
+using ::executorch::extension::training::optimizer::AdamWParamGroup;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+// Straightforward AdamW, as documented for torch.optim.AdamW.
+void reference_adamw(
+    std::vector<double>& param,
+    const std::vector<double>& grad,
+    std::vector<double>& exp_avg,
+    std::vector<double>& exp_avg_sq,
+    const AdamWOptions& options,
+    int step) {
+  for (size_t i = 0; i < param.size(); ++i) {
+    param[i] *= 1 - options.lr() * options.weight_decay();
+    exp_avg[i] = options.beta1() * exp_avg[i] + (1 - options.beta1()) * grad[i];
+    exp_avg_sq[i] = options.beta2() * exp_avg_sq[i] +
+        (1 - options.beta2()) * grad[i] * grad[i];
+    const double m_hat = exp_avg[i] / (1 - std::pow(options.beta1(), step));
+    const double v_hat = exp_avg_sq[i] / (1 - std::pow(options.beta2(), step));
+    param[i] -= options.lr() * m_hat / (std::sqrt(v_hat) + options.eps());
+  }
+}
+
+} // namespace
+
+class AdamWOptimizerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+};
+
+TEST_F(AdamWOptimizerTest, AdamWOptionsDefaultValuesTest) {
+  AdamWOptions options;
+
+  EXPECT_EQ(options.lr(), 1e-3);
+  EXPECT_EQ(options.beta1(), 0.9);
+  EXPECT_EQ(options.beta2(), 0.999);
+  EXPECT_EQ(options.eps(), 1e-8);
+  EXPECT_EQ(options.weight_decay(), 1e-2);
+}
+
+TEST_F(AdamWOptimizerTest, AdamWOptimizerMatchesReference) {
+  TensorFactory<ScalarType::Float> tf;
+  // Large enough to be split into several chunks.
+  const size_t numel = 40000;
+  std::vector<float> param_data(numel);
+  std::vector<double> expected(numel);
+  for (size_t i = 0; i < numel; ++i) {
+    param_data[i] = expected[i] = std::sin(static_cast<double>(i));
+  }
+
+  std::map<std::string_view, Tensor> named_parameters;
+  named_parameters.insert(
+      {"param1", tf.make({static_cast<int32_t>(numel)}, param_data)});
+  named_parameters.insert({"param2", tf.make({2}, {1.0, -1.0})});
+
+  AdamWOptions options(0.01, 0.8, 0.9, 1e-6, 0.1);
+  AdamW optimizer(named_parameters, options);
+
+  std::vector<double> exp_avg(numel), exp_avg_sq(numel);
+  for (int step = 1; step <= 5; ++step) {
+    std::vector<float> grad_data(numel);
+    std::vector<double> grad(numel);
+    for (size_t i = 0; i < numel; ++i) {
+      grad_data[i] = grad[i] = std::cos(static_cast<double>(i * step));
+    }
+    // Only param1 gets a gradient.
+    std::map<std::string_view, Tensor> named_gradients;
+    named_gradients.insert(
+        {"param1", tf.make({static_cast<int32_t>(numel)}, grad_data)});
+    ASSERT_EQ(optimizer.step(named_gradients), Error::Ok);
+    reference_adamw(expected, grad, exp_avg, exp_avg_sq, options, step);
+  }
+
+  const float* p1 = named_parameters.at("param1").const_data_ptr<float>();
+  for (size_t i = 0; i < numel; ++i) {
+    ASSERT_NEAR(p1[i], expected[i], 1e-4) << "at index " << i;
+  }
+  const float* p2 = named_parameters.at("param2").const_data_ptr<float>();
+  EXPECT_EQ(p2[0], 1.0);
+  EXPECT_EQ(p2[1], -1.0);
+}
+
+TEST_F(AdamWOptimizerTest, AdamWOptimizerParamGroups) {
+  TensorFactory<ScalarType::Float> tf;
+
+  std::map<std::string_view, Tensor> group1;
+  group1.insert({"b", tf.make({1}, {1.0})});
+  std::map<std::string_view, Tensor> group2;
+  group2.insert({"a", tf.make({1}, {1.0})});
+
+  // Group 2 uses a learning rate of 0, so its parameter never changes.
+  std::vector<AdamWParamGroup> param_groups;
+  param_groups.emplace_back(group1);
+  param_groups.emplace_back(group2, std::make_unique<AdamWOptions>(0.0));
+  AdamW optimizer(param_groups, AdamWOptions(0.1, 0.9, 0.999, 1e-8, 0));
+
+  for (int i = 0; i < 10; ++i) {
+    std::map<std::string_view, Tensor> named_gradients;
+    named_gradients.insert({"a", tf.make({1}, {-1})});
+    named_gradients.insert({"b", tf.make({1}, {-1})});
+    ASSERT_EQ(optimizer.step(named_gradients), Error::Ok);
+  }
+
+  // With a constant gradient every step moves by about lr.
+  EXPECT_NEAR(group1.at("b").const_data_ptr<float>()[0], 2.0, 1e-3);
+  EXPECT_EQ(group2.at("a").const_data_ptr<float>()[0], 1.0);
+}
+
+TEST_F(AdamWOptimizerTest, AdamWOptimizerRejectsMismatchedGradient) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Int> tf_int;
+
+  std::map<std::string_view, Tensor> named_parameters;
+  named_parameters.insert({"param1", tf.make({2}, {1.0, 2.0})});
+  AdamW optimizer(named_parameters, AdamWOptions());
+
+  std::map<std::string_view, Tensor> wrong_size;
+  wrong_size.insert({"param1", tf.make({1}, {1.0})});
+  EXPECT_EQ(optimizer.step(wrong_size), Error::InvalidArgument);
+
+  std::map<std::string_view, Tensor> wrong_dtype;
+  wrong_dtype.insert({"param1", tf_int.make({2}, {1, 1})});
+  EXPECT_EQ(optimizer.step(wrong_dtype), Error::InvalidArgument);
+
+  const float* p1 = named_parameters.at("param1").const_data_ptr<float>();
+  EXPECT_EQ(p1[0], 1.0);
+  EXPECT_EQ(p1[1], 2.0);
+}
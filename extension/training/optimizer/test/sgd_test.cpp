@@ -112,3 +112,45 @@ TEST_F(SGDOptimizerTest, SGDOptimizerComplex) {
   EXPECT_NEAR(p1[0], 0.540303, 0.1);
   EXPECT_NEAR(p2[0], 0.620909, 0.1);
 }
+
+TEST_F(SGDOptimizerTest, SGDOptimizerMomentumMatchesReference) {
+  TensorFactory<ScalarType::Float> tf;
+  // Large enough to be split into several chunks.
+  const size_t numel = 40000;
+  std::vector<float> param_data(numel);
+  std::vector<double> expected(numel);
+  for (size_t i = 0; i < numel; ++i) {
+    param_data[i] = expected[i] = static_cast<double>(i % 7);
+  }
+
+  std::map<std::string_view, executorch::aten::Tensor> named_parameters;
+  named_parameters.insert(
+      {"param1", tf.make({static_cast<int32_t>(numel)}, param_data)});
+
+  const double lr = 0.1, momentum = 0.9, dampening = 0.1, weight_decay = 0.01;
+  SGD optimizer(
+      named_parameters, SGDOptions{lr, momentum, dampening, weight_decay});
+
+  std::vector<double> buf(numel);
+  for (int step = 0; step < 5; ++step) {
+    std::vector<float> grad_data(numel);
+    for (size_t i = 0; i < numel; ++i) {
+      grad_data[i] = static_cast<float>((i + step) % 5) - 2;
+    }
+    std::map<std::string_view, executorch::aten::Tensor> named_gradients;
+    named_gradients.insert(
+        {"param1", tf.make({static_cast<int32_t>(numel)}, grad_data)});
+    ASSERT_EQ(optimizer.step(named_gradients), Error::Ok);
+
+    for (size_t i = 0; i < numel; ++i) {
+      const double d_p = grad_data[i] + weight_decay * expected[i];
+      buf[i] = step == 0 ? d_p : momentum * buf[i] + (1 - dampening) * d_p;
+      expected[i] -= lr * buf[i];
+    }
+  }
+
+  const float* p1 = named_parameters.at("param1").const_data_ptr<float>();
+  for (size_t i = 0; i < numel; ++i) {
+    ASSERT_NEAR(p1[i], expected[i], 1e-4) << "at index " << i;
+  }
+}
@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/data_movement.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <c10/util/irange.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+
+namespace {
+
+// Side of the square tiles that transposes are blocked into. A tile of the
+// input and one of the output stay in the L1 cache for all element sizes.
+constexpr int64_t kTransposeTileSize = 32;
+
+// A strided copy after dropping size-1 dims, ordering the dims by decreasing
+// output stride and merging dims that are contiguous in both views.
+struct CopyPlan {
+  size_t ndim;
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t sizes[kMaxStridedCopyDims];
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t out_strides[kMaxStridedCopyDims];
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t in_strides[kMaxStridedCopyDims];
+};
+
+// Returns false if the copy is empty.
+bool make_copy_plan(
+    size_t ndim,
+    const int64_t* sizes,
+    const int64_t* out_strides,
+    const int64_t* in_strides,
+    CopyPlan& plan) {
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  size_t order[kMaxStridedCopyDims];
+  size_t num_dims = 0;
+  for (const auto d : c10::irange(ndim)) {
+    if (sizes[d] == 0) {
+      return false;
+    }
+    if (sizes[d] != 1) {
+      order[num_dims++] = d;
+    }
+  }
+  // Insertion sort, since there are few dims and they are usually in order
+  // already.
+  for (size_t i = 1; i < num_dims; ++i) {
+    const size_t d = order[i];
+    size_t j = i;
+    for (; j > 0 && out_strides[order[j - 1]] < out_strides[d]; --j) {
+      order[j] = order[j - 1];
+    }
+    order[j] = d;
+  }
+
+  // Merge from the innermost dim outwards.
+  plan.ndim = 0;
+  for (size_t i = num_dims; i > 0; --i) {
+    const size_t d = order[i - 1];
+    if (plan.ndim > 0) {
+      const size_t inner = plan.ndim - 1;
+      if (out_strides[d] == plan.out_strides[inner] * plan.sizes[inner] &&
+          in_strides[d] == plan.in_strides[inner] * plan.sizes[inner]) {
+        plan.sizes[inner] *= sizes[d];
+        continue;
+      }
+    }
+    plan.sizes[plan.ndim] = sizes[d];
+    plan.out_strides[plan.ndim] = out_strides[d];
+    plan.in_strides[plan.ndim] = in_strides[d];
+    plan.ndim++;
+  }
+  std::reverse(plan.sizes, plan.sizes + plan.ndim);
+  std::reverse(plan.out_strides, plan.out_strides + plan.ndim);
+  std::reverse(plan.in_strides, plan.in_strides + plan.ndim);
+  return true;
+}
+
+// Walks the outermost `num_outer` dims of a plan in row-major order and
+// tracks the matching element offsets.
+class OuterIndex {
+ public:
+  OuterIndex(const CopyPlan& plan, size_t num_outer, int64_t linear)
+      : plan_(plan), num_outer_(num_outer), out_offset(0), in_offset(0) {
+    for (size_t i = num_outer_; i > 0; --i) {
+      const size_t d = i - 1;
+      index_[d] = linear % plan_.sizes[d];
+      linear /= plan_.sizes[d];
+      out_offset += index_[d] * plan_.out_strides[d];
+      in_offset += index_[d] * plan_.in_strides[d];
+    }
+  }
+
+  void next() {
+    for (size_t i = num_outer_; i > 0; --i) {
+      const size_t d = i - 1;
+      out_offset += plan_.out_strides[d];
+      in_offset += plan_.in_strides[d];
+      if (++index_[d] < plan_.sizes[d]) {
+        return;
+      }
+      out_offset -= plan_.sizes[d] * plan_.out_strides[d];
+      in_offset -= plan_.sizes[d] * plan_.in_strides[d];
+      index_[d] = 0;
+    }
+  }
+
+ private:
+  const CopyPlan& plan_;
+  const size_t num_outer_;
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t index_[kMaxStridedCopyDims];
+
+ public:
+  int64_t out_offset;
+  int64_t in_offset;
+};
+
+int64_t outer_numel(const CopyPlan& plan, size_t num_outer) {
+  int64_t numel = 1;
+  for (const auto d : c10::irange(num_outer)) {
+    numel *= plan.sizes[d];
+  }
+  return numel;
+}
+
+// Grain size, in outer iterations, for outer iterations that each copy
+// `inner_numel` elements.
+int64_t outer_grain_size(int64_t inner_numel) {
+  return std::max<int64_t>(
+      1, ::executorch::extension::internal::GRAIN_SIZE / inner_numel);
+}
+
+// Both views are contiguous in the innermost dim: one memcpy per run.
+bool copy_runs(
+    char* out,
+    const char* in,
+    size_t element_size,
+    const CopyPlan& plan) {
+  const size_t num_outer = plan.ndim - 1;
+  const int64_t run = plan.sizes[num_outer];
+  const size_t run_bytes = run * element_size;
+  return ::executorch::extension::parallel_for(
+      0,
+      outer_numel(plan, num_outer),
+      outer_grain_size(run),
+      [&](const auto begin, const auto end) {
+        OuterIndex index(plan, num_outer, begin);
+        for (int64_t i = begin; i < end; ++i, index.next()) {
+          std::memcpy(
+              out + index.out_offset * element_size,
+              in + index.in_offset * element_size,
+              run_bytes);
+        }
+      });
+}
+
+// The output is contiguous in the innermost dim and the input repeats one
+// element along it.
+template <typename T>
+bool fill_runs(T* out, const T* in, const CopyPlan& plan) {
+  const size_t num_outer = plan.ndim - 1;
+  const int64_t run = plan.sizes[num_outer];
+  return ::executorch::extension::parallel_for(
+      0,
+      outer_numel(plan, num_outer),
+      outer_grain_size(run),
+      [&](const auto begin, const auto end) {
+        OuterIndex index(plan, num_outer, begin);
+        for (int64_t i = begin; i < end; ++i, index.next()) {
+          std::fill_n(out + index.out_offset, run, in[index.in_offset]);
+        }
+      });
+}
+
+// The innermost dim is contiguous in the output and the next one is
+// contiguous in the input: copy tile by tile so that both sides are read and
+// written a cache line at a time. Rows of tiles are split across threads.
+template <typename T>
+bool transpose_tiles(T* out, const T* in, const CopyPlan& plan) {
+  const size_t num_outer = plan.ndim - 2;
+  const int64_t rows = plan.sizes[num_outer];
+  const int64_t cols = plan.sizes[num_outer + 1];
+  const int64_t out_row_stride = plan.out_strides[num_outer];
+  const int64_t in_col_stride = plan.in_strides[num_outer + 1];
+  const int64_t tile_rows =
+      (rows + kTransposeTileSize - 1) / kTransposeTileSize;
+  return ::executorch::extension::parallel_for(
+      0,
+      outer_numel(plan, num_outer) * tile_rows,
+      outer_grain_size(kTransposeTileSize * cols),
+      [&](const auto begin, const auto end) {
+        OuterIndex index(plan, num_outer, begin / tile_rows);
+        int64_t tile_row = begin % tile_rows;
+        for (int64_t i = begin; i < end; ++i) {
+          T* const out_base = out + index.out_offset;
+          const T* const in_base = in + index.in_offset;
+          const int64_t r_begin = tile_row * kTransposeTileSize;
+          const int64_t r_end = std::min(rows, r_begin + kTransposeTileSize);
+          for (int64_t c_begin = 0; c_begin < cols;
+               c_begin += kTransposeTileSize) {
+            const int64_t c_end =
+                std::min(cols, c_begin + kTransposeTileSize);
+            for (int64_t c = c_begin; c < c_end; ++c) {
+              const T* const in_col = in_base + c * in_col_stride;
+              for (int64_t r = r_begin; r < r_end; ++r) {
+                out_base[r * out_row_stride + c] = in_col[r];
+              }
+            }
+          }
+          if (++tile_row == tile_rows) {
+            tile_row = 0;
+            index.next();
+          }
+        }
+      });
+}
+
+// Anything else: one element at a time along the innermost dim.
+template <typename T>
+bool gather_elements(T* out, const T* in, const CopyPlan& plan) {
+  const size_t num_outer = plan.ndim - 1;
+  const int64_t n = plan.sizes[num_outer];
+  const int64_t out_stride = plan.out_strides[num_outer];
+  const int64_t in_stride = plan.in_strides[num_outer];
+  return ::executorch::extension::parallel_for(
+      0,
+      outer_numel(plan, num_outer),
+      outer_grain_size(n),
+      [&](const auto begin, const auto end) {
+        OuterIndex index(plan, num_outer, begin);
+        for (int64_t i = begin; i < end; ++i, index.next()) {
+          T* const out_row = out + index.out_offset;
+          const T* const in_row = in + index.in_offset;
+          for (int64_t j = 0; j < n; ++j) {
+            out_row[j * out_stride] = in_row[j * in_stride];
+          }
+        }
+      });
+}
+
+template <typename T>
+bool strided_copy_impl(T* out, const T* in, const CopyPlan& plan) {
+  const size_t inner = plan.ndim - 1;
+  if (plan.out_strides[inner] == 1 && plan.in_strides[inner] == 0) {
+    return fill_runs(out, in, plan);
+  }
+  if (plan.ndim >= 2 && plan.out_strides[inner] == 1 &&
+      plan.in_strides[inner - 1] == 1) {
+    return transpose_tiles(out, in, plan);
+  }
+  return gather_elements(out, in, plan);
+}
+
+// Storage for elements of any size that the copies move as a whole.
+template <size_t N>
+struct ElementBytes {
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  unsigned char bytes[N];
+};
+
+} // namespace
+
+bool check_strided_copy_args(size_t element_size, size_t ndim) {
+  ET_CHECK_OR_RETURN_FALSE(
+      ndim <= kMaxStridedCopyDims,
+      "%zu dims exceed the limit of %zu",
+      ndim,
+      kMaxStridedCopyDims);
+  ET_CHECK_OR_RETURN_FALSE(
+      element_size == 1 || element_size == 2 || element_size == 4 ||
+          element_size == 8 || element_size == 16,
+      "Unsupported element size %zu",
+      element_size);
+  return true;
+}
+
+bool strided_copy(
+    void* out,
+    const void* in,
+    size_t element_size,
+    size_t ndim,
+    const int64_t* sizes,
+    const int64_t* out_strides,
+    const int64_t* in_strides) {
+  ET_DCHECK_MSG(
+      check_strided_copy_args(element_size, ndim),
+      "Callers must check the arguments with check_strided_copy_args()");
+  CopyPlan plan;
+  if (!make_copy_plan(ndim, sizes, out_strides, in_strides, plan)) {
+    return true;
+  }
+  if (plan.ndim == 0) {
+    std::memcpy(out, in, element_size);
+    return true;
+  }
+
+  const size_t inner = plan.ndim - 1;
+  if (plan.out_strides[inner] == 1 && plan.in_strides[inner] == 1) {
+    return copy_runs(
+        static_cast<char*>(out), static_cast<const char*>(in), element_size, plan);
+  }
+
+  switch (element_size) {
+#define ET_STRIDED_COPY_CASE(size, type) \
+  case size:                             \
+    return strided_copy_impl(            \
+        static_cast<type*>(out), static_cast<const type*>(in), plan);
+    ET_STRIDED_COPY_CASE(1, uint8_t)
+    ET_STRIDED_COPY_CASE(2, uint16_t)
+    ET_STRIDED_COPY_CASE(4, uint32_t)
+    ET_STRIDED_COPY_CASE(8, uint64_t)
+    ET_STRIDED_COPY_CASE(16, ElementBytes<16>)
+#undef ET_STRIDED_COPY_CASE
+    default:
+      // Rejected by check_strided_copy_args().
+      return false;
+  }
+}
+
+bool permuted_copy(
+    const executorch::aten::Tensor& in,
+    const int64_t* dims,
+    executorch::aten::Tensor& out) {
+  const size_t ndim = out.dim();
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t sizes[kTensorDimensionLimit];
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t out_strides[kTensorDimensionLimit];
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t in_strides[kTensorDimensionLimit];
+  for (const auto d : c10::irange(ndim)) {
+    sizes[d] = out.size(d);
+    out_strides[d] = out.strides()[d];
+    in_strides[d] = in.strides()[dims[d]];
+  }
+  return strided_copy(
+      out.mutable_data_ptr(),
+      in.const_data_ptr(),
+      out.element_size(),
+      ndim,
+      sizes,
+      out_strides,
+      in_strides);
+}
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+/// The maximum number of dims of a strided copy. Repeats are expressed as
+/// copies with two dims per tensor dim, so this is twice the tensor limit.
+constexpr size_t kMaxStridedCopyDims = 2 * kTensorDimensionLimit;
+
+/**
+ * Returns true if strided_copy() supports copies of `ndim` dims of elements of
+ * `element_size` bytes. Kernels check this before calling strided_copy().
+ */
+bool check_strided_copy_args(size_t element_size, size_t ndim);
+
+/**
+ * Copies every element of a strided view of `in` to the matching element of a
+ * strided view of `out`. All strides are in elements, not bytes, and an input
+ * stride may be 0 to repeat elements. Output views may not repeat elements.
+ *
+ * Dims are reordered to walk the output in memory order and coalesced where
+ * both views allow, so that contiguous runs become memcpys and swaps of the
+ * two innermost dims become cache-blocked transposes. The outer dims are split
+ * across threads.
+ *
+ * @param[out] out Data of the first output element.
+ * @param[in] in Data of the first input element.
+ * @param[in] element_size Size of one element in bytes.
+ * @param[in] ndim Number of entries in each of the following arrays.
+ *     check_strided_copy_args() must accept `element_size` and `ndim`.
+ * @param[in] sizes Sizes of the dims of the copied view.
+ * @param[in] out_strides Strides of the dims in the output.
+ * @param[in] in_strides Strides of the dims in the input.
+ *
+ * @returns false if the work could not be split across threads.
+ */
+bool strided_copy(
+    void* out,
+    const void* in,
+    size_t element_size,
+    size_t ndim,
+    const int64_t* sizes,
+    const int64_t* out_strides,
+    const int64_t* in_strides);
+
+/**
+ * Copies `in` into `out`, which must have the same shape and element size,
+ * after the dims of `in` are permuted by `dims`; `dims[i]` is the dim of `in`
+ * that becomes dim `i` of `out`. With an identity permutation this is a plain
+ * copy between any two layouts. check_strided_copy_args() must accept the
+ * element size and dims of `out`.
+ *
+ * @returns false if the work could not be split across threads.
+ */
+bool permuted_copy(
+    const executorch::aten::Tensor& in,
+    const int64_t* dims,
+    executorch::aten::Tensor& out);
+
+} // namespace executor
+} // namespace torch
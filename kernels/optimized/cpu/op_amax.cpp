@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+
+namespace {
+
+// If `dim_list` reduces exactly the innermost dimensions of `in`, returns the
+// number of elements each output element is reduced from, which then form a
+// contiguous row of a default dim order tensor. Returns 0 otherwise.
+int64_t get_innermost_reduction_size(
+    const Tensor& in,
+    ArrayRef<int64_t> dim_list) {
+  if (dim_list.empty() || in.dim() == 0) {
+    return in.numel();
+  }
+  bool reduced[kTensorDimensionLimit] = {};
+  for (const int64_t d : dim_list) {
+    reduced[d < 0 ? d + in.dim() : d] = true;
+  }
+  int64_t size = 1;
+  bool in_suffix = true;
+  for (int64_t d = in.dim() - 1; d >= 0; --d) {
+    if (reduced[d]) {
+      if (!in_suffix) {
+        return 0;
+      }
+      size *= in.size(d);
+    } else {
+      in_suffix = false;
+    }
+  }
+  return size;
+}
+
+} // namespace
+
+Tensor& opt_amax_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    ArrayRef<int64_t> dim_list,
+    bool keepdim,
+    Tensor& out) {
+  (void)ctx;
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_amin_amax_args(in, dim_list, keepdim, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_reduction_out(in, dim_list, keepdim, out) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  if (in.scalar_type() == ScalarType::Float && in.numel() > 0 &&
+      tensor_is_default_dim_order(in)) {
+    const int64_t reduction_size = get_innermost_reduction_size(in, dim_list);
+    if (reduction_size > 0) {
+      using Vec = at::vec::Vectorized<float>;
+      const float* in_data = in.const_data_ptr<float>();
+      float* out_data = out.mutable_data_ptr<float>();
+      const bool success = ::executorch::extension::parallel_for(
+          0,
+          out.numel(),
+          std::max<int64_t>(
+              1,
+              ::executorch::extension::internal::GRAIN_SIZE / reduction_size),
+          [&](const auto begin, const auto end) {
+            for (const auto out_ix : c10::irange(begin, end)) {
+              // maximum() propagates NaN like the reference implementation.
+              out_data[out_ix] = at::vec::reduce_all<float>(
+                  [](Vec& x, Vec& y) { return at::vec::maximum(x, y); },
+                  in_data + out_ix * reduction_size,
+                  reduction_size);
+            }
+          });
+      ET_KERNEL_CHECK_MSG(ctx, success, Internal, out, "parallel_for failed");
+      return out;
+    }
+  }
+
+  ReduceOverDimListPlan plan(in, dim_list);
+  ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, "amax.out", CTYPE, [&]() {
+    CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+    const bool success = parallel_for_each_reduce_over_dim_list_output_index(
+        in, dim_list, out, [&](const auto begin, const auto end) {
+          for (const auto out_ix : c10::irange(begin, end)) {
+            out_data[out_ix] = plan.execute<CTYPE>(
+                [](CTYPE v, CTYPE max_v) {
+                  return std::isnan(v) || v > max_v ? v : max_v;
+                },
+                out_ix);
+          }
+        });
+    ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
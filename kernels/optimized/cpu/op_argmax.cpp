@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using executorch::aten::Tensor;
+using std::optional;
+
+namespace {
+
+// Index of the first maximum of a contiguous row, or of its first NaN.
+int64_t argmax_row(const float* in, int64_t size) {
+  using Vec = at::vec::Vectorized<float>;
+  // maximum() propagates NaN, so the max is NaN iff the row contains one.
+  const float max_in = at::vec::reduce_all<float>(
+      [](Vec& x, Vec& y) { return at::vec::maximum(x, y); }, in, size);
+  if (std::isnan(max_in)) {
+    return std::find_if(in, in + size, [](float v) { return std::isnan(v); }) -
+        in;
+  }
+  return std::find(in, in + size, max_in) - in;
+}
+
+// argmax over the innermost dimension of a contiguous float tensor. Returns
+// false if parallel_for fails.
+bool argmax_lastdim(const Tensor& in, int64_t dim_size, Tensor& out) {
+  const float* in_data = in.const_data_ptr<float>();
+  long* out_data = out.mutable_data_ptr<long>();
+  const int64_t outer_size = dim_size == 0 ? 0 : in.numel() / dim_size;
+  return ::executorch::extension::parallel_for(
+      0,
+      outer_size,
+      std::max<int64_t>(
+          1, ::executorch::extension::internal::GRAIN_SIZE / dim_size),
+      [&](const auto begin, const auto end) {
+        for (const auto row : c10::irange(begin, end)) {
+          out_data[row] = argmax_row(in_data + row * dim_size, dim_size);
+        }
+      });
+}
+
+} // namespace
+
+Tensor& opt_argmax_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    optional<int64_t> dim,
+    bool keepdim,
+    Tensor& out) {
+  (void)ctx;
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_argmin_argmax_args(in, dim, keepdim, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_reduction_out(in, dim, keepdim, out) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  // Reducing over the innermost dimension, or over all elements, of a
+  // contiguous tensor reads contiguous rows.
+  if (in.scalar_type() == ScalarType::Float && in.numel() > 0 &&
+      tensor_is_default_dim_order(in)) {
+    int64_t dim_size = 0;
+    if (!dim.has_value() || in.dim() == 0) {
+      dim_size = in.numel();
+    } else {
+      const int64_t d = dim.value() < 0 ? dim.value() + in.dim() : dim.value();
+      if (d == in.dim() - 1) {
+        dim_size = in.size(d);
+      }
+    }
+    if (dim_size > 0) {
+      const bool success = argmax_lastdim(in, dim_size, out);
+      ET_KERNEL_CHECK_MSG(ctx, success, Internal, out, "parallel_for failed");
+      return out;
+    }
+  }
+
+  ET_SWITCH_REALHBF16_TYPES(in.scalar_type(), ctx, "argmax.out", CTYPE, [&] {
+    long* out_data = out.mutable_data_ptr<long>();
+
+    const bool success = parallel_for_each_reduce_over_dim_output_index(
+        in, dim, out, [&](const auto begin, const auto end) {
+          for (const auto out_ix : c10::irange(begin, end)) {
+            std::tuple<CTYPE, long> acc = reduce_over_dim<CTYPE>(
+                [](CTYPE v, long ix, CTYPE acc_val, long acc_ix) {
+                  // Equivalent to !isnan(acc_val) && (isnan(v) || v >
+                  // acc_val), so the first NaN wins.
+                  if (!std::isnan(acc_val) && !(v <= acc_val)) {
+                    acc_val = v;
+                    acc_ix = ix;
+                  }
+                  return std::tuple<CTYPE, long>{acc_val, acc_ix};
+                },
+                in,
+                dim,
+                out_ix);
+            out_data[out_ix] = std::get<1>(acc);
+          }
+        });
+    ET_KERNEL_CHECK_MSG(ctx, success, Internal, , "parallel_for failed");
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
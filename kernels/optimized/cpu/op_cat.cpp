@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+#include <executorch/kernels/optimized/cpu/data_movement.h>
+#include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+namespace {
+
+// Copies `in` into the part of `out` that starts at `dim_offset` along `dim`.
+bool copy_into_slice(
+    const Tensor& in,
+    int64_t dim,
+    int64_t dim_offset,
+    Tensor& out) {
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t sizes[kTensorDimensionLimit];
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t out_strides[kTensorDimensionLimit];
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t in_strides[kTensorDimensionLimit];
+  for (const auto d : c10::irange(in.dim())) {
+    sizes[d] = in.size(d);
+    out_strides[d] = out.strides()[d];
+    in_strides[d] = in.strides()[d];
+  }
+  char* const out_data = static_cast<char*>(out.mutable_data_ptr()) +
+      dim_offset * out.strides()[dim] * out.element_size();
+  return strided_copy(
+      out_data,
+      in.const_data_ptr(),
+      out.element_size(),
+      in.dim(),
+      sizes,
+      out_strides,
+      in_strides);
+}
+
+// Like copy_into_slice(), for inputs of a different dtype than `out`. Both
+// must be contiguous.
+bool convert_into_slice(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t outer,
+    int64_t inner,
+    int64_t out_row_size,
+    int64_t out_row_offset,
+    Tensor& out) {
+  bool success = true;
+  ET_SWITCH_REALHBBF16_TYPES(out.scalar_type(), ctx, "cat.out", CTYPE_OUT, [&] {
+    ET_SWITCH_REALHBBF16_TYPES(in.scalar_type(), ctx, "cat.out", CTYPE_IN, [&] {
+      const CTYPE_IN* const in_data = in.const_data_ptr<CTYPE_IN>();
+      CTYPE_OUT* const out_data =
+          out.mutable_data_ptr<CTYPE_OUT>() + out_row_offset;
+      success = ::executorch::extension::parallel_for(
+          0,
+          outer,
+          std::max<int64_t>(
+              1, ::executorch::extension::internal::GRAIN_SIZE / inner),
+          [&](const auto begin, const auto end) {
+            for (const auto i : c10::irange(begin, end)) {
+              const CTYPE_IN* const in_row = in_data + i * inner;
+              CTYPE_OUT* const out_row = out_data + i * out_row_size;
+              for (const auto k : c10::irange(inner)) {
+                out_row[k] = static_cast<CTYPE_OUT>(in_row[k]);
+              }
+            }
+          });
+    });
+  });
+  return success;
+}
+
+} // namespace
+
+// cat.out(Tensor[] tensors, int dim=0, *, Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_cat_out(
+    KernelRuntimeContext& ctx,
+    executorch::aten::ArrayRef<Tensor> tensors,
+    int64_t dim,
+    Tensor& out) {
+  if (dim < 0) {
+    dim += out.dim();
+  }
+
+  ET_KERNEL_CHECK(ctx, check_cat_args(tensors, dim, out), InvalidArgument, out);
+
+  Tensor::SizesType expected_out_size[kTensorDimensionLimit];
+  size_t expected_out_dim = 0;
+  get_cat_out_target_size(tensors, dim, expected_out_size, &expected_out_dim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {expected_out_size, expected_out_dim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_strided_copy_args(out.element_size(), out.dim()),
+      InvalidArgument,
+      out);
+
+  // Empty inputs, including 1D-empty ones of any rank, contribute nothing.
+  const size_t outer = getLeadingDims(out, dim);
+  const size_t dim_stride = getTrailingDims(out, dim);
+  const int64_t out_row_size = out.dim() == 0 ? 1 : out.size(dim) * dim_stride;
+  const bool out_is_complex =
+      executorch::runtime::isComplexType(out.scalar_type());
+
+  int64_t dim_offset = 0;
+  for (const auto& in : tensors) {
+    if (in.numel() == 0) {
+      continue;
+    }
+    bool success = true;
+    if (in.scalar_type() == out.scalar_type()) {
+      success = copy_into_slice(in, dim, dim_offset, out);
+    } else {
+      // TODO: The current support for complex dtype enforces that input and
+      // output tensors have the same dtype. Support mixed dtypes in the
+      // future.
+      ET_KERNEL_CHECK(
+          ctx,
+          !out_is_complex && !executorch::runtime::isComplexType(
+                                 in.scalar_type()),
+          InvalidArgument,
+          out);
+      ET_KERNEL_CHECK(
+          ctx,
+          tensor_is_default_dim_order(in),
+          InvalidArgument,
+          out);
+      success = convert_into_slice(
+          ctx,
+          in,
+          outer,
+          in.size(dim) * dim_stride,
+          out_row_size,
+          dim_offset * dim_stride,
+          out);
+    }
+    ET_KERNEL_CHECK_MSG(ctx, success, Internal, out, "parallel_for failed");
+    dim_offset += in.size(dim);
+  }
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
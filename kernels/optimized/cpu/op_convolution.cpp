@@ -0,0 +1,654 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <c10/util/irange.h>
+
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/portable/cpu/util/dtype_util.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+// Performs a 1D or 2D (optionally grouped or transposed) convolution.
+//
+// Contiguous floating point convolutions are lowered onto cpublas::gemm: 1x1
+// convolutions multiply the input directly, general convolutions go through
+// an im2col buffer taken from the temp allocator, and depthwise convolutions
+// use a direct per-channel stencil. Everything else (transposed convolutions,
+// channels-last tensors, integer dtypes, mixed bias dtypes, or a missing temp
+// allocator) runs a generic stride-aware loop. All paths are parallelized over
+// (batch, output channel) pairs.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+using ScalarType = executorch::aten::ScalarType;
+using IntArrayRef = executorch::aten::ArrayRef<int64_t>;
+
+namespace {
+
+using ::executorch::cpublas::gemm;
+using ::executorch::cpublas::TransposeType;
+
+// Geometry of a convolution, with 1D convolutions expressed as 2D
+// convolutions whose height is 1.
+struct ConvParams {
+  int64_t batch;
+  int64_t in_C;
+  int64_t in_H;
+  int64_t in_W;
+  int64_t out_C;
+  int64_t out_H;
+  int64_t out_W;
+  int64_t w_H;
+  int64_t w_W;
+  int64_t groups;
+  int64_t stride_y;
+  int64_t stride_x;
+  int64_t padding_y;
+  int64_t padding_x;
+  int64_t dilation_y;
+  int64_t dilation_x;
+};
+
+// Element strides of an NCHW-indexed tensor; the H stride of a 3D tensor is 0.
+struct Strides4D {
+  int64_t n;
+  int64_t c;
+  int64_t h;
+  int64_t w;
+};
+
+ConvParams get_conv_params(
+    const Tensor& in,
+    const Tensor& weight,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    const Tensor& out) {
+  const bool is_1d = in.dim() == 3;
+  ConvParams p;
+  p.batch = in.size(0);
+  p.in_C = in.size(1);
+  p.in_H = is_1d ? 1 : in.size(2);
+  p.in_W = in.size(in.dim() - 1);
+  p.out_C = out.size(1);
+  p.out_H = is_1d ? 1 : out.size(2);
+  p.out_W = out.size(out.dim() - 1);
+  p.w_H = is_1d ? 1 : weight.size(2);
+  p.w_W = weight.size(weight.dim() - 1);
+  p.groups = groups;
+  p.stride_y = is_1d ? 1 : val_at(stride, 0);
+  p.stride_x = val_at(stride, is_1d ? 0 : 1);
+  p.padding_y = is_1d ? 0 : val_at(padding, 0, /*default_value=*/0);
+  p.padding_x = val_at(padding, is_1d ? 0 : 1, /*default_value=*/0);
+  p.dilation_y = is_1d ? 1 : val_at(dilation, 0);
+  p.dilation_x = val_at(dilation, is_1d ? 0 : 1);
+  return p;
+}
+
+Strides4D get_strides_4d(const Tensor& t) {
+  const auto strides = t.strides();
+  if (t.dim() == 3) {
+    return {strides[0], strides[1], 0, strides[2]};
+  }
+  return {strides[0], strides[1], strides[2], strides[3]};
+}
+
+// Number of (batch, output channel) pairs to hand to each thread, given the
+// number of multiply-accumulates needed for one output channel.
+int64_t channel_grain_size(int64_t macs_per_channel) {
+  return std::max<int64_t>(
+      1,
+      ::executorch::extension::internal::GRAIN_SIZE /
+          std::max<int64_t>(1, macs_per_channel));
+}
+
+// Initializes the output planes of channels [c_begin, c_end) of one batch
+// entry to the bias (or zero) so that gemm can accumulate into them.
+template <typename CTYPE>
+void fill_output_planes(
+    CTYPE* out_batch,
+    const CTYPE* bias,
+    int64_t c_begin,
+    int64_t c_end,
+    int64_t plane_size) {
+  for (const auto c : c10::irange(c_begin, c_end)) {
+    CTYPE* plane = out_batch + c * plane_size;
+    if (bias == nullptr) {
+      std::memset(plane, 0, plane_size * sizeof(CTYPE));
+    } else {
+      std::fill(plane, plane + plane_size, bias[c]);
+    }
+  }
+}
+
+// Splits a parallel range over (batch, group, channel-in-group) into runs of
+// consecutive output channels that share a batch entry and a group, and calls
+// fn(batch, group, first_channel_in_group, num_channels) on each run.
+template <typename Fn>
+void for_each_channel_run(
+    int64_t begin,
+    int64_t end,
+    int64_t groups,
+    int64_t out_C_per_group,
+    const Fn& fn) {
+  int64_t idx = begin;
+  while (idx < end) {
+    const int64_t batch_group = idx / out_C_per_group;
+    const int64_t c = idx % out_C_per_group;
+    const int64_t run =
+        std::min(end, (batch_group + 1) * out_C_per_group) - idx;
+    fn(batch_group / groups, batch_group % groups, c, run);
+    idx += run;
+  }
+}
+
+/**
+ * 1x1 convolution with unit stride and no padding. Each group of each batch
+ * entry is a single matrix product between the weights and the input planes,
+ * which are already laid out as a column-major (H * W) x C matrix, so no
+ * packing is needed.
+ */
+template <typename CTYPE>
+void pointwise_conv(
+    const ConvParams& p,
+    const CTYPE* in,
+    const CTYPE* w,
+    const CTYPE* bias,
+    CTYPE* out) {
+  const int64_t plane = p.out_H * p.out_W;
+  const int64_t in_C_per_group = p.in_C / p.groups;
+  const int64_t out_C_per_group = p.out_C / p.groups;
+
+  ::executorch::extension::parallel_for(
+      0,
+      p.batch * p.out_C,
+      channel_grain_size(plane * in_C_per_group),
+      [&](const auto begin, const auto end) {
+        for_each_channel_run(
+            begin,
+            end,
+            p.groups,
+            out_C_per_group,
+            [&](int64_t n, int64_t g, int64_t c, int64_t num_channels) {
+              const int64_t out_c = g * out_C_per_group + c;
+              CTYPE* out_ptr = out + (n * p.out_C + out_c) * plane;
+              fill_output_planes(
+                  out + n * p.out_C * plane,
+                  bias,
+                  out_c,
+                  out_c + num_channels,
+                  plane);
+              gemm(
+                  TransposeType::NoTranspose,
+                  TransposeType::NoTranspose,
+                  plane,
+                  num_channels,
+                  in_C_per_group,
+                  static_cast<CTYPE>(1),
+                  in + (n * p.in_C + g * in_C_per_group) * plane,
+                  plane,
+                  w + out_c * in_C_per_group,
+                  in_C_per_group,
+                  static_cast<CTYPE>(1),
+                  out_ptr,
+                  plane);
+            });
+      });
+}
+
+/**
+ * Unpacks the input planes of one group of one batch entry into a
+ * (C_per_group * w_H * w_W) x (out_H * out_W) row-major matrix, where each row
+ * holds the input values seen by one weight tap across all output positions.
+ */
+template <typename CTYPE>
+void im2col(
+    const ConvParams& p,
+    const CTYPE* in_group,
+    int64_t in_C_per_group,
+    CTYPE* col) {
+  const int64_t plane = p.out_H * p.out_W;
+  const int64_t taps = p.w_H * p.w_W;
+
+  ::executorch::extension::parallel_for(
+      0,
+      in_C_per_group * taps,
+      channel_grain_size(plane),
+      [&](const auto begin, const auto end) {
+        for (const auto row : c10::irange(begin, end)) {
+          const int64_t c = row / taps;
+          const int64_t w_y = (row % taps) / p.w_W;
+          const int64_t w_x = row % p.w_W;
+          const CTYPE* in_plane = in_group + c * p.in_H * p.in_W;
+          CTYPE* col_row = col + row * plane;
+          for (const auto out_y : c10::irange(p.out_H)) {
+            CTYPE* col_out = col_row + out_y * p.out_W;
+            const int64_t in_y =
+                out_y * p.stride_y - p.padding_y + w_y * p.dilation_y;
+            if (in_y < 0 || in_y >= p.in_H) {
+              std::memset(col_out, 0, p.out_W * sizeof(CTYPE));
+              continue;
+            }
+            const CTYPE* in_row = in_plane + in_y * p.in_W;
+            for (const auto out_x : c10::irange(p.out_W)) {
+              const int64_t in_x =
+                  out_x * p.stride_x - p.padding_x + w_x * p.dilation_x;
+              col_out[out_x] =
+                  (in_x >= 0 && in_x < p.in_W) ? in_row[in_x] : CTYPE(0);
+            }
+          }
+        }
+      });
+}
+
+/**
+ * General convolution via im2col + gemm. The column buffer holds one group of
+ * one batch entry at a time; the gemm for that group is split across threads
+ * by output channel.
+ */
+template <typename CTYPE>
+void im2col_conv(
+    const ConvParams& p,
+    const CTYPE* in,
+    const CTYPE* w,
+    const CTYPE* bias,
+    CTYPE* out,
+    CTYPE* col) {
+  const int64_t plane = p.out_H * p.out_W;
+  const int64_t in_C_per_group = p.in_C / p.groups;
+  const int64_t out_C_per_group = p.out_C / p.groups;
+  const int64_t k = in_C_per_group * p.w_H * p.w_W;
+
+  for (const auto n : c10::irange(p.batch)) {
+    for (const auto g : c10::irange(p.groups)) {
+      im2col(
+          p,
+          in + (n * p.in_C + g * in_C_per_group) * p.in_H * p.in_W,
+          in_C_per_group,
+          col);
+
+      const int64_t out_c_start = g * out_C_per_group;
+      CTYPE* out_batch = out + n * p.out_C * plane;
+      ::executorch::extension::parallel_for(
+          0,
+          out_C_per_group,
+          channel_grain_size(plane * k),
+          [&](const auto begin, const auto end) {
+            fill_output_planes(
+                out_batch,
+                bias,
+                out_c_start + begin,
+                out_c_start + end,
+                plane);
+            gemm(
+                TransposeType::NoTranspose,
+                TransposeType::NoTranspose,
+                plane,
+                end - begin,
+                k,
+                static_cast<CTYPE>(1),
+                col,
+                plane,
+                w + (out_c_start + begin) * k,
+                k,
+                static_cast<CTYPE>(1),
+                out_batch + (out_c_start + begin) * plane,
+                plane);
+          });
+    }
+  }
+}
+
+/**
+ * Depthwise convolution (one input channel per group). Each output plane is
+ * accumulated one weight tap at a time; the valid output column range for a
+ * tap is computed up front so the innermost loop has no bounds checks and can
+ * be vectorized by the compiler.
+ */
+template <typename CTYPE>
+void depthwise_conv(
+    const ConvParams& p,
+    const CTYPE* in,
+    const CTYPE* w,
+    const CTYPE* bias,
+    CTYPE* out) {
+  const int64_t out_plane = p.out_H * p.out_W;
+  const int64_t in_plane = p.in_H * p.in_W;
+  const int64_t multiplier = p.out_C / p.groups;
+  const int64_t taps = p.w_H * p.w_W;
+
+  ::executorch::extension::parallel_for(
+      0,
+      p.batch * p.out_C,
+      channel_grain_size(out_plane * taps),
+      [&](const auto begin, const auto end) {
+        for (const auto idx : c10::irange(begin, end)) {
+          const int64_t n = idx / p.out_C;
+          const int64_t out_c = idx % p.out_C;
+          const CTYPE* in_ptr =
+              in + (n * p.in_C + out_c / multiplier) * in_plane;
+          const CTYPE* w_ptr = w + out_c * taps;
+          CTYPE* out_ptr = out + idx * out_plane;
+          std::fill(
+              out_ptr,
+              out_ptr + out_plane,
+              bias != nullptr ? bias[out_c] : CTYPE(0));
+
+          for (const auto w_x : c10::irange(p.w_W)) {
+            // Output columns whose input column lies inside the image.
+            const int64_t offset = w_x * p.dilation_x - p.padding_x;
+            const int64_t x_begin =
+                offset >= 0 ? 0 : (-offset + p.stride_x - 1) / p.stride_x;
+            const int64_t x_end = p.in_W - 1 - offset >= 0
+                ? std::min(p.out_W, (p.in_W - 1 - offset) / p.stride_x + 1)
+                : 0;
+            if (x_begin >= x_end) {
+              continue;
+            }
+            for (const auto w_y : c10::irange(p.w_H)) {
+              const CTYPE w_val = w_ptr[w_y * p.w_W + w_x];
+              for (const auto out_y : c10::irange(p.out_H)) {
+                const int64_t in_y =
+                    out_y * p.stride_y - p.padding_y + w_y * p.dilation_y;
+                if (in_y < 0 || in_y >= p.in_H) {
+                  continue;
+                }
+                const CTYPE* in_row = in_ptr + in_y * p.in_W;
+                CTYPE* out_row = out_ptr + out_y * p.out_W;
+                if (p.stride_x == 1) {
+                  for (int64_t out_x = x_begin; out_x < x_end; ++out_x) {
+                    out_row[out_x] += w_val * in_row[out_x + offset];
+                  }
+                } else {
+                  for (int64_t out_x = x_begin; out_x < x_end; ++out_x) {
+                    out_row[out_x] +=
+                        w_val * in_row[out_x * p.stride_x + offset];
+                  }
+                }
+              }
+            }
+          }
+        }
+      });
+}
+
+/**
+ * Stride-aware direct convolution used for every case the gemm-based paths do
+ * not cover. Each (batch, output channel) pair writes a disjoint output plane,
+ * so pairs are processed in parallel for regular and transposed convolutions
+ * alike.
+ */
+template <typename CTYPE, typename LoadFn = CTYPE (*)(const void*)>
+void generic_conv(
+    const ConvParams& p,
+    const Tensor& in,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    LoadFn load_bias,
+    bool transposed,
+    Tensor& out) {
+  const CTYPE* const in_ptr = in.const_data_ptr<CTYPE>();
+  const CTYPE* const w_ptr = weight.const_data_ptr<CTYPE>();
+  CTYPE* const out_ptr = out.mutable_data_ptr<CTYPE>();
+  const char* const bias_ptr = bias.has_value()
+      ? reinterpret_cast<const char*>(bias.value().const_data_ptr())
+      : nullptr;
+  const size_t bias_element_size =
+      bias.has_value() ? bias.value().element_size() : 0;
+
+  const Strides4D in_s = get_strides_4d(in);
+  const Strides4D w_s = get_strides_4d(weight);
+  const Strides4D out_s = get_strides_4d(out);
+
+  const int64_t in_C_per_group = p.in_C / p.groups;
+  const int64_t out_C_per_group = p.out_C / p.groups;
+
+  ::executorch::extension::parallel_for(
+      0,
+      p.batch * p.out_C,
+      channel_grain_size(p.out_H * p.out_W * in_C_per_group * p.w_H * p.w_W),
+      [&](const auto begin, const auto end) {
+        for (const auto idx : c10::irange(begin, end)) {
+          const int64_t n = idx / p.out_C;
+          const int64_t out_c = idx % p.out_C;
+          const int64_t group = out_c / out_C_per_group;
+          const int64_t in_c_start = group * in_C_per_group;
+          const CTYPE bias_val = bias_ptr != nullptr
+              ? load_bias(&bias_ptr[out_c * bias_element_size])
+              : CTYPE(0);
+          CTYPE* const out_base = out_ptr + n * out_s.n + out_c * out_s.c;
+
+          if (!transposed) {
+            for (const auto out_y : c10::irange(p.out_H)) {
+              for (const auto out_x : c10::irange(p.out_W)) {
+                CTYPE accum = 0;
+                for (const auto c : c10::irange(in_C_per_group)) {
+                  const CTYPE* in_base =
+                      in_ptr + n * in_s.n + (in_c_start + c) * in_s.c;
+                  const CTYPE* w_base = w_ptr + out_c * w_s.n + c * w_s.c;
+                  for (const auto w_y : c10::irange(p.w_H)) {
+                    const int64_t in_y =
+                        out_y * p.stride_y - p.padding_y + w_y * p.dilation_y;
+                    if (in_y < 0 || in_y >= p.in_H) {
+                      continue;
+                    }
+                    for (const auto w_x : c10::irange(p.w_W)) {
+                      const int64_t in_x = out_x * p.stride_x - p.padding_x +
+                          w_x * p.dilation_x;
+                      if (in_x < 0 || in_x >= p.in_W) {
+                        continue;
+                      }
+                      accum += in_base[in_y * in_s.h + in_x * in_s.w] *
+                          w_base[w_y * w_s.h + w_x * w_s.w];
+                    }
+                  }
+                }
+                out_base[out_y * out_s.h + out_x * out_s.w] = accum + bias_val;
+              }
+            }
+          } else {
+            // Transposed weights are laid out as
+            // [in_C, out_C_per_group, w_H, w_W]. Scatter every input value
+            // into this output channel's plane.
+            for (const auto out_y : c10::irange(p.out_H)) {
+              for (const auto out_x : c10::irange(p.out_W)) {
+                out_base[out_y * out_s.h + out_x * out_s.w] = bias_val;
+              }
+            }
+            const int64_t w_c = out_c - group * out_C_per_group;
+            for (const auto c : c10::irange(in_C_per_group)) {
+              const CTYPE* in_base =
+                  in_ptr + n * in_s.n + (in_c_start + c) * in_s.c;
+              const CTYPE* w_base =
+                  w_ptr + (in_c_start + c) * w_s.n + w_c * w_s.c;
+              for (const auto in_y : c10::irange(p.in_H)) {
+                for (const auto in_x : c10::irange(p.in_W)) {
+                  const CTYPE in_val = in_base[in_y * in_s.h + in_x * in_s.w];
+                  for (const auto w_y : c10::irange(p.w_H)) {
+                    const int64_t out_y =
+                        in_y * p.stride_y - p.padding_y + w_y * p.dilation_y;
+                    if (out_y < 0 || out_y >= p.out_H) {
+                      continue;
+                    }
+                    for (const auto w_x : c10::irange(p.w_W)) {
+                      const int64_t out_x = in_x * p.stride_x - p.padding_x +
+                          w_x * p.dilation_x;
+                      if (out_x < 0 || out_x >= p.out_W) {
+                        continue;
+                      }
+                      out_base[out_y * out_s.h + out_x * out_s.w] +=
+                          in_val * w_base[w_y * w_s.h + w_x * w_s.w];
+                    }
+                  }
+                }
+              }
+            }
+          }
+        }
+      });
+}
+
+// The gemm-based paths need contiguous tensors that all share one floating
+// point dtype.
+bool can_use_gemm_paths(
+    const Tensor& in,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    bool transposed,
+    const Tensor& out) {
+  const ScalarType dtype = in.scalar_type();
+  if (transposed ||
+      !(dtype == ScalarType::Float || dtype == ScalarType::Double ||
+        dtype == ScalarType::Half || dtype == ScalarType::BFloat16) ||
+      weight.scalar_type() != dtype || out.scalar_type() != dtype) {
+    return false;
+  }
+  if (bias.has_value() &&
+      (bias.value().scalar_type() != dtype || bias.value().dim() != 1)) {
+    return false;
+  }
+  return is_contiguous_dim_order(in.dim_order().data(), in.dim()) &&
+      is_contiguous_dim_order(weight.dim_order().data(), weight.dim()) &&
+      is_contiguous_dim_order(out.dim_order().data(), out.dim());
+}
+
+} // namespace
+
+Tensor& opt_convolution_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const std::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool transposed,
+    IntArrayRef output_padding,
+    int64_t groups,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_convolution_args(
+          in,
+          weight,
+          bias,
+          stride,
+          padding,
+          dilation,
+          transposed,
+          output_padding,
+          groups,
+          out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  size_t output_ndim = 0;
+  executorch::aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_convolution_out_target_size(
+      in,
+      weight,
+      stride,
+      padding,
+      dilation,
+      transposed,
+      output_padding,
+      groups,
+      output_sizes,
+      &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, in.dim() - 2),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  static constexpr const char name[] = "convolution.out";
+
+  const ConvParams p =
+      get_conv_params(in, weight, stride, padding, dilation, groups, out);
+
+  if (can_use_gemm_paths(in, weight, bias, transposed, out)) {
+    const int64_t in_C_per_group = p.in_C / p.groups;
+    const bool is_depthwise = p.groups > 1 && in_C_per_group == 1;
+    const bool is_pointwise = p.w_H == 1 && p.w_W == 1 && p.stride_y == 1 &&
+        p.stride_x == 1 && p.padding_y == 0 && p.padding_x == 0;
+
+    bool handled = false;
+    ET_SWITCH_FLOATHBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+      const CTYPE* in_ptr = in.const_data_ptr<CTYPE>();
+      const CTYPE* w_ptr = weight.const_data_ptr<CTYPE>();
+      const CTYPE* bias_ptr =
+          bias.has_value() ? bias.value().const_data_ptr<CTYPE>() : nullptr;
+      CTYPE* out_ptr = out.mutable_data_ptr<CTYPE>();
+
+      if (is_depthwise) {
+        depthwise_conv<CTYPE>(p, in_ptr, w_ptr, bias_ptr, out_ptr);
+        handled = true;
+      } else if (is_pointwise) {
+        pointwise_conv<CTYPE>(p, in_ptr, w_ptr, bias_ptr, out_ptr);
+        handled = true;
+      } else {
+        // The column buffer is only needed for the duration of this call; if
+        // the method has no temp allocator, use the direct loop instead.
+        const size_t col_size = in_C_per_group * p.w_H * p.w_W * p.out_H *
+            p.out_W * sizeof(CTYPE);
+        Result<void*> col = ctx.allocate_temp(col_size);
+        if (col.ok()) {
+          im2col_conv<CTYPE>(
+              p,
+              in_ptr,
+              w_ptr,
+              bias_ptr,
+              out_ptr,
+              static_cast<CTYPE*>(col.get()));
+          handled = true;
+        }
+      }
+    });
+    if (handled) {
+      return out;
+    }
+  }
+
+  ET_SWITCH_REALHBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+    const auto load_bias = bias.has_value()
+        ? utils::internal::get_load_to_compute_fn<CTYPE, name>(
+              bias.value(), utils::SupportedTensorDtypes::REALHBF16)
+        : nullptr;
+    generic_conv<CTYPE>(p, in, weight, bias, load_bias, transposed, out);
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
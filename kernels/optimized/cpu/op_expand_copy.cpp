@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+#include <executorch/kernels/optimized/cpu/data_movement.h>
+#include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+// expand_copy.out(Tensor self, SymInt[] size, *, bool implicit=False,
+// Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_expand_copy_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& self,
+    ArrayRef<int64_t> expand_sizes,
+    bool implicit,
+    Tensor& out) {
+  (void)ctx;
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_expand_copy_args(self, expand_sizes, implicit, out),
+      InvalidArgument,
+      out);
+
+  // Holds the result of converting -1 to the original dim sizes
+  executorch::aten::SizesType output_sizes[kTensorDimensionLimit];
+  size_t output_rank = 0;
+  ET_KERNEL_CHECK(
+      ctx,
+      get_expand_copy_out_target_size(
+          self.sizes(), expand_sizes, output_sizes, &output_rank),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_rank}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(self, out), InvalidArgument, out);
+  ET_KERNEL_CHECK(ctx, tensor_is_default_dim_order(self), InvalidArgument, out);
+  ET_KERNEL_CHECK(
+      ctx,
+      check_strided_copy_args(out.element_size(), output_rank),
+      InvalidArgument,
+      out);
+
+  // Expanded dims, including the new leading ones, read the same input
+  // elements again, so they have an input stride of 0.
+  const size_t leading = output_rank - self.dim();
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t sizes[kTensorDimensionLimit];
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t out_strides[kTensorDimensionLimit];
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t in_strides[kTensorDimensionLimit];
+  for (const auto d : c10::irange(output_rank)) {
+    sizes[d] = out.size(d);
+    out_strides[d] = out.strides()[d];
+    in_strides[d] = d < leading || self.size(d - leading) == 1
+        ? 0
+        : self.strides()[d - leading];
+  }
+  const bool success = strided_copy(
+      out.mutable_data_ptr(),
+      self.const_data_ptr(),
+      out.element_size(),
+      output_rank,
+      sizes,
+      out_strides,
+      in_strides);
+  ET_KERNEL_CHECK_MSG(ctx, success, Internal, out, "parallel_for failed");
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+#include <executorch/kernels/optimized/cpu/data_movement.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+namespace {
+
+bool calculate_output_size(
+    const executorch::aten::ArrayRef<executorch::aten::SizesType>& self_sizes,
+    const executorch::aten::ArrayRef<int64_t>& repeats,
+    Tensor::SizesType* out_sizes_ptr) {
+  ET_LOG_AND_RETURN_IF_FALSE(repeats.size() < kTensorDimensionLimit);
+
+  ET_CHECK_OR_RETURN_FALSE(
+      repeats.size() >= self_sizes.size(),
+      "Repeats vector size is %zu must be >= self_sizes %zu.",
+      repeats.size(),
+      self_sizes.size());
+
+  const size_t leading = repeats.size() - self_sizes.size();
+  for (const auto i : c10::irange(repeats.size())) {
+    ET_CHECK_OR_RETURN_FALSE(
+        repeats[i] >= 0, "Repeat %" PRId64 " is negative", repeats[i]);
+    out_sizes_ptr[i] = static_cast<Tensor::SizesType>(repeats[i]) *
+        (i < leading ? 1 : self_sizes[i - leading]);
+  }
+
+  return true;
+}
+
+} // namespace
+
+// repeat.out(Tensor self, int[] repeats, *, Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_repeat_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& self,
+    executorch::aten::ArrayRef<int64_t> repeats,
+    Tensor& out) {
+  (void)ctx;
+  Tensor::SizesType expected_output_size[kTensorDimensionLimit];
+
+  ET_KERNEL_CHECK(
+      ctx,
+      calculate_output_size(self.sizes(), repeats, expected_output_size),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dtype(self, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(self, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(ctx, tensor_is_default_dim_order(self), InvalidArgument, out);
+
+  // Resize for dynamic shape
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_tensor(out, {expected_output_size, repeats.size()}) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor.");
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_strided_copy_args(out.element_size(), 2 * repeats.size()),
+      InvalidArgument,
+      out);
+
+  // Output dim d of size repeats[d] * self_size is the pair of dims
+  // (repeats[d], self_size), which are both contiguous in the output. The
+  // repeat dim reads the same input again, so it has an input stride of 0.
+  const size_t leading = repeats.size() - self.dim();
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t sizes[kMaxStridedCopyDims];
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t out_strides[kMaxStridedCopyDims];
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t in_strides[kMaxStridedCopyDims];
+  for (const auto d : c10::irange(repeats.size())) {
+    const int64_t self_size = d < leading ? 1 : self.size(d - leading);
+    sizes[2 * d] = repeats[d];
+    out_strides[2 * d] = self_size * out.strides()[d];
+    in_strides[2 * d] = 0;
+    sizes[2 * d + 1] = self_size;
+    out_strides[2 * d + 1] = out.strides()[d];
+    in_strides[2 * d + 1] = d < leading ? 0 : self.strides()[d - leading];
+  }
+  const bool success = strided_copy(
+      out.mutable_data_ptr(),
+      self.const_data_ptr(),
+      out.element_size(),
+      2 * repeats.size(),
+      sizes,
+      out_strides,
+      in_strides);
+  ET_KERNEL_CHECK_MSG(ctx, success, Internal, out, "parallel_for failed");
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <c10/util/irange.h>
+#include <executorch/kernels/optimized/cpu/data_movement.h>
+#include <executorch/kernels/portable/cpu/util/slice_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+
+// slice_copy.Tensor_out(Tensor self, int dim=0, SymInt? start=None,
+// SymInt? end=None, SymInt step=1, *, Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_slice_copy_Tensor_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    std::optional<int64_t> start_val,
+    std::optional<int64_t> end_val,
+    int64_t step,
+    Tensor& out) {
+  (void)ctx;
+
+  ET_KERNEL_CHECK(
+      ctx, check_slice_copy_args(in, dim, step, out), InvalidArgument, out);
+
+  if (dim < 0) {
+    dim += in.dim();
+  }
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  // If user do not set value to end_val, set end to in.size(dim) (largest
+  // value available)
+  int64_t end = end_val.has_value() ? end_val.value() : in.size(dim);
+  // If user do not set value to start_val, set start to 0 (smallest value
+  // available)
+  int64_t start = start_val.has_value() ? start_val.value() : 0;
+
+  int64_t length = adjust_slice_indices(in.size(dim), &start, &end, step);
+
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  Tensor::SizesType target_sizes[kTensorDimensionLimit];
+  size_t target_ndim = 0;
+  get_slice_copy_out_target_size(in, dim, length, target_sizes, &target_ndim);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {target_sizes, target_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (length <= 0) {
+    return out;
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_strided_copy_args(out.element_size(), out.dim()),
+      InvalidArgument,
+      out);
+
+  // The slice is a view of the input that starts at `start` along `dim` and
+  // steps over `step` elements along it. Every other dim is copied whole, so
+  // the copy is a memcpy per run unless `dim` is the innermost one.
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t sizes[kTensorDimensionLimit];
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t out_strides[kTensorDimensionLimit];
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int64_t in_strides[kTensorDimensionLimit];
+  for (const auto d : c10::irange(out.dim())) {
+    sizes[d] = out.size(d);
+    out_strides[d] = out.strides()[d];
+    in_strides[d] = in.strides()[d];
+  }
+  in_strides[dim] *= step;
+  const char* const in_data = static_cast<const char*>(in.const_data_ptr()) +
+      start * in.strides()[dim] * in.element_size();
+  const bool success = strided_copy(
+      out.mutable_data_ptr(),
+      in_data,
+      out.element_size(),
+      out.dim(),
+      sizes,
+      out_strides,
+      in_strides);
+  ET_KERNEL_CHECK_MSG(ctx, success, Internal, out, "parallel_for failed");
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
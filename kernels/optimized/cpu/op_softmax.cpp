@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/activation_ops_util.h>
+#include <executorch/kernels/portable/cpu/util/functional_util.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+// `_softmax_out` Applies the Softmax function to an n-dimensional input Tensor
+// rescaling them so that the elements of the n-dimensional output Tensor lie
+// in the range [0,1] and sum to 1.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = executorch::aten::Tensor;
+namespace {
+
+// Softmax over contiguous rows of `dim_size` elements, for rows [begin, end).
+// The max, exp and sum passes read each row at most twice.
+void softmax_lastdim_range(
+    const float* __restrict__ in_data,
+    float* __restrict__ out_data,
+    int64_t dim_size,
+    int64_t begin,
+    int64_t end) {
+  using Vec = at::vec::Vectorized<float>;
+  for (const auto row : c10::irange(begin, end)) {
+    const float* in = in_data + row * dim_size;
+    float* out = out_data + row * dim_size;
+
+    const float max_in = at::vec::reduce_all<float>(
+        [](Vec& x, Vec& y) { return at::vec::maximum(x, y); }, in, dim_size);
+
+    // Write exp(x - max) to the output while summing it up.
+    const Vec max_vec(max_in);
+    Vec sum_vec(0.0f);
+    int64_t d = 0;
+    for (; d + Vec::size() <= dim_size; d += Vec::size()) {
+      const Vec e = (Vec::loadu(in + d) - max_vec).exp();
+      e.store(out + d);
+      sum_vec = sum_vec + e;
+    }
+    float sum = at::vec::vec_reduce_all<float>(
+        [](Vec& x, Vec& y) { return x + y; }, sum_vec);
+    for (; d < dim_size; ++d) {
+      out[d] = std::exp(in[d] - max_in);
+      sum += out[d];
+    }
+
+    const Vec scale(1.0f / sum);
+    at::vec::map([scale](Vec x) { return x * scale; }, out, out, dim_size);
+  }
+}
+
+// Softmax over a dimension that is not the innermost one, for outer indices
+// [begin, end). Each vector covers Vec::size() consecutive inner elements, so
+// all loads are contiguous.
+void softmax_innerdim_range(
+    const float* __restrict__ in_data,
+    float* __restrict__ out_data,
+    int64_t dim_size,
+    int64_t inner_size,
+    int64_t begin,
+    int64_t end) {
+  using Vec = at::vec::Vectorized<float>;
+  const int64_t outer_stride = dim_size * inner_size;
+  for (const auto outer : c10::irange(begin, end)) {
+    const float* in = in_data + outer * outer_stride;
+    float* out = out_data + outer * outer_stride;
+    int64_t i = 0;
+    for (; i + Vec::size() <= inner_size; i += Vec::size()) {
+      Vec max_vec = Vec::loadu(in + i);
+      for (const auto d : c10::irange(1, dim_size)) {
+        max_vec = at::vec::maximum(max_vec, Vec::loadu(in + d * inner_size + i));
+      }
+      Vec sum_vec(0.0f);
+      for (const auto d : c10::irange(dim_size)) {
+        const Vec e = (Vec::loadu(in + d * inner_size + i) - max_vec).exp();
+        e.store(out + d * inner_size + i);
+        sum_vec = sum_vec + e;
+      }
+      const Vec scale = Vec(1.0f) / sum_vec;
+      for (const auto d : c10::irange(dim_size)) {
+        (Vec::loadu(out + d * inner_size + i) * scale)
+            .store(out + d * inner_size + i);
+      }
+    }
+    for (; i < inner_size; ++i) {
+      float max_in = in[i];
+      for (const auto d : c10::irange(1, dim_size)) {
+        const float v = in[d * inner_size + i];
+        max_in = std::isnan(v) || v > max_in ? v : max_in;
+      }
+      float sum = 0;
+      for (const auto d : c10::irange(dim_size)) {
+        out[d * inner_size + i] = std::exp(in[d * inner_size + i] - max_in);
+        sum += out[d * inner_size + i];
+      }
+      for (const auto d : c10::irange(dim_size)) {
+        out[d * inner_size + i] /= sum;
+      }
+    }
+  }
+}
+
+bool softmax_float(const Tensor& in, int64_t dim, Tensor& out) {
+  const float* in_data = in.const_data_ptr<float>();
+  float* out_data = out.mutable_data_ptr<float>();
+  if (in.dim() == 0) {
+    out_data[0] = 1;
+    return true;
+  }
+  const int64_t dim_size = in.size(dim);
+  const int64_t outer_size = getLeadingDims(in, dim);
+  const int64_t inner_size = getTrailingDims(in, dim);
+  if (dim_size == 0 || outer_size == 0 || inner_size == 0) {
+    return true;
+  }
+  const int64_t grain_size = std::max<int64_t>(
+      1,
+      ::executorch::extension::internal::GRAIN_SIZE /
+          (dim_size * inner_size));
+  if (inner_size == 1) {
+    return ::executorch::extension::parallel_for(
+        0, outer_size, grain_size, [&](const auto begin, const auto end) {
+          softmax_lastdim_range(in_data, out_data, dim_size, begin, end);
+        });
+  }
+  return ::executorch::extension::parallel_for(
+      0, outer_size, grain_size, [&](const auto begin, const auto end) {
+        softmax_innerdim_range(
+            in_data, out_data, dim_size, inner_size, begin, end);
+      });
+}
+
+} // namespace
+
+// _softmax.out(Tensor self, int dim, bool half_to_float, *, Tensor(a!) out)
+// -> Tensor(a!)
+Tensor& opt_softmax_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    bool half_to_float,
+    Tensor& out) {
+  (void)ctx;
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_softmax_args(in, dim, half_to_float, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  // Adjust for negative dim
+  dim = dim < 0 ? dim + nonzero_dim(in) : dim;
+
+  if (in.scalar_type() == ScalarType::Float &&
+      tensor_is_default_dim_order(in)) {
+    const bool success = softmax_float(in, dim, out);
+    ET_KERNEL_CHECK_MSG(ctx, success, Internal, out, "parallel_for failed");
+    return out;
+  }
+
+  ET_SWITCH_FLOATHBF16_TYPES(
+      in.scalar_type(), ctx, "_softmax.out", CTYPE, [&]() {
+        const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+        CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+        apply_over_dim(
+            [in_data, out_data](
+                const size_t size, const size_t stride, const size_t base) {
+              const CTYPE max_in = apply_unary_reduce_fn(
+                  [](const CTYPE val_in, CTYPE val_accum) {
+                    return std::max(val_in, val_accum);
+                  },
+                  in_data + base,
+                  size,
+                  stride);
+
+              const CTYPE temp_sum = apply_unary_map_reduce_fn<CTYPE, CTYPE>(
+                  [max_in](const CTYPE val_in) {
+                    return std::exp(val_in - max_in);
+                  },
+                  [](const CTYPE mapped_in, CTYPE val_accum) {
+                    return val_accum + mapped_in;
+                  },
+                  in_data + base,
+                  size,
+                  stride);
+
+              apply_unary_map_fn(
+                  [max_in, temp_sum](const CTYPE val_in) {
+                    return std::exp(val_in - max_in) / temp_sum;
+                  },
+                  in_data + base,
+                  out_data + base,
+                  size,
+                  stride);
+            },
+            in,
+            dim);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <utility>
+
+#include <c10/util/irange.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace {
+
+// The slices are split into at most this many chunks, each with its own
+// scratch queue, so that the scratch memory stays bounded.
+constexpr int64_t kMaxNumChunks = 64;
+
+bool check_topk_args(
+    const Tensor& in,
+    int64_t k,
+    int64_t dim,
+    Tensor& values,
+    Tensor& indices) {
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(in, values));
+  ET_LOG_AND_RETURN_IF_FALSE(indices.scalar_type() == ScalarType::Long);
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_has_dim(in, dim));
+  if (dim < 0) {
+    dim += nonzero_dim(in);
+  }
+  ET_CHECK_OR_RETURN_FALSE(
+      k >= 0 && k <= nonempty_size(in, dim),
+      "selected index k out of range; k = %" PRId64 ", dim = %" PRId64
+      ", in.dim() = %" ET_PRI_TENSOR_DIM ", nonempty_size(in, dim) = %zd",
+      k,
+      dim,
+      in.dim(),
+      nonempty_size(in, dim));
+  return true;
+}
+
+template <typename T>
+bool float_less_than(T x, T y) {
+  if constexpr (std::is_integral_v<T>) {
+    return x < y;
+  }
+  return (!std::isnan(x) && std::isnan(y)) || x < y;
+}
+
+// Selects the top k of one slice into queue[0, k), best first.
+//
+// For small k a heap of the best k elements seen so far is kept, which reads
+// the slice once and only needs k entries of scratch. Otherwise the slice is
+// copied into the queue and partitioned with nth_element.
+template <typename CTYPE, typename elem_t, typename Compare>
+void topk_slice(
+    const CTYPE* in,
+    size_t stride,
+    size_t dim_size,
+    size_t k,
+    bool use_heap,
+    const Compare& cmp,
+    elem_t* queue) {
+  if (use_heap) {
+    for (const auto i : c10::irange(k)) {
+      queue[i] = elem_t(in[i * stride], static_cast<int64_t>(i));
+    }
+    // With cmp ordering better elements first, the top of the heap is the
+    // worst element kept.
+    std::make_heap(queue, queue + k, cmp);
+    for (const auto i : c10::irange(k, dim_size)) {
+      const elem_t candidate(in[i * stride], static_cast<int64_t>(i));
+      if (cmp(candidate, queue[0])) {
+        std::pop_heap(queue, queue + k, cmp);
+        queue[k - 1] = candidate;
+        std::push_heap(queue, queue + k, cmp);
+      }
+    }
+    std::sort_heap(queue, queue + k, cmp);
+    return;
+  }
+  for (const auto i : c10::irange(dim_size)) {
+    queue[i] = elem_t(in[i * stride], static_cast<int64_t>(i));
+  }
+  std::nth_element(queue, queue + k - 1, queue + dim_size, cmp);
+  std::sort(queue, queue + k - 1, cmp);
+}
+
+} // namespace
+
+std::tuple<Tensor&, Tensor&> opt_topk_values(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t k,
+    int64_t dim,
+    bool largest,
+    bool sorted,
+    Tensor& values,
+    Tensor& indices) {
+  auto out = std::tuple<Tensor&, Tensor&>({values, indices});
+  // The selected elements are always returned sorted.
+  (void)sorted;
+
+  ET_KERNEL_CHECK(
+      ctx, check_topk_args(in, k, dim, values, indices), InvalidArgument, out);
+
+  if (dim < 0) {
+    dim += nonzero_dim(in);
+  }
+
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  Tensor::SizesType target_size[kTensorDimensionLimit];
+  for (const auto i : c10::irange(in.dim())) {
+    target_size[i] = static_cast<int64_t>(i) == dim ? k : in.size(i);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(values, {target_size, static_cast<size_t>(in.dim())}) ==
+          Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(indices, {target_size, static_cast<size_t>(in.dim())}) ==
+          Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (in.numel() == 0 || (k == 0 && in.dim() > 0)) {
+    return out;
+  }
+
+  constexpr auto name = "topk.values";
+  bool temp_mem_allocated = false;
+  bool success = false;
+
+  ET_SWITCH_REALHBF16_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+    using elem_t = std::pair<CTYPE, int64_t>;
+    const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+    CTYPE* const values_data = values.mutable_data_ptr<CTYPE>();
+    long* const indices_data = indices.mutable_data_ptr<long>();
+
+    if (in.dim() == 0) {
+      values_data[0] = in_data[0];
+      indices_data[0] = 0;
+      temp_mem_allocated = true;
+      success = true;
+      return;
+    }
+
+    const size_t dim_size = in.size(dim);
+    const size_t dim_stride = in.strides()[dim];
+    const size_t num_slices = getLeadingDims(in, dim) * dim_stride;
+    const size_t uk = static_cast<size_t>(k);
+    const bool use_heap = uk * 64 <= dim_size;
+    const size_t queue_size = use_heap ? uk : dim_size;
+
+    // Give each chunk at least GRAIN_SIZE input elements.
+    const int64_t slices_per_chunk = std::max<int64_t>(
+        {1,
+         static_cast<int64_t>(
+             (num_slices + kMaxNumChunks - 1) / kMaxNumChunks),
+         ::executorch::extension::internal::GRAIN_SIZE /
+             static_cast<int64_t>(dim_size)});
+    const int64_t num_chunks =
+        (num_slices + slices_per_chunk - 1) / slices_per_chunk;
+
+    Result<void*> temp_mem =
+        ctx.allocate_temp(num_chunks * queue_size * sizeof(elem_t));
+    if (!temp_mem.ok()) {
+      return;
+    }
+    temp_mem_allocated = true;
+    elem_t* const queues = static_cast<elem_t*>(temp_mem.get());
+
+    const auto elem_greater = [](const elem_t& x, const elem_t& y) -> bool {
+      return float_less_than(y.first, x.first);
+    };
+    const auto elem_less = [](const elem_t& x, const elem_t& y) -> bool {
+      return float_less_than(x.first, y.first);
+    };
+
+    success = ::executorch::extension::parallel_for(
+        0, num_chunks, 1, [&](const auto begin, const auto end) {
+          for (const auto chunk : c10::irange(begin, end)) {
+            elem_t* queue = queues + chunk * queue_size;
+            const size_t slice_end = std::min<size_t>(
+                num_slices, (chunk + 1) * slices_per_chunk);
+            for (size_t slice = chunk * slices_per_chunk; slice < slice_end;
+                 ++slice) {
+              const size_t outer_idx = slice / dim_stride;
+              const size_t inner_idx = slice % dim_stride;
+              const CTYPE* slice_in =
+                  in_data + outer_idx * dim_size * dim_stride + inner_idx;
+              if (largest) {
+                topk_slice<CTYPE>(
+                    slice_in,
+                    dim_stride,
+                    dim_size,
+                    uk,
+                    use_heap,
+                    elem_greater,
+                    queue);
+              } else {
+                topk_slice<CTYPE>(
+                    slice_in,
+                    dim_stride,
+                    dim_size,
+                    uk,
+                    use_heap,
+                    elem_less,
+                    queue);
+              }
+              const size_t base_out = outer_idx * uk * dim_stride + inner_idx;
+              for (const auto i : c10::irange(uk)) {
+                values_data[base_out + i * dim_stride] = queue[i].first;
+                indices_data[base_out + i * dim_stride] = queue[i].second;
+              }
+            }
+          }
+        });
+  });
+
+  ET_KERNEL_CHECK(ctx, temp_mem_allocated, MemoryAllocationFailed, out);
+  ET_KERNEL_CHECK_MSG(ctx, success, Internal, out, "parallel_for failed");
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -54,6 +54,24 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "data_movement",
+        srcs = ["data_movement.cpp"],
+        exported_headers = ["data_movement.h"],
+        visibility = [
+            "//executorch/kernels/optimized/cpu/...",
+            "//executorch/kernels/optimized/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            "//executorch/runtime/kernel:kernel_includes",
+        ],
+        deps = [
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
+        ],
+    )
+
     runtime.cxx_library(
         name = "cpu_optimized",
         srcs = [],
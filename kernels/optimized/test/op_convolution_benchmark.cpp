@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * Measures the optimized and the portable convolution.out kernels on the
+ * convolution shapes of ResNet-50 and MobileNetV2, at batch size 1. The
+ * optimized kernel gets a temp allocator, the way it does inside a method, so
+ * that it can take its im2col path.
+ *
+ * Not a test: run it by hand and compare the times before and after changes
+ * to the convolution kernels.
+ */
+
+#include <executorch/kernels/optimized/NativeFunctions.h>
+#include <executorch/kernels/portable/NativeFunctions.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::Error;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::MemoryAllocator;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+constexpr int kTimedRuns = 5;
+// Enough for the im2col buffer of every shape below.
+constexpr size_t kTempAllocatorSize = 32 * 1024 * 1024;
+
+struct ConvShape {
+  const char* name;
+  int32_t in_channels;
+  int32_t out_channels;
+  int32_t size;
+  int32_t kernel;
+  int64_t stride;
+  int64_t padding;
+  int64_t groups;
+};
+
+const ConvShape kShapes[] = {
+    {"resnet50 conv1 7x7/2", 3, 64, 224, 7, 2, 3, 1},
+    {"resnet50 3x3", 64, 64, 56, 3, 1, 1, 1},
+    {"resnet50 1x1 reduce", 256, 64, 56, 1, 1, 0, 1},
+    {"resnet50 3x3/2", 128, 128, 56, 3, 2, 1, 1},
+    {"resnet50 3x3 deep", 512, 512, 7, 3, 1, 1, 1},
+    {"mobilenetv2 1x1 expand", 24, 144, 56, 1, 1, 0, 1},
+    {"mobilenetv2 3x3 depthwise", 144, 144, 56, 3, 1, 1, 144},
+    {"mobilenetv2 3x3/2 depthwise", 144, 144, 56, 3, 2, 1, 144},
+    {"mobilenetv2 1x1 project", 144, 24, 56, 1, 1, 0, 1},
+};
+
+std::vector<float> random_values(size_t n, std::mt19937& gen) {
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> values(n);
+  for (auto& value : values) {
+    value = dist(gen);
+  }
+  return values;
+}
+
+// Returns the fastest of kTimedRuns calls of `fn`, in milliseconds.
+template <typename Fn>
+double best_time_ms(Fn&& fn) {
+  auto best = std::chrono::steady_clock::duration::max();
+  for (int i = 0; i < kTimedRuns; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    best = std::min(best, std::chrono::steady_clock::now() - start);
+  }
+  return std::chrono::duration<double, std::milli>(best).count();
+}
+
+} // namespace
+
+int main() {
+  executorch::runtime::runtime_init();
+  TensorFactory<ScalarType::Float> tf;
+  std::mt19937 gen(0);
+  std::vector<uint8_t> temp_buffer(kTempAllocatorSize);
+  MemoryAllocator temp_allocator(temp_buffer.size(), temp_buffer.data());
+
+  std::printf(
+      "ms per call, best of %d runs\n%-30s %10s %10s %8s\n",
+      kTimedRuns,
+      "shape",
+      "optimized",
+      "portable",
+      "speedup");
+  for (const ConvShape& s : kShapes) {
+    Tensor input = tf.make(
+        {1, s.in_channels, s.size, s.size},
+        random_values(s.in_channels * s.size * s.size, gen));
+    const int32_t in_channels_per_group = s.in_channels / s.groups;
+    Tensor weight = tf.make(
+        {s.out_channels, in_channels_per_group, s.kernel, s.kernel},
+        random_values(
+            s.out_channels * in_channels_per_group * s.kernel * s.kernel,
+            gen));
+    std::optional<Tensor> bias =
+        tf.make({s.out_channels}, random_values(s.out_channels, gen));
+    const int32_t out_size =
+        (s.size + 2 * s.padding - s.kernel) / s.stride + 1;
+    Tensor out = tf.zeros({1, s.out_channels, out_size, out_size});
+    int64_t stride[] = {s.stride, s.stride};
+    int64_t padding[] = {s.padding, s.padding};
+    int64_t dilation[] = {1, 1};
+    int64_t output_padding[] = {0, 0};
+
+    KernelRuntimeContext context(nullptr, &temp_allocator);
+    const double optimized_ms = best_time_ms([&] {
+      // A method resets the temp allocator after every kernel.
+      temp_allocator.reset();
+      torch::executor::native::opt_convolution_out(
+          context,
+          input,
+          weight,
+          bias,
+          stride,
+          padding,
+          dilation,
+          false,
+          output_padding,
+          s.groups,
+          out);
+    });
+    const double portable_ms = best_time_ms([&] {
+      torch::executor::native::convolution_out(
+          context,
+          input,
+          weight,
+          bias,
+          stride,
+          padding,
+          dilation,
+          false,
+          output_padding,
+          s.groups,
+          out);
+    });
+    if (context.failure_state() != Error::Ok) {
+      std::fprintf(stderr, "%s failed\n", s.name);
+      return 1;
+    }
+    std::printf(
+        "%-30s %10.3f %10.3f %7.1fx\n",
+        s.name,
+        optimized_ms,
+        portable_ms,
+        portable_ms / optimized_ms);
+  }
+  return 0;
+}
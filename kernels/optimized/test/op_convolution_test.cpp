@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/NativeFunctions.h> // Declares the operator
+#include <executorch/kernels/portable/NativeFunctions.h> // Declares the reference
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/memory_allocator.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+using namespace ::testing;
+using executorch::aten::ArrayRef;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using std::optional;
+using torch::executor::testing::TensorFactory;
+
+// Note: This file checks the optimized convolution.out kernel against the
+// portable one over a sweep of parameters, so that each of its fast paths
+// (pointwise, depthwise, im2col) and its fallback loop are covered. Generic
+// test cases belong in executorch/kernels/test/op_convolution_test.cpp.
+
+namespace {
+
+struct ConvCase {
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t stride;
+  int64_t padding;
+  int64_t dilation;
+  int64_t groups;
+  bool has_bias;
+};
+
+std::vector<float> random_values(size_t n, std::mt19937& gen) {
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> values(n);
+  for (auto& value : values) {
+    value = dist(gen);
+  }
+  return values;
+}
+
+int32_t conv_out_size(
+    int32_t in_size,
+    int64_t kernel,
+    int64_t stride,
+    int64_t padding,
+    int64_t dilation) {
+  return (in_size + 2 * padding - dilation * (kernel - 1) - 1) / stride + 1;
+}
+
+} // namespace
+
+class OpConvolutionOutKernelTest : public OperatorTest {
+ protected:
+  // Runs the optimized and the portable kernel on the same random inputs and
+  // checks that they agree. With `temp_allocator_size` > 0 the optimized
+  // kernel gets a temp allocator, which its im2col path needs.
+  void check_against_portable(
+      const ConvCase& c,
+      int32_t batches,
+      int32_t in_channels,
+      int32_t out_channels,
+      int32_t in_h,
+      int32_t in_w,
+      size_t temp_allocator_size) {
+    TensorFactory<ScalarType::Float> tf;
+    std::mt19937 gen(0);
+
+    Tensor input = tf.make(
+        {batches, in_channels, in_h, in_w},
+        random_values(batches * in_channels * in_h * in_w, gen));
+    const int32_t in_channels_per_group = in_channels / c.groups;
+    Tensor weight = tf.make(
+        {out_channels,
+         in_channels_per_group,
+         static_cast<int32_t>(c.kernel_h),
+         static_cast<int32_t>(c.kernel_w)},
+        random_values(
+            out_channels * in_channels_per_group * c.kernel_h * c.kernel_w,
+            gen));
+    optional<Tensor> bias;
+    if (c.has_bias) {
+      bias = tf.make({out_channels}, random_values(out_channels, gen));
+    }
+
+    const std::vector<int32_t> out_sizes = {
+        batches,
+        out_channels,
+        conv_out_size(in_h, c.kernel_h, c.stride, c.padding, c.dilation),
+        conv_out_size(in_w, c.kernel_w, c.stride, c.padding, c.dilation)};
+    int64_t stride[] = {c.stride, c.stride};
+    int64_t padding[] = {c.padding, c.padding};
+    int64_t dilation[] = {c.dilation, c.dilation};
+    int64_t output_padding[] = {0, 0};
+
+    Tensor expected = tf.zeros(out_sizes);
+    torch::executor::native::convolution_out(
+        context_,
+        input,
+        weight,
+        bias,
+        stride,
+        padding,
+        dilation,
+        false,
+        output_padding,
+        c.groups,
+        expected);
+
+    std::vector<uint8_t> temp_buffer(temp_allocator_size);
+    executorch::runtime::MemoryAllocator temp_allocator(
+        temp_buffer.size(), temp_buffer.data());
+    executorch::ET_RUNTIME_NAMESPACE::KernelRuntimeContext context(
+        nullptr, temp_allocator_size > 0 ? &temp_allocator : nullptr);
+    Tensor out = tf.zeros(out_sizes);
+    torch::executor::native::opt_convolution_out(
+        context,
+        input,
+        weight,
+        bias,
+        stride,
+        padding,
+        dilation,
+        false,
+        output_padding,
+        c.groups,
+        out);
+
+    EXPECT_EQ(context.failure_state(), torch::executor::Error::Ok);
+    // The gemm paths sum in a different order than the portable kernel.
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-5, 1e-5)
+        << "kernel " << c.kernel_h << "x" << c.kernel_w << ", stride "
+        << c.stride << ", padding " << c.padding << ", dilation "
+        << c.dilation << ", groups " << c.groups << ", bias " << c.has_bias
+        << ", temp allocator " << temp_allocator_size;
+  }
+};
+
+TEST_F(OpConvolutionOutKernelTest, MatchesPortableOverParameterSweep) {
+  constexpr int32_t kInChannels = 4;
+  constexpr int32_t kOutChannels = 8;
+  // Large enough for the im2col buffer of every case below.
+  constexpr size_t kTempAllocatorSize = 64 * 1024;
+
+  const int64_t kernel_sizes[][2] = {{1, 1}, {3, 3}, {2, 3}};
+  for (const auto& kernel : kernel_sizes) {
+    for (int64_t stride : {1, 2}) {
+      for (int64_t padding : {0, 1}) {
+        for (int64_t dilation : {1, 2}) {
+          // groups == kInChannels is a depthwise convolution.
+          for (int64_t groups : {1, 2, 4}) {
+            for (bool has_bias : {false, true}) {
+              const ConvCase c = {
+                  kernel[0],
+                  kernel[1],
+                  stride,
+                  padding,
+                  dilation,
+                  groups,
+                  has_bias};
+              for (size_t temp_size : {size_t(0), kTempAllocatorSize}) {
+                check_against_portable(
+                    c,
+                    /*batches=*/2,
+                    kInChannels,
+                    kOutChannels,
+                    /*in_h=*/7,
+                    /*in_w=*/8,
+                    temp_size);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_F(OpConvolutionOutKernelTest, MatchesPortableForLargeIm2col) {
+  // A ResNet-like 3x3 convolution, where the im2col buffer is larger than a
+  // single tile of the gemm.
+  const ConvCase c = {3, 3, 1, 1, 1, 1, true};
+  check_against_portable(
+      c,
+      /*batches=*/1,
+      /*in_channels=*/16,
+      /*out_channels=*/32,
+      /*in_h=*/14,
+      /*in_w=*/14,
+      /*temp_allocator_size=*/16 * 9 * 14 * 14 * sizeof(float));
+}
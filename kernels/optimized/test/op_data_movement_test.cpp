@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/NativeFunctions.h> // Declares the operators
+#include <executorch/kernels/optimized/cpu/data_movement.h>
+#include <executorch/kernels/portable/NativeFunctions.h> // Declares the reference
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace ::testing;
+using executorch::aten::ArrayRef;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using torch::executor::check_strided_copy_args;
+using torch::executor::strided_copy;
+using torch::executor::testing::TensorFactory;
+
+// Note: This file checks the optimized data-movement kernels, and the
+// strided_copy() helper they share, against reference implementations over
+// shapes that reach each of the helper's paths: memcpy runs, broadcast fills,
+// cache-blocked transposes with partial tiles, and element gathers. The large
+// shapes are split across threads when a threadpool is available. Generic test
+// cases belong in executorch/kernels/test/op_<name>_test.cpp.
+
+namespace {
+
+// A strided view to copy, with strides in elements.
+struct StridedCopyCase {
+  std::vector<int64_t> sizes;
+  std::vector<int64_t> out_strides;
+  std::vector<int64_t> in_strides;
+};
+
+// Number of elements a buffer needs to hold every element of a view.
+size_t buffer_numel(
+    const std::vector<int64_t>& sizes,
+    const std::vector<int64_t>& strides) {
+  int64_t last = 0;
+  for (size_t d = 0; d < sizes.size(); ++d) {
+    if (sizes[d] == 0) {
+      return 0;
+    }
+    last += (sizes[d] - 1) * strides[d];
+  }
+  return last + 1;
+}
+
+// Copies one element at a time, in row-major order of the view.
+void reference_strided_copy(
+    uint8_t* out,
+    const uint8_t* in,
+    size_t element_size,
+    const StridedCopyCase& c) {
+  const size_t ndim = c.sizes.size();
+  int64_t numel = 1;
+  for (const int64_t size : c.sizes) {
+    numel *= size;
+  }
+  std::vector<int64_t> index(ndim, 0);
+  for (int64_t i = 0; i < numel; ++i) {
+    int64_t out_offset = 0;
+    int64_t in_offset = 0;
+    for (size_t d = 0; d < ndim; ++d) {
+      out_offset += index[d] * c.out_strides[d];
+      in_offset += index[d] * c.in_strides[d];
+    }
+    std::memcpy(
+        out + out_offset * element_size,
+        in + in_offset * element_size,
+        element_size);
+    for (size_t d = ndim; d > 0; --d) {
+      if (++index[d - 1] < c.sizes[d - 1]) {
+        break;
+      }
+      index[d - 1] = 0;
+    }
+  }
+}
+
+std::vector<float> random_values(size_t n, std::mt19937& gen) {
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> values(n);
+  for (auto& value : values) {
+    value = dist(gen);
+  }
+  return values;
+}
+
+Tensor random_tensor(
+    TensorFactory<ScalarType::Float>& tf,
+    const std::vector<int32_t>& sizes,
+    std::mt19937& gen) {
+  size_t numel = 1;
+  for (const int32_t size : sizes) {
+    numel *= size;
+  }
+  return tf.make(sizes, random_values(numel, gen));
+}
+
+} // namespace
+
+class OpDataMovementKernelTest : public OperatorTest {
+ protected:
+  // Runs `optimized` and `portable` on the same output shape and checks that
+  // they write the same values.
+  template <typename OptimizedFn, typename PortableFn>
+  void check_against_portable(
+      const std::vector<int32_t>& out_sizes,
+      OptimizedFn optimized,
+      PortableFn portable) {
+    TensorFactory<ScalarType::Float> tf;
+    Tensor expected = tf.zeros(out_sizes);
+    portable(expected);
+    ASSERT_EQ(context_.failure_state(), torch::executor::Error::Ok);
+
+    Tensor out = tf.zeros(out_sizes);
+    optimized(out);
+    EXPECT_EQ(context_.failure_state(), torch::executor::Error::Ok);
+    EXPECT_TENSOR_EQ(out, expected);
+  }
+};
+
+TEST_F(OpDataMovementKernelTest, StridedCopyMatchesReference) {
+  const std::vector<StridedCopyCase> cases = {
+      // Contiguous, with a non-contiguous output: one memcpy per row.
+      {{17, 33}, {50, 1}, {33, 1}},
+      // Transposes whose sides are not multiples of the tile size.
+      {{33, 65}, {65, 1}, {1, 33}},
+      {{31, 3}, {3, 1}, {1, 31}},
+      {{5, 97}, {97, 1}, {1, 5}},
+      // A transpose of an input whose columns are padded.
+      {{33, 65}, {65, 1}, {1, 40}},
+      // A large batched transpose of the two innermost dims.
+      {{3, 5, 257, 131}, {5 * 257 * 131, 257 * 131, 131, 1},
+       {5 * 131 * 257, 131 * 257, 1, 257}},
+      // Broadcasts along the innermost dim, and along an outer one.
+      {{7, 300, 129}, {300 * 129, 129, 1}, {300, 1, 0}},
+      {{7, 300, 129}, {300 * 129, 129, 1}, {129, 0, 1}},
+      // Reversed dims, which take the element gather.
+      {{65, 33, 3}, {99, 3, 1}, {1, 65, 65 * 33}},
+      // A large strided read, like a slice with a step.
+      {{129, 257}, {257, 1}, {257 * 3 * 2, 3}},
+      // Dims of size 1 are dropped, and empty views copy nothing.
+      {{1, 33, 1, 65}, {65 * 33, 65, 65, 1}, {1, 1, 1, 33}},
+      {{1, 1}, {1, 1}, {1, 1}},
+      {{3, 0, 5}, {5, 5, 1}, {5, 5, 1}},
+  };
+
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> byte(0, 255);
+  for (const size_t element_size : {1, 2, 4, 8, 16}) {
+    for (const auto& c : cases) {
+      ASSERT_TRUE(check_strided_copy_args(element_size, c.sizes.size()));
+      std::vector<uint8_t> in(
+          std::max<size_t>(1, buffer_numel(c.sizes, c.in_strides)) *
+          element_size);
+      for (auto& value : in) {
+        value = static_cast<uint8_t>(byte(gen));
+      }
+      // Elements outside of the output view must keep their values.
+      std::vector<uint8_t> expected(
+          std::max<size_t>(1, buffer_numel(c.sizes, c.out_strides)) *
+              element_size,
+          0xab);
+      std::vector<uint8_t> out = expected;
+
+      reference_strided_copy(expected.data(), in.data(), element_size, c);
+      EXPECT_TRUE(strided_copy(
+          out.data(),
+          in.data(),
+          element_size,
+          c.sizes.size(),
+          c.sizes.data(),
+          c.out_strides.data(),
+          c.in_strides.data()));
+      EXPECT_EQ(out, expected) << "element size " << element_size << ", dims "
+                               << c.sizes.size() << ", first size "
+                               << c.sizes[0];
+    }
+  }
+}
+
+TEST_F(OpDataMovementKernelTest, StridedCopyRejectsUnsupportedArgs) {
+  EXPECT_FALSE(check_strided_copy_args(3, 2));
+  EXPECT_FALSE(check_strided_copy_args(
+      4, torch::executor::kMaxStridedCopyDims + 1));
+}
+
+TEST_F(OpDataMovementKernelTest, PermuteMatchesPortable) {
+  TensorFactory<ScalarType::Float> tf;
+  std::mt19937 gen(0);
+  for (const auto& sizes : std::vector<std::vector<int32_t>>{
+           {2, 37, 67, 33}, {5, 257, 131}, {33, 65}}) {
+    Tensor in = random_tensor(tf, sizes, gen);
+    std::vector<int64_t> dims(sizes.size());
+    for (size_t d = 0; d < dims.size(); ++d) {
+      dims[d] = d;
+    }
+    do {
+      std::vector<int32_t> out_sizes(sizes.size());
+      for (size_t d = 0; d < dims.size(); ++d) {
+        out_sizes[d] = sizes[dims[d]];
+      }
+      const ArrayRef<int64_t> dims_ref(dims.data(), dims.size());
+      check_against_portable(
+          out_sizes,
+          [&](Tensor& out) {
+            torch::executor::native::opt_permute_copy_out(
+                context_, in, dims_ref, out);
+          },
+          [&](Tensor& out) {
+            torch::executor::native::permute_copy_out(
+                context_, in, dims_ref, out);
+          });
+    } while (std::next_permutation(dims.begin(), dims.end()));
+  }
+}
+
+TEST_F(OpDataMovementKernelTest, TransposeMatchesPortable) {
+  TensorFactory<ScalarType::Float> tf;
+  std::mt19937 gen(0);
+  for (const auto& sizes : std::vector<std::vector<int32_t>>{
+           {3, 33, 130, 5}, {65, 33}, {1, 97, 31}}) {
+    Tensor in = random_tensor(tf, sizes, gen);
+    for (size_t dim0 = 0; dim0 < sizes.size(); ++dim0) {
+      for (size_t dim1 = dim0 + 1; dim1 < sizes.size(); ++dim1) {
+        std::vector<int32_t> out_sizes = sizes;
+        std::swap(out_sizes[dim0], out_sizes[dim1]);
+        check_against_portable(
+            out_sizes,
+            [&](Tensor& out) {
+              torch::executor::native::opt_transpose_copy_int_out(
+                  context_, in, dim0, dim1, out);
+            },
+            [&](Tensor& out) {
+              torch::executor::native::transpose_copy_int_out(
+                  context_, in, dim0, dim1, out);
+            });
+      }
+    }
+  }
+}
+
+TEST_F(OpDataMovementKernelTest, ExpandMatchesPortable) {
+  TensorFactory<ScalarType::Float> tf;
+  std::mt19937 gen(0);
+  const std::vector<std::pair<std::vector<int32_t>, std::vector<int64_t>>>
+      cases = {
+          // Broadcasts along the innermost dim, an outer one, and both.
+          {{33, 1}, {4, 33, 257}},
+          {{1, 33, 129}, {7, 33, 129}},
+          {{1, 33, 1}, {5, 33, 129}},
+          // New leading dims only.
+          {{65}, {3, 7, 65}},
+          // -1 keeps the size of the input.
+          {{3, 1, 5}, {-1, 301, -1}},
+      };
+  for (const auto& [in_sizes, expand_sizes] : cases) {
+    Tensor in = random_tensor(tf, in_sizes, gen);
+    const size_t leading = expand_sizes.size() - in_sizes.size();
+    std::vector<int32_t> out_sizes(expand_sizes.size());
+    for (size_t d = 0; d < expand_sizes.size(); ++d) {
+      out_sizes[d] = expand_sizes[d] == -1 ? in_sizes[d - leading]
+                                           : expand_sizes[d];
+    }
+    const ArrayRef<int64_t> sizes_ref(expand_sizes.data(), expand_sizes.size());
+    check_against_portable(
+        out_sizes,
+        [&](Tensor& out) {
+          torch::executor::native::opt_expand_copy_out(
+              context_, in, sizes_ref, false, out);
+        },
+        [&](Tensor& out) {
+          torch::executor::native::expand_copy_out(
+              context_, in, sizes_ref, false, out);
+        });
+  }
+}
+
+TEST_F(OpDataMovementKernelTest, RepeatMatchesPortable) {
+  TensorFactory<ScalarType::Float> tf;
+  std::mt19937 gen(0);
+  const std::vector<std::pair<std::vector<int32_t>, std::vector<int64_t>>>
+      cases = {
+          {{3, 33}, {2, 3, 5}},
+          {{1, 65, 7}, {4, 1, 33}},
+          {{129, 257}, {3, 1}},
+          {{33}, {1, 1, 97}},
+      };
+  for (const auto& [in_sizes, repeats] : cases) {
+    Tensor in = random_tensor(tf, in_sizes, gen);
+    const size_t leading = repeats.size() - in_sizes.size();
+    std::vector<int32_t> out_sizes(repeats.size());
+    for (size_t d = 0; d < repeats.size(); ++d) {
+      out_sizes[d] = repeats[d] * (d < leading ? 1 : in_sizes[d - leading]);
+    }
+    const ArrayRef<int64_t> repeats_ref(repeats.data(), repeats.size());
+    check_against_portable(
+        out_sizes,
+        [&](Tensor& out) {
+          torch::executor::native::opt_repeat_out(
+              context_, in, repeats_ref, out);
+        },
+        [&](Tensor& out) {
+          torch::executor::native::repeat_out(context_, in, repeats_ref, out);
+        });
+  }
+}
+
+TEST_F(OpDataMovementKernelTest, SliceMatchesPortable) {
+  TensorFactory<ScalarType::Float> tf;
+  std::mt19937 gen(0);
+  const std::vector<int32_t> sizes = {9, 65, 131};
+  Tensor in = random_tensor(tf, sizes, gen);
+  struct Range {
+    int64_t start;
+    int64_t end;
+    int64_t step;
+  };
+  for (size_t dim = 0; dim < sizes.size(); ++dim) {
+    for (const Range& range : {Range{0, sizes[dim], 1},
+                               Range{1, sizes[dim] - 1, 2},
+                               Range{3, sizes[dim], 3}}) {
+      std::vector<int32_t> out_sizes = sizes;
+      out_sizes[dim] = (range.end - range.start + range.step - 1) / range.step;
+      check_against_portable(
+          out_sizes,
+          [&](Tensor& out) {
+            torch::executor::native::opt_slice_copy_Tensor_out(
+                context_, in, dim, range.start, range.end, range.step, out);
+          },
+          [&](Tensor& out) {
+            torch::executor::native::slice_copy_Tensor_out(
+                context_, in, dim, range.start, range.end, range.step, out);
+          });
+    }
+  }
+}
+
+TEST_F(OpDataMovementKernelTest, CatMatchesPortable) {
+  TensorFactory<ScalarType::Float> tf;
+  std::mt19937 gen(0);
+  const std::vector<int32_t> sizes = {5, 33, 129};
+  for (size_t dim = 0; dim < sizes.size(); ++dim) {
+    // Each input writes a non-contiguous part of the output, unless `dim` is
+    // the outermost one.
+    std::vector<Tensor> inputs;
+    std::vector<int32_t> out_sizes = sizes;
+    out_sizes[dim] = 0;
+    for (const int32_t dim_size : {3, 1, 32}) {
+      std::vector<int32_t> in_sizes = sizes;
+      in_sizes[dim] = dim_size;
+      inputs.push_back(random_tensor(tf, in_sizes, gen));
+      out_sizes[dim] += dim_size;
+    }
+    const ArrayRef<Tensor> inputs_ref(inputs.data(), inputs.size());
+    check_against_portable(
+        out_sizes,
+        [&](Tensor& out) {
+          torch::executor::native::opt_cat_out(context_, inputs_ref, dim, out);
+        },
+        [&](Tensor& out) {
+          torch::executor::native::cat_out(context_, inputs_ref, dim, out);
+        });
+  }
+}
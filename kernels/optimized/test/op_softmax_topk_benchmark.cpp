@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * Measures the optimized and the portable softmax, topk, argmax and amax
+ * kernels over a sweep of shapes: LLM logits over vocabularies of 32k and
+ * 128k tokens, attention scores, and classifier outputs, reduced along the
+ * innermost dim and, for softmax, along an outer one.
+ *
+ * Not a test: run it by hand and compare the times before and after changes
+ * to these kernels.
+ */
+
+#include <executorch/kernels/optimized/NativeFunctions.h>
+#include <executorch/kernels/portable/NativeFunctions.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::Error;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::testing::TensorFactory;
+using torch::executor::native::amax_out;
+using torch::executor::native::argmax_out;
+using torch::executor::native::opt_amax_out;
+using torch::executor::native::opt_argmax_out;
+using torch::executor::native::opt_softmax_out;
+using torch::executor::native::opt_topk_values;
+using torch::executor::native::softmax_out;
+using torch::executor::native::topk_values;
+
+namespace {
+
+constexpr int kTimedRuns = 10;
+
+Tensor random_tensor(
+    TensorFactory<ScalarType::Float>& tf,
+    const std::vector<int32_t>& sizes,
+    std::mt19937& gen) {
+  size_t numel = 1;
+  for (int32_t size : sizes) {
+    numel *= size;
+  }
+  std::normal_distribution<float> dist(0.0f, 3.0f);
+  std::vector<float> values(numel);
+  for (auto& value : values) {
+    value = dist(gen);
+  }
+  return tf.make(sizes, values);
+}
+
+// Returns the fastest of kTimedRuns calls of `fn`, in microseconds.
+template <typename Fn>
+double best_time_us(Fn&& fn) {
+  auto best = std::chrono::steady_clock::duration::max();
+  for (int i = 0; i < kTimedRuns; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    best = std::min(best, std::chrono::steady_clock::now() - start);
+  }
+  return std::chrono::duration<double, std::micro>(best).count();
+}
+
+template <typename OptimizedFn, typename PortableFn>
+void report(const char* name, OptimizedFn&& optimized, PortableFn&& portable) {
+  const double optimized_us = best_time_us(optimized);
+  const double portable_us = best_time_us(portable);
+  std::printf(
+      "%-36s %11.1f %11.1f %7.1fx\n",
+      name,
+      optimized_us,
+      portable_us,
+      portable_us / optimized_us);
+}
+
+} // namespace
+
+int main() {
+  executorch::runtime::runtime_init();
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+  std::mt19937 gen(0);
+  KernelRuntimeContext context;
+
+  std::printf(
+      "us per call, best of %d runs\n%-36s %11s %11s %8s\n",
+      kTimedRuns,
+      "kernel and shape",
+      "optimized",
+      "portable",
+      "speedup");
+
+  struct SoftmaxCase {
+    const char* name;
+    std::vector<int32_t> sizes;
+    int64_t dim;
+  };
+  const SoftmaxCase softmax_cases[] = {
+      {"softmax [1, 32000] dim 1", {1, 32000}, 1},
+      {"softmax [1, 128256] dim 1", {1, 128256}, 1},
+      {"softmax [32, 128, 128] dim 2", {32, 128, 128}, 2},
+      {"softmax [64, 1000] dim 1", {64, 1000}, 1},
+      {"softmax [64, 1000, 16] dim 1", {64, 1000, 16}, 1},
+  };
+  for (const auto& c : softmax_cases) {
+    Tensor in = random_tensor(tf, c.sizes, gen);
+    Tensor out = tf.zeros(c.sizes);
+    report(
+        c.name,
+        [&] { opt_softmax_out(context, in, c.dim, false, out); },
+        [&] { softmax_out(context, in, c.dim, false, out); });
+  }
+
+  struct TopkCase {
+    const char* name;
+    std::vector<int32_t> sizes;
+    int32_t k;
+  };
+  const TopkCase topk_cases[] = {
+      {"topk [1, 32000] k 1", {1, 32000}, 1},
+      {"topk [1, 32000] k 40", {1, 32000}, 40},
+      {"topk [1, 128256] k 40", {1, 128256}, 40},
+      {"topk [1, 128256] k 4096", {1, 128256}, 4096},
+      {"topk [64, 1000] k 5", {64, 1000}, 5},
+      {"topk [64, 1000] k 500", {64, 1000}, 500},
+  };
+  for (const auto& c : topk_cases) {
+    Tensor in = random_tensor(tf, c.sizes, gen);
+    std::vector<int32_t> out_sizes = c.sizes;
+    out_sizes.back() = c.k;
+    Tensor values = tf.zeros(out_sizes);
+    Tensor indices = tf_long.zeros(out_sizes);
+    report(
+        c.name,
+        [&] {
+          opt_topk_values(context, in, c.k, -1, true, true, values, indices);
+        },
+        [&] {
+          topk_values(context, in, c.k, -1, true, true, values, indices);
+        });
+  }
+
+  struct ReduceCase {
+    const char* name;
+    std::vector<int32_t> sizes;
+  };
+  const ReduceCase argmax_cases[] = {
+      {"argmax [1, 32000] dim 1", {1, 32000}},
+      {"argmax [1, 128256] dim 1", {1, 128256}},
+      {"argmax [256, 1000] dim 1", {256, 1000}},
+  };
+  for (const auto& c : argmax_cases) {
+    Tensor in = random_tensor(tf, c.sizes, gen);
+    Tensor out = tf_long.zeros({c.sizes[0]});
+    report(
+        c.name,
+        [&] { opt_argmax_out(context, in, 1, false, out); },
+        [&] { argmax_out(context, in, 1, false, out); });
+  }
+
+  const ReduceCase amax_cases[] = {
+      {"amax [1, 128256] dim 1", {1, 128256}},
+      {"amax [256, 4096] dim 1", {256, 4096}},
+  };
+  for (const auto& c : amax_cases) {
+    Tensor in = random_tensor(tf, c.sizes, gen);
+    Tensor out = tf.zeros({c.sizes[0]});
+    int64_t dims[] = {1};
+    report(
+        c.name,
+        [&] { opt_amax_out(context, in, dims, false, out); },
+        [&] { amax_out(context, in, dims, false, out); });
+  }
+
+  if (context.failure_state() != Error::Ok) {
+    std::fprintf(stderr, "A kernel failed\n");
+    return 1;
+  }
+  return 0;
+}
@@ -4,7 +4,7 @@ load(
     "get_vec_preprocessor_flags",
     "get_vec_cxx_preprocessor_flags",
 )
-load("@fbsource//xplat/executorch/kernels/test:util.bzl", "define_supported_features_lib")
+load("@fbsource//xplat/executorch/kernels/test:util.bzl", "define_supported_features_lib", "op_test")
 
 def _lib_test_bin(name, extra_deps = [], in_cpu = False):
     """Defines a cxx_binary() for a single test file.
@@ -40,3 +40,78 @@ def define_common_targets():
 
     _lib_test_bin("moments_utils_test_bin", in_cpu = True)
     _lib_test_bin("libblas_test_bin")
+
+    # Checks the optimized kernel against the portable one.
+    op_test(
+        "op_convolution_test",
+        kernel_name = "optimized",
+        deps = [
+            "//executorch/kernels/portable/cpu:op_convolution",
+            "//executorch/kernels/portable:generated_lib_headers",
+        ],
+    )
+
+    # Checks the optimized data-movement kernels, and the strided copy they
+    # share, against the portable kernels.
+    runtime.cxx_test(
+        name = "op_data_movement_test",
+        srcs = [
+            "op_data_movement_test.cpp",
+        ],
+        deps = [
+            "//executorch/kernels/optimized/cpu:data_movement",
+            "//executorch/kernels/optimized/cpu:op_cat",
+            "//executorch/kernels/optimized/cpu:op_expand_copy",
+            "//executorch/kernels/optimized/cpu:op_permute_copy",
+            "//executorch/kernels/optimized/cpu:op_repeat",
+            "//executorch/kernels/optimized/cpu:op_slice_copy",
+            "//executorch/kernels/optimized/cpu:op_transpose_copy",
+            "//executorch/kernels/optimized:generated_lib_headers",
+            "//executorch/kernels/portable/cpu:op_cat",
+            "//executorch/kernels/portable/cpu:op_expand_copy",
+            "//executorch/kernels/portable/cpu:op_permute_copy",
+            "//executorch/kernels/portable/cpu:op_repeat",
+            "//executorch/kernels/portable/cpu:op_slice_copy",
+            "//executorch/kernels/portable/cpu:op_transpose_copy",
+            "//executorch/kernels/portable:generated_lib_headers",
+            "//executorch/kernels/test:test_util",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+        ],
+    )
+
+    # Not a test: run it by hand to time the convolution kernels.
+    runtime.cxx_binary(
+        name = "op_convolution_benchmark",
+        srcs = [
+            "op_convolution_benchmark.cpp",
+        ],
+        deps = [
+            "//executorch/kernels/optimized/cpu:op_convolution",
+            "//executorch/kernels/optimized:generated_lib_headers",
+            "//executorch/kernels/portable/cpu:op_convolution",
+            "//executorch/kernels/portable:generated_lib_headers",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+        ],
+    )
+
+    # Not a test: run it by hand to time the softmax, topk, argmax and amax
+    # kernels.
+    runtime.cxx_binary(
+        name = "op_softmax_topk_benchmark",
+        srcs = [
+            "op_softmax_topk_benchmark.cpp",
+        ],
+        deps = [
+            "//executorch/kernels/optimized/cpu:op_amax",
+            "//executorch/kernels/optimized/cpu:op_argmax",
+            "//executorch/kernels/optimized/cpu:op_softmax",
+            "//executorch/kernels/optimized/cpu:op_topk",
+            "//executorch/kernels/optimized:generated_lib_headers",
+            "//executorch/kernels/portable/cpu:op_amax",
+            "//executorch/kernels/portable/cpu:op_argmax",
+            "//executorch/kernels/portable/cpu:op_softmax",
+            "//executorch/kernels/portable/cpu:op_topk",
+            "//executorch/kernels/portable:generated_lib_headers",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+        ],
+    )
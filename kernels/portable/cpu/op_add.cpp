@@ -8,6 +8,7 @@
 
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
 #include <executorch/kernels/portable/cpu/util/elementwise_util.h>
+#include <executorch/kernels/portable/cpu/util/fused_elementwise_util.h>
 #include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <executorch/runtime/platform/assert.h>
@@ -16,6 +17,28 @@ namespace torch {
 namespace executor {
 namespace native {
 
+namespace {
+
+// Shared by add_out and its fused variant, so that both compute the same
+// values.
+template <typename CTYPE>
+auto make_add_fn(const CTYPE val_alpha) {
+  return [val_alpha](const auto val_a, const auto val_b) {
+    return val_a + val_alpha * val_b;
+  };
+}
+
+void add_block(
+    const float* const* inputs,
+    const float* scalars,
+    float* out,
+    size_t n) {
+  utils::apply_fused_elementwise_block<2>(
+      make_add_fn(scalars[0]), inputs, out, n);
+}
+
+} // namespace
+
 Tensor& add_out(
     KernelRuntimeContext& ctx,
     const Tensor& a,
@@ -80,9 +103,7 @@ Tensor& add_out(
           CTYPE_COMPUTE,
           op_name,
           utils::SupportedTensorDtypes::REALHBBF16>(
-          [val_alpha](const auto val_a, const auto val_b) {
-            return val_a + val_alpha * val_b;
-          },
+          make_add_fn(val_alpha),
           ctx,
           a,
           utils::SupportedTensorDtypes::REALHBBF16,
@@ -95,6 +116,14 @@ Tensor& add_out(
   return out;
 }
 
+namespace {
+
+// Fused runs only stand in for instructions that resolved to this kernel.
+auto fusible_add_registered = utils::register_fusible_op(
+    "aten::add.out", add_block, 2, 1, utils::native_kernel_id(add_out));
+
+} // namespace
+
 Tensor& add_scalar_out(
     KernelRuntimeContext& ctx,
     const Tensor& a,
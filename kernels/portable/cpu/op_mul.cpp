@@ -8,6 +8,7 @@
 
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
 #include <executorch/kernels/portable/cpu/util/elementwise_util.h>
+#include <executorch/kernels/portable/cpu/util/fused_elementwise_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <executorch/runtime/platform/assert.h>
 
@@ -15,6 +16,24 @@ namespace torch {
 namespace executor {
 namespace native {
 
+namespace {
+
+// Shared by mul_out and its fused variant, so that both compute the same
+// values.
+constexpr auto mul_fn = [](const auto val_a, const auto val_b) {
+  return val_a * val_b;
+};
+
+void mul_block(
+    const float* const* inputs,
+    const float* /* scalars */,
+    float* out,
+    size_t n) {
+  utils::apply_fused_elementwise_block<2>(mul_fn, inputs, out, n);
+}
+
+} // namespace
+
 Tensor& mul_out(
     KernelRuntimeContext& ctx,
     const Tensor& a,
@@ -72,7 +91,7 @@ Tensor& mul_out(
           CTYPE_COMPUTE,
           op_name,
           utils::SupportedTensorDtypes::REALHBBF16>(
-          [](const auto val_a, const auto val_b) { return val_a * val_b; },
+          mul_fn,
           ctx,
           a,
           utils::SupportedTensorDtypes::REALHBBF16,
@@ -85,6 +104,14 @@ Tensor& mul_out(
   return out;
 }
 
+namespace {
+
+// Fused runs only stand in for instructions that resolved to this kernel.
+auto fusible_mul_registered = utils::register_fusible_op(
+    "aten::mul.out", mul_block, 2, 0, utils::native_kernel_id(mul_out));
+
+} // namespace
+
 Tensor& mul_scalar_out(
     KernelRuntimeContext& ctx,
     const Tensor& a,
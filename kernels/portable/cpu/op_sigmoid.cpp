@@ -9,6 +9,7 @@
 #include <cmath>
 
 #include <executorch/kernels/portable/cpu/util/elementwise_util.h>
+#include <executorch/kernels/portable/cpu/util/fused_elementwise_util.h>
 #include <executorch/kernels/portable/cpu/util/functional_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
@@ -18,6 +19,26 @@ namespace native {
 
 using Tensor = executorch::aten::Tensor;
 
+namespace {
+
+// Shared by sigmoid_out and its fused variant, so that both compute the same
+// values.
+constexpr auto sigmoid_fn = [](const auto val_in) {
+  const auto one = static_cast<decltype(val_in)>(1.0);
+  auto out_val = one / (one + executorch::math::exp(-val_in));
+  return out_val;
+};
+
+void sigmoid_block(
+    const float* const* inputs,
+    const float* /* scalars */,
+    float* out,
+    size_t n) {
+  utils::apply_fused_elementwise_block<1>(sigmoid_fn, inputs, out, n);
+}
+
+} // namespace
+
 Tensor& sigmoid_out(KernelRuntimeContext& ctx, const Tensor& in, Tensor& out) {
   (void)ctx;
 
@@ -49,11 +70,7 @@ Tensor& sigmoid_out(KernelRuntimeContext& ctx, const Tensor& in, Tensor& out) {
         CTYPE_COMPUTE,
         op_name,
         utils::SupportedTensorDtypes::FLOATHBF16>(
-        [](const auto val_in) {
-          const auto one = static_cast<decltype(val_in)>(1.0);
-          auto out_val = one / (one + executorch::math::exp(-val_in));
-          return out_val;
-        },
+        sigmoid_fn,
         ctx,
         in,
         utils::SupportedTensorDtypes::REALHBBF16,
@@ -63,6 +80,18 @@ Tensor& sigmoid_out(KernelRuntimeContext& ctx, const Tensor& in, Tensor& out) {
   return out;
 }
 
+namespace {
+
+// Fused runs only stand in for instructions that resolved to this kernel.
+auto fusible_sigmoid_registered = utils::register_fusible_op(
+    "aten::sigmoid.out",
+    sigmoid_block,
+    1,
+    0,
+    utils::native_kernel_id(sigmoid_out));
+
+} // namespace
+
 } // namespace native
 } // namespace executor
 } // namespace torch
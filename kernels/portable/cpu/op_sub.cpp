@@ -8,6 +8,7 @@
 
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
 #include <executorch/kernels/portable/cpu/util/elementwise_util.h>
+#include <executorch/kernels/portable/cpu/util/fused_elementwise_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <executorch/runtime/platform/assert.h>
 
@@ -15,6 +16,28 @@ namespace torch {
 namespace executor {
 namespace native {
 
+namespace {
+
+// Shared by sub_out and its fused variant, so that both compute the same
+// values.
+template <typename CTYPE>
+auto make_sub_fn(const CTYPE val_alpha) {
+  return [val_alpha](const auto val_a, const auto val_b) {
+    return val_a - (decltype(val_b))(val_alpha)*val_b;
+  };
+}
+
+void sub_block(
+    const float* const* inputs,
+    const float* scalars,
+    float* out,
+    size_t n) {
+  utils::apply_fused_elementwise_block<2>(
+      make_sub_fn(scalars[0]), inputs, out, n);
+}
+
+} // namespace
+
 Tensor& sub_out(
     KernelRuntimeContext& ctx,
     const Tensor& a,
@@ -60,9 +83,7 @@ Tensor& sub_out(
         CTYPE_COMPUTE,
         op_name,
         utils::SupportedTensorDtypes::REALHBF16>(
-        [val_alpha](const auto val_a, const auto val_b) {
-          return val_a - (decltype(val_b))(val_alpha)*val_b;
-        },
+        make_sub_fn(val_alpha),
         ctx,
         a,
         utils::SupportedTensorDtypes::REALHBF16,
@@ -74,6 +95,14 @@ Tensor& sub_out(
   return out;
 }
 
+namespace {
+
+// Fused runs only stand in for instructions that resolved to this kernel.
+auto fusible_sub_registered = utils::register_fusible_op(
+    "aten::sub.out", sub_block, 2, 1, utils::native_kernel_id(sub_out));
+
+} // namespace
+
 Tensor& sub_scalar_out(
     KernelRuntimeContext& ctx,
     const Tensor& a,
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/cpu/util/fused_elementwise_util.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace utils {
+
+using ::executorch::ET_RUNTIME_NAMESPACE::FusedElementwiseStep;
+using ::executorch::ET_RUNTIME_NAMESPACE::FusibleElementwiseOp;
+using ::executorch::ET_RUNTIME_NAMESPACE::kMaxFusedElementwiseSteps;
+using ::executorch::ET_RUNTIME_NAMESPACE::kMaxFusibleElementwiseInputs;
+using ::executorch::ET_RUNTIME_NAMESPACE::kMaxFusibleElementwiseScalars;
+
+namespace {
+
+// Number of elements each step computes at a time. Small enough that the
+// intermediates of a whole chain stay in the L1 cache.
+constexpr int64_t kFusedBlockSize = 256;
+
+// Byte range of a tensor's data.
+struct DataRange {
+  uintptr_t begin;
+  uintptr_t end;
+};
+
+DataRange data_range(const Tensor& t) {
+  const auto begin = reinterpret_cast<uintptr_t>(t.const_data_ptr());
+  return {begin, begin + t.nbytes()};
+}
+
+// True if the ranges overlap without being identical. Identical ranges are
+// fine, since every step reads and writes element i of block b together.
+bool partially_overlap(const DataRange& a, const DataRange& b) {
+  const bool identical = a.begin == b.begin && a.end == b.end;
+  return !identical && a.begin < b.end && b.begin < a.end;
+}
+
+bool can_fuse_tensor(const Tensor& t, const Tensor& ref) {
+  return t.scalar_type() == ScalarType::Float &&
+      t.sizes().equals(ref.sizes()) && tensors_have_same_dim_order(t, ref);
+}
+
+} // namespace
+
+Error run_fused_elementwise_chain(
+    KernelRuntimeContext& ctx,
+    Span<const FusedElementwiseStep> steps) {
+  (void)ctx;
+  const size_t num_steps = steps.size();
+  if (num_steps == 0 || num_steps > kMaxFusedElementwiseSteps) {
+    return Error::NotSupported;
+  }
+
+  // The first input of the first step fixes the shape of the chain.
+  const Tensor& ref = steps[0].args[0]->toTensor();
+
+  // For each step input, the index of the step that produces it, or -1 if it
+  // comes from outside the chain.
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  int8_t producers[kMaxFusedElementwiseSteps][kMaxFusibleElementwiseInputs];
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  const float* input_data[kMaxFusedElementwiseSteps]
+                         [kMaxFusibleElementwiseInputs];
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  float scalars[kMaxFusedElementwiseSteps][kMaxFusibleElementwiseScalars];
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  float* out_data[kMaxFusedElementwiseSteps];
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  DataRange input_ranges[kMaxFusedElementwiseSteps *
+                         kMaxFusibleElementwiseInputs];
+  size_t num_input_ranges = 0;
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  DataRange out_ranges[kMaxFusedElementwiseSteps];
+  size_t num_out_ranges = 0;
+
+  for (const auto s : c10::irange(num_steps)) {
+    const FusedElementwiseStep& step = steps[s];
+    const FusibleElementwiseOp& op = *step.op;
+    for (const auto i : c10::irange(op.num_inputs)) {
+      const EValue* arg = step.args[i];
+      producers[s][i] = -1;
+      for (const auto p : c10::irange(s)) {
+        if (steps[p].args[steps[p].op->out_index()] == arg) {
+          producers[s][i] = static_cast<int8_t>(p);
+        }
+      }
+      if (producers[s][i] < 0) {
+        const Tensor& in = arg->toTensor();
+        if (!can_fuse_tensor(in, ref)) {
+          return Error::NotSupported;
+        }
+        input_data[s][i] = in.const_data_ptr<float>();
+        input_ranges[num_input_ranges++] = data_range(in);
+      }
+    }
+    for (const auto i : c10::irange(op.num_scalars)) {
+      scalars[s][i] =
+          utils::scalar_to<float>(step.args[op.num_inputs + i]->toScalar());
+    }
+    Tensor& out = step.args[op.out_index()]->toTensor();
+    if (out.scalar_type() != ScalarType::Float ||
+        !tensors_have_same_dim_order(out, ref)) {
+      return Error::NotSupported;
+    }
+  }
+
+  // Resizing only touches metadata. If it fails, the kernels will report the
+  // error when run one at a time.
+  for (const auto s : c10::irange(num_steps)) {
+    const FusedElementwiseStep& step = steps[s];
+    Tensor& out = step.args[step.op->out_index()]->toTensor();
+    if (resize_tensor(out, ref.sizes()) != Error::Ok) {
+      return Error::NotSupported;
+    }
+    out_data[s] = out.mutable_data_ptr<float>();
+    if (step.materialize_out) {
+      if (out_data[s] == nullptr) {
+        return Error::NotSupported;
+      }
+      out_ranges[num_out_ranges++] = data_range(out);
+    }
+  }
+
+  // Blocks run in parallel, and each step of a block runs after the earlier
+  // steps of that block, so an output may not share memory with an input or
+  // another output unless it is exactly the same memory.
+  for (const auto o : c10::irange(num_out_ranges)) {
+    for (const auto i : c10::irange(num_input_ranges)) {
+      if (partially_overlap(out_ranges[o], input_ranges[i])) {
+        return Error::NotSupported;
+      }
+    }
+    for (const auto other : c10::irange(o)) {
+      if (partially_overlap(out_ranges[o], out_ranges[other])) {
+        return Error::NotSupported;
+      }
+    }
+  }
+
+  const int64_t numel = ref.numel();
+  const int64_t num_blocks = (numel + kFusedBlockSize - 1) / kFusedBlockSize;
+  const bool success = ::executorch::extension::parallel_for(
+      0,
+      num_blocks,
+      std::max<int64_t>(
+          1, ::executorch::extension::internal::GRAIN_SIZE / kFusedBlockSize),
+      [&](const auto begin, const auto end) {
+        // @lint-ignore CLANGTIDY facebook-hte-CArray
+        float scratch[kMaxFusedElementwiseSteps][kFusedBlockSize];
+        // @lint-ignore CLANGTIDY facebook-hte-CArray
+        float* step_out[kMaxFusedElementwiseSteps];
+        for (const auto block : c10::irange(begin, end)) {
+          const int64_t offset = block * kFusedBlockSize;
+          const size_t n =
+              static_cast<size_t>(std::min(kFusedBlockSize, numel - offset));
+          for (const auto s : c10::irange(num_steps)) {
+            const FusibleElementwiseOp& op = *steps[s].op;
+            // @lint-ignore CLANGTIDY facebook-hte-CArray
+            const float* step_in[kMaxFusibleElementwiseInputs];
+            for (const auto i : c10::irange(op.num_inputs)) {
+              step_in[i] = producers[s][i] >= 0
+                  ? step_out[producers[s][i]]
+                  : input_data[s][i] + offset;
+            }
+            step_out[s] = steps[s].materialize_out ? out_data[s] + offset
+                                                   : scratch[s];
+            op.fn(step_in, scalars[s], step_out[s], n);
+          }
+        }
+      });
+  ET_CHECK_OR_RETURN_ERROR(success, Internal, "parallel_for failed");
+  return Error::Ok;
+}
+
+Error register_fusible_op(
+    const char* name,
+    ::executorch::ET_RUNTIME_NAMESPACE::ElementwiseBlockFunction fn,
+    uint8_t num_inputs,
+    uint8_t num_scalars,
+    const void* native_kernel) {
+  return ::executorch::ET_RUNTIME_NAMESPACE::register_fusible_elementwise_op(
+      {name,
+       fn,
+       run_fused_elementwise_chain,
+       num_inputs,
+       num_scalars,
+       native_kernel});
+}
+
+} // namespace utils
+} // namespace native
+} // namespace executor
+} // namespace torch
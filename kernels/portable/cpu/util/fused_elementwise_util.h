@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <tuple>
+#include <utility>
+
+#include <c10/util/irange.h>
+#include <executorch/kernels/portable/cpu/util/elementwise_util.h>
+#include <executorch/runtime/kernel/elementwise_fusion.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace utils {
+
+#if defined(ET_USE_PYTORCH_HEADERS) && ET_USE_PYTORCH_HEADERS
+namespace internal {
+// Can I call a function of type Op with sizeof...(Is) float Vectorized
+// arguments?
+template <typename Op, size_t... Is>
+constexpr bool can_use_vectorized_block(std::index_sequence<Is...>) {
+  return can_use_vectorized<
+      float,
+      Op,
+      ignore_first_yield_second<std::integral_constant<size_t, Is>, float>...>();
+}
+} // namespace internal
+#endif // ET_USE_PYTORCH_HEADERS
+
+/**
+ * Applies `compute_fun` to `n` elements of `kNumInputs` float inputs, as one
+ * step of a fused elementwise chain. Kernels pass the same functor that they
+ * pass to apply_*_elementwise_fn(), so that fused and unfused results match.
+ */
+template <size_t kNumInputs, typename Op>
+inline void apply_fused_elementwise_block(
+    const Op& compute_fun,
+    const float* const* inputs,
+    float* out,
+    size_t n) {
+  size_t idx = 0;
+#if defined(ET_USE_PYTORCH_HEADERS) && ET_USE_PYTORCH_HEADERS
+  if constexpr (internal::can_use_vectorized_block<Op>(
+                    std::make_index_sequence<kNumInputs>())) {
+    using Vec = at::vec::Vectorized<float>;
+    for (; idx + Vec::size() <= n; idx += Vec::size()) {
+      std::array<Vec, kNumInputs> loaded_vec_inputs;
+      for (const auto input_idx : c10::irange(kNumInputs)) {
+        loaded_vec_inputs[input_idx] = Vec::loadu(&inputs[input_idx][idx]);
+      }
+      std::apply(compute_fun, loaded_vec_inputs).store(&out[idx]);
+    }
+  }
+#endif // ET_USE_PYTORCH_HEADERS
+  for (; idx < n; ++idx) {
+    std::array<float, kNumInputs> loaded_inputs;
+    for (const auto input_idx : c10::irange(kNumInputs)) {
+      loaded_inputs[input_idx] = inputs[input_idx][idx];
+    }
+    out[idx] = std::apply(compute_fun, loaded_inputs);
+  }
+}
+
+/**
+ * Runs a chain of operators registered with register_fusible_op() in one pass
+ * over their elements, split across threads. Intermediates that are only read
+ * within the chain are kept in small per-thread blocks rather than written to
+ * their tensors.
+ *
+ * Returns Error::NotSupported, without writing to any tensor, unless every
+ * tensor is float, has the same dim order, and has the same sizes as the first
+ * input, and no output partially overlaps another tensor of the chain.
+ */
+::executorch::runtime::Error run_fused_elementwise_chain(
+    KernelRuntimeContext& ctx,
+    ::executorch::runtime::Span<
+        const ::executorch::ET_RUNTIME_NAMESPACE::FusedElementwiseStep> steps);
+
+using ::executorch::ET_RUNTIME_NAMESPACE::native_kernel_id;
+
+/**
+ * Registers a portable out-variant kernel as fusible into chains run by
+ * run_fused_elementwise_chain(). `fn` must compute the same values as the
+ * kernel does for float tensors without broadcasting. `native_kernel` is the
+ * native_kernel_id() of the kernel.
+ */
+::executorch::runtime::Error register_fusible_op(
+    const char* name,
+    ::executorch::ET_RUNTIME_NAMESPACE::ElementwiseBlockFunction fn,
+    uint8_t num_inputs,
+    uint8_t num_scalars,
+    const void* native_kernel);
+
+} // namespace utils
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/cpu/util/fused_elementwise_util.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using executorch::aten::Scalar;
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::Error;
+using executorch::runtime::EValue;
+using executorch::runtime::FusedElementwiseStep;
+using executorch::runtime::FusibleElementwiseOp;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::Span;
+using executorch::runtime::testing::TensorFactory;
+using torch::executor::native::utils::apply_fused_elementwise_block;
+using torch::executor::native::utils::run_fused_elementwise_chain;
+
+namespace {
+
+void mul_block(
+    const float* const* inputs,
+    const float* /* scalars */,
+    float* out,
+    size_t n) {
+  apply_fused_elementwise_block<2>(
+      [](const auto a, const auto b) { return a * b; }, inputs, out, n);
+}
+
+void add_block(
+    const float* const* inputs,
+    const float* scalars,
+    float* out,
+    size_t n) {
+  const float alpha = scalars[0];
+  apply_fused_elementwise_block<2>(
+      [alpha](const auto a, const auto b) { return a + alpha * b; },
+      inputs,
+      out,
+      n);
+}
+
+void sigmoid_block(
+    const float* const* inputs,
+    const float* /* scalars */,
+    float* out,
+    size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = 1.0f / (1.0f + std::exp(-inputs[0][i]));
+  }
+}
+
+const FusibleElementwiseOp kMul = {
+    "test::mul.out",
+    mul_block,
+    run_fused_elementwise_chain,
+    2,
+    0};
+const FusibleElementwiseOp kAdd = {
+    "test::add.out",
+    add_block,
+    run_fused_elementwise_chain,
+    2,
+    1};
+const FusibleElementwiseOp kSigmoid = {
+    "test::sigmoid.out",
+    sigmoid_block,
+    run_fused_elementwise_chain,
+    1,
+    0};
+
+class FusedElementwiseTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+
+  // Runs y = sigmoid(a * b + 2 * a) * b with the intermediates as given.
+  Error run_chain(
+      const Tensor& a,
+      const Tensor& b,
+      const Tensor& t0,
+      const Tensor& t1,
+      const Tensor& t2,
+      const Tensor& y,
+      bool materialize_intermediates) {
+    values_ = {
+        EValue(a),
+        EValue(b),
+        EValue(Scalar(2.0)),
+        EValue(t0),
+        EValue(t1),
+        EValue(t2),
+        EValue(y)};
+    EValue* v = values_.data();
+    mul_args_ = {&v[0], &v[1], &v[3], &v[3]};
+    add_args_ = {&v[3], &v[0], &v[2], &v[4], &v[4]};
+    sigmoid_args_ = {&v[4], &v[5], &v[5]};
+    out_mul_args_ = {&v[5], &v[1], &v[6], &v[6]};
+    steps_ = {
+        FusedElementwiseStep{
+            &kMul,
+            Span<EValue*>(mul_args_.data(), mul_args_.size()),
+            materialize_intermediates},
+        FusedElementwiseStep{
+            &kAdd,
+            Span<EValue*>(add_args_.data(), add_args_.size()),
+            materialize_intermediates},
+        FusedElementwiseStep{
+            &kSigmoid,
+            Span<EValue*>(sigmoid_args_.data(), sigmoid_args_.size()),
+            materialize_intermediates},
+        FusedElementwiseStep{
+            &kMul,
+            Span<EValue*>(out_mul_args_.data(), out_mul_args_.size()),
+            true},
+    };
+    KernelRuntimeContext context;
+    return run_fused_elementwise_chain(
+        context,
+        Span<const FusedElementwiseStep>(steps_.data(), steps_.size()));
+  }
+
+  std::vector<EValue> values_;
+  std::vector<EValue*> mul_args_;
+  std::vector<EValue*> add_args_;
+  std::vector<EValue*> sigmoid_args_;
+  std::vector<EValue*> out_mul_args_;
+  std::vector<FusedElementwiseStep> steps_;
+};
+
+std::vector<float> expected_chain(
+    const std::vector<float>& a,
+    const std::vector<float>& b) {
+  std::vector<float> y(a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    const float t1 = a[i] * b[i] + 2.0f * a[i];
+    y[i] = 1.0f / (1.0f + std::exp(-t1)) * b[i];
+  }
+  return y;
+}
+
+} // namespace
+
+TEST_F(FusedElementwiseTest, ChainSkipsInternalOutputs) {
+  TensorFactory<ScalarType::Float> tf;
+  const std::vector<float> a_data = {-2.0, -0.5, 0.0, 0.5, 1.0, 3.0};
+  const std::vector<float> b_data = {1.0, 2.0, -1.0, 0.25, -3.0, 0.5};
+  Tensor a = tf.make({2, 3}, a_data);
+  Tensor b = tf.make({2, 3}, b_data);
+  Tensor t0 = tf.zeros({2, 3});
+  Tensor t1 = tf.zeros({2, 3});
+  Tensor t2 = tf.zeros({2, 3});
+  Tensor y = tf.zeros({2, 3});
+
+  ASSERT_EQ(run_chain(a, b, t0, t1, t2, y, false), Error::Ok);
+  EXPECT_TENSOR_CLOSE(y, tf.make({2, 3}, expected_chain(a_data, b_data)));
+  // Outputs only read within the chain are never written.
+  EXPECT_TENSOR_EQ(t0, tf.zeros({2, 3}));
+  EXPECT_TENSOR_EQ(t1, tf.zeros({2, 3}));
+  EXPECT_TENSOR_EQ(t2, tf.zeros({2, 3}));
+}
+
+TEST_F(FusedElementwiseTest, ChainWritesMaterializedOutputs) {
+  TensorFactory<ScalarType::Float> tf;
+  const std::vector<float> a_data = {-2.0, -0.5, 0.0, 0.5, 1.0, 3.0};
+  const std::vector<float> b_data = {1.0, 2.0, -1.0, 0.25, -3.0, 0.5};
+  Tensor a = tf.make({6}, a_data);
+  Tensor b = tf.make({6}, b_data);
+  Tensor t0 = tf.zeros({6});
+  Tensor t1 = tf.zeros({6});
+  Tensor t2 = tf.zeros({6});
+  Tensor y = tf.zeros({6});
+
+  ASSERT_EQ(run_chain(a, b, t0, t1, t2, y, true), Error::Ok);
+  std::vector<float> t0_data(6);
+  for (size_t i = 0; i < t0_data.size(); ++i) {
+    t0_data[i] = a_data[i] * b_data[i];
+  }
+  EXPECT_TENSOR_CLOSE(t0, tf.make({6}, t0_data));
+  EXPECT_TENSOR_CLOSE(y, tf.make({6}, expected_chain(a_data, b_data)));
+}
+
+TEST_F(FusedElementwiseTest, ChainCrossingManyBlocks) {
+  TensorFactory<ScalarType::Float> tf;
+  constexpr int32_t kNumel = 4099;
+  std::vector<float> a_data(kNumel);
+  std::vector<float> b_data(kNumel);
+  for (int32_t i = 0; i < kNumel; ++i) {
+    a_data[i] = static_cast<float>(i % 17) * 0.25f - 2.0f;
+    b_data[i] = static_cast<float>(i % 5) * 0.5f - 1.0f;
+  }
+  Tensor a = tf.make({kNumel}, a_data);
+  Tensor b = tf.make({kNumel}, b_data);
+  Tensor t0 = tf.zeros({kNumel});
+  Tensor t1 = tf.zeros({kNumel});
+  Tensor t2 = tf.zeros({kNumel});
+  Tensor y = tf.zeros({kNumel});
+
+  ASSERT_EQ(run_chain(a, b, t0, t1, t2, y, false), Error::Ok);
+  EXPECT_TENSOR_CLOSE(y, tf.make({kNumel}, expected_chain(a_data, b_data)));
+}
+
+TEST_F(FusedElementwiseTest, MismatchedShapesAreNotSupported) {
+  TensorFactory<ScalarType::Float> tf;
+  // b would need broadcasting, which the fused loop does not do.
+  Tensor a = tf.ones({2, 3});
+  Tensor b = tf.ones({1, 3});
+  Tensor t0 = tf.zeros({2, 3});
+  Tensor t1 = tf.zeros({2, 3});
+  Tensor t2 = tf.zeros({2, 3});
+  Tensor y = tf.zeros({2, 3});
+
+  EXPECT_EQ(run_chain(a, b, t0, t1, t2, y, false), Error::NotSupported);
+  EXPECT_TENSOR_EQ(y, tf.zeros({2, 3}));
+}
+
+TEST_F(FusedElementwiseTest, NonFloatIsNotSupported) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Double> tf_double;
+  Tensor a = tf.ones({4});
+  Tensor b = tf.ones({4});
+  Tensor t0 = tf.zeros({4});
+  Tensor t1 = tf.zeros({4});
+  Tensor t2 = tf.zeros({4});
+  Tensor y = tf_double.zeros({4});
+
+  EXPECT_EQ(run_chain(a, b, t0, t1, t2, y, false), Error::NotSupported);
+  EXPECT_TENSOR_EQ(y, tf_double.zeros({4}));
+}
@@ -23,6 +23,16 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "fused_elementwise_test",
+        srcs = ["fused_elementwise_test.cpp"],
+        deps = [
+            "//executorch/kernels/portable/cpu/util:fused_elementwise_util",
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+        ],
+    )
+
     runtime.cxx_test(
         name = "reduce_test",
         srcs = ["reduce_test.cpp"],
@@ -7,7 +7,9 @@
  */
 
 #include <executorch/kernels/quantized/cpu/embeddingxb.h>
+#include <c10/util/irange.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 #include <algorithm>
 #include <cassert>
 #include <cinttypes>
@@ -23,32 +25,45 @@ using ScalarType = executorch::aten::ScalarType;
 
 namespace {
 
-static inline int32_t
-weight_value(const unsigned char* w_data, int32_t index, int32_t weight_nbit) {
-  if (weight_nbit == 2) {
-    int32_t subbyte = index % 4;
-    index >>= 2;
-    switch (subbyte) {
-      case 0:
-        return (int32_t)(w_data[index] & 3) - 2;
-      case 1:
-        return (int32_t)((w_data[index] & 12) >> 2) - 2;
-      case 2:
-        return (int32_t)((w_data[index] & 48) >> 4) - 2;
-      case 3:
-        return (int32_t)((w_data[index] & 192) >> 6) - 2;
-    }
-  } else if (weight_nbit == 4) {
-    int32_t odd = index & 1;
-    index >>= 1;
-    if (odd) {
-      return (int32_t)(w_data[index] & 0x0F) - 8;
-    } else {
-      return (int32_t)((w_data[index] >> 4) & 0x0F) - 8;
-    }
+// Number of values unpacked and dequantized at a time. A multiple of every
+// supported packing, so that each block starts on a byte boundary.
+constexpr int32_t kUnpackBlockSize = 256;
+
+/**
+ * Unpacks `n` consecutive values of a packed weight row into `out`, shifted to
+ * be signed. 2-bit values are packed starting from the least significant bits
+ * of each byte, 4-bit values starting from the most significant ones. `n` must
+ * be a multiple of the number of values per byte.
+ */
+template <int WEIGHT_NBIT>
+inline void unpack_weight_values(const uint8_t* w_data, int32_t n, float* out);
+
+template <>
+inline void unpack_weight_values<2>(
+    const uint8_t* w_data,
+    int32_t n,
+    float* out) {
+  for (int32_t i = 0; i < n / 4; ++i) {
+    const uint8_t byte = w_data[i];
+    out[4 * i] = static_cast<float>(static_cast<int32_t>(byte & 3) - 2);
+    out[4 * i + 1] =
+        static_cast<float>(static_cast<int32_t>((byte >> 2) & 3) - 2);
+    out[4 * i + 2] =
+        static_cast<float>(static_cast<int32_t>((byte >> 4) & 3) - 2);
+    out[4 * i + 3] = static_cast<float>(static_cast<int32_t>(byte >> 6) - 2);
   }
+}
 
-  ET_CHECK_MSG(false, "invalid weight_nbit");
+template <>
+inline void unpack_weight_values<4>(
+    const uint8_t* w_data,
+    int32_t n,
+    float* out) {
+  for (int32_t i = 0; i < n / 2; ++i) {
+    const uint8_t byte = w_data[i];
+    out[2 * i] = static_cast<float>(static_cast<int32_t>(byte >> 4) - 8);
+    out[2 * i + 1] = static_cast<float>(static_cast<int32_t>(byte & 0x0F) - 8);
+  }
 }
 
 static inline int32_t get_embedding_dim(
@@ -107,13 +122,15 @@ void check_embedding_xbit_args(
 
   ET_CHECK_MSG(
       out.scalar_type() == ScalarType::Float ||
-          out.scalar_type() == ScalarType::Half,
+          out.scalar_type() == ScalarType::Half ||
+          out.scalar_type() == ScalarType::BFloat16,
       "out.scalar_type() %" PRId8 " is not supported:",
       static_cast<int8_t>(out.scalar_type()));
 
   ET_CHECK_MSG(
       weight_scales.scalar_type() == ScalarType::Float ||
-          weight_scales.scalar_type() == ScalarType::Half,
+          weight_scales.scalar_type() == ScalarType::Half ||
+          weight_scales.scalar_type() == ScalarType::BFloat16,
       "weight_scales.scalar_type() %" PRId8 " is not supported:",
       static_cast<int8_t>(weight_scales.scalar_type()));
 
@@ -162,28 +179,75 @@ void check_embedding_xbit_args(
   }
 }
 
+/**
+ * Dequantizes the embedding row `index` of the packed weight into `out_row`.
+ * The row is unpacked in blocks of kUnpackBlockSize values, and each block is
+ * dequantized group by group with the group's scale and zero point hoisted out
+ * of the inner loop, so that both loops are free of per-element branches.
+ */
+template <int WEIGHT_NBIT, typename CTYPE_PARAMS, typename CTYPE_OUT>
+void dequantize_embedding_row(
+    const uint8_t* w_data,
+    const CTYPE_PARAMS* scale_ptr,
+    const CTYPE_PARAMS* zero_points_ptr,
+    int32_t embedding_dim,
+    int32_t group_size,
+    CTYPE_OUT* out_row) {
+  constexpr int32_t kValuesPerByte = 8 / WEIGHT_NBIT;
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  float unpacked[kUnpackBlockSize];
+  for (int32_t block_begin = 0; block_begin < embedding_dim;
+       block_begin += kUnpackBlockSize) {
+    const int32_t block_end =
+        std::min(block_begin + kUnpackBlockSize, embedding_dim);
+    unpack_weight_values<WEIGHT_NBIT>(
+        w_data + block_begin / kValuesPerByte,
+        block_end - block_begin,
+        unpacked);
+
+    int32_t j = block_begin;
+    while (j < block_end) {
+      const int32_t group_id = j / group_size;
+      const int32_t group_end =
+          std::min((group_id + 1) * group_size, block_end);
+      const float scale = static_cast<float>(scale_ptr[group_id]);
+      const float zp = zero_points_ptr != nullptr
+          ? static_cast<float>(zero_points_ptr[group_id])
+          : 0.0f;
+      const float* q = unpacked + (j - block_begin);
+      CTYPE_OUT* out = out_row + j;
+      for (int32_t k = 0; k < group_end - j; ++k) {
+        out[k] = static_cast<CTYPE_OUT>((q[k] - zp) * scale);
+      }
+      j = group_end;
+    }
+  }
+}
+
 /**
  * Retrieves the embeddings specified by indices, dequantizes them, and stores
- * them in out. Weight will always be uint8
+ * them in out. Weight will always be uint8. The lookups are independent, so
+ * they are split across threads.
  */
-template <typename CTYPE_PARAMS, typename CTYPE_OUT>
+template <int WEIGHT_NBIT, typename CTYPE_PARAMS, typename CTYPE_OUT>
 void embedding_xbit_per_channel(
     const Tensor& weight,
     const Tensor& weight_scales,
     const std::optional<Tensor>& opt_weight_zero_points,
     const Tensor& indices,
-    Tensor& out,
-    int weight_nbit) {
-  auto embedding_dim = get_embedding_dim(weight.size(1), weight_nbit);
+    Tensor& out) {
+  const int32_t embedding_dim = get_embedding_dim(weight.size(1), WEIGHT_NBIT);
 
   int32_t num_groups_per_channel = 1;
   if (weight_scales.dim() == 2) {
     num_groups_per_channel = weight_scales.size(1);
   }
-  int32_t group_size = embedding_dim / num_groups_per_channel;
+  const int32_t group_size = embedding_dim / num_groups_per_channel;
 
   CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
   const int64_t* indices_ptr = indices.const_data_ptr<int64_t>();
+  const uint8_t* weight_data = weight.const_data_ptr<uint8_t>();
+  const int64_t packed_dim = weight.size(1);
 
   const CTYPE_PARAMS* scales = weight_scales.const_data_ptr<CTYPE_PARAMS>();
   const CTYPE_PARAMS* zero_points = nullptr;
@@ -191,32 +255,47 @@ void embedding_xbit_per_channel(
     zero_points = opt_weight_zero_points.value().const_data_ptr<CTYPE_PARAMS>();
   }
 
-  for (int i = 0; i < indices.numel(); i++) {
-    int64_t index = indices_ptr[i];
-    // If using groupwise embedding
-    int32_t qparams_index = index * num_groups_per_channel;
-    CTYPE_PARAMS zp = 0.0;
-    const CTYPE_PARAMS* scale_ptr = scales + qparams_index;
-    const CTYPE_PARAMS* zero_points_ptr = nullptr;
-    if (opt_weight_zero_points.has_value()) {
-      zero_points_ptr = zero_points + qparams_index;
-    }
-
-    const uint8_t* w_data =
-        weight.const_data_ptr<uint8_t>() + weight.size(1) * index;
+  const bool success = ::executorch::extension::parallel_for(
+      0,
+      indices.numel(),
+      std::max<int64_t>(
+          1, ::executorch::extension::internal::GRAIN_SIZE / embedding_dim),
+      [&](const auto begin, const auto end) {
+        for (const auto i : c10::irange(begin, end)) {
+          const int64_t index = indices_ptr[i];
+          // If using groupwise embedding
+          const int64_t qparams_index = index * num_groups_per_channel;
+          dequantize_embedding_row<WEIGHT_NBIT>(
+              weight_data + packed_dim * index,
+              scales + qparams_index,
+              zero_points != nullptr ? zero_points + qparams_index : nullptr,
+              embedding_dim,
+              group_size,
+              out_data + i * embedding_dim);
+        }
+      });
+  ET_CHECK_MSG(success, "parallel_for failed");
+}
 
-    for (int j = 0; j < embedding_dim; ++j) {
-      int32_t group_id = j / group_size;
-      const CTYPE_PARAMS scale = scale_ptr[group_id];
-      if (opt_weight_zero_points.has_value()) {
-        zp = zero_points_ptr[group_id];
-      }
-      out_data[j] = static_cast<CTYPE_OUT>(
-          (static_cast<float>(weight_value(w_data, j, weight_nbit)) -
-           static_cast<float>(zp)) *
-          static_cast<float>(scale));
-    }
-    out_data += embedding_dim;
+template <typename CTYPE_PARAMS, typename CTYPE_OUT>
+void embedding_xbit_per_channel(
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const std::optional<Tensor>& opt_weight_zero_points,
+    const Tensor& indices,
+    Tensor& out,
+    int weight_nbit) {
+  switch (weight_nbit) {
+    case 2:
+      embedding_xbit_per_channel<2, CTYPE_PARAMS, CTYPE_OUT>(
+          weight, weight_scales, opt_weight_zero_points, indices, out);
+      return;
+    case 4:
+      embedding_xbit_per_channel<4, CTYPE_PARAMS, CTYPE_OUT>(
+          weight, weight_scales, opt_weight_zero_points, indices, out);
+      return;
+    default:
+      ET_CHECK_MSG(false, "invalid weight_nbit");
   }
 }
 
@@ -282,15 +361,16 @@ Tensor& quantized_embedding_xbit_out(
       weight_nbit);
 
   constexpr auto name = "quantized_decomposed::embedding_xbit.out";
-  ET_SWITCH_TWO_TYPES(Float, Half, out_type, ctx, name, CTYPE_OUT, [&]() {
-    embedding_xbit_per_channel<CTYPE_OUT, CTYPE_OUT>(
-        weight,
-        weight_scales,
-        opt_weight_zero_points,
-        indices,
-        out,
-        weight_nbit);
-  });
+  ET_SWITCH_THREE_TYPES(
+      Float, Half, BFloat16, out_type, ctx, name, CTYPE_OUT, [&]() {
+        embedding_xbit_per_channel<CTYPE_OUT, CTYPE_OUT>(
+            weight,
+            weight_scales,
+            opt_weight_zero_points,
+            indices,
+            out,
+            weight_nbit);
+      });
 
   return out;
 }
@@ -349,17 +429,19 @@ Tensor& quantized_embedding_xbit_dtype_out(
   ScalarType out_type = out.scalar_type();
 
   constexpr auto name = "quantized_decomposed::embedding_xbit.dtype_out";
-  ET_SWITCH_TWO_TYPES(Float, Half, params_type, ctx, name, CTYPE_P, [&]() {
-    ET_SWITCH_TWO_TYPES(Float, Half, out_type, ctx, name, CTYPE_OUT, [&]() {
-      embedding_xbit_per_channel<CTYPE_P, CTYPE_OUT>(
-          weight,
-          weight_scales,
-          opt_weight_zero_points,
-          indices,
-          out,
-          weight_nbit);
-    });
-  });
+  ET_SWITCH_THREE_TYPES(
+      Float, Half, BFloat16, params_type, ctx, name, CTYPE_P, [&]() {
+        ET_SWITCH_THREE_TYPES(
+            Float, Half, BFloat16, out_type, ctx, name, CTYPE_OUT, [&]() {
+              embedding_xbit_per_channel<CTYPE_P, CTYPE_OUT>(
+                  weight,
+                  weight_scales,
+                  opt_weight_zero_points,
+                  indices,
+                  out,
+                  weight_nbit);
+            });
+      });
 
   return out;
 }
@@ -77,7 +77,10 @@ def define_common_targets():
         visibility = [
             "//executorch/kernels/quantized/...",
         ],
-        deps = ["//executorch/runtime/kernel:kernel_includes"],
+        deps = [
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/runtime/kernel:kernel_includes",
+        ],
     )
 
     runtime.cxx_library(
@@ -87,7 +90,10 @@ def define_common_targets():
         visibility = [
             "//executorch/kernels/quantized/...",
         ],
-        deps = ["//executorch/runtime/kernel:kernel_includes_aten"],
+        deps = [
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/runtime/kernel:kernel_includes_aten",
+        ],
     )
 
     runtime.cxx_library(
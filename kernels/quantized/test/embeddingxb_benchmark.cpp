@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * Measures the 4-bit and 2-bit quantized embedding lookups on an LLM sized
+ * table (32000 x 4096, group size 32), from a single decode token up to a
+ * long prefill. Each kernel is compared to a scalar loop that unpacks one
+ * value at a time, the way the kernel used to.
+ *
+ * Not a test: run it by hand and compare the times before and after changes
+ * to the quantized embedding kernels.
+ */
+
+#include <executorch/kernels/quantized/NativeFunctions.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using executorch::aten::ScalarType;
+using executorch::aten::Tensor;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+constexpr int kTimedRuns = 10;
+constexpr int32_t kVocabSize = 32000;
+constexpr int32_t kEmbeddingDim = 4096;
+constexpr int32_t kGroupSize = 32;
+constexpr int32_t kNumGroups = kEmbeddingDim / kGroupSize;
+
+// Unpacks and dequantizes one value at a time, as the kernel did before it
+// was blocked and parallelized.
+void reference_lookup(
+    const uint8_t* weight,
+    const float* scales,
+    const float* zero_points,
+    const int64_t* indices,
+    int32_t num_indices,
+    int weight_nbit,
+    float* out) {
+  const int32_t packed_dim = kEmbeddingDim * weight_nbit / 8;
+  for (int32_t i = 0; i < num_indices; ++i) {
+    const uint8_t* row = weight + indices[i] * packed_dim;
+    const float* row_scales = scales + indices[i] * kNumGroups;
+    const float* row_zero_points = zero_points + indices[i] * kNumGroups;
+    for (int32_t j = 0; j < kEmbeddingDim; ++j) {
+      int32_t value;
+      if (weight_nbit == 2) {
+        value = ((row[j >> 2] >> (2 * (j & 3))) & 3) - 2;
+      } else {
+        value = (j & 1) ? (row[j >> 1] & 0x0F) - 8
+                        : ((row[j >> 1] >> 4) & 0x0F) - 8;
+      }
+      const int32_t group = j / kGroupSize;
+      out[j] = (static_cast<float>(value) - row_zero_points[group]) *
+          row_scales[group];
+    }
+    out += kEmbeddingDim;
+  }
+}
+
+// Returns the fastest of kTimedRuns calls of `fn`, in microseconds.
+template <typename Fn>
+double best_time_us(Fn&& fn) {
+  auto best = std::chrono::steady_clock::duration::max();
+  for (int i = 0; i < kTimedRuns; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    best = std::min(best, std::chrono::steady_clock::now() - start);
+  }
+  return std::chrono::duration<double, std::micro>(best).count();
+}
+
+} // namespace
+
+int main() {
+  executorch::runtime::runtime_init();
+  TensorFactory<ScalarType::Byte> tf_byte;
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+  std::mt19937 gen(0);
+
+  std::uniform_real_distribution<float> scale_dist(0.001f, 0.1f);
+  std::vector<float> scale_values(kVocabSize * kNumGroups);
+  for (auto& value : scale_values) {
+    value = scale_dist(gen);
+  }
+  std::vector<float> zero_point_values(kVocabSize * kNumGroups);
+  for (auto& value : zero_point_values) {
+    value = static_cast<float>(gen() % 3) - 1.0f;
+  }
+  Tensor scales = tf.make({kVocabSize, kNumGroups}, scale_values);
+  Tensor zero_points = tf.make({kVocabSize, kNumGroups}, zero_point_values);
+
+  std::printf(
+      "us per call, best of %d runs\n%-28s %11s %11s %8s %10s\n",
+      kTimedRuns,
+      "lookup",
+      "kernel",
+      "scalar",
+      "speedup",
+      "ns per row");
+  for (int weight_nbit : {4, 2}) {
+    const int32_t packed_dim = kEmbeddingDim * weight_nbit / 8;
+    std::vector<uint8_t> packed(static_cast<size_t>(kVocabSize) * packed_dim);
+    for (auto& byte : packed) {
+      byte = static_cast<uint8_t>(gen());
+    }
+    Tensor weight = tf_byte.make({kVocabSize, packed_dim}, packed);
+    const int64_t quant_min = weight_nbit == 4 ? -8 : -2;
+    const int64_t quant_max = weight_nbit == 4 ? 7 : 1;
+
+    for (int32_t num_indices : {1, 8, 64, 512, 4096}) {
+      std::vector<int64_t> index_values(num_indices);
+      for (auto& index : index_values) {
+        index = gen() % kVocabSize;
+      }
+      Tensor indices = tf_long.make({num_indices}, index_values);
+      Tensor out = tf.zeros({num_indices, kEmbeddingDim});
+      std::vector<float> reference_out(
+          static_cast<size_t>(num_indices) * kEmbeddingDim);
+
+      const double kernel_us = best_time_us([&] {
+        if (weight_nbit == 4) {
+          torch::executor::native::quantized_embedding_4bit_out(
+              weight, scales, zero_points, quant_min, quant_max, indices, out);
+        } else {
+          torch::executor::native::quantized_embedding_2bit_out(
+              weight, scales, zero_points, quant_min, quant_max, indices, out);
+        }
+      });
+      const double scalar_us = best_time_us([&] {
+        reference_lookup(
+            packed.data(),
+            scale_values.data(),
+            zero_point_values.data(),
+            index_values.data(),
+            num_indices,
+            weight_nbit,
+            reference_out.data());
+      });
+
+      const float* out_data = out.const_data_ptr<float>();
+      if (!std::equal(
+              reference_out.begin(), reference_out.end(), out_data)) {
+        std::fprintf(
+            stderr,
+            "%d-bit lookup of %d rows does not match the scalar loop\n",
+            weight_nbit,
+            num_indices);
+        return 1;
+      }
+
+      char name[32];
+      std::snprintf(
+          name, sizeof(name), "%d-bit, %d indices", weight_nbit, num_indices);
+      std::printf(
+          "%-28s %11.1f %11.1f %7.1fx %10.1f\n",
+          name,
+          kernel_us,
+          scalar_us,
+          scalar_us / kernel_us,
+          kernel_us * 1000.0 / num_indices);
+    }
+  }
+  return 0;
+}
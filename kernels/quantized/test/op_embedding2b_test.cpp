@@ -14,7 +14,9 @@
 #include <executorch/test/utils/DeathTest.h>
 
 #include <gtest/gtest.h>
+#include <cstdint>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using executorch::aten::ArrayRef;
@@ -188,3 +190,64 @@ TEST(OpQuantizedEmbedding2bTest, TestGroupWiseQuantizedEmbeddingDeath3) {
           out),
       "");
 }
+
+TEST(OpQuantizedEmbedding2bTest, LargeGroupWiseMatchesReference) {
+  et_pal_init();
+  TensorFactory<ScalarType::Byte> tfb;
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  // Groups of 200 values straddle the kernel's unpack blocks, and there are
+  // enough lookups to be split across threads.
+  constexpr int32_t kNumEmbeddings = 16;
+  constexpr int32_t kEmbeddingDim = 600;
+  constexpr int32_t kNumGroups = 3;
+  constexpr int32_t kPackedDim = kEmbeddingDim / 4;
+  constexpr int32_t kNumIndices = 300;
+
+  std::vector<uint8_t> packed(kNumEmbeddings * kPackedDim);
+  for (size_t i = 0; i < packed.size(); ++i) {
+    packed[i] = static_cast<uint8_t>((i * 37 + 11) % 256);
+  }
+  std::vector<float> scales(kNumEmbeddings * kNumGroups);
+  std::vector<float> zero_points(kNumEmbeddings * kNumGroups);
+  for (size_t i = 0; i < scales.size(); ++i) {
+    scales[i] = 0.25f * static_cast<float>(i % 7 + 1);
+    zero_points[i] = static_cast<float>(static_cast<int32_t>(i % 3) - 1);
+  }
+  std::vector<int64_t> index_values(kNumIndices);
+  for (int32_t i = 0; i < kNumIndices; ++i) {
+    index_values[i] = (i * 5 + 3) % kNumEmbeddings;
+  }
+
+  std::vector<float> expected_values;
+  expected_values.reserve(kNumIndices * kEmbeddingDim);
+  for (const int64_t row : index_values) {
+    for (int32_t j = 0; j < kEmbeddingDim; ++j) {
+      const int64_t group = row * kNumGroups + j / (kEmbeddingDim / kNumGroups);
+      const uint8_t byte = packed[row * kPackedDim + j / 4];
+      const int32_t q = ((byte >> (2 * (j % 4))) & 3) - 2;
+      expected_values.push_back(
+          (static_cast<float>(q) - zero_points[group]) * scales[group]);
+    }
+  }
+
+  Tensor qweight = tfb.make({kNumEmbeddings, kPackedDim}, packed);
+  Tensor weight_scales = tf.make({kNumEmbeddings, kNumGroups}, scales);
+  Tensor weight_zero_points =
+      tf.make({kNumEmbeddings, kNumGroups}, zero_points);
+  Tensor indices = tfl.make({kNumIndices}, index_values);
+  Tensor out = tf.zeros({kNumIndices, kEmbeddingDim});
+  Tensor expected = tf.make({kNumIndices, kEmbeddingDim}, expected_values);
+
+  quantized_embedding_2bit_out(
+      qweight,
+      weight_scales,
+      weight_zero_points,
+      -2,
+      1,
+      indices,
+      out);
+
+  EXPECT_TENSOR_EQ(out, expected);
+}
@@ -14,7 +14,9 @@
 #include <executorch/test/utils/DeathTest.h>
 
 #include <gtest/gtest.h>
+#include <cstdint>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using executorch::aten::ArrayRef;
@@ -22,6 +24,7 @@ using executorch::aten::ScalarType;
 using executorch::aten::Tensor;
 using executorch::ET_RUNTIME_NAMESPACE::KernelRuntimeContext;
 using std::optional;
+using torch::executor::native::quantized_embedding_4bit_dtype_out;
 using torch::executor::native::quantized_embedding_4bit_out;
 
 using torch::executor::testing::TensorFactory;
@@ -154,3 +157,97 @@ TEST(OpQuantizedEmbedding4bTest, TestGroupWiseQuantizedEmbeddingDeath2) {
           out),
       "");
 }
+
+TEST(OpQuantizedEmbedding4bTest, LargeGroupWiseMatchesReference) {
+  et_pal_init();
+  TensorFactory<ScalarType::Byte> tfb;
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  // Groups of 200 values straddle the kernel's unpack blocks, and there are
+  // enough lookups to be split across threads.
+  constexpr int32_t kNumEmbeddings = 16;
+  constexpr int32_t kEmbeddingDim = 600;
+  constexpr int32_t kNumGroups = 3;
+  constexpr int32_t kPackedDim = kEmbeddingDim / 2;
+  constexpr int32_t kNumIndices = 300;
+
+  std::vector<uint8_t> packed(kNumEmbeddings * kPackedDim);
+  for (size_t i = 0; i < packed.size(); ++i) {
+    packed[i] = static_cast<uint8_t>((i * 37 + 11) % 256);
+  }
+  std::vector<float> scales(kNumEmbeddings * kNumGroups);
+  std::vector<float> zero_points(kNumEmbeddings * kNumGroups);
+  for (size_t i = 0; i < scales.size(); ++i) {
+    scales[i] = 0.25f * static_cast<float>(i % 7 + 1);
+    zero_points[i] = static_cast<float>(static_cast<int32_t>(i % 3) - 1);
+  }
+  std::vector<int64_t> index_values(kNumIndices);
+  for (int32_t i = 0; i < kNumIndices; ++i) {
+    index_values[i] = (i * 5 + 3) % kNumEmbeddings;
+  }
+
+  std::vector<float> expected_values;
+  expected_values.reserve(kNumIndices * kEmbeddingDim);
+  for (const int64_t row : index_values) {
+    for (int32_t j = 0; j < kEmbeddingDim; ++j) {
+      const int64_t group = row * kNumGroups + j / (kEmbeddingDim / kNumGroups);
+      const uint8_t byte = packed[row * kPackedDim + j / 2];
+      const int32_t q = (j % 2 == 0 ? byte >> 4 : byte & 0x0F) - 8;
+      expected_values.push_back(
+          (static_cast<float>(q) - zero_points[group]) * scales[group]);
+    }
+  }
+
+  Tensor qweight = tfb.make({kNumEmbeddings, kPackedDim}, packed);
+  Tensor weight_scales = tf.make({kNumEmbeddings, kNumGroups}, scales);
+  Tensor weight_zero_points =
+      tf.make({kNumEmbeddings, kNumGroups}, zero_points);
+  Tensor indices = tfl.make({kNumIndices}, index_values);
+  Tensor out = tf.zeros({kNumIndices, kEmbeddingDim});
+  Tensor expected = tf.make({kNumIndices, kEmbeddingDim}, expected_values);
+
+  quantized_embedding_4bit_out(
+      qweight,
+      weight_scales,
+      weight_zero_points,
+      -8,
+      7,
+      indices,
+      out);
+
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+TEST(OpQuantizedEmbedding4bTest, BFloat16Output) {
+  et_pal_init();
+  TensorFactory<ScalarType::Byte> tfb;
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::BFloat16> tfbf16;
+  TensorFactory<ScalarType::Long> tfl;
+
+  int64_t quant_min = -8;
+  int64_t quant_max = 7;
+
+  Tensor weight_scales = tf.make({3}, {0.5, 1.0, 1.5});
+  Tensor qweight = tfb.make({3, 2}, {89, 239, 163, 72, 11, 126});
+  Tensor indices = tfl.make({3}, {0, 2, 1});
+
+  // Same as TestGroupWiseQuantizedEmbedding without zero points.
+  Tensor out = tfbf16.zeros({3, 4});
+  Tensor expected = tfbf16.make(
+      {3, 4},
+      {-1.5, 0.5, 3.0, 3.5, -12.0, 4.5, -1.5, 9.0, 2.0, -5.0, -4.0, 0.0});
+
+  quantized_embedding_4bit_dtype_out(
+      qweight,
+      weight_scales,
+      std::nullopt,
+      quant_min,
+      quant_max,
+      indices,
+      ScalarType::BFloat16,
+      out);
+
+  EXPECT_TENSOR_EQ(out, expected);
+}
@@ -1,3 +1,4 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
 load("@fbsource//xplat/executorch/kernels/test:util.bzl", "define_supported_features_lib", "op_test")
 
 def define_common_targets():
@@ -39,3 +40,17 @@ def define_common_targets():
         "//executorch/kernels/portable:generated_lib_headers",
         "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
     ])
+
+    # Not a test: run it by hand to time the 2-bit and 4-bit embedding lookups.
+    runtime.cxx_binary(
+        name = "embeddingxb_benchmark",
+        srcs = [
+            "embeddingxb_benchmark.cpp",
+        ],
+        deps = [
+            "//executorch/kernels/quantized/cpu:op_embedding2b",
+            "//executorch/kernels/quantized/cpu:op_embedding4b",
+            "//executorch/kernels/quantized:generated_lib_headers",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+        ],
+    )
@@ -12,6 +12,7 @@
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/memory_allocator.h>
 
 #include <gtest/gtest.h>
 
@@ -455,6 +456,172 @@ TEST_F(OpConvCorrectnessTest, 2DSanityCheckChannelsLast) {
   EXPECT_TENSOR_CLOSE(out, expected);
 }
 
+TEST_F(OpConvCorrectnessTest, 2DPointwise) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor input = tf.make(
+      {2, 3, 2, 2},
+      {0.1, 0.8, 1.5, 0.3, 1.0, 1.7, 0.5, 1.2, 1.9, 0.7, 1.4, 0.2,
+       0.9, 1.6, 0.4, 1.1, 1.8, 0.6, 1.3, 0.1, 0.8, 1.5, 0.3, 1.0});
+  Tensor weight =
+      tf.make({2, 3, 1, 1}, {-0.5, 0.0, 0.5, -0.1, 0.4, -0.2});
+  optional<Tensor> bias(tf.make({2}, {1.0, -0.5}));
+  Tensor expected = tf.make(
+      {2, 2, 2, 2},
+      {1.9,
+       0.95,
+       0.95,
+       0.95,
+       -0.49,
+       -0.04,
+       -0.73,
+       -0.09,
+       0.95,
+       0.95,
+       0.95,
+       0.95,
+       -0.03,
+       -0.72,
+       -0.08,
+       -0.77});
+  Tensor out = tf.zeros({2, 2, 2, 2});
+
+  int64_t stride[] = {1, 1};
+  int64_t padding[] = {0, 0};
+  int64_t dilation[] = {1, 1};
+  int64_t output_padding[] = {0};
+
+  op_convolution_out(
+      input,
+      weight,
+      bias,
+      stride,
+      padding,
+      dilation,
+      false,
+      output_padding,
+      1,
+      out);
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
+
+TEST_F(OpConvCorrectnessTest, 2DDepthwise) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor input = tf.make(
+      {1, 2, 4, 4},
+      {0.1, 0.8, 1.5, 0.3, 1.0, 1.7, 0.5, 1.2, 1.9, 0.7, 1.4,
+       0.2, 0.9, 1.6, 0.4, 1.1, 1.8, 0.6, 1.3, 0.1, 0.8, 1.5,
+       0.3, 1.0, 1.7, 0.5, 1.2, 1.9, 0.7, 1.4, 0.2, 0.9});
+  Tensor weight = tf.make(
+      {4, 1, 3, 3},
+      {-0.5, 0.0,  0.5, -0.1, 0.4, -0.2, 0.3,  -0.3, 0.2,
+       -0.4, 0.1,  -0.5, 0.0, 0.5, -0.1, 0.4,  -0.2, 0.3,
+       -0.3, 0.2,  -0.4, 0.1, -0.5, 0.0, 0.5,  -0.1, 0.4,
+       -0.2, 0.3,  -0.3, 0.2, -0.4, 0.1, -0.5, 0.0,  0.5});
+  optional<Tensor> bias(tf.make({4}, {0.5, 1.0, -1.0, 2.0}));
+  Tensor expected = tf.make(
+      {1, 4, 2, 2},
+      {0.42,
+       1.56,
+       2.02,
+       1.28,
+       1.28,
+       2.66,
+       1.43,
+       1.34,
+       -1.38,
+       -0.47,
+       -1.8,
+       -1.3,
+       2.09,
+       1.36,
+       1.86,
+       1.05});
+  Tensor out = tf.zeros({1, 4, 2, 2});
+
+  int64_t stride[] = {2, 2};
+  int64_t padding[] = {1, 1};
+  int64_t dilation[] = {1, 1};
+  int64_t output_padding[] = {0};
+
+  op_convolution_out(
+      input,
+      weight,
+      bias,
+      stride,
+      padding,
+      dilation,
+      false,
+      output_padding,
+      2,
+      out);
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
+
+TEST_F(OpConvCorrectnessTest, 2DGroupedWithTempAllocator) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor input = tf.make(
+      {1, 4, 3, 3},
+      {0.1, 0.8, 1.5, 0.3, 1.0, 1.7, 0.5, 1.2, 1.9, 0.7, 1.4, 0.2,
+       0.9, 1.6, 0.4, 1.1, 1.8, 0.6, 1.3, 0.1, 0.8, 1.5, 0.3, 1.0,
+       1.7, 0.5, 1.2, 1.9, 0.7, 1.4, 0.2, 0.9, 1.6, 0.4, 1.1, 1.8});
+  Tensor weight = tf.make(
+      {4, 2, 2, 2},
+      {-0.5, 0.0, 0.5, -0.1, 0.4, -0.2, 0.3, -0.3, 0.2, -0.4, 0.1,
+       -0.5, 0.0, 0.5, -0.1, 0.4, -0.2, 0.3, -0.3, 0.2, -0.4, 0.1,
+       -0.5, 0.0, 0.5, -0.1, 0.4, -0.2, 0.3, -0.3, 0.2, -0.4});
+  Tensor expected = tf.make(
+      {1, 4, 3, 3},
+      {-0.58, 0.13,  0.98,  -0.94, 0.4,   1.3,  -0.32, 0.13,  0.14,
+       0.14,  -0.75, -0.06, 0.5,   -1.25, 0.1,  0.4,   -0.42, 0.2,
+       0.06,  -0.35, -0.54, 0.2,   -1.11, -1.0, 0.18,  0.08,  -0.42,
+       -0.42, -0.2,  0.3,   -0.76, 0.52,  0.68, -0.3,  0.23,  0.42});
+
+  int64_t stride[] = {1, 1};
+  int64_t padding[] = {1, 1};
+  int64_t dilation[] = {2, 2};
+  int64_t output_padding[] = {0};
+
+  // Kernels may use the temp allocator for scratch space (e.g. an im2col
+  // buffer), so check the result both with and without one.
+  Tensor out = tf.zeros({1, 4, 3, 3});
+  op_convolution_out(
+      input,
+      weight,
+      std::nullopt,
+      stride,
+      padding,
+      dilation,
+      false,
+      output_padding,
+      2,
+      out);
+  EXPECT_TENSOR_CLOSE(out, expected);
+
+  alignas(16) uint8_t temp_buffer[1024];
+  executorch::runtime::MemoryAllocator temp_allocator(
+      sizeof(temp_buffer), temp_buffer);
+  executorch::ET_RUNTIME_NAMESPACE::KernelRuntimeContext context(
+      nullptr, &temp_allocator);
+  Tensor out_with_temp = tf.zeros({1, 4, 3, 3});
+  torch::executor::aten::convolution_outf(
+      context,
+      input,
+      weight,
+      std::nullopt,
+      stride,
+      padding,
+      dilation,
+      false,
+      output_padding,
+      2,
+      out_with_temp);
+  EXPECT_EQ(context.failure_state(), torch::executor::Error::Ok);
+  EXPECT_TENSOR_CLOSE(out_with_temp, expected);
+}
+
 TEST_F(OpConvOutTest, DynamicShapeUpperBoundSameAsExpected) {
   test_dynamic_shape(
       {1, 4, 2}, torch::executor::TensorShapeDynamism::DYNAMIC_BOUND);
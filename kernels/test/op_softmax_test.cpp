@@ -16,6 +16,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <vector>
+
 using namespace ::testing;
 using executorch::aten::ArrayRef;
 using executorch::aten::ScalarType;
@@ -328,3 +331,48 @@ TEST_F(OpSoftmaxOutTest, DynamicShapeUnbound) {
   Tensor ret = op_softmax_out(x, 1, false, out);
   EXPECT_TENSOR_CLOSE(out, expected_result);
 }
+
+TEST_F(OpSoftmaxOutTest, ShapeSweepMatchesReference) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Sizes around common vector widths, reduced over every dimension.
+  const std::vector<std::vector<int32_t>> shapes = {
+      {1}, {7}, {16}, {33}, {4, 17}, {3, 8, 5}, {2, 9, 19}, {65, 3}};
+  for (const auto& sizes : shapes) {
+    int32_t numel = 1;
+    for (const int32_t size : sizes) {
+      numel *= size;
+    }
+    std::vector<float> data(numel);
+    for (int32_t i = 0; i < numel; ++i) {
+      data[i] = std::sin(i * 0.7f) * 4;
+    }
+    Tensor x = tf.make(sizes, data);
+
+    for (size_t dim = 0; dim < sizes.size(); ++dim) {
+      int32_t inner = 1;
+      for (size_t d = dim + 1; d < sizes.size(); ++d) {
+        inner *= sizes[d];
+      }
+      const int32_t dim_size = sizes[dim];
+      std::vector<float> expected_data(numel);
+      for (int32_t outer = 0; outer < numel / (dim_size * inner); ++outer) {
+        for (int32_t i = 0; i < inner; ++i) {
+          const int32_t base = outer * dim_size * inner + i;
+          double sum = 0;
+          for (int32_t d = 0; d < dim_size; ++d) {
+            sum += std::exp(static_cast<double>(data[base + d * inner]));
+          }
+          for (int32_t d = 0; d < dim_size; ++d) {
+            expected_data[base + d * inner] =
+                std::exp(static_cast<double>(data[base + d * inner])) / sum;
+          }
+        }
+      }
+
+      Tensor out = tf.zeros(sizes);
+      op_softmax_out(x, dim, /*half_to_float=*/false, out);
+      EXPECT_TENSOR_CLOSE(out, tf.make(sizes, expected_data));
+    }
+  }
+}
@@ -16,6 +16,7 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <numeric>
 
 using namespace ::testing;
 using executorch::aten::IntArrayRef;
@@ -174,3 +175,46 @@ TEST_F(OpTopkValuesTest, NonPartialSort) {
     EXPECT_TENSOR_EQ(indices, indices_expected);
   }
 }
+
+TEST_F(OpTopkValuesTest, ShapeSweepMatchesReference) {
+  TensorFactory<ScalarType::Float> tfFloat;
+  TensorFactory<ScalarType::Long> tfLong;
+
+  // Distinct values, so the expected indices are unique.
+  const int32_t outer = 3;
+  for (const int32_t dim_size : {5, 64, 300}) {
+    std::vector<float> data(outer * dim_size);
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<float>((i * 37) % data.size());
+    }
+    Tensor input = tfFloat.make({outer, dim_size}, data);
+
+    for (const int32_t k : {1, 4, dim_size}) {
+      if (k > dim_size) {
+        continue;
+      }
+      for (const bool largest : {true, false}) {
+        std::vector<float> expected_values;
+        std::vector<int64_t> expected_indices;
+        for (int32_t o = 0; o < outer; ++o) {
+          std::vector<int64_t> order(dim_size);
+          std::iota(order.begin(), order.end(), 0);
+          const float* row = data.data() + o * dim_size;
+          std::sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+            return largest ? row[a] > row[b] : row[a] < row[b];
+          });
+          for (int32_t i = 0; i < k; ++i) {
+            expected_values.push_back(row[order[i]]);
+            expected_indices.push_back(order[i]);
+          }
+        }
+
+        Tensor values = tfFloat.zeros({outer, k});
+        Tensor indices = tfLong.zeros({outer, k});
+        op_topk_values(input, k, 1, largest, true, values, indices);
+        EXPECT_TENSOR_CLOSE(values, tfFloat.make({outer, k}, expected_values));
+        EXPECT_TENSOR_EQ(indices, tfLong.make({outer, k}, expected_indices));
+      }
+    }
+  }
+}
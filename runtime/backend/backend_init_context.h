@@ -29,7 +29,8 @@ class BackendInitContext final {
       MemoryAllocator* runtime_allocator,
       EventTracer* event_tracer = nullptr,
       const char* method_name = nullptr,
-      const NamedDataMap* named_data_map = nullptr)
+      const NamedDataMap* named_data_map = nullptr,
+      const void* method_id = nullptr)
       : runtime_allocator_(runtime_allocator),
 #ifdef ET_EVENT_TRACER_ENABLED
         event_tracer_(event_tracer),
@@ -37,8 +38,8 @@ class BackendInitContext final {
         event_tracer_(nullptr),
 #endif
         method_name_(method_name),
-        named_data_map_(named_data_map) {
-  }
+        named_data_map_(named_data_map),
+        method_id_(method_id != nullptr ? method_id : runtime_allocator) {}
 
   /** Get the runtime allocator passed from Method. It's the same runtime
    * executor used by the standard executor runtime and the life span is the
@@ -48,6 +49,17 @@ class BackendInitContext final {
     return runtime_allocator_;
   }
 
+  /** Get an opaque id of the Method instance that the delegate is loaded
+   * into. It is the same for all delegates of a Method and differs between
+   * Methods that are alive at the same time, including clones of a Method.
+   * Backends can use it to group delegates, e.g. to share resources between
+   * them. Do not dereference it. If the caller gave no id, the runtime
+   * allocator stands in for it.
+   */
+  const void* get_method_id() const {
+    return method_id_;
+  }
+
   /**
    * Returns a pointer (null if not installed) to an instance of EventTracer to
    * do profiling/debugging logging inside the delegate backend. Users will need
@@ -80,6 +92,7 @@ class BackendInitContext final {
   EventTracer* event_tracer_ = nullptr;
   const char* method_name_ = nullptr;
   const NamedDataMap* named_data_map_ = nullptr;
+  const void* method_id_ = nullptr;
 };
 
 } // namespace ET_RUNTIME_NAMESPACE
@@ -86,6 +86,31 @@ class BackendInterface {
       FreeableBuffer* processed,
       ArrayRef<CompileSpec> compile_specs) const = 0;
 
+  /**
+   * Creates another handle that executes the same delegate as `handle`, for a
+   * clone of the Method that owns `handle` (see `Method::clone()`). This lets
+   * backends share compiled state such as packed weights instead of
+   * processing the delegate again in init().
+   *
+   * The two handles may be executed at the same time, so the new one must not
+   * share any state that execute() writes. It may point to state owned by
+   * `handle`: the clone never outlives the Method that owns `handle`.
+   *
+   * @param[in] context The context of the clone, as it would be passed to
+   *     init().
+   * @param[in] handle An opaque handle returned by `init()`.
+   *
+   * @returns On success, a new handle that is passed to `execute()` and
+   *     `destroy()` like one returned by `init()`.
+   * @returns Error::NotSupported if the delegate must be initialized again
+   *     with init() instead, which is what backends do by default.
+   */
+  ET_NODISCARD virtual Result<DelegateHandle*> clone(
+      ET_UNUSED BackendInitContext& context,
+      ET_UNUSED DelegateHandle* handle) const {
+    return Error::NotSupported;
+  }
+
   /**
    * Responsible for executing the given method’s handle, as it was produced
    * by compile.
@@ -44,6 +44,7 @@ def define_common_targets():
             "function_ref.h",
             "result.h",
             "span.h",
+            "task_runner.h",
         ],
         visibility = [
             "//executorch/...",
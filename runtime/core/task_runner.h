@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <executorch/runtime/core/function_ref.h>
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * Runs batches of independent tasks, possibly concurrently. The runtime does
+ * not own any threads, so callers that want work to happen in parallel provide
+ * an implementation backed by their threads, e.g.
+ * `executorch::extension::threadpool::ThreadPoolTaskRunner`.
+ */
+class TaskRunner {
+ public:
+  /**
+   * Calls `task(i)` once for every `i` in `[0, num_tasks)` and returns after
+   * all of the calls have returned. Calls may run on other threads, in any
+   * order and at the same time as each other.
+   */
+  virtual void run(size_t num_tasks, FunctionRef<void(size_t)> task) = 0;
+
+  virtual ~TaskRunner() = default;
+};
+
+} // namespace runtime
+} // namespace executorch
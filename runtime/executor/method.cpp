@@ -9,13 +9,16 @@
 #include <executorch/runtime/executor/method.h>
 
 #include <c10/util/irange.h>
+#include <algorithm>
 #include <array>
 #include <cinttypes> // @donotremove
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/event_tracer_hooks.h>
+#include <executorch/runtime/core/event_tracer_hooks_delegate.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 #include <executorch/runtime/core/named_data_map.h>
 #include <executorch/runtime/core/span.h>
@@ -24,11 +27,13 @@
 #include <executorch/runtime/executor/platform_memory_allocator.h>
 #include <executorch/runtime/executor/program.h>
 #include <executorch/runtime/executor/tensor_parser.h>
+#include <executorch/runtime/kernel/elementwise_fusion.h>
 #include <executorch/runtime/kernel/kernel_runtime_context.h>
 #include <executorch/runtime/kernel/operator_registry.h>
 #include <executorch/runtime/platform/assert.h>
 #include <executorch/runtime/platform/compiler.h>
 #include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/platform.h>
 #include <executorch/runtime/platform/profiler.h>
 #include <executorch/schema/program_generated.h>
 
@@ -119,6 +124,47 @@ class BackendDelegate final {
     return Error::Ok;
   }
 
+  /**
+   * Initializes an already-allocated BackendDelegate to run the same delegate
+   * as `source`, for a clone of the Method that owns `source`. Lets the
+   * backend clone the handle of `source`, and falls back to Init() if it
+   * can't.
+   *
+   * @param[in] source The initialized BackendDelegate to clone.
+   * @param[in] delegate The serialized backend delegate of `source`.
+   * @param[in] program The serialized program to load from.
+   * @param[in] backend_init_context The context pointer to pass to the
+   *     backend's clone() or init() method.
+   * @param[out] out The BackendDelegate to initialize.
+   *
+   * @returns Error::Ok if the initialization succeeded, or an error otherwise.
+   */
+  static Error Clone(
+      const BackendDelegate& source,
+      const executorch_flatbuffer::BackendDelegate& delegate,
+      const Program* program,
+      BackendInitContext& backend_init_context,
+      BackendDelegate* out) {
+    Result<DelegateHandle*> handle =
+        source.backend_->clone(backend_init_context, source.handle_);
+    if (handle.error() == Error::NotSupported) {
+      return Init(delegate, program, backend_init_context, out);
+    }
+    if (!handle.ok()) {
+      ET_LOG(
+          Error,
+          "Clone failed for backend %s: 0x%" PRIx32,
+          delegate.id()->c_str(),
+          static_cast<uint32_t>(handle.error()));
+      return handle.error();
+    }
+    out->backend_ = source.backend_;
+    out->handle_ = handle.get();
+    // The processed data stays with `source`, which outlives the clone.
+    new (&out->segment_) FreeableBuffer();
+    return Error::Ok;
+  }
+
   ~BackendDelegate() {
     if (backend_ != nullptr) {
       backend_->destroy(handle_);
@@ -212,6 +258,62 @@ class BackendDelegate final {
   DelegateHandle* handle_;
 };
 
+/**
+ * Consecutive KernelCall instructions that run as one fused elementwise loop.
+ */
+struct FusedKernelCall {
+  FusedElementwiseRunner runner;
+  /// One step per fused instruction, starting at the instruction that this
+  /// call is attached to.
+  Span<const FusedElementwiseStep> steps;
+};
+
+/**
+ * An instruction of a chain, decoded from the flatbuffer when the method is
+ * initialized so that executing it does not touch the flatbuffer.
+ */
+struct DecodedInstruction {
+  struct KernelCall {
+    OpFunction kernel;
+    /// The fused call that starts at this instruction, or nullptr.
+    const FusedKernelCall* fused_call;
+  };
+  struct JumpFalseCall {
+    const EValue* cond_value;
+    size_t destination_instruction;
+  };
+  struct MoveCall {
+    const EValue* move_from;
+    EValue* move_to;
+  };
+
+  executorch_flatbuffer::InstructionArguments type;
+  /// The arguments of a KernelCall or DelegateCall; empty otherwise.
+  InstructionArgs args;
+  /// The member that matches `type`.
+  union {
+    KernelCall kernel_call;
+    BackendDelegate* delegate;
+    JumpFalseCall jump_false_call;
+    MoveCall move_call;
+    EValue* free_value;
+  };
+};
+
+/**
+ * The order in which execute() runs the instructions of a chain when some of
+ * them run concurrently. A unit is a fused run of instructions, or a single
+ * instruction that is not part of one.
+ */
+struct ChainSchedule {
+  /// The index of the first instruction of each unit, grouped by level. The
+  /// units of a level do not depend on each other, only on earlier levels.
+  Span<size_t> units;
+  /// Level `i` is `units[level_ends[i - 1]:level_ends[i]]`, where
+  /// `level_ends[-1]` is 0.
+  Span<size_t> level_ends;
+};
+
 /**
  * Runtime state for a chain of instructions.
  */
@@ -219,12 +321,39 @@ struct Chain {
   /// Pointer to the associated flatbuffer chain.
   const executorch_flatbuffer::Chain* s_chain_;
 
-  /// Each entry is a list of parameters for a kernel or delegate call.
-  Span<InstructionArgs> argument_lists_;
-  /// Each instruction will have one kernel (not for delegate).
-  OpFunction* kernels_;
+  /// The instructions of the chain, in order.
+  Span<DecodedInstruction> instructions_;
+
+  /// How to run the chain concurrently, or nullptr to run it in order.
+  const ChainSchedule* schedule_;
 };
 
+/**
+ * State of one of the tasks that run the units of a level concurrently.
+ */
+struct InstructionSlot {
+  /// Temp memory for the instructions that the task runs.
+  MemoryAllocator* temp_allocator;
+  /// The first error that the task hit, and the instruction that caused it.
+  Error error;
+  size_t error_instr_idx;
+};
+
+namespace {
+
+/// Returns the number of instructions that execute together starting at
+/// `instruction`: the length of its fused run, or 1.
+size_t instruction_unit_size(const DecodedInstruction& instruction) {
+  if (instruction.type ==
+          executorch_flatbuffer::InstructionArguments::KernelCall &&
+      instruction.kernel_call.fused_call != nullptr) {
+    return instruction.kernel_call.fused_call->steps.size();
+  }
+  return 1;
+}
+
+} // namespace
+
 namespace {
 
 Result<InstructionArgs> gen_instruction_arguments(
@@ -291,6 +420,18 @@ Result<bool> parse_cond_value(const EValue& cond_value) {
   return true;
 }
 
+/// Returns true if the data of the tensor comes from the program or from
+/// external data, and is never written.
+bool is_constant_tensor(const executorch_flatbuffer::Tensor& s_tensor) {
+  if (s_tensor.allocation_info() != nullptr) {
+    return false;
+  }
+  return s_tensor.data_buffer_idx() > 0 ||
+      (s_tensor.extra_tensor_info() != nullptr &&
+       s_tensor.extra_tensor_info()->location() ==
+           executorch_flatbuffer::TensorDataLocation::EXTERNAL);
+}
+
 } // namespace
 
 Result<size_t> Method::get_num_external_constants() {
@@ -403,7 +544,9 @@ Error Method::parse_external_constants(const NamedDataMap* external_data_map) {
   return Error::Ok;
 }
 
-Error Method::parse_values(const NamedDataMap* external_data_map) {
+Error Method::parse_values(
+    const NamedDataMap* external_data_map,
+    const Method* source) {
   auto flatbuffer_values = serialization_plan_->values();
   ET_CHECK_OR_RETURN_ERROR(
       flatbuffer_values != nullptr, InvalidProgram, "Missing values");
@@ -423,7 +566,9 @@ Error Method::parse_values(const NamedDataMap* external_data_map) {
   if (!max_external_constants.ok()) {
     return max_external_constants.error();
   }
-  if (max_external_constants.get() > 0) {
+  // A clone shares the tensors that point to external constants with its
+  // source, so it doesn't need the constants itself.
+  if (max_external_constants.get() > 0 && source == nullptr) {
     // Allocate space for external tensors.
     external_constants_ =
         memory_manager_->method_allocator()->allocateList<NamedData>(
@@ -540,10 +685,18 @@ Error Method::parse_values(const NamedDataMap* external_data_map) {
         new (&values_[i]) EValue(fb_str->c_str(), fb_str->size());
       } break;
       case executorch_flatbuffer::KernelTypes::Tensor: {
+        const auto s_tensor =
+            static_cast<const executorch_flatbuffer::Tensor*>(val);
+        if (source != nullptr && is_constant_tensor(*s_tensor)) {
+          // Nothing writes to constants, so the clone can use the same
+          // tensor.
+          new (&values_[i]) EValue(source->values_[i]);
+          break;
+        }
         auto t = deserialization::parseTensor(
             program_,
             memory_manager_,
-            static_cast<const executorch_flatbuffer::Tensor*>(val),
+            s_tensor,
             external_data_map,
             Span<NamedData>(external_constants_, n_external_constants_));
         if (!t.ok()) {
@@ -666,8 +819,7 @@ Error populate_operator_name(
 
 Error Method::resolve_operator(
     int32_t op_index,
-    OpFunction* kernels,
-    size_t kernel_index,
+    OpFunction* kernel,
     InstructionArgs args,
     size_t n_args) {
   // TODO(T153506819) Investigate optimizing this function for both
@@ -742,16 +894,893 @@ Error Method::resolve_operator(
         operator_name);
     return op_function.error();
   }
-  kernels[kernel_index] = op_function.get();
+  *kernel = op_function.get();
+  return Error::Ok;
+}
+
+namespace {
+
+// Use counts saturate at this value. Values that must always be written, like
+// method inputs and outputs, start out with it.
+constexpr uint8_t kPinnedValueUses = UINT8_MAX;
+
+void add_value_use(uint8_t* use_counts, size_t n_value, int32_t index) {
+  if (index >= 0 && static_cast<size_t>(index) < n_value &&
+      use_counts[index] < kPinnedValueUses) {
+    use_counts[index]++;
+  }
+}
+
+void pin_value(uint8_t* use_counts, size_t n_value, int32_t index) {
+  if (index >= 0 && static_cast<size_t>(index) < n_value) {
+    use_counts[index] = kPinnedValueUses;
+  }
+}
+
+/**
+ * Returns the fusible operator that a KernelCall instruction calls, or nullptr
+ * if the instruction is not a KernelCall or can't be fused. An operator is
+ * only fused if its block function reproduces the kernel that the instruction
+ * resolved to, not just another kernel registered under the same name.
+ */
+const FusibleElementwiseOp* get_fusible_op(
+    const executorch_flatbuffer::ExecutionPlan& plan,
+    const executorch_flatbuffer::Instruction& instruction,
+    const DecodedInstruction& decoded) {
+  if (decoded.type != executorch_flatbuffer::InstructionArguments::KernelCall) {
+    return nullptr;
+  }
+  InstructionArgs args = decoded.args;
+  // The op index was checked when the operator was resolved.
+  const auto* op =
+      plan.operators()->Get(instruction.instr_args_as_KernelCall()->op_index());
+  constexpr size_t kTempBufferSizeForName = 100;
+  char operator_name[kTempBufferSizeForName];
+  if (populate_operator_name(op, kTempBufferSizeForName, operator_name) !=
+      Error::Ok) {
+    return nullptr;
+  }
+  const FusibleElementwiseOp* fusible_op =
+      get_fusible_elementwise_op(operator_name, decoded.kernel_call.kernel);
+  if (fusible_op == nullptr) {
+    return nullptr;
+  }
+
+  // Check the argument layout, and that the returned value is the out tensor
+  // so that it does not need to be written separately.
+  const size_t out_index = fusible_op->out_index();
+  if (args.size() != out_index + 2 || args[out_index + 1] != args[out_index] ||
+      !args[out_index]->isTensor()) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < fusible_op->num_inputs; ++i) {
+    if (!args[i]->isTensor()) {
+      return nullptr;
+    }
+  }
+  for (size_t i = fusible_op->num_inputs; i < out_index; ++i) {
+    if (!args[i]->isScalar()) {
+      return nullptr;
+    }
+  }
+  return fusible_op;
+}
+
+} // namespace
+
+Error Method::fuse_elementwise_kernels() {
+  auto method_allocator = memory_manager_->method_allocator();
+  // Like resolve_operator(), prefer the temp allocator for scratch memory.
+  auto allocator = memory_manager_->temp_allocator();
+  if (allocator == nullptr || allocator->size() == 0) {
+    allocator = method_allocator;
+  }
+  uint8_t* use_counts = allocator->allocateList<uint8_t>(n_value_);
+  if (use_counts == nullptr) {
+    // Fusion is only an optimization, so run the kernels one at a time
+    // rather than failing.
+    ET_LOG(Debug, "Not enough memory to fuse elementwise kernels");
+    return Error::Ok;
+  }
+  memset(use_counts, 0, n_value_);
+
+  // Count how often each value is referenced. Values that can be read
+  // indirectly, through a list or a move, are pinned.
+  const auto s_values = serialization_plan_->values();
+  for (size_t i = 0; i < n_value_; ++i) {
+    const auto* s_value = s_values->Get(i);
+    const flatbuffers::Vector<int32_t>* items = nullptr;
+    if (s_value->val_type() == executorch_flatbuffer::KernelTypes::TensorList) {
+      items = s_value->val_as_TensorList()->items();
+    } else if (
+        s_value->val_type() ==
+        executorch_flatbuffer::KernelTypes::OptionalTensorList) {
+      items = s_value->val_as_OptionalTensorList()->items();
+    }
+    if (items != nullptr) {
+      for (const int32_t item : *items) {
+        pin_value(use_counts, n_value_, item);
+      }
+    }
+  }
+  for (size_t i = 0; i < inputs_size(); ++i) {
+    pin_value(use_counts, n_value_, get_input_index(i));
+  }
+  for (size_t i = 0; i < outputs_size(); ++i) {
+    pin_value(use_counts, n_value_, get_output_index(i));
+  }
+  for (size_t i = 0; i < n_chains_; ++i) {
+    for (const auto* instruction : *chains_[i].s_chain_->instructions()) {
+      switch (instruction->instr_args_type()) {
+        case executorch_flatbuffer::InstructionArguments::KernelCall:
+          for (const int32_t arg : *instruction->instr_args_as_KernelCall()
+                                        ->args()) {
+            add_value_use(use_counts, n_value_, arg);
+          }
+          break;
+        case executorch_flatbuffer::InstructionArguments::DelegateCall:
+          for (const int32_t arg : *instruction->instr_args_as_DelegateCall()
+                                        ->args()) {
+            add_value_use(use_counts, n_value_, arg);
+          }
+          break;
+        case executorch_flatbuffer::InstructionArguments::JumpFalseCall:
+          add_value_use(
+              use_counts,
+              n_value_,
+              instruction->instr_args_as_JumpFalseCall()->cond_value_index());
+          break;
+        case executorch_flatbuffer::InstructionArguments::MoveCall: {
+          const auto* move_call = instruction->instr_args_as_MoveCall();
+          pin_value(use_counts, n_value_, move_call->move_from());
+          pin_value(use_counts, n_value_, move_call->move_to());
+        } break;
+        case executorch_flatbuffer::InstructionArguments::FreeCall:
+          add_value_use(
+              use_counts,
+              n_value_,
+              instruction->instr_args_as_FreeCall()->value_index());
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < n_chains_; ++i) {
+    Chain& chain = chains_[i];
+    const auto instructions = chain.s_chain_->instructions();
+    const size_t num_instructions = chain.instructions_.size();
+
+    // Jumps may land in the middle of a fused run, so leave chains with
+    // control flow alone.
+    bool has_jumps = false;
+    for (const DecodedInstruction& instruction : chain.instructions_) {
+      has_jumps |= instruction.type ==
+          executorch_flatbuffer::InstructionArguments::JumpFalseCall;
+    }
+    if (has_jumps) {
+      continue;
+    }
+
+    size_t instr_idx = 0;
+    while (instr_idx < num_instructions) {
+      // Extend the run as long as each instruction shares the first one's
+      // runner and reads the output of an earlier instruction of the run.
+      // @lint-ignore CLANGTIDY facebook-hte-CArray
+      const FusibleElementwiseOp* ops[kMaxFusedElementwiseSteps];
+      size_t num_steps = 0;
+      while (num_steps < kMaxFusedElementwiseSteps &&
+             instr_idx + num_steps < num_instructions) {
+        const size_t idx = instr_idx + num_steps;
+        const FusibleElementwiseOp* op = get_fusible_op(
+            *serialization_plan_,
+            *instructions->Get(idx),
+            chain.instructions_[idx]);
+        if (op == nullptr ||
+            (num_steps > 0 && op->runner != ops[0]->runner)) {
+          break;
+        }
+        bool reads_run_output = num_steps == 0;
+        for (size_t in = 0; in < op->num_inputs; ++in) {
+          for (size_t p = 0; p < num_steps; ++p) {
+            reads_run_output |= chain.instructions_[idx].args[in] ==
+                chain.instructions_[instr_idx + p].args[ops[p]->out_index()];
+          }
+        }
+        if (!reads_run_output) {
+          break;
+        }
+        ops[num_steps++] = op;
+      }
+      if (num_steps < 2) {
+        ++instr_idx;
+        continue;
+      }
+
+      FusedKernelCall* fused_call =
+          method_allocator->allocateInstance<FusedKernelCall>();
+      FusedElementwiseStep* steps =
+          method_allocator->allocateList<FusedElementwiseStep>(num_steps);
+      if (fused_call == nullptr || steps == nullptr) {
+        return Error::MemoryAllocationFailed;
+      }
+
+      for (size_t s = 0; s < num_steps; ++s) {
+        InstructionArgs args = chain.instructions_[instr_idx + s].args;
+        EValue* out = args[ops[s]->out_index()];
+        // The output may stay in the fused loop's scratch space if only
+        // later steps of the run read it, and no other step writes it.
+        size_t uses_in_run = 0;
+        bool read_later = false;
+        bool conflicts = false;
+        for (size_t t = 0; t < num_steps; ++t) {
+          InstructionArgs t_args = chain.instructions_[instr_idx + t].args;
+          for (size_t a = 0; a < t_args.size(); ++a) {
+            uses_in_run += t_args[a] == out;
+          }
+          for (size_t in = 0; in < ops[t]->num_inputs; ++in) {
+            if (t_args[in] == out) {
+              read_later |= t > s;
+              conflicts |= t <= s;
+            }
+          }
+          conflicts |= t != s && t_args[ops[t]->out_index()] == out;
+        }
+        const uint8_t total_uses = use_counts[out - values_];
+        const bool internal = total_uses != kPinnedValueUses &&
+            total_uses == uses_in_run && read_later && !conflicts;
+        steps[s] = FusedElementwiseStep{ops[s], args, !internal};
+      }
+      new (fused_call) FusedKernelCall{
+          ops[0]->runner, Span<const FusedElementwiseStep>(steps, num_steps)};
+      chain.instructions_[instr_idx].kernel_call.fused_call = fused_call;
+      instr_idx += num_steps;
+    }
+  }
+  return Error::Ok;
+}
+
+namespace {
+
+/**
+ * A byte range that an instruction reads or writes. Values other than tensors
+ * stand for the memory of their EValue.
+ */
+struct MemoryAccess {
+  uintptr_t begin;
+  uintptr_t end;
+  bool write;
+};
+
+/// Tensors whose data is only known at execution time, like unallocated
+/// method inputs and outputs, all use the range that starts here, since they
+/// may alias each other.
+constexpr uintptr_t kUnknownDataAddress = 0;
+
+MemoryAccess value_memory(const EValue& value, bool write) {
+  if (value.isTensor()) {
+    const auto& tensor = value.toTensor();
+    const auto data = reinterpret_cast<uintptr_t>(tensor.const_data_ptr());
+    if (data == 0) {
+      return MemoryAccess{kUnknownDataAddress, kUnknownDataAddress + 1, write};
+    }
+    return MemoryAccess{
+        data, data + std::max<size_t>(tensor.nbytes(), 1), write};
+  }
+  const auto evalue = reinterpret_cast<uintptr_t>(&value);
+  return MemoryAccess{evalue, evalue + sizeof(EValue), write};
+}
+
+/// A kernel argument that the kernel updates in place, on top of writing its
+/// out arguments. Schemas mark these as mutable, e.g. `Tensor(a!) cache`, but
+/// programs don't record it.
+struct MutatedArg {
+  const char* op_name;
+  size_t arg_index;
+};
+
+constexpr MutatedArg kMutatedArgs[] = {
+    {"llama::sdpa_with_kv_cache.out", 3}, // key_cache
+    {"llama::sdpa_with_kv_cache.out", 4}, // value_cache
+    {"llama::update_cache.out", 1}, // cache
+    {"llama::update_cache_with_indices.out", 1}, // cache
+};
+
+/// Returns whether the kernel named `op_name` updates its argument
+/// `arg_index` in place.
+bool is_mutated_arg(const char* op_name, size_t arg_index) {
+  for (const MutatedArg& mutated : kMutatedArgs) {
+    if (mutated.arg_index == arg_index &&
+        strcmp(mutated.op_name, op_name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Returns the index of the first argument that a kernel writes, apart from
+ * those in kMutatedArgs. The emitter passes the arguments in schema order,
+ * out arguments last, and then the values that the kernel returns. An out
+ * variant returns its out arguments, so they appear twice at the end; any
+ * other kernel returns a new value, which is its last argument.
+ */
+size_t first_written_kernel_arg(const flatbuffers::Vector<int32_t>& args) {
+  const size_t n_args = args.size();
+  for (size_t n_returned = n_args / 2; n_returned > 0; --n_returned) {
+    bool repeated = true;
+    for (size_t i = n_args - n_returned; repeated && i < n_args; ++i) {
+      repeated = args[i] == args[i - n_returned];
+    }
+    if (repeated) {
+      return n_args - 2 * n_returned;
+    }
+  }
+  return n_args > 0 ? n_args - 1 : 0;
+}
+
+/// Returns the value indices that a KernelCall or DelegateCall takes.
+const flatbuffers::Vector<int32_t>* instruction_arg_indices(
+    const executorch_flatbuffer::Instruction& instruction) {
+  if (instruction.instr_args_type() ==
+      executorch_flatbuffer::InstructionArguments::KernelCall) {
+    return instruction.instr_args_as_KernelCall()->args();
+  }
+  return instruction.instr_args_as_DelegateCall()->args();
+}
+
+/// Calls `fn` with `index`, and with the index of each value that the value
+/// at `index` refers to if it is a list.
+template <typename Fn>
+void for_each_referenced_value(
+    const flatbuffers::Vector<flatbuffers::Offset<executorch_flatbuffer::EValue>>&
+        s_values,
+    size_t n_value,
+    size_t index,
+    Fn fn) {
+  fn(index);
+  const auto* s_value = s_values.Get(index);
+  const auto visit_items = [&](const auto* items) {
+    if (items == nullptr) {
+      return;
+    }
+    for (const auto item : *items) {
+      // OptionalTensorLists use -1 for None.
+      if (item >= 0 && static_cast<size_t>(item) < n_value) {
+        fn(static_cast<size_t>(item));
+      }
+    }
+  };
+  switch (s_value->val_type()) {
+    case executorch_flatbuffer::KernelTypes::TensorList:
+      visit_items(s_value->val_as_TensorList()->items());
+      break;
+    case executorch_flatbuffer::KernelTypes::OptionalTensorList:
+      visit_items(s_value->val_as_OptionalTensorList()->items());
+      break;
+    case executorch_flatbuffer::KernelTypes::IntList:
+      visit_items(s_value->val_as_IntList()->items());
+      break;
+    default:
+      break;
+  }
+}
+
+} // namespace
+
+Error Method::schedule_instructions(const MethodLoadOptions& options) {
+  if (options.max_concurrent_instructions < 2) {
+    return Error::Ok;
+  }
+  auto method_allocator = memory_manager_->method_allocator();
+  // Like resolve_operator(), prefer the temp allocator for scratch memory.
+  auto allocator = memory_manager_->temp_allocator();
+  if (allocator == nullptr || allocator->size() == 0) {
+    allocator = method_allocator;
+  }
+  const auto s_values = serialization_plan_->values();
+
+  size_t n_slots = 0;
+  for (size_t chain_idx = 0; chain_idx < n_chains_; ++chain_idx) {
+    Chain& chain = chains_[chain_idx];
+    const auto s_instructions = chain.s_chain_->instructions();
+    const size_t n_instructions = chain.instructions_.size();
+
+    // Only plain calls can be reordered; jumps, moves and frees depend on
+    // the order of the whole chain.
+    bool supported = true;
+    for (const DecodedInstruction& instruction : chain.instructions_) {
+      supported &= instruction.type ==
+              executorch_flatbuffer::InstructionArguments::KernelCall ||
+          instruction.type ==
+              executorch_flatbuffer::InstructionArguments::DelegateCall;
+    }
+    size_t n_units = 0;
+    size_t n_accesses = 0;
+    for (size_t instr_idx = 0; supported && instr_idx < n_instructions;) {
+      const size_t end_instr_idx =
+          instr_idx + instruction_unit_size(chain.instructions_[instr_idx]);
+      for (; instr_idx < end_instr_idx; ++instr_idx) {
+        for (const int32_t arg :
+             *instruction_arg_indices(*s_instructions->Get(instr_idx))) {
+          for_each_referenced_value(
+              *s_values, n_value_, static_cast<size_t>(arg), [&](size_t) {
+                n_accesses++;
+              });
+        }
+      }
+      n_units++;
+    }
+    if (!supported || n_units < 2) {
+      continue;
+    }
+
+    // Collect what each unit reads and writes. Kernels write their out
+    // arguments, and the ones in kMutatedArgs. Delegates don't say which
+    // arguments are outputs, so they may write anything but a constant
+    // tensor.
+    size_t* unit_instrs = allocator->allocateList<size_t>(n_units);
+    size_t* unit_access_ends = allocator->allocateList<size_t>(n_units);
+    MemoryAccess* accesses = allocator->allocateList<MemoryAccess>(n_accesses);
+    if (unit_instrs == nullptr || unit_access_ends == nullptr ||
+        accesses == nullptr) {
+      ET_LOG(
+          Debug,
+          "Not enough memory to schedule chain %" ET_PRIsize_t,
+          chain_idx);
+      break;
+    }
+    size_t n_filled = 0;
+    for (size_t u = 0, instr_idx = 0; u < n_units; ++u) {
+      unit_instrs[u] = instr_idx;
+      const size_t end_instr_idx =
+          instr_idx + instruction_unit_size(chain.instructions_[instr_idx]);
+      for (; instr_idx < end_instr_idx; ++instr_idx) {
+        const auto& args =
+            *instruction_arg_indices(*s_instructions->Get(instr_idx));
+        const bool is_kernel = chain.instructions_[instr_idx].type ==
+            executorch_flatbuffer::InstructionArguments::KernelCall;
+        size_t first_written = 0;
+        constexpr size_t kTempBufferSizeForName = 100;
+        char operator_name[kTempBufferSizeForName];
+        operator_name[0] = '\0';
+        if (is_kernel) {
+          first_written = first_written_kernel_arg(args);
+          // The op index was checked when the operator was resolved.
+          const auto* op = serialization_plan_->operators()->Get(
+              s_instructions->Get(instr_idx)
+                  ->instr_args_as_KernelCall()
+                  ->op_index());
+          if (populate_operator_name(
+                  op, kTempBufferSizeForName, operator_name) != Error::Ok) {
+            operator_name[0] = '\0';
+          }
+        }
+        for (size_t a = 0; a < args.size(); ++a) {
+          const bool written_arg = !is_kernel || a >= first_written ||
+              is_mutated_arg(operator_name, a);
+          for_each_referenced_value(
+              *s_values,
+              n_value_,
+              static_cast<size_t>(args[a]),
+              [&](size_t index) {
+                const EValue& value = values_[index];
+                const bool constant_tensor = value.isTensor() &&
+                    s_values->Get(index)->val_as_Tensor()->allocation_info() ==
+                        nullptr &&
+                    value.toTensor().const_data_ptr() != nullptr;
+                accesses[n_filled++] =
+                    value_memory(value, written_arg && !constant_tensor);
+              });
+        }
+      }
+      unit_access_ends[u] = n_filled;
+    }
+
+    // Number the distinct ranges in order of their start, and list the other
+    // ranges that each one overlaps. The memory plan reuses buffers across
+    // values, so different values can share bytes.
+    size_t* order = allocator->allocateList<size_t>(n_accesses);
+    size_t* access_ranges = allocator->allocateList<size_t>(n_accesses);
+    if (order == nullptr || access_ranges == nullptr) {
+      ET_LOG(
+          Debug,
+          "Not enough memory to schedule chain %" ET_PRIsize_t,
+          chain_idx);
+      break;
+    }
+    for (size_t a = 0; a < n_accesses; ++a) {
+      order[a] = a;
+    }
+    std::sort(order, order + n_accesses, [&](size_t lhs, size_t rhs) {
+      return accesses[lhs].begin != accesses[rhs].begin
+          ? accesses[lhs].begin < accesses[rhs].begin
+          : accesses[lhs].end < accesses[rhs].end;
+    });
+    size_t n_ranges = 0;
+    for (size_t i = 0; i < n_accesses; ++i) {
+      const MemoryAccess& access = accesses[order[i]];
+      if (i == 0 || access.begin != accesses[order[i - 1]].begin ||
+          access.end != accesses[order[i - 1]].end) {
+        // Reuse `order` for the first access of each range.
+        order[n_ranges++] = order[i];
+      }
+      access_ranges[order[i]] = n_ranges - 1;
+    }
+    const auto range_begin = [&](size_t r) { return accesses[order[r]].begin; };
+    const auto range_end = [&](size_t r) { return accesses[order[r]].end; };
+
+    // The overlaps of range r are overlaps[overlap_begins[r]:
+    // overlap_begins[r + 1]]. Ranges are sorted by start, so the ranges that
+    // overlap r and start after it are the ones that start before r ends.
+    size_t* overlap_begins = allocator->allocateList<size_t>(n_ranges + 1);
+    size_t* write_after = allocator->allocateList<size_t>(n_ranges);
+    size_t* read_after = allocator->allocateList<size_t>(n_ranges);
+    size_t* unit_levels = allocator->allocateList<size_t>(n_units);
+    if (overlap_begins == nullptr || write_after == nullptr ||
+        read_after == nullptr || unit_levels == nullptr) {
+      ET_LOG(
+          Debug,
+          "Not enough memory to schedule chain %" ET_PRIsize_t,
+          chain_idx);
+      break;
+    }
+    memset(overlap_begins, 0, (n_ranges + 1) * sizeof(size_t));
+    for (size_t r = 0; r < n_ranges; ++r) {
+      for (size_t q = r + 1; q < n_ranges && range_begin(q) < range_end(r);
+           ++q) {
+        overlap_begins[r + 1]++;
+        overlap_begins[q + 1]++;
+      }
+    }
+    for (size_t r = 0; r < n_ranges; ++r) {
+      overlap_begins[r + 1] += overlap_begins[r];
+    }
+    size_t* overlaps =
+        allocator->allocateList<size_t>(overlap_begins[n_ranges]);
+    if (overlap_begins[n_ranges] > 0 && overlaps == nullptr) {
+      ET_LOG(
+          Debug,
+          "Not enough memory to schedule chain %" ET_PRIsize_t,
+          chain_idx);
+      break;
+    }
+    // write_after is free until the levels are computed; use it as the fill
+    // position of each list.
+    memcpy(write_after, overlap_begins, n_ranges * sizeof(size_t));
+    for (size_t r = 0; r < n_ranges; ++r) {
+      for (size_t q = r + 1; q < n_ranges && range_begin(q) < range_end(r);
+           ++q) {
+        overlaps[write_after[r]++] = q;
+        overlaps[write_after[q]++] = r;
+      }
+    }
+    memset(write_after, 0, n_ranges * sizeof(size_t));
+    memset(read_after, 0, n_ranges * sizeof(size_t));
+
+    // Put each unit one level after the latest unit it conflicts with: one
+    // that wrote memory it touches, or that read memory it writes.
+    // write_after[r] and read_after[r] hold the first level that may follow
+    // such an access to range r.
+    size_t n_levels = 0;
+    for (size_t u = 0; u < n_units; ++u) {
+      const size_t access_begin = u == 0 ? 0 : unit_access_ends[u - 1];
+      size_t level = 0;
+      for (size_t a = access_begin; a < unit_access_ends[u]; ++a) {
+        const size_t r = access_ranges[a];
+        const auto visit = [&](size_t q) {
+          level = std::max(level, write_after[q]);
+          if (accesses[a].write) {
+            level = std::max(level, read_after[q]);
+          }
+        };
+        visit(r);
+        for (size_t o = overlap_begins[r]; o < overlap_begins[r + 1]; ++o) {
+          visit(overlaps[o]);
+        }
+      }
+      for (size_t a = access_begin; a < unit_access_ends[u]; ++a) {
+        size_t& after = accesses[a].write ? write_after[access_ranges[a]]
+                                          : read_after[access_ranges[a]];
+        after = std::max(after, level + 1);
+      }
+      unit_levels[u] = level;
+      n_levels = std::max(n_levels, level + 1);
+    }
+
+    // Group the units by level, keeping them in order within a level.
+    size_t* level_sizes = allocator->allocateList<size_t>(n_levels);
+    if (level_sizes == nullptr) {
+      ET_LOG(
+          Debug,
+          "Not enough memory to schedule chain %" ET_PRIsize_t,
+          chain_idx);
+      break;
+    }
+    memset(level_sizes, 0, n_levels * sizeof(size_t));
+    size_t max_level_size = 0;
+    for (size_t u = 0; u < n_units; ++u) {
+      max_level_size = std::max(max_level_size, ++level_sizes[unit_levels[u]]);
+    }
+    if (max_level_size < 2) {
+      // Nothing in the chain can run concurrently.
+      continue;
+    }
+    size_t* level_ends = method_allocator->allocateList<size_t>(n_levels);
+    size_t* units = method_allocator->allocateList<size_t>(n_units);
+    ChainSchedule* schedule =
+        method_allocator->allocateInstance<ChainSchedule>();
+    if (level_ends == nullptr || units == nullptr || schedule == nullptr) {
+      ET_LOG(
+          Debug,
+          "Not enough memory to schedule chain %" ET_PRIsize_t,
+          chain_idx);
+      break;
+    }
+    // level_sizes becomes the fill position of each level.
+    size_t level_begin = 0;
+    for (size_t l = 0; l < n_levels; ++l) {
+      level_ends[l] = level_begin + level_sizes[l];
+      level_sizes[l] = level_begin;
+      level_begin = level_ends[l];
+    }
+    for (size_t u = 0; u < n_units; ++u) {
+      units[level_sizes[unit_levels[u]]++] = unit_instrs[u];
+    }
+    new (schedule) ChainSchedule{
+        Span<size_t>(units, n_units), Span<size_t>(level_ends, n_levels)};
+    chain.schedule_ = schedule;
+    n_slots = std::max(
+        n_slots, std::min(max_level_size, options.max_concurrent_instructions));
+  }
+  if (n_slots == 0) {
+    return Error::Ok;
+  }
+  return init_instruction_slots(
+      options.instruction_runner,
+      n_slots,
+      options.instruction_temp_arena_size);
+}
+
+Error Method::init_instruction_slots(
+    TaskRunner* runner,
+    size_t n_slots,
+    size_t temp_arena_size) {
+  auto method_allocator = memory_manager_->method_allocator();
+  // Give each slot its own temp allocator, since the allocators are not
+  // thread safe.
+  ET_CHECK_OR_RETURN_ERROR(
+      temp_arena_size <= UINT32_MAX,
+      InvalidArgument,
+      "Instruction temp arena size %" ET_PRIsize_t " too large",
+      temp_arena_size);
+  // Concurrency is only an optimization, so run every chain in order
+  // rather than failing if the slots don't fit.
+  const auto run_in_order = [&]() {
+    ET_LOG(Debug, "Not enough memory for %" ET_PRIsize_t " slots", n_slots);
+    for (size_t i = 0; i < n_chains_; ++i) {
+      chains_[i].schedule_ = nullptr;
+    }
+    return Error::Ok;
+  };
+  InstructionSlot* slots =
+      method_allocator->allocateList<InstructionSlot>(n_slots);
+  if (slots == nullptr) {
+    return run_in_order();
+  }
+  for (size_t i = 0; i < n_slots; ++i) {
+    MemoryAllocator* temp_allocator = nullptr;
+    if (temp_arena_size > 0) {
+      temp_allocator = method_allocator->allocateInstance<MemoryAllocator>();
+      uint8_t* arena_buffer =
+          static_cast<uint8_t*>(method_allocator->allocate(temp_arena_size));
+      if (temp_allocator == nullptr || arena_buffer == nullptr) {
+        return run_in_order();
+      }
+      new (temp_allocator) MemoryAllocator(
+          static_cast<uint32_t>(temp_arena_size), arena_buffer);
+    } else {
+      auto* platform_allocator =
+          method_allocator->allocateInstance<PlatformMemoryAllocator>();
+      if (platform_allocator == nullptr) {
+        return run_in_order();
+      }
+      new (platform_allocator) PlatformMemoryAllocator();
+      temp_allocator = platform_allocator;
+    }
+    slots[i] = InstructionSlot{temp_allocator, Error::Ok, 0};
+  }
+  instruction_runner_ = runner;
+  n_instruction_slots_ = n_slots;
+  instruction_slots_ = slots;
   return Error::Ok;
 }
 
+Error Method::share_execution_plan(const Method& source) {
+  if (event_tracer_ != nullptr) {
+    // Like a method that is loaded with an event tracer, run and report each
+    // instruction on its own.
+    return Error::Ok;
+  }
+  auto method_allocator = memory_manager_->method_allocator();
+  for (size_t i = 0; i < n_chains_; ++i) {
+    Chain& chain = chains_[i];
+    const Chain& source_chain = source.chains_[i];
+    for (size_t instr_idx = 0; instr_idx < chain.instructions_.size();
+         ++instr_idx) {
+      const DecodedInstruction& source_instruction =
+          source_chain.instructions_[instr_idx];
+      if (source_instruction.type !=
+              executorch_flatbuffer::InstructionArguments::KernelCall ||
+          source_instruction.kernel_call.fused_call == nullptr) {
+        continue;
+      }
+      // Same steps, but over the arguments of this method.
+      const FusedKernelCall& source_call =
+          *source_instruction.kernel_call.fused_call;
+      const size_t num_steps = source_call.steps.size();
+      FusedKernelCall* fused_call =
+          method_allocator->allocateInstance<FusedKernelCall>();
+      FusedElementwiseStep* steps =
+          method_allocator->allocateList<FusedElementwiseStep>(num_steps);
+      if (fused_call == nullptr || steps == nullptr) {
+        return Error::MemoryAllocationFailed;
+      }
+      for (size_t s = 0; s < num_steps; ++s) {
+        steps[s] = FusedElementwiseStep{
+            source_call.steps[s].op,
+            chain.instructions_[instr_idx + s].args,
+            source_call.steps[s].materialize_out};
+      }
+      new (fused_call) FusedKernelCall{
+          source_call.runner,
+          Span<const FusedElementwiseStep>(steps, num_steps)};
+      chain.instructions_[instr_idx].kernel_call.fused_call = fused_call;
+    }
+    // Schedules only hold instruction indices, and the memory plan aliases
+    // the values of the clone the same way as those of the source.
+    chain.schedule_ = source_chain.schedule_;
+  }
+  if (source.n_instruction_slots_ == 0) {
+    return Error::Ok;
+  }
+  // Slot allocators are either arenas or platform allocators, whose size is
+  // 0.
+  return init_instruction_slots(
+      source.instruction_runner_,
+      source.n_instruction_slots_,
+      source.instruction_slots_[0].temp_allocator->size());
+}
+
+namespace {
+
+/**
+ * Logs how long the delegate at `delegate_index` took to initialize, as a
+ * delegate event whose int id is that index. Several delegates of a method may
+ * share a backend, so its name would not tell them apart.
+ */
+void log_delegate_init_time(
+    EventTracer* event_tracer,
+    size_t delegate_index,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time) {
+  // Tracers accept either a name or an int id for a delegate event, not both.
+  event_tracer_log_profiling_delegate(
+      event_tracer,
+      /*name=*/nullptr,
+      static_cast<DebugHandle>(delegate_index),
+      start_time,
+      end_time);
+}
+
+/// A delegate that is initialized as a parallel task.
+struct DelegateInitTask {
+  MemoryAllocator* arena;
+  Error error;
+  et_timestamp_t start_time;
+  et_timestamp_t end_time;
+};
+
+} // namespace
+
+Error Method::init_delegates_in_parallel(
+    const NamedDataMap* named_data_map,
+    const MethodLoadOptions& options) {
+  const auto delegates = serialization_plan_->delegates();
+  const size_t n_delegate = delegates->size();
+  const char* const method_name = serialization_plan_->name()->c_str();
+  auto method_allocator = memory_manager_->method_allocator();
+  ET_CHECK_OR_RETURN_ERROR(
+      options.delegate_init_arena_size <= UINT32_MAX,
+      InvalidArgument,
+      "Delegate init arena size %" ET_PRIsize_t " is too large",
+      options.delegate_init_arena_size);
+
+  // Carve out all arenas before any task starts, in delegate order, so that
+  // the layout of the method allocator does not depend on scheduling.
+  DelegateInitTask* tasks =
+      method_allocator->allocateList<DelegateInitTask>(n_delegate);
+  if (tasks == nullptr) {
+    return Error::MemoryAllocationFailed;
+  }
+  for (size_t i = 0; i < n_delegate; ++i) {
+    MemoryAllocator* arena =
+        method_allocator->allocateInstance<MemoryAllocator>();
+    uint8_t* arena_buffer = static_cast<uint8_t*>(
+        method_allocator->allocate(options.delegate_init_arena_size));
+    if (arena == nullptr || arena_buffer == nullptr) {
+      return Error::MemoryAllocationFailed;
+    }
+    new (arena) MemoryAllocator(
+        static_cast<uint32_t>(options.delegate_init_arena_size), arena_buffer);
+    tasks[i] = DelegateInitTask{arena, Error::Ok, 0, 0};
+  }
+
+  options.delegate_init_runner->run(n_delegate, [&](size_t i) {
+    DelegateInitTask& task = tasks[i];
+    BackendInitContext backend_init_context(
+        task.arena,
+        /*event_tracer=*/nullptr,
+        method_name,
+        named_data_map,
+        /*method_id=*/delegates_);
+    task.start_time = et_pal_current_ticks();
+    task.error = BackendDelegate::Init(
+        *delegates->Get(i), program_, backend_init_context, &delegates_[i]);
+    task.end_time = et_pal_current_ticks();
+  });
+
+  Error error = Error::Ok;
+  for (size_t i = 0; i < n_delegate; ++i) {
+    DelegateInitTask& task = tasks[i];
+    if (error == Error::Ok && task.error == Error::MemoryAllocationFailed) {
+      // The arena was too small. Now that no other task is running, the
+      // delegate can allocate from the method allocator directly.
+      ET_LOG(
+          Info,
+          "Delegate %" ET_PRIsize_t " did not fit in its %" ET_PRIsize_t
+          "-byte init arena, initializing it again",
+          i,
+          options.delegate_init_arena_size);
+      BackendInitContext backend_init_context(
+          method_allocator,
+          /*event_tracer=*/event_tracer_,
+          method_name,
+          named_data_map,
+          /*method_id=*/delegates_);
+      task.start_time = et_pal_current_ticks();
+      task.error = BackendDelegate::Init(
+          *delegates->Get(i), program_, backend_init_context, &delegates_[i]);
+      task.end_time = et_pal_current_ticks();
+    }
+    if (task.error != Error::Ok) {
+      if (error == Error::Ok) {
+        // Entries before this one are valid and cleaned up by ~Method().
+        error = task.error;
+        n_delegate_ = i;
+      }
+    } else if (error != Error::Ok) {
+      // ~Method() won't see entries after the first failure.
+      delegates_[i].~BackendDelegate();
+    } else {
+      log_delegate_init_time(event_tracer_, i, task.start_time, task.end_time);
+    }
+  }
+  if (error == Error::Ok) {
+    n_delegate_ = n_delegate;
+  }
+  return error;
+}
+
 Result<Method> Method::load(
     executorch_flatbuffer::ExecutionPlan* s_plan,
     const Program* program,
     MemoryManager* memory_manager,
     EventTracer* event_tracer,
-    const NamedDataMap* external_data_map) {
+    const NamedDataMap* external_data_map,
+    const MethodLoadOptions& options,
+    const Method* source) {
   MemoryAllocator* temp_allocator = memory_manager->temp_allocator();
   if (temp_allocator == nullptr) {
     PlatformMemoryAllocator* platform_allocator =
@@ -765,7 +1794,7 @@ Result<Method> Method::load(
   }
   Method method(program, memory_manager, event_tracer, temp_allocator);
   ET_LOG(Debug, "Loading method: %s.", s_plan->name()->c_str());
-  Error err = method.init(s_plan, external_data_map);
+  Error err = method.init(s_plan, external_data_map, options, source);
   if (err != Error::Ok) {
     return err;
   } else {
@@ -774,9 +1803,33 @@ Result<Method> Method::load(
   }
 }
 
+Result<Method> Method::clone(
+    MemoryManager* memory_manager,
+    EventTracer* event_tracer,
+    const NamedDataMap* named_data_map) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Method must be initialized before it can be cloned.");
+  ET_CHECK_OR_RETURN_ERROR(
+      memory_manager != memory_manager_,
+      InvalidArgument,
+      "A clone needs a MemoryManager of its own.");
+  return load(
+      serialization_plan_,
+      program_,
+      memory_manager,
+      event_tracer,
+      named_data_map,
+      MethodLoadOptions(),
+      this);
+}
+
 Error Method::init(
     executorch_flatbuffer::ExecutionPlan* s_plan,
-    const NamedDataMap* external_data_map) {
+    const NamedDataMap* external_data_map,
+    const MethodLoadOptions& options,
+    const Method* source) {
   EXECUTORCH_SCOPE_PROF("Method::init");
   internal::EventTracerProfileMethodScope event_tracer_profile_scope =
       internal::EventTracerProfileMethodScope(event_tracer_, "Method::init");
@@ -793,7 +1846,7 @@ Error Method::init(
 
   {
     // Parse the elements of the values_ array.
-    Error err = parse_values(external_data_map);
+    Error err = parse_values(external_data_map, source);
     if (err != Error::Ok) {
       return err;
     }
@@ -845,18 +1898,37 @@ Error Method::init(
     // makes it safe for errors to return without updating any state.
     n_delegate_ = 0;
 
-    for (size_t i = 0; i < n_delegate; ++i) {
+    if (options.delegate_init_runner != nullptr && n_delegate > 0 &&
+        source == nullptr) {
+      Error err = init_delegates_in_parallel(named_data_map, options);
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+
+    for (size_t i = n_delegate_; i < n_delegate; ++i) {
       const auto& delegate = *delegates->Get(i);
       BackendInitContext backend_init_context(
           method_allocator,
           /*event_tracer=*/event_tracer_,
           /*method_name=*/serialization_plan_->name()->c_str(),
-          /*named_data_map=*/named_data_map);
-      Error err = BackendDelegate::Init(
-          delegate, program_, backend_init_context, &delegates_[i]);
+          /*named_data_map=*/named_data_map,
+          /*method_id=*/delegates_);
+      const et_timestamp_t start_time = et_pal_current_ticks();
+      Error err = source != nullptr
+          ? BackendDelegate::Clone(
+                source->delegates_[i],
+                delegate,
+                program_,
+                backend_init_context,
+                &delegates_[i])
+          : BackendDelegate::Init(
+                delegate, program_, backend_init_context, &delegates_[i]);
       if (err != Error::Ok) {
         return err;
       }
+      log_delegate_init_time(
+          event_tracer_, i, start_time, et_pal_current_ticks());
       // ~Method() will try to clean up n_delegate_ entries in the delegates_
       // array. Only increment this once we know the entry is valid, so that
       // we don't try to clean up an uninitialized entry.
@@ -888,19 +1960,15 @@ Error Method::init(
           "Missing instructions in chain %" ET_PRIsize_t,
           i);
       auto num_instructions = s_instructions->size();
-      auto chain_instruction_kernels =
-          method_allocator->allocateList<OpFunction>(num_instructions);
-      if (chain_instruction_kernels == nullptr) {
-        return Error::MemoryAllocationFailed;
-      }
-      auto chain_instruction_arg_lists =
-          method_allocator->allocateList<InstructionArgs>(num_instructions);
-      if (chain_instruction_arg_lists == nullptr) {
+      auto decoded_instructions =
+          method_allocator->allocateList<DecodedInstruction>(num_instructions);
+      if (decoded_instructions == nullptr) {
         return Error::MemoryAllocationFailed;
       }
 
-      // Set up the argument lists ahead of time and store pointers to them to
-      // use when the instructions are called
+      // Decode each instruction ahead of time, resolving its kernel, its
+      // argument list and any indices it holds, so that executing it does not
+      // need to read the flatbuffer again.
       for (size_t instr_idx = 0; instr_idx < s_instructions->size();
            ++instr_idx) {
         const auto instruction = s_instructions->Get(instr_idx);
@@ -911,6 +1979,9 @@ Error Method::init(
             "Null instruction at index %" ET_PRIsize_t,
             instr_idx);
 
+        DecodedInstruction& decoded = decoded_instructions[instr_idx];
+        decoded.type = instruction->instr_args_type();
+        decoded.args = InstructionArgs();
         const void* instr_args = instruction->instr_args();
         switch (instruction->instr_args_type()) {
           case executorch_flatbuffer::InstructionArguments::KernelCall: {
@@ -929,11 +2000,20 @@ Error Method::init(
             if (!res.ok()) {
               return res.error();
             }
-            chain_instruction_arg_lists[instr_idx] = res.get();
+            decoded.args = res.get();
+            decoded.kernel_call = DecodedInstruction::KernelCall{
+                /*kernel=*/nullptr, /*fused_call=*/nullptr};
+            if (source != nullptr) {
+              // The source resolved the same operator for arguments of the
+              // same types.
+              decoded.kernel_call.kernel = source->chains_[i]
+                                               .instructions_[instr_idx]
+                                               .kernel_call.kernel;
+              break;
+            }
             auto err = resolve_operator(
                 instr_args_as_KernelCall->op_index(),
-                chain_instruction_kernels,
-                instr_idx,
+                &decoded.kernel_call.kernel,
                 res.get(),
                 arg_idxs->size());
             if (err == Error::OperatorMissing) {
@@ -945,10 +2025,10 @@ Error Method::init(
             }
           } break;
           case executorch_flatbuffer::InstructionArguments::DelegateCall: {
-            const auto arg_idxs =
+            const auto* instr_args_as_DelegateCall =
                 static_cast<const executorch_flatbuffer::DelegateCall*>(
-                    instr_args)
-                    ->args();
+                    instr_args);
+            const auto arg_idxs = instr_args_as_DelegateCall->args();
             ET_CHECK_OR_RETURN_ERROR(
                 arg_idxs != nullptr,
                 InvalidProgram,
@@ -962,32 +2042,74 @@ Error Method::init(
             if (!res.ok()) {
               return res.error();
             }
-            chain_instruction_arg_lists[instr_idx] = res.get();
+            decoded.args = res.get();
+            const auto delegate_idx =
+                instr_args_as_DelegateCall->delegate_index();
+            ET_CHECK_OR_RETURN_ERROR(
+                static_cast<size_t>(delegate_idx) < n_delegate_,
+                InvalidProgram,
+                "DELEGATE_CALL index %" PRIu32 " >= num delegates %" ET_PRIsize_t
+                " at instruction %" ET_PRIsize_t,
+                delegate_idx,
+                n_delegate_,
+                instr_idx);
+            decoded.delegate = &delegates_[delegate_idx];
           } break;
           case executorch_flatbuffer::InstructionArguments::JumpFalseCall: {
             // Validate the index at load time so we can trust it during
             // execution.
-            auto index =
+            const auto* jf_call =
                 static_cast<const executorch_flatbuffer::JumpFalseCall*>(
-                    instr_args)
-                    ->cond_value_index();
+                    instr_args);
+            auto index = jf_call->cond_value_index();
             ET_CHECK_OR_RETURN_ERROR(
                 index >= 0 && static_cast<size_t>(index) < n_value_,
                 InvalidProgram,
                 "Index %zd negative or >= %" ET_PRIsize_t,
                 static_cast<ssize_t>(index),
                 n_value_);
-            chain_instruction_arg_lists[instr_idx] = InstructionArgs();
+            decoded.jump_false_call = DecodedInstruction::JumpFalseCall{
+                &values_[index],
+                static_cast<size_t>(jf_call->destination_instruction())};
           } break;
-          default: {
-            chain_instruction_arg_lists[instr_idx] = InstructionArgs();
+          case executorch_flatbuffer::InstructionArguments::MoveCall: {
+            const auto* move_call =
+                static_cast<const executorch_flatbuffer::MoveCall*>(
+                    instr_args);
+            const auto move_from = move_call->move_from();
+            const auto move_to = move_call->move_to();
+            ET_CHECK_OR_RETURN_ERROR(
+                move_from >= 0 && static_cast<size_t>(move_from) < n_value_ &&
+                    move_to >= 0 && static_cast<size_t>(move_to) < n_value_,
+                InvalidProgram,
+                "MoveCall index %zd or %zd negative or >= %" ET_PRIsize_t,
+                static_cast<ssize_t>(move_from),
+                static_cast<ssize_t>(move_to),
+                n_value_);
+            decoded.move_call = DecodedInstruction::MoveCall{
+                &values_[move_from], &values_[move_to]};
           } break;
+          case executorch_flatbuffer::InstructionArguments::FreeCall: {
+            const auto index =
+                static_cast<const executorch_flatbuffer::FreeCall*>(instr_args)
+                    ->value_index();
+            ET_CHECK_OR_RETURN_ERROR(
+                index >= 0 && static_cast<size_t>(index) < n_value_,
+                InvalidProgram,
+                "FreeCall index %zd negative or >= %" ET_PRIsize_t,
+                static_cast<ssize_t>(index),
+                n_value_);
+            decoded.free_value = &values_[index];
+          } break;
+          default:
+            // Unknown instructions fail when they are executed.
+            break;
         }
       }
       chains_[i] = Chain{
           s_chain,
-          Span<InstructionArgs>(chain_instruction_arg_lists, num_instructions),
-          chain_instruction_kernels,
+          Span<DecodedInstruction>(decoded_instructions, num_instructions),
+          /*schedule_=*/nullptr,
       };
     }
     ET_CHECK_OR_RETURN_ERROR(
@@ -1001,6 +2123,40 @@ Error Method::init(
     }
   }
 
+  if (source != nullptr) {
+    // A clone reuses the fused calls and schedules of its source instead of
+    // building them again.
+    Error err = share_execution_plan(*source);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+
+  {
+    // Kernel events and intermediate outputs are reported per instruction,
+    // so only fuse when nobody is tracing.
+    if (options.fuse_elementwise_kernels && event_tracer_ == nullptr &&
+        source == nullptr) {
+      Error err = fuse_elementwise_kernels();
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+  }
+
+#ifndef PROFILING_ENABLED
+  {
+    // Instructions would log to the event tracer and the profiler from
+    // several threads at once, so only schedule them when neither is in use.
+    if (options.instruction_runner != nullptr && event_tracer_ == nullptr) {
+      Error err = schedule_instructions(options);
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+  }
+#endif
+
   step_state_ = StepState{0, 0};
 
   init_state_ = InitializationState::Initialized;
@@ -1303,43 +2459,88 @@ ET_NODISCARD Error Method::get_inputs(EValue* input_evalues, size_t length) {
 
 Error Method::execute_instruction() {
   auto& chain = chains_[step_state_.chain_idx];
-  auto instructions = chain.s_chain_->instructions();
 
   ET_CHECK_OR_RETURN_ERROR(
-      step_state_.instr_idx < instructions->size(),
+      step_state_.instr_idx < chain.instructions_.size(),
       Internal,
       "Instr index %" ET_PRIsize_t " >= chain[%" ET_PRIsize_t
       "] instr count %" ET_PRIsize_t,
       step_state_.instr_idx,
       step_state_.chain_idx,
-      (size_t)instructions->size());
+      chain.instructions_.size());
 
-  auto instruction = instructions->Get(step_state_.instr_idx);
   size_t next_instr_idx = step_state_.instr_idx + 1;
+  Error err = execute_instruction_at(
+      step_state_.chain_idx,
+      step_state_.instr_idx,
+      temp_allocator_,
+      &next_instr_idx);
+  // Reset the temp allocator for every instruction.
+  if (temp_allocator_ != nullptr) {
+    temp_allocator_->reset();
+  }
+  if (err == Error::Ok) {
+    step_state_.instr_idx = next_instr_idx;
+  }
+  return err;
+}
+
+Error Method::execute_instruction_at(
+    size_t chain_idx,
+    size_t instr_idx,
+    MemoryAllocator* temp_allocator,
+    size_t* next_instr_idx) {
+  const DecodedInstruction& instruction =
+      chains_[chain_idx].instructions_[instr_idx];
+  *next_instr_idx = instr_idx + 1;
   Error err = Error::Ok;
 
-  switch (instruction->instr_args_type()) {
+  switch (instruction.type) {
     case executorch_flatbuffer::InstructionArguments::KernelCall: {
       EXECUTORCH_SCOPE_PROF("OPERATOR_CALL");
       internal::EventTracerProfileOpScope event_tracer_op_scope =
           internal::EventTracerProfileOpScope(event_tracer_, "OPERATOR_CALL");
       // TODO(T147221312): Also expose tensor resizer via the context.
-      KernelRuntimeContext context(event_tracer_, temp_allocator_);
-      auto args = chain.argument_lists_[step_state_.instr_idx];
-      chain.kernels_[step_state_.instr_idx](context, args);
-      // We reset the temp_allocator after the switch statement
+      KernelRuntimeContext context(event_tracer_, temp_allocator);
+      const FusedKernelCall* fused_call = instruction.kernel_call.fused_call;
+      if (fused_call != nullptr) {
+        err = fused_call->runner(context, fused_call->steps);
+        if (err == Error::Ok) {
+          *next_instr_idx = instr_idx + fused_call->steps.size();
+          break;
+        }
+        if (err != Error::NotSupported) {
+          ET_LOG(
+              Error,
+              "Fused KernelCall failed at instruction %" ET_PRIsize_t
+              ":%" ET_PRIsize_t ": 0x%x",
+              chain_idx,
+              instr_idx,
+              (unsigned int)err);
+          break;
+        }
+        // The arguments can't run fused this time, e.g. because of dynamic
+        // shapes. Run the kernels one at a time instead.
+        err = Error::Ok;
+      }
+      auto args = instruction.args;
+      instruction.kernel_call.kernel(context, args);
+      // The caller resets the temp allocator.
       err = context.failure_state();
       if (err != Error::Ok) {
-        // We know that instr_args_as_KernelCall is non-null because it was
-        // checked at init time.
-        auto op_index = instruction->instr_args_as_KernelCall()->op_index();
+        // Only the failure path goes back to the flatbuffer, for the name of
+        // the operator. The instruction was checked at init time.
+        auto op_index = chains_[chain_idx].s_chain_->instructions()
+                            ->Get(instr_idx)
+                            ->instr_args_as_KernelCall()
+                            ->op_index();
         ET_UNUSED auto op = serialization_plan_->operators()->Get(op_index);
         ET_LOG(
             Error,
             "KernelCall failed at instruction %" ET_PRIsize_t ":%" ET_PRIsize_t
             " in operator %s.%s: 0x%x",
-            step_state_.chain_idx,
-            step_state_.instr_idx,
+            chain_idx,
+            instr_idx,
             op->name()->c_str(),
             op->overload()->c_str(),
             (unsigned int)err);
@@ -1359,31 +2560,19 @@ Error Method::execute_instruction() {
       EXECUTORCH_SCOPE_PROF("DELEGATE_CALL");
       internal::EventTracerProfileOpScope event_tracer_op_scope =
           internal::EventTracerProfileOpScope(event_tracer_, "DELEGATE_CALL");
-      // We know that instr_args_as_DelegateCall is non-null because it was
-      // checked at init time.
-      auto delegate_idx =
-          instruction->instr_args_as_DelegateCall()->delegate_index();
-      ET_CHECK_OR_RETURN_ERROR(
-          static_cast<size_t>(delegate_idx) < n_delegate_,
-          Internal,
-          "DELEGATE_CALL index %" PRIu32 " >= num delegates %" ET_PRIsize_t
-          " at instruction %" ET_PRIsize_t,
-          delegate_idx,
-          n_delegate_,
-          step_state_.instr_idx);
       BackendExecutionContext backend_execution_context(
           /*event_tracer=*/event_tracer_,
-          /*temp_allocator=*/temp_allocator_,
+          /*temp_allocator=*/temp_allocator,
           /*method_name=*/serialization_plan_->name()->c_str());
-      err = delegates_[delegate_idx].Execute(
-          backend_execution_context,
-          chain.argument_lists_[step_state_.instr_idx].data());
+      // The delegate index was checked at init time.
+      err = instruction.delegate->Execute(
+          backend_execution_context, instruction.args.data());
       if (err != Error::Ok) {
         ET_LOG(
             Error,
             "CALL_DELEGATE execute failed at instruction %" ET_PRIsize_t
             ": 0x%" PRIx32,
-            step_state_.instr_idx,
+            instr_idx,
             static_cast<uint32_t>(err));
       }
 
@@ -1393,10 +2582,8 @@ Error Method::execute_instruction() {
       // log everything. This will be changed in the future when the inputs and
       // ouputs are separate lists.
 #ifdef ET_EVENT_TRACER_ENABLED
-      for (size_t i = 0;
-           i < chain.argument_lists_[step_state_.instr_idx].size();
-           i++) {
-        EValue* arg = chain.argument_lists_[step_state_.instr_idx].data()[i];
+      for (size_t i = 0; i < instruction.args.size(); i++) {
+        EValue* arg = instruction.args.data()[i];
         internal::event_tracer_log_evalue(event_tracer_, *arg);
       }
 #endif
@@ -1405,16 +2592,12 @@ Error Method::execute_instruction() {
       EXECUTORCH_SCOPE_PROF("JF_CALL");
       internal::EventTracerProfileOpScope event_tracer_op_scope =
           internal::EventTracerProfileOpScope(event_tracer_, "JF_CALL");
-      // We know that instr_args_as_JumpFalseCall is non-null because it was
-      // checked at init time.
-      auto jf_call = instruction->instr_args_as_JumpFalseCall();
-      // We know that index is a valid values_ index because it was checked at
-      // init time.
-      auto index = jf_call->cond_value_index();
-      Result<bool> jf_result = parse_cond_value(values_[index]);
+      // The condition value index was checked at init time.
+      const auto& jf_call = instruction.jump_false_call;
+      Result<bool> jf_result = parse_cond_value(*jf_call.cond_value);
       if (jf_result.ok()) {
         if (!jf_result.get()) {
-          next_instr_idx = jf_call->destination_instruction();
+          *next_instr_idx = jf_call.destination_instruction;
         }
       } else {
         err = jf_result.error();
@@ -1424,36 +2607,88 @@ Error Method::execute_instruction() {
       EXECUTORCH_SCOPE_PROF("MOVE_CALL");
       internal::EventTracerProfileOpScope event_tracer_op_scope =
           internal::EventTracerProfileOpScope(event_tracer_, "MOVE_CALL");
-      // We know that instr_args_as_MoveCall is non-null because it was checked
-      // at init time.
-      auto move_call = instruction->instr_args_as_MoveCall();
-      mutable_value(move_call->move_to()) = get_value(move_call->move_from());
+      // The value indices were checked at init time.
+      *instruction.move_call.move_to = *instruction.move_call.move_from;
     } break;
     case executorch_flatbuffer::InstructionArguments::FreeCall: {
       EXECUTORCH_SCOPE_PROF("FREE_CALL");
       internal::EventTracerProfileOpScope event_tracer_op_scope =
           internal::EventTracerProfileOpScope(event_tracer_, "FREE_CALL");
-      // We know that instr_args_as_FreeCall is non-null because it was checked
-      // at init time.
-      auto free_call = instruction->instr_args_as_FreeCall();
-      auto t = values_[free_call->value_index()].toTensor();
+      // The value index was checked at init time.
+      auto t = instruction.free_value->toTensor();
       internal::reset_data_ptr(t);
     } break;
     default:
       ET_LOG(
           Error,
           "Unknown instruction: %hhu",
-          static_cast<uint8_t>(instruction->instr_args_type()));
+          static_cast<uint8_t>(instruction.type));
       err = Error::InvalidProgram;
   }
-  // Reset the temp allocator for every instruction.
-  if (temp_allocator_ != nullptr) {
-    temp_allocator_->reset();
+  return err;
+}
+
+Error Method::execute_instruction_unit(
+    size_t chain_idx,
+    size_t instr_idx,
+    MemoryAllocator* temp_allocator) {
+  const size_t end_instr_idx = instr_idx +
+      instruction_unit_size(chains_[chain_idx].instructions_[instr_idx]);
+  while (instr_idx < end_instr_idx) {
+    size_t next_instr_idx = instr_idx + 1;
+    Error err = execute_instruction_at(
+        chain_idx, instr_idx, temp_allocator, &next_instr_idx);
+    temp_allocator->reset();
+    if (err != Error::Ok) {
+      return err;
+    }
+    instr_idx = next_instr_idx;
   }
-  if (err == Error::Ok) {
-    step_state_.instr_idx = next_instr_idx;
+  return Error::Ok;
+}
+
+Error Method::execute_scheduled_chain(size_t chain_idx) {
+  const ChainSchedule& schedule = *chains_[chain_idx].schedule_;
+  size_t level_begin = 0;
+  for (const size_t level_end : schedule.level_ends) {
+    const size_t* units = schedule.units.data() + level_begin;
+    const size_t n_units = level_end - level_begin;
+    level_begin = level_end;
+
+    if (n_units == 1) {
+      // Not worth a trip to the runner.
+      step_state_.instr_idx = units[0];
+      Error err = execute_instruction_unit(chain_idx, units[0], temp_allocator_);
+      if (err != Error::Ok) {
+        return err;
+      }
+      continue;
+    }
+
+    // Each task runs every n_tasks-th unit of the level in its own slot.
+    const size_t n_tasks = std::min(n_units, n_instruction_slots_);
+    instruction_runner_->run(n_tasks, [&](size_t task) {
+      InstructionSlot& slot = instruction_slots_[task];
+      slot.error = Error::Ok;
+      for (size_t u = task; u < n_units; u += n_tasks) {
+        slot.error =
+            execute_instruction_unit(chain_idx, units[u], slot.temp_allocator);
+        if (slot.error != Error::Ok) {
+          slot.error_instr_idx = units[u];
+          break;
+        }
+      }
+    });
+    for (size_t task = 0; task < n_tasks; ++task) {
+      const InstructionSlot& slot = instruction_slots_[task];
+      if (slot.error != Error::Ok) {
+        step_state_.instr_idx = slot.error_instr_idx;
+        return slot.error;
+      }
+    }
   }
-  return err;
+  step_state_.instr_idx = chains_[chain_idx].instructions_.size();
+  return Error::Ok;
 }
 
 Error Method::reset_execution() {
@@ -1506,8 +2741,7 @@ Error Method::step() {
     return Error::EndOfMethod;
   }
 
-  auto num_instructions =
-      chains_[step_state_.chain_idx].s_chain_->instructions()->size();
+  auto num_instructions = chains_[step_state_.chain_idx].instructions_.size();
 
   // Special case chains with no instructions. These appear for example in a
   // model that just returns the input/a constant.
@@ -1547,21 +2781,27 @@ Error Method::execute() {
       "Cannot execute until method has been initialized.");
   ET_LOG(Debug, "Executing method: %s.", method_meta().name());
 
-  // Chains are executed sequentially today, but future async designs may
-  // branch and run many in parallel or out of order.
+  // Chains are executed sequentially. The instructions of a chain run in
+  // order too, unless the chain was scheduled to run some of them
+  // concurrently.
   for (step_state_.chain_idx = 0; step_state_.chain_idx < n_chains_;
        ++step_state_.chain_idx) {
-    Chain& chain = chains_[step_state_.chain_idx];
-    auto instructions = chain.s_chain_->instructions();
-    ET_CHECK_OR_RETURN_ERROR(
-        instructions != nullptr,
-        Internal,
-        "chain %" ET_PRIsize_t " has no instructions field",
-        step_state_.chain_idx);
+    if (chains_[step_state_.chain_idx].schedule_ != nullptr) {
+      auto status = execute_scheduled_chain(step_state_.chain_idx);
+      if (status != Error::Ok) {
+        return status;
+      }
+      continue;
+    }
+
+    // The instructions were decoded at init time, so the loop only needs
+    // their count.
+    const size_t num_instructions =
+        chains_[step_state_.chain_idx].instructions_.size();
 
     // Loop over instructions
     step_state_.instr_idx = 0;
-    while (step_state_.instr_idx < chain.s_chain_->instructions()->size()) {
+    while (step_state_.instr_idx < num_instructions) {
       EXECUTORCH_PROFILE_INSTRUCTION_SCOPE(
           static_cast<int32_t>(step_state_.chain_idx),
           static_cast<uint32_t>(step_state_.instr_idx));
@@ -21,6 +21,7 @@
 #include <executorch/runtime/core/span.h>
 #include <executorch/runtime/executor/memory_manager.h>
 #include <executorch/runtime/executor/merged_data_map.h>
+#include <executorch/runtime/executor/method_load_options.h>
 #include <executorch/runtime/executor/method_meta.h>
 #include <executorch/runtime/platform/compiler.h>
 
@@ -47,6 +48,7 @@ class Program;
 // Forward declare internal types.
 class BackendDelegate;
 struct Chain;
+struct InstructionSlot;
 class KernelRuntimeContext;
 using OpFunction = void (*)(KernelRuntimeContext&, Span<EValue*>);
 /// A list of pointers into the master values table that together compose the
@@ -77,6 +79,9 @@ class Method final {
         delegates_(rhs.delegates_),
         n_chains_(rhs.n_chains_),
         chains_(rhs.chains_),
+        instruction_runner_(rhs.instruction_runner_),
+        n_instruction_slots_(rhs.n_instruction_slots_),
+        instruction_slots_(rhs.instruction_slots_),
         merged_data_map_(std::move(rhs.merged_data_map_)),
         external_constants_(rhs.external_constants_),
         n_external_constants_(rhs.n_external_constants_),
@@ -102,6 +107,9 @@ class Method final {
     rhs.event_tracer_ = nullptr;
     rhs.n_chains_ = 0;
     rhs.chains_ = nullptr;
+    rhs.instruction_runner_ = nullptr;
+    rhs.n_instruction_slots_ = 0;
+    rhs.instruction_slots_ = nullptr;
   }
 
   /**
@@ -244,6 +252,35 @@ class Method final {
   /// DEPRECATED: Use `reset_execution()` instead.
   ET_DEPRECATED ET_NODISCARD Error experimental_reset_execution();
 
+  /**
+   * EXPERIMENTAL: Creates another instance of this method, e.g. to serve
+   * several requests at the same time, that is much cheaper to create than
+   * loading the method again.
+   *
+   * The clone shares the constant tensors, the resolved kernels and the
+   * execution plan of this method, so its memory_manager only needs room for
+   * its planned memory and its own values. Mutable state, like memory-planned
+   * buffers and tensors whose data is set at runtime, starts out the same as
+   * in a freshly loaded method. Backends can share compiled delegates with
+   * the clone (see `BackendInterface::clone()`); other delegates are
+   * initialized again.
+   *
+   * The clone and this method may execute at the same time, on different
+   * threads, as long as the kernels and backends they call allow it.
+   *
+   * @param[in] memory_manager The allocators of the clone. Its planned memory
+   *     must not overlap with that of this method or of other clones.
+   * @param[in] event_tracer The event tracer of the clone, if any.
+   * @param[in] named_data_map The external data that this method was loaded
+   *     with, if any.
+   *
+   * @returns The clone, which must not outlive this method.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Result<Method> clone(
+      MemoryManager* memory_manager,
+      EventTracer* event_tracer = nullptr,
+      const NamedDataMap* named_data_map = nullptr) const;
+
   /**
    * Returns the MethodMeta that corresponds to the calling Method.
    */
@@ -318,27 +355,35 @@ class Method final {
         delegates_(nullptr),
         n_chains_(0),
         chains_(nullptr),
+        instruction_runner_(nullptr),
+        n_instruction_slots_(0),
+        instruction_slots_(nullptr),
         merged_data_map_(nullptr),
         external_constants_(nullptr),
         n_external_constants_(0),
         init_state_(InitializationState::Uninitialized) {}
 
-  /// Static factory used by Program.
+  /// Static factory used by Program and clone().
   ET_NODISCARD static Result<Method> load(
       executorch_flatbuffer::ExecutionPlan* s_plan,
       const Program* program,
       MemoryManager* memory_manager,
       EventTracer* event_tracer,
-      const NamedDataMap* named_data_map);
+      const NamedDataMap* named_data_map,
+      const MethodLoadOptions& options,
+      const Method* source = nullptr);
 
   /**
-   * Initialize the method from its serialized representation.
+   * Initialize the method from its serialized representation. If `source` is
+   * not null, the method becomes a clone of it: see clone().
    *
    * @returns Error::Ok on success, non-Ok on failure.
    */
   ET_NODISCARD Error init(
       executorch_flatbuffer::ExecutionPlan* s_plan,
-      const NamedDataMap* named_data_map);
+      const NamedDataMap* named_data_map,
+      const MethodLoadOptions& options,
+      const Method* source = nullptr);
 
   /// Returns true if the Method was successfully initialized.
   inline bool initialized() const {
@@ -353,6 +398,33 @@ class Method final {
   // Executes a single instruction using the state in step_state_
   ET_NODISCARD Error execute_instruction();
 
+  /**
+   * Executes the instruction at `instr_idx` of chain `chain_idx` without
+   * touching step_state_, allocating temp memory from `temp_allocator`.
+   * Does not reset `temp_allocator`. On success, sets `*next_instr_idx` to
+   * the index of the instruction to execute next.
+   */
+  ET_NODISCARD Error execute_instruction_at(
+      size_t chain_idx,
+      size_t instr_idx,
+      MemoryAllocator* temp_allocator,
+      size_t* next_instr_idx);
+
+  /**
+   * Executes the fused run or single instruction that starts at `instr_idx`
+   * of chain `chain_idx`, resetting `temp_allocator` after each instruction.
+   */
+  ET_NODISCARD Error execute_instruction_unit(
+      size_t chain_idx,
+      size_t instr_idx,
+      MemoryAllocator* temp_allocator);
+
+  /**
+   * Executes chain `chain_idx` level by level following its schedule,
+   * running the units of each level concurrently on instruction_runner_.
+   */
+  ET_NODISCARD Error execute_scheduled_chain(size_t chain_idx);
+
   StepState step_state_;
   const Program* program_;
   MemoryManager* memory_manager_;
@@ -369,6 +441,10 @@ class Method final {
   size_t n_chains_;
   Chain* chains_;
 
+  TaskRunner* instruction_runner_;
+  size_t n_instruction_slots_;
+  InstructionSlot* instruction_slots_;
+
   internal::MergedDataMap* merged_data_map_;
   NamedData* external_constants_;
   size_t n_external_constants_ = 0;
@@ -398,17 +474,61 @@ class Method final {
   /**
    * Parses the elements of the values_ array. On error, n_value_ will be set to
    * the number of successfully-initialized entries so that ~Method doesn't try
-   * to clean up uninitialized entries.
+   * to clean up uninitialized entries. If `source` is not null, constant
+   * tensors are shared with it instead of being parsed again.
+   */
+  ET_NODISCARD Error parse_values(
+      const NamedDataMap* named_data_map,
+      const Method* source = nullptr);
+
+  /**
+   * Initializes all delegates_ as independent tasks on
+   * `options.delegate_init_runner`, each allocating from its own arena. On
+   * error, n_delegate_ is set to the number of leading entries that were
+   * initialized, and any later entries that were initialized are destroyed.
    */
-  ET_NODISCARD Error parse_values(const NamedDataMap* named_data_map);
+  ET_NODISCARD Error init_delegates_in_parallel(
+      const NamedDataMap* named_data_map,
+      const MethodLoadOptions& options);
 
   ET_NODISCARD Error resolve_operator(
       int32_t op_index,
-      OpFunction* kernels,
-      size_t kernel_index,
+      OpFunction* kernel,
       InstructionArgs args,
       size_t n_args);
 
+  /**
+   * Replaces runs of consecutive fusible elementwise KernelCalls with fused
+   * calls that make one pass over their elements. Outputs that only feed later
+   * steps of the same run are not written.
+   */
+  ET_NODISCARD Error fuse_elementwise_kernels();
+
+  /**
+   * Builds a schedule for each chain that can run some of its instructions
+   * concurrently on `options.instruction_runner`, and sets up the slots that
+   * those instructions run in. Chains that gain nothing, or that there
+   * isn't enough memory to schedule, keep running in order.
+   */
+  ET_NODISCARD Error schedule_instructions(const MethodLoadOptions& options);
+
+  /**
+   * Sets up `n_slots` slots for instructions that run concurrently on
+   * `runner`, each with a temp arena of `temp_arena_size` bytes, or with the
+   * platform allocator if it is 0. If they don't fit in the method allocator,
+   * every chain runs in order instead.
+   */
+  ET_NODISCARD Error init_instruction_slots(
+      TaskRunner* runner,
+      size_t n_slots,
+      size_t temp_arena_size);
+
+  /**
+   * Gives the chains of this clone the fused calls and schedules of the same
+   * chains of `source`, pointing at the values of this method.
+   */
+  ET_NODISCARD Error share_execution_plan(const Method& source);
+
   void log_outputs();
 };
 
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <executorch/runtime/core/task_runner.h>
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * Optional behavior for `Program::load_method()`. The defaults load a method
+ * the same way as when no options are given.
+ */
+struct MethodLoadOptions {
+  /**
+   * If not null, the backend delegates of the method are initialized as
+   * independent tasks on this runner instead of one after the other on the
+   * calling thread.
+   *
+   * Backends, the DataLoader of the Program and the NamedDataMap must then
+   * support being called from several threads at once. Backends do not get an
+   * EventTracer during a parallel init, since EventTracers are not thread
+   * safe; the time that each delegate took to initialize is still logged.
+   *
+   * Backends may still serialize part of their init. For example, XNNPACK
+   * delegates that share a workspace create their runtimes, which packs their
+   * weights, one at a time, and with the XNNPACK weights cache enabled every
+   * XNNPACK delegate compiles one at a time. Use
+   * `WorkspaceSharingMode::Disabled` to let XNNPACK delegates of a method
+   * initialize fully in parallel.
+   */
+  TaskRunner* delegate_init_runner = nullptr;
+
+  /**
+   * When delegates are initialized in parallel, each one allocates from its
+   * own arena of this many bytes, which is carved out of the method allocator
+   * in delegate order before any of them starts. This keeps allocations
+   * deterministic, but unused arena space is not returned to the method
+   * allocator. A delegate that runs out of space in its arena is initialized
+   * again on the calling thread once the parallel tasks are done.
+   */
+  size_t delegate_init_arena_size = 16 * 1024;
+
+  /**
+   * If true, runs of consecutive elementwise kernels, where each reads the
+   * output of an earlier one, are fused into a single loop over their
+   * elements. Intermediates that only the run reads are then never written
+   * to memory.
+   *
+   * Only kernels that registered a fusible block function are fused, and only
+   * when the instruction resolved to that same kernel. Nothing is fused while
+   * the method has an EventTracer, since kernel events and intermediate
+   * outputs are reported per instruction.
+   */
+  bool fuse_elementwise_kernels = false;
+
+  /**
+   * If not null, `Method::execute()` runs instructions that do not depend on
+   * each other at the same time, as tasks on this runner. `Method::step()`
+   * still runs one instruction at a time.
+   *
+   * Dependencies are found when the method is loaded, from the arguments that
+   * instructions share and from the memory that the memory plan reuses across
+   * values, so instructions never race on aliased buffers. A kernel is
+   * assumed to write only its out arguments, plus the inputs that a few known
+   * kernels update in place, like the cache of llama::update_cache.out; a
+   * kernel that updates any other input in place must not be used with this
+   * option. A delegate is assumed to write all of its non-constant arguments,
+   * since it doesn't mark its outputs. Chains with control flow, moves or
+   * frees run in order as usual.
+   *
+   * Kernels and backends must then support being called from several threads
+   * at once. Instructions only run concurrently when the method has no
+   * EventTracer and profiling is not compiled in, since neither is thread
+   * safe.
+   */
+  TaskRunner* instruction_runner = nullptr;
+
+  /**
+   * The most instructions that `instruction_runner` runs at the same time.
+   * Each of them gets its own temp allocator.
+   */
+  size_t max_concurrent_instructions = 4;
+
+  /**
+   * If not 0, each instruction that runs concurrently with others allocates
+   * temp memory from its own arena of this many bytes, carved out of the
+   * method allocator when the method is loaded. If 0, they allocate temp
+   * memory from the platform allocator instead, like methods whose
+   * MemoryManager has no temp allocator.
+   */
+  size_t instruction_temp_arena_size = 0;
+};
+
+} // namespace runtime
+} // namespace executorch
@@ -279,7 +279,8 @@ Result<Method> Program::load_method(
     const char* method_name,
     MemoryManager* memory_manager,
     EventTracer* event_tracer,
-    const NamedDataMap* named_data_map) const {
+    const NamedDataMap* named_data_map,
+    const MethodLoadOptions& options) const {
   EXECUTORCH_SCOPE_PROF("Program::load_method");
   internal::event_tracer_create_event_block(event_tracer, "Default");
   internal::EventTracerProfileMethodScope event_tracer_scope =
@@ -297,7 +298,7 @@ Result<Method> Program::load_method(
     return plan.error();
   }
   return Method::load(
-      plan.get(), this, memory_manager, event_tracer, named_data_map);
+      plan.get(), this, memory_manager, event_tracer, named_data_map, options);
 }
 
 Result<MethodMeta> Program::method_meta(const char* method_name) const {
@@ -447,6 +448,71 @@ Error Program::get_backend_delegate_data(
   return HeaderStatus::NotPresent;
 }
 
+size_t Program::num_segments() const {
+  if (loader_ == nullptr || segment_base_offset_ == 0) {
+    return 0;
+  }
+  const auto* segments = internal_program_->segments();
+  return segments == nullptr ? 0 : segments->size();
+}
+
+Result<Program::SegmentLocation> Program::get_segment_location(
+    size_t segment_index) const {
+  size_t num_segments = this->num_segments();
+  if (segment_index >= num_segments) {
+    ET_LOG(
+        Error,
+        "Segment index %zu out of range (>= %zu)",
+        segment_index,
+        num_segments);
+    return Error::NotFound;
+  }
+  const executorch_flatbuffer::DataSegment* segment =
+      internal_program_->segments()->Get(segment_index);
+  return SegmentLocation{
+      segment_base_offset_ + static_cast<size_t>(segment->offset()),
+      static_cast<size_t>(segment->size()),
+      get_segment_info(segment_index)};
+}
+
+DataLoader::SegmentInfo Program::get_segment_info(size_t segment_index) const {
+  const auto* constant_segment = internal_program_->constant_segment();
+  if (constant_segment != nullptr &&
+      constant_segment->segment_index() == segment_index) {
+    return DataLoader::SegmentInfo(
+        DataLoader::SegmentInfo::Type::Constant, segment_index);
+  }
+  const auto* plans = internal_program_->execution_plan();
+  for (size_t i = 0; plans != nullptr && i < plans->size(); i++) {
+    const auto* delegates = plans->Get(i)->delegates();
+    for (size_t j = 0; delegates != nullptr && j < delegates->size(); j++) {
+      const auto* delegate = delegates->Get(j);
+      const auto* processed = delegate->processed();
+      if (processed != nullptr &&
+          processed->location() ==
+              executorch_flatbuffer::DataLocation::SEGMENT &&
+          processed->index() == segment_index && delegate->id() != nullptr) {
+        return DataLoader::SegmentInfo(
+            DataLoader::SegmentInfo::Type::Backend,
+            segment_index,
+            delegate->id()->c_str());
+      }
+    }
+  }
+  const auto* mutable_segments = internal_program_->mutable_data_segments();
+  for (size_t i = 0;
+       mutable_segments != nullptr && i < mutable_segments->size();
+       i++) {
+    if (mutable_segments->Get(i)->segment_index() == segment_index) {
+      return DataLoader::SegmentInfo(
+          DataLoader::SegmentInfo::Type::Mutable, segment_index);
+    }
+  }
+  // Named data, which is loaded through the program's data map.
+  return DataLoader::SegmentInfo(
+      DataLoader::SegmentInfo::Type::External, segment_index);
+}
+
 Result<FreeableBuffer> Program::LoadSegment(
     const DataLoader::SegmentInfo& segment_info) const {
   EXECUTORCH_SCOPE_PROF("Program::LoadSegment");
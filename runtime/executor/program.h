@@ -19,6 +19,7 @@
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/executor/memory_manager.h>
 #include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/method_load_options.h>
 #include <executorch/runtime/executor/method_meta.h>
 #include <executorch/runtime/executor/pte_data_map.h>
 #include <executorch/runtime/platform/compiler.h>
@@ -125,6 +126,38 @@ class Program final {
    */
   Result<const char*> get_method_name(size_t method_index) const;
 
+  /**
+   * Returns the number of entries in the program's segment table.
+   */
+  size_t num_segments() const;
+
+  /**
+   * Location of a segment within the DataLoader the program was loaded from.
+   */
+  struct SegmentLocation {
+    /// Absolute offset of the segment in the DataLoader, in bytes.
+    size_t offset;
+    /// Size of the segment in bytes.
+    size_t size;
+    /// What the segment holds, as the runtime describes it to the DataLoader
+    /// when it loads the segment.
+    DataLoader::SegmentInfo segment_info;
+  };
+
+  /**
+   * Returns where a segment lives in the DataLoader that was passed to
+   * `load()`. This lets callers schedule reads of segment data (e.g., to
+   * prefetch it) before the runtime asks for it.
+   *
+   * @param[in] segment_index The index of the segment to locate. Must be less
+   *     than the value returned by `num_segments()`.
+   *
+   * @returns The offset, size and type of the segment.
+   * @retval Error::NotFound The program does not contain any segments or the
+   *     index is out of range.
+   */
+  Result<SegmentLocation> get_segment_location(size_t segment_index) const;
+
   /**
    * Loads the named method and prepares it for execution.
    *
@@ -135,6 +168,8 @@ class Program final {
    * @param[in] event_tracer The event tracer to use for this method run.
    * @param[in] named_data_map An optional map of {name, blob} used to resolve
    *     data that is external to the PTE, if any.
+   * @param[in] options Optional behavior for loading the method, e.g. to
+   *     initialize its backend delegates in parallel.
    *
    * @returns The loaded method on success, or an error on failure.
    */
@@ -142,7 +177,8 @@ class Program final {
       const char* method_name,
       MemoryManager* memory_manager,
       EventTracer* event_tracer = nullptr,
-      const NamedDataMap* named_data_map = nullptr) const;
+      const NamedDataMap* named_data_map = nullptr,
+      const MethodLoadOptions& options = MethodLoadOptions()) const;
 
   /**
    * Gathers metadata for the named method.
@@ -264,6 +300,12 @@ class Program final {
       size_t size,
       void* buffer) const;
 
+  /**
+   * Returns the SegmentInfo that the runtime passes to the DataLoader when it
+   * loads the segment at `segment_index`, based on what refers to it.
+   */
+  DataLoader::SegmentInfo get_segment_info(size_t segment_index) const;
+
  private:
   Program(
       DataLoader* loader,
@@ -9,9 +9,13 @@
 #include <cstdlib>
 #include <cstring>
 #include <functional>
+#include <memory>
 #include <optional>
+#include <utility>
 #include <vector>
 
+#include <executorch/devtools/etdump/etdump_flatcc.h>
+#include <executorch/devtools/etdump/etdump_schema_flatcc_reader.h>
 #include <executorch/extension/data_loader/buffer_data_loader.h>
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/extension/runner_util/inputs.h>
@@ -29,6 +33,8 @@
 
 using namespace ::testing;
 using executorch::aten::ArrayRef;
+using executorch::etdump::ETDumpGen;
+using executorch::etdump::ETDumpResult;
 using executorch::runtime::BackendExecutionContext;
 using executorch::runtime::BackendInitContext;
 using executorch::runtime::BackendInterface;
@@ -39,9 +45,12 @@ using executorch::runtime::Error;
 using executorch::runtime::EValue;
 using executorch::runtime::FreeableBuffer;
 using executorch::runtime::MemoryAllocator;
+using executorch::runtime::FunctionRef;
 using executorch::runtime::Method;
+using executorch::runtime::MethodLoadOptions;
 using executorch::runtime::Program;
 using executorch::runtime::Result;
+using executorch::runtime::TaskRunner;
 using executorch::runtime::testing::ManagedMemoryManager;
 using torch::executor::util::FileDataLoader;
 
@@ -56,6 +65,9 @@ class StubBackend final : public BackendInterface {
       FreeableBuffer*,
       ArrayRef<CompileSpec>,
       BackendInitContext&)>;
+  using CloneFn = std::function<Result<DelegateHandle*>(
+      BackendInitContext&,
+      DelegateHandle*)>;
   using ExecuteFn =
       std::function<Error(BackendExecutionContext&, DelegateHandle*, EValue**)>;
   using DestroyFn = std::function<void(DelegateHandle*)>;
@@ -90,6 +102,20 @@ class StubBackend final : public BackendInterface {
     return nullptr;
   }
 
+  void install_clone(CloneFn fn) {
+    clone_fn_ = fn;
+  }
+
+  Result<DelegateHandle*> clone(
+      BackendInitContext& context,
+      DelegateHandle* handle) const override {
+    if (clone_fn_) {
+      return clone_fn_.value()(context, handle);
+    }
+    // Fall back to init(), like the default implementation.
+    return Error::NotSupported;
+  }
+
   void install_execute(ExecuteFn fn) {
     execute_fn_ = fn;
   }
@@ -121,6 +147,7 @@ class StubBackend final : public BackendInterface {
   void reset() {
     is_available_fn_.reset();
     init_fn_.reset();
+    clone_fn_.reset();
     execute_fn_.reset();
     destroy_fn_.reset();
   }
@@ -153,6 +180,7 @@ class StubBackend final : public BackendInterface {
 
   std::optional<IsAvailableFn> is_available_fn_;
   std::optional<InitFn> init_fn_;
+  std::optional<CloneFn> clone_fn_;
   std::optional<ExecuteFn> execute_fn_;
   std::optional<DestroyFn> destroy_fn_;
 };
@@ -160,6 +188,22 @@ class StubBackend final : public BackendInterface {
 bool StubBackend::registered_ = false;
 StubBackend StubBackend::singleton_;
 
+/**
+ * A TaskRunner that runs tasks in reverse order on the calling thread and
+ * counts the tasks it was given.
+ */
+class CountingTaskRunner final : public TaskRunner {
+ public:
+  void run(size_t num_tasks, FunctionRef<void(size_t)> task) override {
+    num_tasks_run += num_tasks;
+    for (size_t i = num_tasks; i > 0; --i) {
+      task(i - 1);
+    }
+  }
+
+  size_t num_tasks_run = 0;
+};
+
 /**
  * A DataLoader that wraps a real DataLoader and records the operations
  * performed on it and the FreeableBuffers it loads.
@@ -561,8 +605,23 @@ TEST_P(BackendIntegrationTest, SegmentInfoIsPassedIntoDataLoader) {
       "StubBackend"); // This backend id is taken from the StubBackend defined
                       // in export_delegated_program.py.
 
+  // Program::get_segment_location() describes the segment the same way.
+  bool backend_segment_was_located = false;
+  for (size_t i = 0; i < program->num_segments(); ++i) {
+    Result<Program::SegmentLocation> location =
+        program->get_segment_location(i);
+    ASSERT_EQ(location.error(), Error::Ok);
+    if (location->segment_info.segment_type ==
+        DataLoader::SegmentInfo::Type::Backend) {
+      EXPECT_EQ(location->segment_info.segment_index, i);
+      EXPECT_STREQ(location->segment_info.descriptor, "StubBackend");
+      backend_segment_was_located = true;
+    }
+  }
+
   EXPECT_TRUE(program_load_was_called);
   EXPECT_EQ(backend_load_was_called, using_segments());
+  EXPECT_EQ(backend_segment_was_located, using_segments());
 }
 
 TEST_P(BackendIntegrationTest, GetMethodNameDuringInitSuccess) {
@@ -607,6 +666,250 @@ TEST_P(BackendIntegrationTest, GetMethodNameDuringExecuteSuccess) {
   ASSERT_EQ(err, Error::Ok);
 }
 
+TEST_P(BackendIntegrationTest, ParallelInitUsesRunnerAndArena) {
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+
+  size_t num_inits = 0;
+  std::vector<const void*> method_ids;
+  StubBackend::singleton().install_init(
+      [&](ET_UNUSED FreeableBuffer* processed,
+          ET_UNUSED ArrayRef<CompileSpec> compile_specs,
+          BackendInitContext& backend_init_context) -> Result<DelegateHandle*> {
+        ++num_inits;
+        // The delegate allocates from an arena of its own, but can still
+        // identify the method it belongs to.
+        EXPECT_NE(
+            backend_init_context.get_runtime_allocator(),
+            mmm.get().method_allocator());
+        method_ids.push_back(backend_init_context.get_method_id());
+        EXPECT_EQ(backend_init_context.event_tracer(), nullptr);
+        EXPECT_NE(
+            backend_init_context.get_runtime_allocator()->allocate(64),
+            nullptr);
+        return nullptr;
+      });
+
+  CountingTaskRunner runner;
+  MethodLoadOptions options;
+  options.delegate_init_runner = &runner;
+  Result<Method> method = program->load_method(
+      "forward", &mmm.get(), /*event_tracer=*/nullptr, nullptr, options);
+  ASSERT_EQ(method.error(), Error::Ok);
+  EXPECT_GT(runner.num_tasks_run, 0u);
+  EXPECT_EQ(num_inits, runner.num_tasks_run);
+  EXPECT_EQ(method->execute(), Error::Ok);
+
+  // All delegates of the method get the same id, and the delegates of a
+  // second method get another one.
+  const size_t num_delegates = num_inits;
+  ManagedMemoryManager other_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> other_method = program->load_method(
+      "forward", &other_mmm.get(), /*event_tracer=*/nullptr, nullptr, options);
+  ASSERT_EQ(other_method.error(), Error::Ok);
+  ASSERT_EQ(method_ids.size(), 2 * num_delegates);
+  for (size_t i = 0; i < num_delegates; ++i) {
+    EXPECT_EQ(method_ids[i], method_ids[0]);
+    EXPECT_EQ(method_ids[num_delegates + i], method_ids[num_delegates]);
+  }
+  EXPECT_NE(method_ids[0], nullptr);
+  EXPECT_NE(method_ids[0], method_ids[num_delegates]);
+}
+
+TEST_P(BackendIntegrationTest, ParallelInitRetriesDelegatesThatOverflowArena) {
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+
+  std::vector<bool> used_method_allocator;
+  StubBackend::singleton().install_init(
+      [&](ET_UNUSED FreeableBuffer* processed,
+          ET_UNUSED ArrayRef<CompileSpec> compile_specs,
+          BackendInitContext& backend_init_context) -> Result<DelegateHandle*> {
+        MemoryAllocator* allocator =
+            backend_init_context.get_runtime_allocator();
+        used_method_allocator.push_back(
+            allocator == mmm.get().method_allocator());
+        if (allocator->allocate(1024) == nullptr) {
+          return Error::MemoryAllocationFailed;
+        }
+        return nullptr;
+      });
+
+  CountingTaskRunner runner;
+  MethodLoadOptions options;
+  options.delegate_init_runner = &runner;
+  // Room for the compile specs, but not for the allocation above.
+  options.delegate_init_arena_size = 256;
+  Result<Method> method = program->load_method(
+      "forward", &mmm.get(), /*event_tracer=*/nullptr, nullptr, options);
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // Every delegate first fails in its arena, then succeeds on the calling
+  // thread with the method allocator.
+  ASSERT_EQ(used_method_allocator.size(), 2 * runner.num_tasks_run);
+  for (size_t i = 0; i < runner.num_tasks_run; ++i) {
+    EXPECT_FALSE(used_method_allocator[i]);
+    EXPECT_TRUE(used_method_allocator[runner.num_tasks_run + i]);
+  }
+}
+
+TEST_P(BackendIntegrationTest, InitTimeIsLoggedToETDump) {
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+
+  size_t num_inits = 0;
+  StubBackend::singleton().install_init(
+      [&](ET_UNUSED FreeableBuffer* processed,
+          ET_UNUSED ArrayRef<CompileSpec> compile_specs,
+          ET_UNUSED BackendInitContext& backend_init_context)
+          -> Result<DelegateHandle*> {
+        ++num_inits;
+        return nullptr;
+      });
+
+  // Covers both the sequential and the parallel init paths. ETDumpGen aborts
+  // if a delegate event carries both a name and an int id.
+  CountingTaskRunner runner;
+  TaskRunner* const delegate_init_runners[] = {nullptr, &runner};
+  for (TaskRunner* delegate_init_runner : delegate_init_runners) {
+    num_inits = 0;
+    ETDumpGen etdump_gen;
+    ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    MethodLoadOptions options;
+    options.delegate_init_runner = delegate_init_runner;
+    Result<Method> method = program->load_method(
+        "forward", &mmm.get(), &etdump_gen, nullptr, options);
+    ASSERT_EQ(method.error(), Error::Ok);
+    EXPECT_GT(num_inits, 0u);
+
+#ifdef ET_EVENT_TRACER_ENABLED
+    ETDumpResult result = etdump_gen.get_etdump_data();
+    ASSERT_NE(result.buf, nullptr);
+    size_t size = 0;
+    void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+    etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+        buf, etdump_ETDump_file_identifier);
+    etdump_RunData_table_t run_data =
+        etdump_RunData_vec_at(etdump_ETDump_run_data(etdump), 0);
+    etdump_Event_vec_t events = etdump_RunData_events(run_data);
+    // Each delegate logs one event, with its index as the int id.
+    std::vector<int32_t> init_event_ids;
+    for (size_t i = 0; i < etdump_Event_vec_len(events); ++i) {
+      etdump_ProfileEvent_table_t event =
+          etdump_Event_profile_event(etdump_Event_vec_at(events, i));
+      if (event == nullptr ||
+          etdump_ProfileEvent_delegate_debug_id_int(event) < 0) {
+        continue;
+      }
+      EXPECT_EQ(etdump_ProfileEvent_delegate_debug_id_str(event), nullptr);
+      init_event_ids.push_back(
+          etdump_ProfileEvent_delegate_debug_id_int(event));
+    }
+    ASSERT_EQ(init_event_ids.size(), num_inits);
+    for (size_t i = 0; i < num_inits; ++i) {
+      EXPECT_EQ(init_event_ids[i], static_cast<int32_t>(i));
+    }
+    free(result.buf);
+#endif // ET_EVENT_TRACER_ENABLED
+  }
+}
+
+TEST_P(BackendIntegrationTest, CloneInitializesDelegatesAgainByDefault) {
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+
+  size_t num_inits = 0;
+  StubBackend::singleton().install_init(
+      [&](ET_UNUSED FreeableBuffer* processed,
+          ET_UNUSED ArrayRef<CompileSpec> compile_specs,
+          ET_UNUSED BackendInitContext& backend_init_context)
+          -> Result<DelegateHandle*> {
+        ++num_inits;
+        return nullptr;
+      });
+
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  const size_t num_delegates = num_inits;
+  EXPECT_GT(num_delegates, 0u);
+
+  ManagedMemoryManager clone_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> clone = method->clone(&clone_mmm.get());
+  ASSERT_EQ(clone.error(), Error::Ok);
+  EXPECT_EQ(num_inits, 2 * num_delegates);
+  EXPECT_EQ(clone->execute(), Error::Ok);
+}
+
+TEST_P(BackendIntegrationTest, CloneSharesDelegatesThatTheBackendClones) {
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+
+  // Each handle points to its own counter, and clones remember their source.
+  std::vector<std::unique_ptr<int>> handles;
+  size_t num_inits = 0;
+  StubBackend::singleton().install_init(
+      [&](ET_UNUSED FreeableBuffer* processed,
+          ET_UNUSED ArrayRef<CompileSpec> compile_specs,
+          ET_UNUSED BackendInitContext& backend_init_context)
+          -> Result<DelegateHandle*> {
+        ++num_inits;
+        handles.push_back(std::make_unique<int>(0));
+        return handles.back().get();
+      });
+  std::vector<std::pair<DelegateHandle*, DelegateHandle*>> clones;
+  StubBackend::singleton().install_clone(
+      [&](ET_UNUSED BackendInitContext& backend_init_context,
+          DelegateHandle* handle) -> Result<DelegateHandle*> {
+        handles.push_back(std::make_unique<int>(0));
+        clones.emplace_back(handle, handles.back().get());
+        return handles.back().get();
+      });
+  std::vector<DelegateHandle*> destroyed;
+  StubBackend::singleton().install_destroy(
+      [&](DelegateHandle* handle) { destroyed.push_back(handle); });
+
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  const size_t num_delegates = num_inits;
+  {
+    ManagedMemoryManager clone_mmm(
+        kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    Result<Method> clone = method->clone(&clone_mmm.get());
+    ASSERT_EQ(clone.error(), Error::Ok);
+
+    // Every delegate was cloned from the handle of the source, not
+    // initialized again.
+    EXPECT_EQ(num_inits, num_delegates);
+    ASSERT_EQ(clones.size(), num_delegates);
+    for (size_t i = 0; i < num_delegates; ++i) {
+      EXPECT_EQ(clones[i].first, handles[i].get());
+    }
+    EXPECT_EQ(clone->execute(), Error::Ok);
+  }
+
+  // Destroying the clone destroys only its handles.
+  ASSERT_EQ(destroyed.size(), num_delegates);
+  for (size_t i = 0; i < num_delegates; ++i) {
+    EXPECT_EQ(destroyed[i], clones[i].second);
+  }
+}
+
 // TODO: Add more tests for the runtime-to-backend interface. E.g.:
 // - Errors during init() or execute() result in runtime init/execution failures
 // - Correct values are passed to init()/execute()
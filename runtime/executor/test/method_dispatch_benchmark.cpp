@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * Measures Program::load_method(), which runs Method::init() and resolves
+ * every kernel, and how long Method::execute() spends per instruction, on a
+ * program of 10k adds whose kernel does nothing.
+ *
+ * Not a test: run it by hand and compare the times before and after changes
+ * to method loading or to the interpreter loop. The program is the one that
+ * ET_MODULE_TRIVIAL_OPS_PATH names, or the first argument.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/extension/runner_util/inputs.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/executor/test/managed_memory_manager.h>
+#include <executorch/runtime/kernel/kernel_runtime_context.h>
+#include <executorch/runtime/kernel/operator_registry.h>
+#include <executorch/runtime/platform/compiler.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using executorch::extension::FileDataLoader;
+using executorch::extension::prepare_input_tensors;
+using executorch::runtime::Error;
+using executorch::runtime::EValue;
+using executorch::runtime::Kernel;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::Method;
+using executorch::runtime::MethodMeta;
+using executorch::runtime::Program;
+using executorch::runtime::Result;
+using executorch::runtime::Span;
+using executorch::runtime::testing::ManagedMemoryManager;
+
+namespace {
+
+// Must match ModuleTrivialOps.NUM_OPS in test/models/export_program.py.
+constexpr size_t kNumOps = 10000;
+
+constexpr size_t kMethodAllocatorBytes = 16 * 1024 * 1024U;
+constexpr int kWarmupRuns = 3;
+constexpr int kTimedLoads = 20;
+constexpr int kTimedRuns = 50;
+
+size_t num_kernel_calls = 0;
+
+// Stands in for aten::add.out so that the time measured is the time spent
+// dispatching, not computing. It is the only kernel registered under that
+// name in this binary, so nothing gets fused either.
+void trivial_kernel(
+    ET_UNUSED KernelRuntimeContext& context,
+    ET_UNUSED Span<EValue*> args) {
+  num_kernel_calls++;
+}
+
+double to_us(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  executorch::runtime::runtime_init();
+  if (executorch::runtime::register_kernel(
+          Kernel("aten::add.out", trivial_kernel)) != Error::Ok) {
+    std::fprintf(stderr, "Failed to register aten::add.out\n");
+    return 1;
+  }
+
+  const char* path =
+      argc > 1 ? argv[1] : std::getenv("ET_MODULE_TRIVIAL_OPS_PATH");
+  if (path == nullptr) {
+    std::fprintf(
+        stderr,
+        "Usage: %s [ModuleTrivialOps.pte], or set "
+        "ET_MODULE_TRIVIAL_OPS_PATH\n",
+        argv[0]);
+    return 1;
+  }
+  Result<FileDataLoader> loader = FileDataLoader::from(path);
+  if (!loader.ok()) {
+    std::fprintf(stderr, "Failed to open %s\n", path);
+    return 1;
+  }
+  Result<Program> program = Program::load(
+      &loader.get(), Program::Verification::InternalConsistency);
+  if (!program.ok()) {
+    std::fprintf(stderr, "Failed to load the program in %s\n", path);
+    return 1;
+  }
+  Result<MethodMeta> method_meta = program->method_meta("forward");
+  if (!method_meta.ok() || method_meta->num_memory_planned_buffers() != 1) {
+    std::fprintf(stderr, "Expected a forward method with one planned buffer\n");
+    return 1;
+  }
+  Result<int64_t> planned_bytes = method_meta->memory_planned_buffer_size(0);
+  if (!planned_bytes.ok()) {
+    return 1;
+  }
+
+  // Each load gets memory of its own; only the load itself is timed.
+  auto best_load = std::chrono::steady_clock::duration::max();
+  for (int i = 0; i < kTimedLoads; ++i) {
+    ManagedMemoryManager mmm(planned_bytes.get(), kMethodAllocatorBytes);
+    const auto start = std::chrono::steady_clock::now();
+    Result<Method> method = program->load_method("forward", &mmm.get());
+    const auto end = std::chrono::steady_clock::now();
+    if (!method.ok()) {
+      std::fprintf(
+          stderr,
+          "load_method() failed with error 0x%x\n",
+          static_cast<unsigned>(method.error()));
+      return 1;
+    }
+    best_load = std::min(best_load, end - start);
+  }
+
+  ManagedMemoryManager mmm(planned_bytes.get(), kMethodAllocatorBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  if (!method.ok()) {
+    return 1;
+  }
+  auto inputs = prepare_input_tensors(*method);
+  if (!inputs.ok()) {
+    std::fprintf(stderr, "Failed to prepare the inputs\n");
+    return 1;
+  }
+  for (int i = 0; i < kWarmupRuns; ++i) {
+    if (method->execute() != Error::Ok) {
+      std::fprintf(stderr, "execute() failed\n");
+      return 1;
+    }
+  }
+
+  num_kernel_calls = 0;
+  auto best_run = std::chrono::steady_clock::duration::max();
+  for (int i = 0; i < kTimedRuns; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    Error err = method->execute();
+    const auto end = std::chrono::steady_clock::now();
+    if (err != Error::Ok) {
+      std::fprintf(stderr, "execute() failed\n");
+      return 1;
+    }
+    best_run = std::min(best_run, end - start);
+  }
+  if (num_kernel_calls != kNumOps * kTimedRuns) {
+    std::fprintf(
+        stderr,
+        "Expected %zu kernel calls, got %zu\n",
+        kNumOps * kTimedRuns,
+        num_kernel_calls);
+    return 1;
+  }
+
+  const double load_us = to_us(best_load);
+  const double run_us = to_us(best_run);
+  std::printf(
+      "Program::load_method(): %.1f us for %zu instructions, %.2f ns per "
+      "instruction (best of %d loads)\n",
+      load_us,
+      kNumOps,
+      load_us * 1000.0 / kNumOps,
+      kTimedLoads);
+  std::printf(
+      "Method::execute(): %.1f us for %zu instructions, %.2f ns per "
+      "instruction (best of %d runs)\n",
+      run_us,
+      kNumOps,
+      run_us * 1000.0 / kNumOps,
+      kTimedRuns);
+  return 0;
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * Measures how long Program::load_method() takes for a method of 10k kernel
+ * calls to 600 different operators, with a registry about as full as one that
+ * links the portable, optimized and quantized kernel libraries. Method::init()
+ * resolves the kernel of every call through the registry, so this is where
+ * the number of registered kernels shows up.
+ *
+ * The program is built in memory, so no model file is needed.
+ *
+ * Not a test: run it by hand and compare the times before and after changes
+ * to the registry or to method loading.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <executorch/extension/data_loader/buffer_data_loader.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/executor/test/managed_memory_manager.h>
+#include <executorch/runtime/kernel/kernel_runtime_context.h>
+#include <executorch/runtime/kernel/operator_registry.h>
+#include <executorch/runtime/platform/compiler.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <executorch/schema/program_generated.h>
+
+using executorch::extension::BufferDataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::EValue;
+using executorch::runtime::Kernel;
+using executorch::runtime::KernelKey;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::Method;
+using executorch::runtime::Program;
+using executorch::runtime::Result;
+using executorch::runtime::Span;
+using executorch::runtime::testing::ManagedMemoryManager;
+
+namespace {
+
+// 3 kernels per operator keeps the registry just under its default capacity.
+constexpr size_t kNumOps = 600;
+constexpr size_t kNumInstructions = 10000;
+
+constexpr size_t kMethodAllocatorBytes = 16 * 1024 * 1024U;
+constexpr int kTimedLoads = 20;
+
+void noop_kernel(
+    ET_UNUSED KernelRuntimeContext& context,
+    ET_UNUSED Span<EValue*> args) {}
+
+/**
+ * Returns a serialized program whose "forward" method calls a random one of
+ * the `op_names` operators, with an overload of "out", kNumInstructions times.
+ */
+flatbuffers::DetachedBuffer make_program(
+    const std::vector<std::string>& op_names) {
+  flatbuffers::FlatBufferBuilder builder;
+
+  std::vector<flatbuffers::Offset<executorch_flatbuffer::Operator>> operators;
+  operators.reserve(op_names.size());
+  for (const auto& name : op_names) {
+    operators.push_back(
+        executorch_flatbuffer::CreateOperatorDirect(
+            builder, name.c_str(), "out"));
+  }
+
+  // Methods call their operators in program order, which is unrelated to the
+  // order that the kernels were registered in.
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<int32_t> pick(
+      0, static_cast<int32_t>(op_names.size()) - 1);
+  const std::vector<int32_t> args = {0};
+  std::vector<flatbuffers::Offset<executorch_flatbuffer::Instruction>>
+      instructions;
+  instructions.reserve(kNumInstructions);
+  for (size_t i = 0; i < kNumInstructions; ++i) {
+    auto call = executorch_flatbuffer::CreateKernelCallDirect(
+        builder, pick(rng), &args);
+    instructions.push_back(
+        executorch_flatbuffer::CreateInstruction(
+            builder,
+            executorch_flatbuffer::InstructionArguments::KernelCall,
+            call.Union()));
+  }
+
+  const std::vector<int32_t> no_values;
+  const std::vector<flatbuffers::Offset<executorch_flatbuffer::Chain>> chains =
+      {executorch_flatbuffer::CreateChainDirect(
+          builder, &no_values, &no_values, &instructions)};
+  const std::vector<flatbuffers::Offset<executorch_flatbuffer::EValue>>
+      values = {executorch_flatbuffer::CreateEValue(
+          builder,
+          executorch_flatbuffer::KernelTypes::Int,
+          executorch_flatbuffer::CreateInt(builder, 0).Union())};
+  const std::vector<flatbuffers::Offset<executorch_flatbuffer::BackendDelegate>>
+      delegates;
+  // The first entry is reserved; there are no planned buffers.
+  const std::vector<int64_t> non_const_buffer_sizes = {0};
+  const std::vector<flatbuffers::Offset<executorch_flatbuffer::ExecutionPlan>>
+      plans = {executorch_flatbuffer::CreateExecutionPlanDirect(
+          builder,
+          "forward",
+          /*container_meta_type=*/0,
+          &values,
+          /*inputs=*/&no_values,
+          /*outputs=*/&no_values,
+          &chains,
+          &operators,
+          &delegates,
+          &non_const_buffer_sizes)};
+
+  // An empty constant segment, which only holds the placeholder offset.
+  const std::vector<uint64_t> constant_offsets = {0};
+  const std::vector<flatbuffers::Offset<executorch_flatbuffer::DataSegment>>
+      segments;
+  auto program = executorch_flatbuffer::CreateProgramDirect(
+      builder,
+      /*version=*/0,
+      &plans,
+      /*constant_buffer=*/nullptr,
+      /*backend_delegate_data=*/nullptr,
+      &segments,
+      executorch_flatbuffer::CreateSubsegmentOffsetsDirect(
+          builder, /*segment_index=*/0, &constant_offsets));
+  builder.Finish(program, executorch_flatbuffer::ProgramIdentifier());
+  return builder.Release();
+}
+
+} // namespace
+
+int main() {
+  executorch::runtime::runtime_init();
+
+  // Kernels point at their names and keys, so they must outlive the registry.
+  static std::vector<std::string> op_names;
+  static std::vector<std::string> kernel_names;
+  op_names.reserve(kNumOps);
+  kernel_names.reserve(kNumOps);
+  for (size_t i = 0; i < kNumOps; ++i) {
+    op_names.push_back("benchmark::op_" + std::to_string(i));
+    kernel_names.push_back(op_names.back() + ".out");
+  }
+  static const char* kFloatKey = "v1/6;0,1|6;0,1";
+  static const char* kIntKey = "v1/3;0,1|3;0,1";
+  std::vector<Kernel> kernels;
+  kernels.reserve(3 * kNumOps);
+  for (const auto& name : kernel_names) {
+    kernels.emplace_back(name.c_str(), KernelKey(kFloatKey), noop_kernel);
+    kernels.emplace_back(name.c_str(), KernelKey(kIntKey), noop_kernel);
+    kernels.emplace_back(name.c_str(), noop_kernel);
+  }
+  if (executorch::runtime::register_kernels(
+          {kernels.data(), kernels.size()}) != Error::Ok) {
+    std::fprintf(stderr, "Failed to register %zu kernels\n", kernels.size());
+    return 1;
+  }
+
+  // Program data must be aligned the way new[] aligns it, which the builder's
+  // buffer need not be.
+  flatbuffers::DetachedBuffer serialized = make_program(op_names);
+  std::unique_ptr<uint8_t[]> program_data(new uint8_t[serialized.size()]);
+  std::memcpy(program_data.get(), serialized.data(), serialized.size());
+  BufferDataLoader loader(program_data.get(), serialized.size());
+  Result<Program> program =
+      Program::load(&loader, Program::Verification::InternalConsistency);
+  if (!program.ok()) {
+    std::fprintf(
+        stderr,
+        "Failed to load the program: 0x%x\n",
+        static_cast<unsigned>(program.error()));
+    return 1;
+  }
+
+  // Each load gets memory of its own; only the load itself is timed.
+  auto best_load = std::chrono::steady_clock::duration::max();
+  for (int i = 0; i < kTimedLoads; ++i) {
+    ManagedMemoryManager mmm(/*planned_memory_bytes=*/0, kMethodAllocatorBytes);
+    const auto start = std::chrono::steady_clock::now();
+    Result<Method> method = program->load_method("forward", &mmm.get());
+    const auto end = std::chrono::steady_clock::now();
+    if (!method.ok()) {
+      std::fprintf(
+          stderr,
+          "load_method() failed with error 0x%x\n",
+          static_cast<unsigned>(method.error()));
+      return 1;
+    }
+    best_load = std::min(best_load, end - start);
+  }
+
+  const double load_us =
+      std::chrono::duration<double, std::micro>(best_load).count();
+  std::printf(
+      "Program::load_method(): %.1f us for %zu kernel calls to %zu operators "
+      "with %zu kernels registered, %.1f ns per call (best of %d loads)\n",
+      load_us,
+      kNumInstructions,
+      kNumOps,
+      executorch::runtime::get_registered_kernels().size(),
+      load_us * 1000.0 / kNumInstructions,
+      kTimedLoads);
+  return 0;
+}
@@ -12,6 +12,8 @@
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/extension/flat_tensor/flat_tensor_data_map.h>
 #include <executorch/extension/runner_util/inputs.h>
+#include <executorch/extension/threadpool/threadpool.h>
+#include <executorch/extension/threadpool/threadpool_task_runner.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/executor/method.h>
 #include <executorch/runtime/executor/program.h>
@@ -24,17 +26,66 @@ using namespace ::testing;
 using executorch::aten::ArrayRef;
 using executorch::extension::FlatTensorDataMap;
 using executorch::extension::prepare_input_tensors;
+using executorch::extension::threadpool::ThreadPool;
+using executorch::extension::threadpool::ThreadPoolTaskRunner;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
+using executorch::runtime::FunctionRef;
 using executorch::runtime::Method;
+using executorch::runtime::MethodLoadOptions;
 using executorch::runtime::Program;
 using executorch::runtime::Result;
+using executorch::runtime::TaskRunner;
 using executorch::runtime::testing::ManagedMemoryManager;
 using torch::executor::util::FileDataLoader;
 
 constexpr size_t kDefaultNonConstMemBytes = 32 * 1024U;
 constexpr size_t kDefaultRuntimeMemBytes = 32 * 1024U;
 
+namespace {
+
+/**
+ * A TaskRunner that runs tasks in reverse order on the calling thread and
+ * counts the batches and tasks it was given.
+ */
+class CountingTaskRunner final : public TaskRunner {
+ public:
+  void run(size_t num_tasks, FunctionRef<void(size_t)> task) override {
+    num_runs++;
+    num_tasks_run += num_tasks;
+    for (size_t i = num_tasks; i > 0; --i) {
+      task(i - 1);
+    }
+  }
+
+  size_t num_runs = 0;
+  size_t num_tasks_run = 0;
+};
+
+/// Runs the method one step at a time and returns the number of steps.
+size_t count_steps(Method& method) {
+  size_t num_steps = 0;
+  Error err = Error::Ok;
+  while ((err = method.step()) == Error::Ok) {
+    num_steps++;
+  }
+  EXPECT_EQ(err, Error::EndOfMethod);
+  return num_steps;
+}
+
+void expect_same_output(const Method& expected, const Method& actual) {
+  const auto& expected_tensor = expected.get_output(0).toTensor();
+  const auto& actual_tensor = actual.get_output(0).toTensor();
+  ASSERT_EQ(actual_tensor.numel(), expected_tensor.numel());
+  for (ssize_t i = 0; i < actual_tensor.numel(); ++i) {
+    EXPECT_FLOAT_EQ(
+        actual_tensor.const_data_ptr<float>()[i],
+        expected_tensor.const_data_ptr<float>()[i]);
+  }
+}
+
+} // namespace
+
 class MethodTest : public ::testing::Test {
  protected:
   void load_program(const char* path, const char* module_name) {
@@ -79,6 +130,11 @@ class MethodTest : public ::testing::Test {
     load_program(
         std::getenv("ET_MODULE_DYNAMIC_CAT_UNALLOCATED_IO_PATH"), "cat");
     load_program(std::getenv("ET_MODULE_ADD_MUL_PATH"), "add_mul");
+    load_program(
+        std::getenv("ET_MODULE_ADD_MUL_SIGMOID_PATH"), "add_mul_sigmoid");
+    load_program(std::getenv("ET_MODULE_BRANCHES_PATH"), "branches");
+    load_program(
+        std::getenv("ET_MODULE_SHARED_BUFFER_PATH"), "shared_buffer");
     load_program(std::getenv("ET_MODULE_STATEFUL_PATH"), "stateful");
     load_program(
         std::getenv("DEPRECATED_ET_MODULE_LINEAR_CONSTANT_BUFFER_PATH"),
@@ -122,6 +178,137 @@ TEST_F(MethodTest, MoveTest) {
   ASSERT_EQ(err, Error::Ok);
 }
 
+TEST_F(MethodTest, IndependentInstructionsRunConcurrently) {
+  ManagedMemoryManager sequential_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> sequential_method =
+      programs_["branches"]->load_method("forward", &sequential_mmm.get());
+  ASSERT_EQ(sequential_method.error(), Error::Ok);
+
+  CountingTaskRunner runner;
+  MethodLoadOptions options;
+  options.instruction_runner = &runner;
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["branches"]->load_method(
+      "forward", &mmm.get(), nullptr, nullptr, options);
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  auto sequential_inputs = prepare_input_tensors(*sequential_method);
+  ASSERT_EQ(sequential_inputs.error(), Error::Ok);
+  auto inputs = prepare_input_tensors(*method);
+  ASSERT_EQ(inputs.error(), Error::Ok);
+  ASSERT_EQ(sequential_method->execute(), Error::Ok);
+
+  // The two matmuls only read x and y, so they run as one batch, and the add
+  // that joins them runs after it.
+  for (size_t run = 1; run <= 2; ++run) {
+    ASSERT_EQ(method->execute(), Error::Ok);
+    EXPECT_EQ(runner.num_runs, run);
+    EXPECT_EQ(runner.num_tasks_run, 2 * run);
+    expect_same_output(*sequential_method, *method);
+  }
+}
+
+TEST_F(MethodTest, IndependentInstructionsRunOnThreadPool) {
+  ManagedMemoryManager sequential_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> sequential_method =
+      programs_["branches"]->load_method("forward", &sequential_mmm.get());
+  ASSERT_EQ(sequential_method.error(), Error::Ok);
+
+  ThreadPool threadpool(2);
+  ThreadPoolTaskRunner runner(&threadpool);
+  MethodLoadOptions options;
+  options.instruction_runner = &runner;
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["branches"]->load_method(
+      "forward", &mmm.get(), nullptr, nullptr, options);
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  auto sequential_inputs = prepare_input_tensors(*sequential_method);
+  ASSERT_EQ(sequential_inputs.error(), Error::Ok);
+  auto inputs = prepare_input_tensors(*method);
+  ASSERT_EQ(inputs.error(), Error::Ok);
+  ASSERT_EQ(sequential_method->execute(), Error::Ok);
+
+  // The matmuls now really run on two threads at once.
+  for (size_t run = 0; run < 100; ++run) {
+    ASSERT_EQ(method->execute(), Error::Ok);
+    expect_same_output(*sequential_method, *method);
+  }
+}
+
+TEST_F(MethodTest, InstructionsThatShareAPlannedBufferRunInOrder) {
+  ManagedMemoryManager sequential_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> sequential_method = programs_["shared_buffer"]->load_method(
+      "forward", &sequential_mmm.get());
+  ASSERT_EQ(sequential_method.error(), Error::Ok);
+
+  CountingTaskRunner runner;
+  MethodLoadOptions options;
+  options.instruction_runner = &runner;
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["shared_buffer"]->load_method(
+      "forward", &mmm.get(), nullptr, nullptr, options);
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  auto sequential_inputs = prepare_input_tensors(*sequential_method);
+  ASSERT_EQ(sequential_inputs.error(), Error::Ok);
+  auto inputs = prepare_input_tensors(*method);
+  ASSERT_EQ(inputs.error(), Error::Ok);
+  ASSERT_EQ(sequential_method->execute(), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+
+  // mm(y, y) writes the buffer that mm(a, a) reads a from, and mm(x, x)
+  // wrote a to, so it runs after both. The runner runs tasks in reverse, so
+  // batching it with either would also change the output.
+  EXPECT_EQ(runner.num_runs, 0u);
+  expect_same_output(*sequential_method, *method);
+}
+
+TEST_F(MethodTest, DependentInstructionsRunInOrder) {
+  // Every instruction of add_mul reads the output of the previous one.
+  CountingTaskRunner runner;
+  MethodLoadOptions options;
+  options.instruction_runner = &runner;
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add_mul"]->load_method(
+      "forward", &mmm.get(), nullptr, nullptr, options);
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  auto inputs = prepare_input_tensors(*method);
+  ASSERT_EQ(inputs.error(), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  EXPECT_EQ(runner.num_runs, 0u);
+}
+
+TEST_F(MethodTest, ElementwiseChainRunsAsOneFusedCall) {
+  ManagedMemoryManager unfused_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> unfused_method = programs_["add_mul_sigmoid"]->load_method(
+      "forward", &unfused_mmm.get());
+  ASSERT_EQ(unfused_method.error(), Error::Ok);
+
+  MethodLoadOptions options;
+  options.fuse_elementwise_kernels = true;
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add_mul_sigmoid"]->load_method(
+      "forward", &mmm.get(), nullptr, nullptr, options);
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  auto unfused_inputs = prepare_input_tensors(*unfused_method);
+  ASSERT_EQ(unfused_inputs.error(), Error::Ok);
+  auto inputs = prepare_input_tensors(*method);
+  ASSERT_EQ(inputs.error(), Error::Ok);
+
+  // The add, mul and sigmoid run as a single step.
+  size_t unfused_steps = count_steps(*unfused_method);
+  size_t steps = count_steps(*method);
+  EXPECT_EQ(steps + 2, unfused_steps);
+  expect_same_output(*unfused_method, *method);
+}
+
 TEST_F(MethodTest, GetInputTests) {
   ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
   Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
@@ -365,6 +552,75 @@ TEST_F(MethodTest, MethodGetAttributeTest) {
   EXPECT_EQ(res->const_data_ptr<int32_t>()[0], 1);
 }
 
+TEST_F(MethodTest, CloneExecutesIndependently) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["add_mul"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  ManagedMemoryManager clone_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> clone = method->clone(&clone_mmm.get());
+  ASSERT_EQ(clone.error(), Error::Ok);
+
+  // A clone can't share the memory manager of its source.
+  EXPECT_EQ(method->clone(&mmm.get()).error(), Error::InvalidArgument);
+
+  auto inputs = prepare_input_tensors(*method);
+  ASSERT_EQ(inputs.error(), Error::Ok);
+  auto clone_inputs = prepare_input_tensors(*clone);
+  ASSERT_EQ(clone_inputs.error(), Error::Ok);
+
+  // Give the clone different inputs: 3 * x + 2 with x = 2 instead of 1.
+  EValue clone_input;
+  ASSERT_EQ(clone->get_inputs(&clone_input, 1), Error::Ok);
+  auto& clone_x = clone_input.toTensor();
+  for (ssize_t i = 0; i < clone_x.numel(); ++i) {
+    clone_x.mutable_data_ptr<float>()[i] = 2.f;
+  }
+
+  ASSERT_EQ(method->execute(), Error::Ok);
+  ASSERT_EQ(clone->execute(), Error::Ok);
+
+  const auto& output = method->get_output(0).toTensor();
+  const auto& clone_output = clone->get_output(0).toTensor();
+  EXPECT_NE(output.const_data_ptr(), clone_output.const_data_ptr());
+  for (ssize_t i = 0; i < output.numel(); ++i) {
+    EXPECT_FLOAT_EQ(output.const_data_ptr<float>()[i], 5.f);
+    EXPECT_FLOAT_EQ(clone_output.const_data_ptr<float>()[i], 8.f);
+  }
+}
+
+TEST_F(MethodTest, CloneStartsWithFreshState) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["stateful"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  int32_t data = 0;
+  auto state = method->get_attribute("state");
+  ASSERT_TRUE(state.ok());
+  state->set_data(&data);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  EXPECT_EQ(data, 1);
+
+  ManagedMemoryManager clone_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> clone = method->clone(&clone_mmm.get());
+  ASSERT_EQ(clone.error(), Error::Ok);
+
+  // The state of the clone is its own, and is not set yet.
+  auto clone_state = clone->get_attribute("state");
+  ASSERT_TRUE(clone_state.ok());
+  EXPECT_EQ(clone_state->const_data_ptr(), nullptr);
+
+  int32_t clone_data = 10;
+  clone_state->set_data(&clone_data);
+  ASSERT_EQ(clone->execute(), Error::Ok);
+  EXPECT_EQ(clone_data, 11);
+  EXPECT_EQ(data, 1);
+}
+
 /*
  * TODO(T161163608): Test is disabled due to a resize bug in tensor_index_out of
  * the portable op lib
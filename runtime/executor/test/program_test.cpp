@@ -457,6 +457,49 @@ TEST_F(ProgramTest, LoadConstantSegment) {
   EXPECT_GE(flatbuffer_program->constant_segment()->offsets()->size(), 1);
 }
 
+TEST_F(ProgramTest, GetSegmentLocation) {
+  const char* path = std::getenv("ET_MODULE_ADD_MUL_PATH");
+  Result<FileDataLoader> loader = FileDataLoader::from(path);
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+
+  // ModuleAddMul has a single segment holding its constants.
+  ASSERT_EQ(program->num_segments(), 1);
+  Result<Program::SegmentLocation> location =
+      program->get_segment_location(0);
+  ASSERT_EQ(location.error(), Error::Ok);
+  EXPECT_EQ(
+      location->segment_info.segment_type,
+      DataLoader::SegmentInfo::Type::Constant);
+  EXPECT_EQ(location->segment_info.segment_index, 0);
+
+  // Reading the location directly should produce the same bytes as loading
+  // the segment through the program.
+  Result<FreeableBuffer> direct = loader->load(
+      location->offset, location->size, location->segment_info);
+  ASSERT_EQ(direct.error(), Error::Ok);
+  Result<FreeableBuffer> segment = ProgramTestFriend::LoadSegment(
+      &program.get(),
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Constant, 0));
+  ASSERT_EQ(segment.error(), Error::Ok);
+  ASSERT_EQ(direct->size(), segment->size());
+  EXPECT_EQ(0, std::memcmp(direct->data(), segment->data(), segment->size()));
+
+  // Out-of-range indices are rejected.
+  EXPECT_EQ(program->get_segment_location(1).error(), Error::NotFound);
+}
+
+TEST_F(ProgramTest, GetSegmentLocationWithNoSegments) {
+  Result<Program> program =
+      Program::load(add_loader_.get(), kDefaultVerification);
+  ASSERT_EQ(program.error(), Error::Ok);
+
+  EXPECT_EQ(program->num_segments(), 0);
+  EXPECT_EQ(program->get_segment_location(0).error(), Error::NotFound);
+}
+
 TEST_F(ProgramTest, LoadConstantSegmentWhenConstantBufferExists) {
   // Load the serialized ModuleAddMul data, with constants in the flatbuffer and
   // no constants in the segment.
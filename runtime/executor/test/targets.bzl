@@ -105,6 +105,25 @@ def define_common_targets(is_fbcode = False):
         ],
     )
 
+    # Not a test: run it by hand to time method loading with a full kernel
+    # registry.
+    runtime.cxx_binary(
+        name = "method_init_benchmark",
+        srcs = [
+            "method_init_benchmark.cpp",
+        ],
+        deps = [
+            ":managed_memory_manager",
+            "//executorch/extension/data_loader:buffer_data_loader",
+            "//executorch/runtime/core:core",
+            "//executorch/runtime/executor:program",
+            "//executorch/runtime/kernel:kernel_runtime_context",
+            "//executorch/runtime/kernel:operator_registry",
+            "//executorch/runtime/platform:platform",
+            "//executorch/schema:program",
+        ],
+    )
+
     # TODO(dbort): Find a way to make these run for ANDROID/APPLE in xplat. The
     # android and ios test determinators don't like the reference to the model
     # file in fbcode. See https://fburl.com/9esapdmd
@@ -120,9 +139,13 @@ def define_common_targets(is_fbcode = False):
             "ET_MODULE_DYNAMIC_CAT_UNALLOCATED_IO_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleDynamicCatUnallocatedIO.pte])",
             "ET_MODULE_INDEX_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleIndex.pte])",
             "ET_MODULE_ADD_MUL_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleAddMul.pte])",
+            "ET_MODULE_ADD_MUL_SIGMOID_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleAddMulSigmoid.pte])",
+            "ET_MODULE_BRANCHES_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleBranches.pte])",
             "ET_MODULE_MULTI_ENTRY_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleMultipleEntry.pte])",
+            "ET_MODULE_SHARED_BUFFER_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleSharedBuffer.pte])",
             "ET_MODULE_SIMPLE_TRAIN_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleSimpleTrain.pte])",
             "ET_MODULE_STATEFUL_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleStateful.pte])",
+            "ET_MODULE_TRIVIAL_OPS_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleTrivialOps.pte])",
             "ET_MODULE_ADD_MUL_PROGRAM_PATH": "$(location fbcode//executorch/test/models:exported_program_and_data[ModuleAddMul.pte])",
             "ET_MODULE_ADD_MUL_DATA_PATH": "$(location fbcode//executorch/test/models:exported_program_and_data[ModuleAddMul.ptd])",
             "ET_MODULE_LINEAR_DATA_PATH": "$(location fbcode//executorch/test/models:exported_program_and_data[ModuleLinear.ptd])",
@@ -168,6 +191,7 @@ def define_common_targets(is_fbcode = False):
                 "//executorch/extension/data_loader:file_data_loader",
                 "//executorch/extension/flat_tensor:flat_tensor_data_map",
                 "//executorch/extension/runner_util:inputs",
+                "//executorch/extension/threadpool:threadpool",
                 "//executorch/kernels/portable:generated_lib",
             ],
             env = modules_env,
@@ -231,6 +255,25 @@ def define_common_targets(is_fbcode = False):
             env = modules_env,
         )
 
+        # Not a test: run it by hand to time method loading and the
+        # interpreter loop.
+        runtime.cxx_binary(
+            name = "method_dispatch_benchmark",
+            srcs = [
+                "method_dispatch_benchmark.cpp",
+            ],
+            deps = [
+                ":managed_memory_manager",
+                "//executorch/extension/data_loader:file_data_loader",
+                "//executorch/extension/runner_util:inputs",
+                "//executorch/runtime/core:core",
+                "//executorch/runtime/executor:program",
+                "//executorch/runtime/kernel:kernel_runtime_context",
+                "//executorch/runtime/kernel:operator_registry",
+                "//executorch/runtime/platform:platform",
+            ],
+        )
+
         runtime.cxx_test(
             name = "backend_integration_test",
             srcs = [
@@ -238,6 +281,7 @@ def define_common_targets(is_fbcode = False):
             ],
             deps = [
                 ":managed_memory_manager",
+                "//executorch/devtools/etdump:etdump_flatcc",
                 "//executorch/runtime/backend:interface",
                 "//executorch/runtime/executor:program",
                 "//executorch/extension/data_loader:buffer_data_loader",
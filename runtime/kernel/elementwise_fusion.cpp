@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/kernel/elementwise_fusion.h>
+
+#include <cstring>
+
+#include <executorch/runtime/platform/log.h>
+
+namespace executorch {
+namespace ET_RUNTIME_NAMESPACE {
+
+namespace {
+
+// Maximum number of operators that can be registered as fusible.
+constexpr size_t kMaxFusibleElementwiseOps = 64;
+
+// @lint-ignore CLANGTIDY facebook-hte-CArray
+FusibleElementwiseOp registered_fusible_ops[kMaxFusibleElementwiseOps];
+
+size_t num_registered_fusible_ops = 0;
+
+const FusibleElementwiseOp* find_fusible_op(const char* name) {
+  for (size_t i = 0; i < num_registered_fusible_ops; ++i) {
+    if (strcmp(registered_fusible_ops[i].name, name) == 0) {
+      return &registered_fusible_ops[i];
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * Returns true if `kernel` was registered as a Kernel that calls the unboxed
+ * kernel identified by `native_kernel`. The registry is only read when a
+ * method is initialized, after all static registration is done, so it does
+ * not matter whether the kernel library or the fusible op registered first.
+ */
+bool kernel_calls_native_kernel(OpFunction kernel, const void* native_kernel) {
+  for (const Kernel& registered : get_registered_kernels()) {
+    if (registered.op_ == kernel &&
+        registered.native_kernel_ == native_kernel) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+Error register_fusible_elementwise_op(const FusibleElementwiseOp& op) {
+  if (op.name == nullptr || op.fn == nullptr || op.runner == nullptr ||
+      op.native_kernel == nullptr || op.num_inputs == 0 ||
+      op.num_inputs > kMaxFusibleElementwiseInputs ||
+      op.num_scalars > kMaxFusibleElementwiseScalars) {
+    ET_LOG(Error, "Invalid fusible elementwise op");
+    return Error::InvalidArgument;
+  }
+  if (find_fusible_op(op.name) != nullptr) {
+    return Error::Ok;
+  }
+  if (num_registered_fusible_ops >= kMaxFusibleElementwiseOps) {
+    ET_LOG(
+        Error,
+        "The number of fusible elementwise ops exceeds %" ET_PRIsize_t,
+        kMaxFusibleElementwiseOps);
+    return Error::RegistrationExceedingMaxKernels;
+  }
+  registered_fusible_ops[num_registered_fusible_ops++] = op;
+  return Error::Ok;
+}
+
+const FusibleElementwiseOp* get_fusible_elementwise_op(
+    const char* name,
+    OpFunction kernel) {
+  const FusibleElementwiseOp* op = find_fusible_op(name);
+  if (op == nullptr ||
+      !kernel_calls_native_kernel(kernel, op->native_kernel)) {
+    return nullptr;
+  }
+  return op;
+}
+
+} // namespace ET_RUNTIME_NAMESPACE
+} // namespace executorch
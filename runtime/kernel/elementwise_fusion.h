@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/evalue.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/kernel/operator_registry.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace ET_RUNTIME_NAMESPACE {
+
+/// The maximum number of instructions that are fused into one loop.
+constexpr size_t kMaxFusedElementwiseSteps = 8;
+
+/// The maximum number of tensor inputs of a fusible operator.
+constexpr size_t kMaxFusibleElementwiseInputs = 3;
+
+/// The maximum number of Scalar arguments of a fusible operator.
+constexpr size_t kMaxFusibleElementwiseScalars = 2;
+
+/**
+ * Computes `n` consecutive output elements of an elementwise operator.
+ *
+ * @param[in] inputs One pointer per tensor input of the operator, in argument
+ *     order, each pointing at the `n` elements matching the output elements.
+ * @param[in] scalars The values of the Scalar arguments of the operator.
+ * @param[out] out The `n` output elements.
+ */
+using ElementwiseBlockFunction = void (*)(
+    const float* const* inputs,
+    const float* scalars,
+    float* out,
+    size_t n);
+
+struct FusedElementwiseStep;
+
+/**
+ * Runs all steps of a fused chain in one pass over their elements.
+ *
+ * Returns Error::NotSupported, before writing to any tensor, if the arguments
+ * do not allow running the chain fused this time; e.g. because a dynamic
+ * shape made two inputs differ in size. The caller then runs the original
+ * kernels one at a time. Any other error is a failure of the chain.
+ */
+using FusedElementwiseRunner = Error (*)(
+    KernelRuntimeContext& context,
+    Span<const FusedElementwiseStep> steps);
+
+/**
+ * An out-variant elementwise operator that can run as one step of a fused
+ * loop. Its arguments must be `num_inputs` tensors, then `num_scalars`
+ * Scalars, then the out tensor, then the returned value.
+ */
+struct FusibleElementwiseOp {
+  /// The operator name including the overload; e.g. "aten::mul.out".
+  const char* name;
+  /// Computes the operator for float tensors.
+  ElementwiseBlockFunction fn;
+  /// Runs chains of this operator. Only operators that share a runner are
+  /// fused with each other.
+  FusedElementwiseRunner runner;
+  uint8_t num_inputs;
+  uint8_t num_scalars;
+  /// The unboxed kernel that `fn` reproduces, as returned by
+  /// native_kernel_id(). Instructions are only fused if they resolved to a
+  /// registered Kernel whose native_kernel_ is this kernel.
+  const void* native_kernel = nullptr;
+
+  /// Index of the out tensor in the argument list.
+  size_t out_index() const {
+    return num_inputs + num_scalars;
+  }
+};
+
+/**
+ * One instruction of a fused chain.
+ */
+struct FusedElementwiseStep {
+  const FusibleElementwiseOp* op;
+  /// The arguments of the instruction, laid out as FusibleElementwiseOp
+  /// describes.
+  Span<EValue*> args;
+  /// False if the out tensor is only read by later steps of the same chain.
+  /// It then does not need to be written to.
+  bool materialize_out;
+};
+
+/**
+ * Registers an operator as fusible. Registering an operator name a second time
+ * is a no-op, since the same kernel sources may be linked into several kernel
+ * libraries.
+ *
+ * @retval Error::Ok The operator was registered, or already was.
+ * @retval Error::InvalidArgument The operator description is invalid.
+ * @retval Error::RegistrationExceedingMaxKernels The table is full.
+ */
+ET_NODISCARD Error
+register_fusible_elementwise_op(const FusibleElementwiseOp& op);
+
+/**
+ * Returns the fusible operator registered under `name`, or nullptr if there
+ * is none or if `kernel` does not call the unboxed kernel that the operator
+ * reproduces, according to the Kernel::native_kernel_ it was registered with.
+ */
+const FusibleElementwiseOp* get_fusible_elementwise_op(
+    const char* name,
+    OpFunction kernel);
+
+} // namespace ET_RUNTIME_NAMESPACE
+} // namespace executorch
@@ -9,11 +9,23 @@
 #include <executorch/runtime/kernel/operator_registry.h>
 
 #include <cinttypes>
+#include <cstdint>
+#include <type_traits>
 
 #include <executorch/runtime/platform/assert.h>
 #include <executorch/runtime/platform/platform.h>
 #include <executorch/runtime/platform/system.h>
 
+/*
+ * Kernels are found through an index by operator name, which takes about 12k of
+ * zeroed data with the default kernel capacity. Targets that need to save this
+ * space can avoid building it by passing -DET_ENABLE_OPERATOR_INDEX=0 on the
+ * compile line; lookups then compare the name of every registered kernel.
+ */
+#ifndef ET_ENABLE_OPERATOR_INDEX
+#define ET_ENABLE_OPERATOR_INDEX 1
+#endif
+
 namespace executorch {
 namespace ET_RUNTIME_NAMESPACE {
 
@@ -48,6 +60,120 @@ Kernel* registered_kernels = reinterpret_cast<Kernel*>(registered_kernels_data);
 /// The number of kernels registered in the table.
 size_t num_registered_kernels = 0;
 
+#if ET_ENABLE_OPERATOR_INDEX
+
+/**
+ * Returns the smallest power of two that is greater than or equal to `n`.
+ */
+constexpr uint32_t round_up_to_power_of_two(uint32_t n) {
+  uint32_t p = 1;
+  while (p < n) {
+    p <<= 1;
+  }
+  return p;
+}
+
+/// The index plus one of a kernel in `registered_kernels`, or zero for none.
+using KernelEntry = std::conditional_t<
+    (kMaxRegisteredKernels <= UINT16_MAX),
+    uint16_t,
+    uint32_t>;
+
+// Number of slots in the operator name index. Twice the kernel capacity so
+// that the load factor stays at or below 1/2 even if every registered kernel
+// belongs to a different operator.
+constexpr uint32_t kOpIndexSize =
+    round_up_to_power_of_two(2 * kMaxRegisteredKernels);
+
+/**
+ * Open-addressing hash index from operator name to the first kernel registered
+ * for that operator. Zero-initialized, so it starts out empty.
+ */
+// @lint-ignore CLANGTIDY facebook-hte-CArray
+KernelEntry op_index[kOpIndexSize];
+
+/**
+ * Links the kernels that belong to the same operator, in registration order.
+ * `next_kernel_entry[i]` is the entry of the next kernel with the same name as
+ * `registered_kernels[i]`, or zero if it is the last one.
+ */
+// @lint-ignore CLANGTIDY facebook-hte-CArray
+KernelEntry next_kernel_entry[kMaxRegisteredKernels];
+
+/// FNV-1a hash of a NUL-terminated operator name.
+uint32_t hash_op_name(const char* name) {
+  uint32_t hash = 2166136261u;
+  for (; *name != '\0'; name++) {
+    hash ^= static_cast<uint8_t>(*name);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/**
+ * Returns the `op_index` slot for `name`: either the slot whose kernels have
+ * that name, or the empty slot where the operator would be inserted. The index
+ * is never more than half full, so an empty slot always exists.
+ */
+uint32_t find_op_slot(const char* name) {
+  constexpr uint32_t kMask = kOpIndexSize - 1;
+  uint32_t slot = hash_op_name(name) & kMask;
+  while (op_index[slot] != 0 &&
+         strcmp(registered_kernels[op_index[slot] - 1].name_, name) != 0) {
+    slot = (slot + 1) & kMask;
+  }
+  return slot;
+}
+
+/// Returns the entry of the first kernel registered as `name`, or zero.
+KernelEntry first_kernel_for_op(const char* name) {
+  return op_index[find_op_slot(name)];
+}
+
+/// Returns the entry of the next kernel with the same name as `entry`, or zero.
+KernelEntry next_kernel_for_op(KernelEntry entry, ET_UNUSED const char* name) {
+  return next_kernel_entry[entry - 1];
+}
+
+/**
+ * Adds the last registered kernel to the index. `last_entry` is the last kernel
+ * registered before it under the same name, or zero if it is the first.
+ */
+void index_last_kernel(KernelEntry last_entry) {
+  const auto new_entry = static_cast<KernelEntry>(num_registered_kernels);
+  if (last_entry == 0) {
+    op_index[find_op_slot(registered_kernels[new_entry - 1].name_)] =
+        new_entry;
+  } else {
+    next_kernel_entry[last_entry - 1] = new_entry;
+  }
+  next_kernel_entry[new_entry - 1] = 0;
+}
+
+#else // ET_ENABLE_OPERATOR_INDEX
+
+// Without the index, kernels of an operator are found by comparing the name of
+// every registered kernel.
+
+using KernelEntry = uint32_t;
+
+KernelEntry next_kernel_for_op(KernelEntry entry, const char* name) {
+  for (size_t i = entry; i < num_registered_kernels; i++) {
+    if (strcmp(registered_kernels[i].name_, name) == 0) {
+      return static_cast<KernelEntry>(i + 1);
+    }
+  }
+  return 0;
+}
+
+KernelEntry first_kernel_for_op(const char* name) {
+  return next_kernel_for_op(0, name);
+}
+
+void index_last_kernel(ET_UNUSED KernelEntry last_entry) {}
+
+#endif // ET_ENABLE_OPERATOR_INDEX
+
 // Registers the kernels, but may return an error.
 Error register_kernels_internal(const Span<const Kernel> kernels) {
   // Operator registration happens in static initialization time before or after
@@ -81,17 +207,21 @@ Error register_kernels_internal(const Span<const Kernel> kernels) {
       et_pal_get_shared_library_name(kernels.data());
 
   for (const auto& kernel : kernels) {
-    // Linear search. This is fine if the number of kernels is small.
-    for (size_t i = 0; i < num_registered_kernels; i++) {
-      Kernel k = registered_kernels[i];
-      if (strcmp(kernel.name_, k.name_) == 0 &&
-          kernel.kernel_key_ == k.kernel_key_) {
+    // Only kernels of the same operator can collide; walk them to reject
+    // duplicates and to find the last one.
+    KernelEntry last_entry = 0;
+    for (KernelEntry entry = first_kernel_for_op(kernel.name_); entry != 0;
+         entry = next_kernel_for_op(entry, kernel.name_)) {
+      const Kernel& k = registered_kernels[entry - 1];
+      if (kernel.kernel_key_ == k.kernel_key_) {
         ET_LOG(Error, "Re-registering %s, from %s", k.name_, lib_name);
         ET_LOG_KERNEL_KEY(k.kernel_key_);
         return Error::RegistrationAlreadyRegistered;
       }
+      last_entry = entry;
     }
     registered_kernels[num_registered_kernels++] = kernel;
+    index_last_kernel(last_entry);
   }
   ET_LOG(
       Debug,
@@ -239,19 +369,20 @@ Result<OpFunction> get_op_function_from_registry(
   }
   KernelKey kernel_key = KernelKey(key_string.data());
 
-  int32_t fallback_idx = -1;
-  for (size_t idx = 0; idx < num_registered_kernels; idx++) {
-    if (strcmp(registered_kernels[idx].name_, name) == 0) {
-      if (registered_kernels[idx].kernel_key_ == kernel_key) {
-        return registered_kernels[idx].op_;
-      }
-      if (registered_kernels[idx].kernel_key_.is_fallback()) {
-        fallback_idx = idx;
-      }
+  // Only the kernels registered for this operator need to be compared.
+  const Kernel* fallback = nullptr;
+  for (KernelEntry entry = first_kernel_for_op(name); entry != 0;
+       entry = next_kernel_for_op(entry, name)) {
+    const Kernel& k = registered_kernels[entry - 1];
+    if (k.kernel_key_ == kernel_key) {
+      return k.op_;
+    }
+    if (k.kernel_key_.is_fallback()) {
+      fallback = &k;
     }
   }
-  if (fallback_idx != -1) {
-    return registered_kernels[fallback_idx].op_;
+  if (fallback != nullptr) {
+    return fallback->op_;
   }
   ET_LOG(Error, "kernel '%s' not found.", name);
   ET_LOG_TENSOR_META(meta_list);
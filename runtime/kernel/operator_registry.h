@@ -183,6 +183,10 @@ struct Kernel {
   // Data is not owned by the Kernel struct.
   KernelKey kernel_key_;
   OpFunction op_;
+  // The unboxed kernel that op_ calls, as returned by native_kernel_id(), or
+  // nullptr if unknown. Lets the runtime tell which implementation an
+  // operator resolved to, e.g. to only fuse portable elementwise kernels.
+  const void* native_kernel_ = nullptr;
   /**
    * We are doing a copy of the string pointer instead of duplicating the string
    * itself, we require the lifetime of the operator name to be at least as long
@@ -193,9 +197,31 @@ struct Kernel {
   explicit Kernel(const char* name, KernelKey key, OpFunction func)
       : name_(name), kernel_key_(key), op_(func) {}
 
+  explicit Kernel(const char* name, OpFunction func, const void* native_kernel)
+      : name_(name), op_(func), native_kernel_(native_kernel) {}
+
+  explicit Kernel(
+      const char* name,
+      KernelKey key,
+      OpFunction func,
+      const void* native_kernel)
+      : name_(name),
+        kernel_key_(key),
+        op_(func),
+        native_kernel_(native_kernel) {}
+
   Kernel() {}
 };
 
+/**
+ * Returns the value that identifies the unboxed kernel `fn` in
+ * Kernel::native_kernel_.
+ */
+template <typename Ret, typename... Args>
+const void* native_kernel_id(Ret (*fn)(KernelRuntimeContext&, Args...)) {
+  return reinterpret_cast<const void*>(fn);
+}
+
 namespace internal {
 
 /**
@@ -1,18 +1,36 @@
 load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "get_aten_mode_options", "runtime")
 
+def _operator_index_preprocessor_flags():
+    # The operator name index adds ~12k of zeroed data with the default kernel
+    # capacity. Make it optional for space-constrained systems.
+    enable_index = native.read_config(
+        "executorch",
+        "enable_operator_index",
+        # Default value
+        "true",
+    )
+    if enable_index == "false":
+        return ["-DET_ENABLE_OPERATOR_INDEX=0"]
+    elif enable_index == "true":
+        # Enabled by default.
+        return []
+    else:
+        fail("executorch.enable_operator_index must be one of 'true' or 'false'; saw '" +
+             enable_index + "'")
+
 def _operator_registry_preprocessor_flags():
     max_kernel_num = native.read_config("executorch", "max_kernel_num", None)
     if max_kernel_num != None:
-        return ["-DMAX_KERNEL_NUM=" + max_kernel_num]
+        return ["-DMAX_KERNEL_NUM=" + max_kernel_num] + _operator_index_preprocessor_flags()
     elif not runtime.is_oss:
         return select({
             "DEFAULT": [],
             "fbsource//xplat/executorch/tools/buck/constraints:executorch-max-kernel-num-256": ["-DMAX_KERNEL_NUM=256"],
             "fbsource//xplat/executorch/tools/buck/constraints:executorch-max-kernel-num-128": ["-DMAX_KERNEL_NUM=128"],
             "fbsource//xplat/executorch/tools/buck/constraints:executorch-max-kernel-num-64": ["-DMAX_KERNEL_NUM=64"],
-        })
+        }) + _operator_index_preprocessor_flags()
     else:
-        return []
+        return _operator_index_preprocessor_flags()
 
 def define_common_targets():
     """Defines targets that should be shared between fbcode and xplat.
@@ -68,6 +86,21 @@ def define_common_targets():
             preprocessor_flags = _operator_registry_preprocessor_flags(),
         )
 
+        runtime.cxx_library(
+            name = "elementwise_fusion" + aten_suffix,
+            srcs = ["elementwise_fusion.cpp"],
+            exported_headers = ["elementwise_fusion.h"],
+            visibility = [
+                "//executorch/...",
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":operator_registry" + aten_suffix,
+                "//executorch/runtime/core:core",
+                "//executorch/runtime/core:evalue" + aten_suffix,
+            ],
+        )
+
         runtime.cxx_library(
             name = "kernel_runtime_context" + aten_suffix,
             exported_headers = [
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/kernel/elementwise_fusion.h>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/kernel/kernel_runtime_context.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::ET_RUNTIME_NAMESPACE::FusedElementwiseStep;
+using executorch::ET_RUNTIME_NAMESPACE::FusibleElementwiseOp;
+using executorch::ET_RUNTIME_NAMESPACE::get_fusible_elementwise_op;
+using executorch::ET_RUNTIME_NAMESPACE::Kernel;
+using executorch::ET_RUNTIME_NAMESPACE::KernelRuntimeContext;
+using executorch::ET_RUNTIME_NAMESPACE::native_kernel_id;
+using executorch::ET_RUNTIME_NAMESPACE::register_fusible_elementwise_op;
+using executorch::ET_RUNTIME_NAMESPACE::register_kernel;
+using executorch::runtime::Error;
+using executorch::runtime::EValue;
+using executorch::runtime::Span;
+
+namespace {
+
+// Stand-ins for two unboxed kernels of the same operator, e.g. a portable and
+// an optimized one.
+int native_kernel(KernelRuntimeContext&, int value) {
+  return value;
+}
+int other_native_kernel(KernelRuntimeContext&, int value) {
+  return -value;
+}
+
+// Stand-ins for the generated OpFunctions that call them.
+void boxed_kernel(KernelRuntimeContext&, Span<EValue*>) {}
+void other_boxed_kernel(KernelRuntimeContext&, Span<EValue*>) {}
+void unknown_kernel(KernelRuntimeContext&, Span<EValue*>) {}
+
+void block(const float* const* inputs, const float*, float* out, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = inputs[0][i];
+  }
+}
+
+Error runner(KernelRuntimeContext&, Span<const FusedElementwiseStep>) {
+  return Error::Ok;
+}
+
+} // namespace
+
+class ElementwiseFusionTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(ElementwiseFusionTest, OnlyMatchesTheKernelThatTheOpReproduces) {
+  ASSERT_EQ(
+      register_fusible_elementwise_op(FusibleElementwiseOp{
+          "test::copy.out",
+          block,
+          runner,
+          1,
+          0,
+          native_kernel_id(native_kernel)}),
+      Error::Ok);
+
+  // Nothing is known about the kernel yet.
+  EXPECT_EQ(
+      get_fusible_elementwise_op("test::copy.out", boxed_kernel), nullptr);
+
+  // Two libraries that register a kernel for the same operator.
+  ASSERT_EQ(
+      register_kernel(Kernel(
+          "test::copy.out", boxed_kernel, native_kernel_id(native_kernel))),
+      Error::Ok);
+  ASSERT_EQ(
+      register_kernel(Kernel(
+          "test::copy.out",
+          "v1/6;0,1|6;0,1",
+          other_boxed_kernel,
+          native_kernel_id(other_native_kernel))),
+      Error::Ok);
+  // And one that does not say which kernel it calls.
+  ASSERT_EQ(
+      register_kernel(Kernel("test::copy.out", "v1/6;0|6;0", unknown_kernel)),
+      Error::Ok);
+
+  const FusibleElementwiseOp* op =
+      get_fusible_elementwise_op("test::copy.out", boxed_kernel);
+  ASSERT_NE(op, nullptr);
+  EXPECT_EQ(op->fn, block);
+  EXPECT_EQ(
+      get_fusible_elementwise_op("test::copy.out", other_boxed_kernel),
+      nullptr);
+  EXPECT_EQ(
+      get_fusible_elementwise_op("test::copy.out", unknown_kernel), nullptr);
+  EXPECT_EQ(
+      get_fusible_elementwise_op("test::other.out", boxed_kernel), nullptr);
+}
+
+TEST_F(ElementwiseFusionTest, RejectsOpsWithoutNativeKernel) {
+  EXPECT_EQ(
+      register_fusible_elementwise_op(
+          FusibleElementwiseOp{"test::unknown.out", block, runner, 1, 0}),
+      Error::InvalidArgument);
+}
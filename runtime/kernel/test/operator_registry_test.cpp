@@ -515,3 +515,91 @@ TEST_F(OperatorRegistryTest, ExecutorUsesFallbackKernel) {
   auto val = values[0].toScalar().to<int64_t>();
   ASSERT_EQ(val, 100);
 }
+
+TEST_F(OperatorRegistryTest, LookupAmongManyOperators) {
+  // Register enough operators that their names collide in the registry index,
+  // and check that each one still resolves to its own kernel.
+  constexpr size_t kNumOps = 64;
+  static std::array<std::array<char, 32>, kNumOps> names;
+  OpFunction first_op = [](KernelRuntimeContext&, Span<EValue*> stack) {
+    *(stack[0]) = Scalar(1);
+  };
+  OpFunction other_op = [](KernelRuntimeContext&, Span<EValue*> stack) {
+    *(stack[0]) = Scalar(2);
+  };
+  std::vector<Kernel> kernels;
+  kernels.reserve(kNumOps);
+  for (size_t i = 0; i < kNumOps; i++) {
+    snprintf(names[i].data(), names[i].size(), "test::many_%zu", i);
+    kernels.emplace_back(names[i].data(), i == 0 ? first_op : other_op);
+  }
+  Error err = register_kernels({kernels.data(), kernels.size()});
+  ASSERT_EQ(err, Error::Ok);
+
+  for (size_t i = 0; i < kNumOps; i++) {
+    EXPECT_TRUE(registry_has_op_function(names[i].data()));
+  }
+  EXPECT_FALSE(registry_has_op_function("test::many_"));
+  EXPECT_FALSE(registry_has_op_function("test::many_64"));
+
+  EValue values[1];
+  EValue* stack[1] = {&values[0]};
+  KernelRuntimeContext context{};
+  Result<OpFunction> first = get_op_function_from_registry("test::many_0", {});
+  ASSERT_EQ(first.error(), Error::Ok);
+  (*first)(context, stack);
+  EXPECT_EQ(values[0].toScalar().to<int64_t>(), 1);
+
+  Result<OpFunction> last = get_op_function_from_registry("test::many_63", {});
+  ASSERT_EQ(last.error(), Error::Ok);
+  (*last)(context, stack);
+  EXPECT_EQ(values[0].toScalar().to<int64_t>(), 2);
+}
+
+TEST_F(OperatorRegistryTest, SpecializedKernelPreferredOverFallback) {
+  std::array<char, kKernelKeyBufSize> buf_long_contiguous;
+  Error err = make_kernel_key(
+      {{ScalarType::Long, {0, 1, 2, 3}}},
+      buf_long_contiguous.data(),
+      buf_long_contiguous.size());
+  ASSERT_EQ(err, Error::Ok);
+
+  // Register the fallback first so that the specialized kernel is not the
+  // first one found for the operator.
+  Kernel kernels[] = {
+      Kernel(
+          "test::grault",
+          KernelKey{},
+          [](KernelRuntimeContext&, Span<EValue*> stack) {
+            *(stack[0]) = Scalar(100);
+          }),
+      Kernel(
+          "test::grault",
+          KernelKey(buf_long_contiguous.data()),
+          [](KernelRuntimeContext&, Span<EValue*> stack) {
+            *(stack[0]) = Scalar(50);
+          })};
+  err = register_kernels(kernels);
+  ASSERT_EQ(err, Error::Ok);
+
+  Tensor::DimOrderType dims[] = {0, 1, 2, 3};
+  auto dim_order_type = Span<Tensor::DimOrderType>(dims, 4);
+  TensorMeta meta_long[] = {TensorMeta(ScalarType::Long, dim_order_type)};
+  TensorMeta meta_float[] = {TensorMeta(ScalarType::Float, dim_order_type)};
+
+  EValue values[1];
+  EValue* stack[1] = {&values[0]};
+  KernelRuntimeContext context{};
+
+  Result<OpFunction> specialized =
+      get_op_function_from_registry("test::grault", meta_long);
+  ASSERT_EQ(specialized.error(), Error::Ok);
+  (*specialized)(context, stack);
+  EXPECT_EQ(values[0].toScalar().to<int64_t>(), 50);
+
+  Result<OpFunction> fallback =
+      get_op_function_from_registry("test::grault", meta_float);
+  ASSERT_EQ(fallback.error(), Error::Ok);
+  (*fallback)(context, stack);
+  EXPECT_EQ(values[0].toScalar().to<int64_t>(), 100);
+}
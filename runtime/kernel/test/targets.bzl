@@ -20,6 +20,17 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "elementwise_fusion_test",
+        srcs = [
+            "elementwise_fusion_test.cpp",
+        ],
+        deps = [
+            "//executorch/runtime/kernel:elementwise_fusion",
+            "//executorch/runtime/kernel:kernel_runtime_context",
+        ],
+    )
+
     runtime.cxx_test(
         name = "operator_registry_max_kernel_num_test",
         srcs = [
@@ -156,6 +156,22 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_amax",
+        deps = [
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+            "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
+        ],
+    ),
+    op_target(
+        name = "op_argmax",
+        deps = [
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+            "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
+        ],
+    ),
     op_target(
         name = "op_bmm",
         deps = [
@@ -163,6 +179,23 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/kernels/portable/cpu/util:matmul_ops_util",
         ],
     ),
+    op_target(
+        name = "op_cat",
+        deps = [
+            "//executorch/kernels/optimized/cpu:data_movement",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_convolution",
+        deps = [
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/optimized:libblas",
+            "//executorch/kernels/portable/cpu/util:dtype_util",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+        ],
+    ),
     op_target(
         name = "op_div",
         deps = [
@@ -186,6 +219,13 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_expand_copy",
+        deps = [
+            "//executorch/kernels/optimized/cpu:data_movement",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
     op_target(
         name = "op_fft_c2r",
         compiler_flags = [] if runtime.is_oss else [
@@ -260,6 +300,36 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_permute_copy",
+        deps = [
+            "//executorch/kernels/optimized/cpu:data_movement",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_repeat",
+        deps = [
+            "//executorch/kernels/optimized/cpu:data_movement",
+        ],
+    ),
+    op_target(
+        name = "op_slice_copy",
+        deps = [
+            "//executorch/kernels/optimized/cpu:data_movement",
+            "//executorch/kernels/portable/cpu/util:slice_util",
+        ],
+    ),
+    op_target(
+        name = "op_softmax",
+        deps = [
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/portable/cpu/util:activation_ops_util",
+            "//executorch/kernels/portable/cpu/util:functional_util",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+            "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
+        ],
+    ),
     op_target(
         name = "op_sub",
         deps = [
@@ -270,6 +340,19 @@ OPTIMIZED_ATEN_OPS = (
             "//executorch/runtime/core/portable_type/c10/c10:aten_headers_for_executorch",
         ],
     ),
+    op_target(
+        name = "op_topk",
+        deps = [
+            "//executorch/extension/threadpool:threadpool",
+        ],
+    ),
+    op_target(
+        name = "op_transpose_copy",
+        deps = [
+            "//executorch/kernels/optimized/cpu:data_movement",
+            "//executorch/kernels/portable/cpu/util:transpose_util",
+        ],
+    ),
     op_target(
         name = "op_where",
         deps = [
@@ -111,6 +111,28 @@ class ModuleLinear(torch.nn.Module):
         return (torch.randn(3),)
 
 
+class ModuleLinearPartitioned(torch.nn.Module):
+    """
+    Linear layers separated by an op that XNNPACK does not support, so that
+    each layer becomes a delegate of its own.
+    """
+
+    def __init__(self, num_layers: int = 4, size: int = 256):
+        super().__init__()
+        self.size = size
+        self.linears = torch.nn.ModuleList(
+            [torch.nn.Linear(size, size) for _ in range(num_layers)]
+        )
+
+    def forward(self, x: torch.Tensor):
+        for linear in self.linears:
+            x = torch.cumsum(linear(x), dim=-1)
+        return x
+
+    def get_random_inputs(self):
+        return (torch.randn(1, self.size),)
+
+
 #
 # Backends
 #
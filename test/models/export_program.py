@@ -146,6 +146,69 @@ class ModuleAddMul(torch.nn.Module):
         return (torch.ones(2, 2, dtype=torch.float),)
 
 
+class ModuleAddMulSigmoid(torch.nn.Module):
+    """A chain of elementwise ops that the runtime can fuse into one call."""
+
+    def __init__(self):
+        super().__init__()
+
+    def forward(self, x: torch.Tensor, y: torch.Tensor):
+        return torch.sigmoid(torch.mul(torch.add(x, y), y))
+
+    def get_random_inputs(self):
+        return (torch.randn(4, 4), torch.randn(4, 4))
+
+
+class ModuleBranches(torch.nn.Module):
+    """Two matmuls that don't depend on each other, then an add that joins
+    them."""
+
+    def __init__(self):
+        super().__init__()
+
+    def forward(self, x: torch.Tensor, y: torch.Tensor):
+        return torch.mm(x, y) + torch.mm(y, x)
+
+    def get_random_inputs(self):
+        return (torch.randn(2, 2), torch.randn(2, 2))
+
+
+class ModuleSharedBuffer(torch.nn.Module):
+    """Like ModuleBranches, but the matmul of y comes after a's last use, so
+    the memory plan puts its output in a's buffer. It shares no value with
+    the matmul that reads a, yet must run after it."""
+
+    def __init__(self):
+        super().__init__()
+
+    def forward(self, x: torch.Tensor, y: torch.Tensor):
+        a = torch.mm(x, x)
+        b = torch.mm(a, a)
+        c = torch.mm(y, y)
+        return b + c
+
+    def get_random_inputs(self):
+        return (torch.randn(2, 2), torch.randn(2, 2))
+
+
+class ModuleTrivialOps(torch.nn.Module):
+    """A long chain of adds on single-element tensors, so that executing it is
+    dominated by the cost of dispatching instructions."""
+
+    NUM_OPS = 10000
+
+    def __init__(self):
+        super().__init__()
+
+    def forward(self, x: torch.Tensor, y: torch.Tensor):
+        for _ in range(self.NUM_OPS):
+            x = torch.add(x, y)
+        return x
+
+    def get_random_inputs(self):
+        return (torch.ones(1), torch.ones(1))
+
+
 # Used for program-data-separation.
 class ModuleLinear(torch.nn.Module):
     def __init__(self):
@@ -62,15 +62,19 @@ def define_common_targets():
         "ModuleAdd",
         "ModuleAddHalf",
         "ModuleAddMul",
+        "ModuleAddMulSigmoid",
         "ModuleBasic",
+        "ModuleBranches",
         "ModuleKVCacheCachePos",
         "ModuleKVCacheInputPos",
         "ModuleMultipleEntry",
         "ModuleNoKVCache",
         "ModuleIndex",
         "ModuleDynamicCatUnallocatedIO",
+        "ModuleSharedBuffer",
         "ModuleSimpleTrain",
         "ModuleStateful",
+        "ModuleTrivialOps",
     ]
 
     # Generates Executorch .pte program files for various modules at build time.
@@ -163,6 +167,7 @@ def define_common_targets():
         "ModuleAddLarge",
         "ModuleSubLarge",
         "ModuleLinear",
+        "ModuleLinearPartitioned",
     ]
 
     # Name of the backend to use when exporting delegated programs.
@@ -196,7 +201,7 @@ def define_common_targets():
     runtime.genrule(
         name = "exported_xnnp_delegated_programs",
         cmd = "$(exe :export_delegated_program)" +
-              " --modules ModuleAddLarge,ModuleSubLarge" +
+              " --modules ModuleAddLarge,ModuleSubLarge,ModuleLinearPartitioned" +
               " --backend_id " + "XnnpackBackend" +
               " --outdir $OUT",
         outs = {
@@ -207,6 +212,7 @@ def define_common_targets():
         visibility = [
             "//executorch/runtime/executor/test/...",
             "//executorch/backends/test/...",
+            "//executorch/backends/xnnpack/test/...",
             "//executorch/test/...",
             "@EXECUTORCH_CLIENTS",
         ],
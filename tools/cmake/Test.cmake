@@ -53,3 +53,22 @@ function(et_cxx_test target_name)
   add_test(NAME ${target_name} COMMAND ${target_name})
 
 endfunction()
+
+# A helper function to generate a benchmark executable target, which is built
+# with the tests but not run by ctest. It takes the same arguments as
+# et_cxx_test, but only links executorch_core by default.
+#
+# Example: et_cxx_benchmark(my_benchmark SOURCES my_benchmark.cpp EXTRA_LIBS
+# portable_kernels)
+#
+function(et_cxx_benchmark target_name)
+
+  set(multi_arg_names SOURCES EXTRA_LIBS)
+  cmake_parse_arguments(ET_CXX_BENCHMARK "" "" "${multi_arg_names}" ${ARGN})
+
+  add_executable(${target_name} ${ET_CXX_BENCHMARK_SOURCES})
+  target_link_libraries(
+    ${target_name} executorch_core ${ET_CXX_BENCHMARK_EXTRA_LIBS}
+  )
+
+endfunction()
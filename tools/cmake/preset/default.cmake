@@ -191,6 +191,10 @@ define_overridable_option(
   EXECUTORCH_BUILD_EXTENSION_RUNNER_UTIL "Build the Runner Util extension" BOOL
   ${_default_executorch_build_executor_runner}
 )
+define_overridable_option(
+  EXECUTORCH_BUILD_BENCHMARK_RUNNER "Build the Linux benchmark_runner executable"
+  BOOL OFF
+)
 
 # NB: Enabling this will serialize execution of delegate instances Keeping this
 # OFF by default to maintain existing behavior, to be revisited.
@@ -255,6 +259,10 @@ check_required_options_on(
   IF_ON EXECUTORCH_BUILD_EXECUTOR_RUNNER REQUIRES
   EXECUTORCH_BUILD_EXTENSION_EVALUE_UTIL EXECUTORCH_BUILD_EXTENSION_RUNNER_UTIL
 )
+check_required_options_on(
+  IF_ON EXECUTORCH_BUILD_BENCHMARK_RUNNER REQUIRES
+  EXECUTORCH_BUILD_EXTENSION_RUNNER_UTIL EXECUTORCH_BUILD_EXTENSION_FLAT_TENSOR
+)
 check_required_options_on(
   IF_ON EXECUTORCH_BUILD_EXTENSION_FLAT_TENSOR REQUIRES
   EXECUTORCH_BUILD_EXTENSION_DATA_LOADER
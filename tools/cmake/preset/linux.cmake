@@ -9,3 +9,4 @@ include(${PROJECT_SOURCE_DIR}/tools/cmake/preset/llm.cmake)
 set_overridable_option(EXECUTORCH_BUILD_EXECUTOR_RUNNER ON)
 set_overridable_option(EXECUTORCH_BUILD_EXTENSION_EVALUE_UTIL ON)
 set_overridable_option(EXECUTORCH_BUILD_EXTENSION_RUNNER_UTIL ON)
+set_overridable_option(EXECUTORCH_BUILD_BENCHMARK_RUNNER ON)